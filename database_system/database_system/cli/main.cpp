@@ -1,11 +1,12 @@
 // =============================================
-// cli/main.cpp  
+// cli/main.cpp  —
 // =============================================
 #include <iostream>
 #include <string>
 #include <algorithm>
 #include <filesystem>
 #include <sstream>
+#include <cstdlib>
 
 #define MINIDB_IMPL_LEXER
 #define MINIDB_IMPL_PARSER
@@ -25,9 +26,10 @@
 #include "../engine/catalog_manager.hpp"
 #include "../engine/storage_engine.hpp"
 #include "../engine/executor.hpp"
+#include "../engine/csv_loader.hpp"
 
-#include "../storage/file_manager.hpp"   // 
-#include "../storage/cache_manager.hpp"  // õ ReplacePolicy ö
+#include "../storage/file_manager.hpp"   // 新增
+#include "../storage/cache_manager.hpp"  // 用到 ReplacePolicy 枚举
 
 using namespace minidb;
 namespace fs = std::filesystem;
@@ -51,21 +53,21 @@ static inline bool ends_with_semicolon(const std::string& s) {
     return false;
 }
 
-// г data/ СݿĿ¼ catalog.txt ǿĿ¼
+// 列出 data/ 下所有“数据库目录”（包含 catalog.txt 或非空目录）
 static std::vector<std::string> list_databases(const std::string& root = "data") {
     std::vector<std::string> out;
     if (!fs::exists(root)) return out;
     for (auto& de : fs::directory_iterator(root)) {
         if (!de.is_directory()) continue;
         auto db = de.path().filename().string();
-        //  catalog.txt ߿Ŀ¼Ҳ⣨ҲƱ catalog.txt
+        // 至少有 catalog.txt 或者空目录也算库（你也可以限制必须有 catalog.txt）
         out.push_back(db);
     }
     std::sort(out.begin(), out.end());
     return out;
 }
 
-// ȷ data/<db>/ Ŀ¼
+// 确保 data/<db>/ 目录存在
 static bool ensure_db_dir(const std::string& db) {
     fs::path p = fs::path("data") / db;
     std::error_code ec;
@@ -86,43 +88,116 @@ static void print_rows(const std::vector<Row>& rows, const TableDef* /*opt_td*/)
     }
 }
 
+// 校验 data/ 下每个库的数据文件，返回进程退出码（0-全部完好，1-有损坏页或无法打开）
+static int verify_databases(IoMode io_mode, ReplacePolicy policy) {
+    int status = 0;
+    for (const auto& db : list_databases()) {
+        fs::path dir = fs::path("data") / db;
+        // 与 FileManager 的路径拼接方式一致；还没有数据文件的库跳过（不为校验新建文件）
+        if (!fs::exists(dir.string() + "\\" + DATA_FILE_NAME)) continue;
+        try {
+            FileManager fm(dir.string(), /*cache*/64, policy, io_mode);
+            VerifyStats st = fm.verify_data_file();
+            std::cout << "Verify data/" << db << ": " << st.pages << " pages of " << fm.get_page_size() << " bytes (ok " << st.ok << ", empty " << st.empty
+                << ", unstamped " << st.unstamped << "), " << st.corrupt.size() << " corrupt, "
+                << st.threads << " thread(s), " << static_cast<uint64_t>(st.seconds * 1000) << " ms\n";
+            if (!st.corrupt.empty()) {
+                status = 1;
+                // 按 文件名:文件内页号 输出
+                std::cout << "  corrupt pages:";
+                for (size_t i = 0; i < st.corrupt.size() && i < 20; ++i) {
+                    std::cout << " " << fm.get_table_file_name(Page::file_of(st.corrupt[i])) << ":" << Page::number_of(st.corrupt[i]);
+                }
+                if (st.corrupt.size() > 20) std::cout << " ...";
+                std::cout << "\n";
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Verify data/" << db << " failed: " << e.what() << "\n";
+            status = 1;
+        }
+    }
+    return status;
+}
+
 // ---------- main ----------
-int main() {
+int main(int argc, char* argv[]) {
+    // 命令行参数：--mmap 以内存映射方式访问数据文件（适合读多写少的库）
+    //             --policy <lru|fifo|clock|2q|lru2|arc> 缓存替换策略（默认lru）
+    //             --verify 校验 data/ 下所有库的数据文件（逐页检查校验和）后退出，有损坏页时返回1
+    //             --page-size <4096|8192|16384|32768|65536> 新建库的页大小（默认4096，已有库按meta.dat中记录的打开）
+    IoMode io_mode = IoMode::STREAM;
+    ReplacePolicy policy = ReplacePolicy::LRU;
+    uint32_t page_size = DEFAULT_PAGE_SIZE;
+    bool verify_only = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--mmap") io_mode = IoMode::MMAP;
+        else if (arg == "--verify") verify_only = true;
+        else if (arg == "--policy" && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "lru") policy = ReplacePolicy::LRU;
+            else if (name == "fifo") policy = ReplacePolicy::FIFO;
+            else if (name == "clock") policy = ReplacePolicy::CLOCK;
+            else if (name == "2q") policy = ReplacePolicy::TWO_Q;
+            else if (name == "lru2") policy = ReplacePolicy::LRU_2;
+            else if (name == "arc") policy = ReplacePolicy::ARC;
+            else std::cerr << "unknown policy: " << name << ", using lru\n";
+        }
+        else if (arg == "--page-size" && i + 1 < argc) {
+            std::string value = argv[++i];
+            uint32_t size = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+            if (Page::is_valid_page_size(size)) page_size = size;
+            else std::cerr << "invalid page size: " << value << ", using " << DEFAULT_PAGE_SIZE << "\n";
+        }
+    }
+
+    if (verify_only) return verify_databases(io_mode, policy);
+
     std::cout << "MiniDB CLI (type \\q to quit)\n";
     if (!fs::exists("data")) {
         fs::create_directories("data");
-        std::cout << "dataѴ\n";
+        std::cout << "data已创建\n";
     }
     else {
-        std::cout << "dataѴ\n";
+        std::cout << "data已存在\n";
     }
 
-    // ǰĬϣ޿⣻ҲĬϽһ "default"
+    // 当前库名（默认：无库；你也可以默认建一个 "default"）
     std::string current_db;
 
-    // ⼸Ҫؽ°󶨡
-    CatalogManager cmgr("");   //  bind_db ·
+    // 这几个对象要“可重建、可重新绑定”
+    CatalogManager cmgr("");   // 将在 bind_db 中重设路径
     Catalog        catalog;
     std::unique_ptr<FileManager>   fm;
     std::unique_ptr<StorageEngine> storage;
     std::unique_ptr<Executor>      exec;
 
     auto bind_db = [&](const std::string& db)->bool {
-        // 1) ȷ data/<db>/ 
+        // 1) 确保 data/<db>/ 存在
         if (!ensure_db_dir(db)) {
             std::cerr << "ERROR: create dir data/" << db << " failed.\n";
             return false;
         }
 
-        // 1) ؽ cmgr / catalog
+        // 1) 先关闭之前的库（StorageEngine 关闭时用旧的 cmgr / catalog 保存目录），再重建 cmgr / catalog
+        exec.reset();
+        storage.reset();
+        fm.reset();
         cmgr = CatalogManager((fs::path("data") / db / "catalog.txt").string());
         catalog = Catalog();
         cmgr.LoadCatalog(catalog);
         
-        // 2) ؽ FM / Storage / Executorע˳ð
+        // 2) 重建 FM / Storage / Executor，注意顺序与引用绑定
         fm = std::make_unique<FileManager>((fs::path("data") / db).string(),
-                                                           /*cache*/64, ReplacePolicy::LRU);
+                                                           /*cache*/64, policy, io_mode,
+                                                           REDO_DEFAULT_THREADS, page_size);
         storage = std::make_unique<StorageEngine>(cmgr, catalog, *fm);
+        // 旧存储格式的库在这里迁移到当前格式
+        if (!storage->Startup()) {
+            std::cerr << "ERROR: storage startup failed for " << db << ".\n";
+            return false;
+        }
         exec = std::make_unique<Executor>(cmgr, catalog, *storage);
         exec->SetDatabase(db);
 
@@ -145,7 +220,7 @@ int main() {
         fs::path p = fs::path("data") / db;
         if (fs::exists(p)) { std::cerr << "Database already exists: " << db << "\n"; return false; }
         if (!ensure_db_dir(db)) return false;
-        // ʼһ catalog.txtѡ
+        // 初始化一个空 catalog.txt（可选）
         CatalogManager temp((p / "catalog.txt").string());
         Catalog empty;
         temp.SaveCatalog(empty);
@@ -171,19 +246,19 @@ int main() {
         return true;
         };
 
-    //  REPL
+    // 进入 REPL
     std::string line, sql;
     while (true) {
         std::cout << "minidb> ";
         if (!std::getline(std::cin, line)) break;
         if (line == "\\q" || line == "quit" || line == "exit") break;
 
-        // мĩβԴ ;
+        // 单行即命令（末尾可以带 ;）
         std::string raw = trim_copy(line);
         if (raw.empty()) continue;
 
-        //  ض߱
-        // Сддзֺſʡ
+        // —— 先拦截多库相关命令（不走编译器）——
+        // 允许大小写混写；参数中分号可省
         {
             std::string up = upper_copy(raw);
             // SHOW DATABASES;
@@ -193,7 +268,7 @@ int main() {
             }
             // CREATE DATABASE <name>;
             if (up.rfind("CREATE DATABASE", 0) == 0) {
-                // ȡ
+                // 取库名
                 std::string db = trim_copy(raw.substr(std::string("CREATE DATABASE").size()));
                 if (!db.empty() && db.back() == ';') db.pop_back();
                 db = trim_copy(db);
@@ -221,16 +296,78 @@ int main() {
                 }
                 continue;
             }
+            // CHECKPOINT;  刷新所有脏页并持久化 meta.dat 与目录
+            if (up == "CHECKPOINT" || up == "CHECKPOINT;") {
+                if (!storage) std::cerr << "No database selected.\n";
+                else if (storage->Checkpoint()) std::cout << "Checkpoint done.\n";
+                else std::cerr << "Checkpoint failed.\n";
+                continue;
+            }
+            // VACUUM [FULL] [<table>];  压缩表页链（不写表名时处理全部表）
+            if (up == "VACUUM" || up.rfind("VACUUM ", 0) == 0 || up == "VACUUM;") {
+                std::string rest = trim_copy(raw.substr(6));
+                if (!rest.empty() && rest.back() == ';') rest.pop_back();
+                rest = trim_copy(rest);
+                bool full = upper_copy(rest) == "FULL" || upper_copy(rest).rfind("FULL ", 0) == 0;
+                if (full) rest = trim_copy(rest.substr(4));
+                if (!storage) {
+                    std::cerr << "No database selected.\n";
+                    continue;
+                }
+                std::vector<std::string> tables = rest.empty() ? catalog.ListTables() : std::vector<std::string>{ rest };
+                for (const auto& name : tables) {
+                    StorageEngine::VacuumState st;
+                    if (!catalog.GetTable(name)) std::cerr << "Error: table " << name << " not found.\n";
+                    else if (!storage->Vacuum(name, full, st)) std::cerr << "VACUUM " << name << " failed.\n";
+                    else std::cout << "VACUUM " << (full ? "FULL " : "") << name << ": " << st.pages_before << " -> "
+                        << st.pages_after << " pages (" << st.pages_freed << " freed, " << st.records_moved
+                        << " records moved, " << st.steps << " step(s)).\n";
+                }
+                continue;
+            }
+            // LOAD DATA INFILE '<文件>' INTO TABLE <表> ...;  /  COPY <表> FROM '<文件>' ...;  从CSV文件批量导入
+            if (up.rfind("LOAD DATA ", 0) == 0 || up.rfind("COPY ", 0) == 0) {
+                std::string table, path, err;
+                CsvLoadOptions opts;
+                if (!CsvLoader::ParseCommand(raw, table, path, opts, err)) {
+                    std::cerr << "Syntax error: " << err << "\n";
+                    continue;
+                }
+                if (!storage) {
+                    std::cerr << "No database selected.\n";
+                    continue;
+                }
+                opts.progress = [&](const CsvLoadStats& st) {
+                    std::cout << "[LOAD] " << table << ": " << st.rows << " rows, " << st.bytes / (1024 * 1024) << " / "
+                        << st.file_bytes / (1024 * 1024) << " MB";
+                    if (st.file_bytes) std::cout << " (" << st.bytes * 100 / st.file_bytes << "%)";
+                    std::cout << ", " << static_cast<uint64_t>(st.rows / (st.seconds > 0 ? st.seconds : 1)) << " rows/s\n";
+                };
+                CsvLoader loader(catalog, *storage);
+                CsvLoadStats st;
+                bool ok = loader.Load(table, path, opts, st);
+                uint64_t rate = static_cast<uint64_t>(st.rows / (st.seconds > 0 ? st.seconds : 1));
+                if (ok) {
+                    std::cout << "LOAD " << table << ": " << st.rows << " rows from '" << path << "' in " << st.seconds
+                        << " s (" << rate << " rows/s, " << st.threads << " parser thread(s)).\n";
+                }
+                else {
+                    std::cerr << "LOAD " << table << ": ";
+                    if (st.error_line) std::cerr << "line " << st.error_line << ": ";
+                    std::cerr << st.error << " (" << st.rows << " rows loaded).\n";
+                }
+                continue;
+            }
             // SHOW TABLES; / DESC ... / SHOW CREATE TABLE ... / ALTER TABLE ...
-            // ЩĿǰ parser/planner δʵ֣ͳһߡдִ
+            // 这些目前 parser/planner 尚未实现，统一走“手写执行器”
         }
 
-        //  ۺ϶ SQLֱ ';'  
+        // —— 聚合多行 SQL，直到遇到 ';' 再送入编译器 ——
         sql += raw + "\n";
-        // ǰﻹû ';'һ
+        // 如果当前缓冲里还没有 ';'，继续读下一行
         if (!ends_with_semicolon(sql)) continue;
 
-        // СߣжǷ INSERT
+        // 小工具：判断是否 INSERT
         auto is_insert_stmt = [](const std::string& s)->bool {
             size_t i = 0; while (i < s.size() && isspace((unsigned char)s[i])) ++i;
             std::string head;
@@ -238,7 +375,7 @@ int main() {
             return head == "INSERT";
         };
 
-        // ִͳһ߱LexerParserSemanticPlannerExecutor
+        // 单条语句执行器：统一走编译器（Lexer→Parser→Semantic→Planner→Executor）
         auto process_one_stmt_compiler = [&](const std::string& one_stmt)->bool {
             Status st = Status::OK();
             Lexer lx(one_stmt);
@@ -265,7 +402,7 @@ int main() {
             return ok;
             };
 
-        // Сߣȡ׹ؼ֣ǰհף
+        // 小工具：取首关键字（忽略前导空白）
         auto head_kw = [](const std::string& s)->std::string {
         size_t i = 0;
         while (i < s.size() && isspace((unsigned char)s[i])) ++i;
@@ -277,13 +414,13 @@ int main() {
         }
             return kw;
         };
-        int inserted_in_batch = 0;  // ԭ N rows inserted. 
+        int inserted_in_batch = 0;  // 用来复刻你原来的 “N rows inserted.” 输出
         while (true) {
             size_t pos = sql.find(';');
             if (pos == std::string::npos) break;
 
             std::string one_no_semi = trim_copy(sql.substr(0, pos));
-            // ɾѴ֣ ';'
+            // 删除已处理部分（包含 ';'）
             sql.erase(0, pos + 1);
             while (!sql.empty() && isspace((unsigned char)sql.front())) sql.erase(sql.begin());
 
@@ -294,25 +431,25 @@ int main() {
             
             bool ok = false;
             if (kw == "UPDATE") {
-                // ȳԡдִ汾֧ IN/BETWEEN/AND ȣ
-                // ʧܣٻ˵/Planner ·ԱδƱԿã
+                // 先尝试“手写执行器”版本（支持 IN/BETWEEN/AND 等），
+                // 如失败，再回退到编译器/Planner 路径（以便未来你完善编译器后仍可用）
                 if (!exec) { std::cerr << "Executor not ready.\n"; ok = false; }
                 else        ok = exec->Execute(one_stmt);
 
                 if (!ok) {
-                    // ˵·
+                    // 回退到编译器链路
                     ok = process_one_stmt_compiler(one_stmt);
                 }
             }
             else {
-                // ȫԭȵġдִּйܲ
+                // 其余语句全部走你原先的“手写执行器”，保持既有功能不变
                 if (!exec) { std::cerr << "Executor not ready.\n"; ok = false; }
                 else        ok = exec->Execute(one_stmt);
             }
             if (ok && kw == "INSERT") ++inserted_in_batch;
         }
 
-        //  INSERT
+        // 若本批次有 INSERT，汇总输出
         if (inserted_in_batch == 1) {
             std::cout << "1 row inserted.\n";
         }
@@ -320,52 +457,66 @@ int main() {
             std::cout << inserted_in_batch << " rows inserted.\n";
         }
 
-        // а䣨βû ';' Ĳһֶȡƴ
+        // 如果还有半句（尾部没有 ';' 的残留），继续下一轮读取拼接
         continue;
     }
 
     return 0;
 }
 
-// Ŀ¼ṹ
+// 目录结构：
 // database_system/
-//  sql_compiler/
-//     ast.h ﷨
-//     lexer.h ʷ
-//     lexer.cpp ʷ
-//     parser.h ﷨
-//     parser.cpp ﷨
-//     semantic.h 
-//     semantic.cpp 
-//     pretty.h Ľ
-//     pretty.cpp Ľ
-//     catalog_iface.h Ŀ¼ӿ
-//     catalog_adapter_engine.h Ŀ¼
-//     planner.h ִмƻ
-//     planner.cpp ִмƻ
-//  storage/
-//     file_manager.hppFileManagerࣨļʼԪݶдͳһ洢ӿڡģЭͬ
-//     file_manager.cppʵFileManagerгԱļԪݳ־ûӿڷװ
-//     cache_manager.hppCacheManagerࣨṹLRU/FIFO ԡͳơĽӿڣ
-//     cache_manager.cppʵCacheManagerгԱ滻߼־
-//     page_manager.hppPageManagerࣨҳ / ͷš̶дӿڡҳ
-//     page_manager.cppʵPageManagerгԱҵ߼
-//     page.hppPageࣨҳṹԪϢʡݶдл / л
-//     page.cppʵPageķԱserializedeserialize
-//  engine/
-//     catalog_manager.hpp ԪݹݿṹϢԪ
-//     catalog_manager.cpp ԪݹݿṹϢԪ
-//     storage_engine.hpp 洢ӿڣʵֶļĲ롢ɾѯȲ
-//     storage_engine.cpp洢ӿڣʵֶļĲ롢ɾѯȲ
-//     executor.hppִִмƻô洢Ŀ¼ SQL ִС 
-//     executor.cppִִмƻô洢Ŀ¼ SQL ִС
-//  utils/
-//     common.hpp
-//     constants.hpp
-//     helpers.hpp
-//  cli/
-//     main.cpp
-//  tests/
-//      test_sql.cpp
-//      test_storage.cpp
-//      test_db.cpp
\ No newline at end of file
+// ├── sql_compiler/
+// │   ├── ast.h 语法分析辅助
+// │   ├── lexer.h 词法分析
+// │   ├── lexer.cpp 词法分析
+// │   ├── parser.h 语法分析
+// │   ├── parser.cpp 语法分析
+// │   ├── semantic.h 语义分析
+// │   ├── semantic.cpp 语义分析
+// │   ├── pretty.h 分析改进
+// │   ├── pretty.cpp 分析改进
+// │   ├── catalog_iface.h 抽象目录接口
+// │   ├── catalog_adapter_engine.h 目录引擎适配器
+// │   ├── planner.h 执行计划生成器
+// │   └── planner.cpp 执行计划生成器
+// ├── storage/
+// │   ├── file_manager.hpp定义FileManager类（文件初始化、元数据读写、统一存储接口、检查点、崩溃恢复、数据文件校验、模块协同）
+// │   ├── file_manager.cpp实现FileManager类的所有成员函数（文件创建、元数据持久化、接口封装）
+// │   ├── cache_manager.hpp定义CacheManager类（按页号分片的缓存结构、分片锁与页帧读写锁、LRU/FIFO/CLOCK/2Q/LRU-2/ARC 策略、顺序扫描提示、后台写线程、命中统计、核心接口）
+// │   ├── cache_manager.cpp实现CacheManager类的所有成员函数（缓存操作、替换逻辑、日志输出）
+// │   ├── page_manager.hpp定义PageManager类（页分配 / 释放、磁盘读写接口、页校验和、空闲页管理）
+// │   ├── page_manager.cpp实现PageManager类的所有成员函数（核心业务逻辑）
+// │   ├── event_log.hpp定义EventLog类（缓存事件日志：无锁环形缓冲、后台刷盘线程、日志级别、采样、按大小轮转）
+// │   ├── event_log.cpp实现EventLog类（无锁入队、后台格式化与写文件、日志轮转）
+// │   ├── free_space_map.hpp定义FreeSpaceMap类（表级空闲空间映射：每个数据页一个空闲档位，持久化在FSM页链中）
+// │   ├── free_space_map.cpp实现FreeSpaceMap类（档位索引、FSM页读写）
+// │   ├── free_page_bitmap.hpp定义FreePageBitmap类（数据文件级空闲页位图：每页一位，带摘要层，持久化在位图页中）
+// │   ├── free_page_bitmap.cpp实现FreePageBitmap类（首次适配、连续段查找、位图页读写）
+// │   ├── page_guard.hpp定义页守卫类（RAII固定缓存页并持有页帧锁：持有期间不被替换，读守卫共享、写守卫独占，写守卫释放时记日志并标脏）
+// │   ├── page_guard.cpp实现页守卫（固定/解除固定、写守卫记录页修改日志）
+// │   ├── wal_manager.hpp定义WalManager类（写前日志：分段日志文件、LSN、组提交、页修改的字节差异记录）
+// │   ├── wal_manager.cpp实现WalManager类（日志追加、组提交写出、段文件管理、日志扫描）
+// │   ├── crc32c.hpp定义CRC32C校验函数（日志记录与页校验和）
+// │   ├── crc32c.cpp实现CRC32C校验（SSE4.2指令，不支持时用查表法）
+// │   ├── page.hpp定义Page类（按库选择的页大小、窄槽/宽槽槽页结构、元信息访问、数据读写、序列化 / 反序列化）
+// │   └── page.cpp实现Page类的非内联成员函数（如serialize、deserialize）
+// ├── engine/
+// │   ├── catalog_manager.hpp 元数据管理器，管理数据库表结构、列信息、索引等元数据
+// │   ├── catalog_manager.cpp 元数据管理器，管理数据库表结构、列信息、索引等元数据
+// │   ├── storage_engine.hpp 存储引擎接口，实现对数据文件的插入、删除、查询等操作。
+// │   ├── storage_engine.cpp存储引擎接口，实现对数据文件的插入、删除、查询等操作。
+// │   ├── tuple_codec.hpp定义TupleCodec/TupleView（按表模式编码的二进制元组、零拷贝只读视图）
+// │   ├── tuple_codec.cpp实现二进制元组的编码、解码与类型检查
+// │   ├── executor.hpp执行器，根据执行计划调用存储引擎和目录管理器完成 SQL 执行。 
+// │   └── executor.cpp执行器，根据执行计划调用存储引擎和目录管理器完成 SQL 执行。
+// ├── utils/
+// │   ├── common.hpp
+// │   ├── constants.hpp
+// │   └── helpers.hpp
+// ├── cli/
+// │   └── main.cpp
+// └── tests/
+//     ├── test_sql.cpp
+//     ├── test_storage.cpp
+//     └── test_db.cpp
\ No newline at end of file
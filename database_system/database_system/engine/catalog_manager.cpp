@@ -1,256 +1,297 @@
-﻿// =============================================
-// engine/catalog_manager.cpp （替换/补丁）
-// =============================================
-#include "catalog_manager.hpp"
-#include <fstream>
-#include <sstream>
-#include <iostream>
-#include <filesystem>
-
-using std::filesystem::path;
-using std::filesystem::create_directories;
-
-static std::string trim(const std::string& s) {
-    size_t b = s.find_first_not_of(" \t\r\n");
-    if (b == std::string::npos) return "";
-    size_t e = s.find_last_not_of(" \t\r\n");
-    return s.substr(b, e - b + 1);
-}
-
-static std::string to_upper(const std::string& s) {
-    std::string r = s; for (auto& c : r) c = (char)std::toupper((unsigned char)c); return r;
-}
-
-bool CatalogManager::PersistCatalog(const Catalog& cat, const std::string& path) {
-    std::ofstream out(path, std::ios::trunc);
-    if (!out) return false;
-
-    // 逐表写： name|file|first|last|col_count|col1|col2|...
-    for (const auto& tname : cat.ListTables()) {
-        const TableInfo* t = cat.GetTable(tname);
-        if (!t) continue;
-
-        std::ostringstream line;
-        line << t->name << "|"
-            << t->file_name << "|"
-            << t->first_pid << "|"
-            << t->last_pid << "|";
-
-        const auto& cols = t->getSchema().GetColumns();
-        line << cols.size();
-        for (auto& c : cols) {
-            // 举例：id:INT 或 name:VARCHAR(64)
-            line << "|" << c.name << ":"
-                << (c.type == ColumnType::INT ? "INT" :
-                    c.type == ColumnType::FLOAT ? "FLOAT" :
-                    "VARCHAR(" + std::to_string(c.length) + ")");
-        }
-        out << line.str() << "\n";
-    }
-    out.flush();
-    return (bool)out;
-}
-
-CatalogManager::CatalogManager(const std::string& file_path)
-    : file_path(file_path) {}
-
-// Load catalog từ file
-bool CatalogManager::LoadCatalog(Catalog& catalog) {
-    std::ifstream ifs(file_path);
-    if (!ifs) return true; // 没文件视为空目录
-    std::string line;
-    while (std::getline(ifs, line)) {
-        line = trim(line);
-        if (line.empty() || line[0] == '#') continue;
-        std::stringstream ss(line);
-        std::string name, file, tok;
-
-        std::getline(ss, name, '|');
-        std::getline(ss, file, '|');
-        std::getline(ss, tok, '|'); uint32_t first_pid = tok.empty() ? 0 : static_cast<uint32_t>(std::stoul(tok));
-        std::getline(ss, tok, '|'); uint32_t last_pid = tok.empty() ? 0 : static_cast<uint32_t>(std::stoul(tok));
-        std::getline(ss, tok, '|'); int col_cnt = tok.empty() ? 0 : std::stoi(tok);
-
-        std::vector<Column> cols;
-        cols.reserve(col_cnt);
-        for (int i = 0; i < col_cnt; ++i) {
-            std::string coldef;
-            if (!std::getline(ss, coldef, '|')) break;
-            // 解析：name:TYPE 或 name:VARCHAR(64)
-            auto pos = coldef.find(':');
-            if (pos == std::string::npos) continue;
-            std::string cname = coldef.substr(0, pos);
-            std::string ctype = coldef.substr(pos + 1);
-            ColumnType ct = ColumnType::VARCHAR;
-            int clen = 0;
-            if (ctype == "INT") ct = ColumnType::INT;
-            else if (ctype == "FLOAT") ct = ColumnType::FLOAT;
-            else {
-                // VARCHAR(n)
-                if (ctype.rfind("VARCHAR", 0) == 0) {
-                    auto l = ctype.find('('), r = ctype.find(')');
-                    if (l != std::string::npos && r != std::string::npos && r > l + 1) {
-                        clen = std::stoi(ctype.substr(l + 1, r - l - 1));
-                    }
-                    ct = ColumnType::VARCHAR;
-                }
-            }
-            cols.emplace_back(cname, ct, clen, false, false);
-        }
-        Schema schema(cols);
-        catalog.AddTable(name, schema, file, first_pid, last_pid);
-    }
-    return true;
-}
-
-// Save catalog xuống file
-bool CatalogManager::SaveCatalog(const Catalog& catalog) {
-    std::ofstream ofs(file_path, std::ios::trunc);
-    if (!ofs) return false;
-
-    // 不能直接访问 map，给 Catalog 增个导出接口更优；这里简化：ListTables + GetTable
-    for (const auto& tname : catalog.ListTables()) {
-        const TableInfo* t = catalog.GetTable(tname);
-        if (!t) continue;
-
-        ofs << t->name << '|'
-            << t->file_name << '|'
-            << t->first_pid << '|'
-            << t->last_pid << '|';
-
-        const auto& cols = t->getSchema().GetColumns();
-        ofs << cols.size();
-        for (const auto& c : cols) {
-            ofs << '|'
-                << c.name << ':';
-            switch (c.type) {
-            case ColumnType::INT:    ofs << "INT"; break;
-            case ColumnType::FLOAT:  ofs << "FLOAT"; break;
-            case ColumnType::VARCHAR:ofs << "VARCHAR(" << c.length << ")"; break;
-            }
-        }
-        ofs << "\n";
-    }
-    return true;
-}
-
-bool CatalogManager::CreateTable(Catalog& catalog,
-    const std::string& tableName,
-    const Schema& schema,
-    const std::string& fileName) {
-    if (catalog.GetTable(tableName)) return false;
-    catalog.AddTable(tableName, schema, fileName, 0, 0);
-    return SaveCatalog(catalog);
-}
-
-bool CatalogManager::DropTable(Catalog& catalog, const std::string& tableName) {
-    if (!catalog.RemoveTable(tableName)) return false;
-    return SaveCatalog(catalog);
-}
-
-bool CatalogManager::UpdateTablePages(Catalog& catalog,
-    const std::string& tableName,
-    uint32_t first_pid,
-    uint32_t last_pid) {
-    TableInfo* t = catalog.GetTable(tableName);
-    if (!t) return false;
-    t->first_pid = first_pid;
-    t->last_pid = last_pid;
-    return SaveCatalog(catalog); // 简单点：每次更新都持久化一次
-}
-
-bool CatalogManager::RenameTable(Catalog& catalog,
-    const std::string& oldName,
-    const std::string& newName) {
-    if (oldName == newName) return true;
-    if (!catalog.GetTable(oldName)) return false;
-    if (catalog.GetTable(newName))  return false;
-
-    TableInfo* t = catalog.GetTable(oldName);
-    TableInfo tmp = *t;         // 拷贝
-    tmp.name = newName;
-    // 可选：文件名跟着改（保留后缀）
-    auto dot = tmp.file_name.rfind('.');
-    if (dot == std::string::npos) tmp.file_name = newName + ".tbl";
-    else                           tmp.file_name = newName + tmp.file_name.substr(dot);
-
-    catalog.RemoveTable(oldName);
-    catalog.AddTable(tmp.name, tmp.schema, tmp.file_name, tmp.first_pid, tmp.last_pid);
-    return SaveCatalog(catalog);
-}
-
-bool CatalogManager::AlterAddColumn(Catalog& catalog,
-    const std::string& tableName,
-    const Column& newCol,
-    const std::string& afterName) {
-    TableInfo* t = catalog.GetTable(tableName);
-    if (!t) return false;
-
-    auto& cols = t->schema.MutableColumns();
-    for (auto& c : cols) if (c.name == newCol.name) return false; // 重名
-
-    if (afterName.empty()) {
-        cols.push_back(newCol);
-    }
-    else {
-        auto it = std::find_if(cols.begin(), cols.end(),
-            [&](const Column& c) { return c.name == afterName; });
-        if (it == cols.end()) return false;
-        cols.insert(it + 1, newCol);
-    }
-    return SaveCatalog(catalog);
-}
-
-bool CatalogManager::AlterDropColumn(Catalog& catalog,
-    const std::string& tableName,
-    const std::string& colName) {
-    TableInfo* t = catalog.GetTable(tableName);
-    if (!t) return false;
-
-    auto& cols = t->schema.MutableColumns();
-    auto before = cols.size();
-    cols.erase(std::remove_if(cols.begin(), cols.end(),
-        [&](const Column& c) { return c.name == colName; }),
-        cols.end());
-    if (cols.size() == before) return false; // 未找到
-    return SaveCatalog(catalog);
-}
-
-bool CatalogManager::AlterModifyColumn(Catalog& catalog,
-    const std::string& tableName,
-    const std::string& colName,
-    ColumnType newType,
-    int newLen) {
-    TableInfo* t = catalog.GetTable(tableName);
-    if (!t) return false;
-
-    auto& cols = t->schema.MutableColumns();
-    for (auto& c : cols) {
-        if (c.name == colName) {
-            c.type = newType;
-            c.length = (newType == ColumnType::VARCHAR ? newLen : 0);
-            return SaveCatalog(catalog);
-        }
-    }
-    return false;
-}
-
-bool CatalogManager::AlterChangeColumn(Catalog& catalog,
-    const std::string& tableName,
-    const std::string& oldName,
-    const Column& newDef) {
-    TableInfo* t = catalog.GetTable(tableName);
-    if (!t) return false;
-
-    auto& cols = t->schema.MutableColumns();
-    // 新名重名检查（允许与 oldName 相同）
-    if (newDef.name != oldName) {
-        for (auto& c : cols) if (c.name == newDef.name) return false;
-    }
-    for (auto& c : cols) {
-        if (c.name == oldName) { c = newDef; return SaveCatalog(catalog); }
-    }
-    return false;
-}
-
-
+// =============================================
+// engine/catalog_manager.cpp （替换/补丁）
+// =============================================
+#include "catalog_manager.hpp"
+#include "../storage/durable_file.hpp"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <filesystem>
+
+using std::filesystem::path;
+using std::filesystem::create_directories;
+
+static std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return "";
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+static std::string to_upper(const std::string& s) {
+    std::string r = s; for (auto& c : r) c = (char)std::toupper((unsigned char)c); return r;
+}
+
+// 列类型 <-> 目录文本：INT(10) UNSIGNED / TINYINT / FLOAT / CHAR(n) / VARCHAR(n) / DECIMAL(p,s) / TIMESTAMP
+// 二进制行格式按列类型编码，因此类型、宽度、小数位与 UNSIGNED 都必须原样持久化
+static std::string type_to_text(const Column& c) {
+    std::string t;
+    switch (c.type) {
+    case ColumnType::INT:       t = "INT"; if (c.length > 0) t += "(" + std::to_string(c.length) + ")"; break;
+    case ColumnType::TINYINT:   t = "TINYINT"; if (c.length > 0) t += "(" + std::to_string(c.length) + ")"; break;
+    case ColumnType::FLOAT:     t = "FLOAT"; break;
+    case ColumnType::CHAR:      t = "CHAR(" + std::to_string(c.length) + ")"; break;
+    case ColumnType::VARCHAR:   t = "VARCHAR(" + std::to_string(c.length) + ")"; break;
+    case ColumnType::DECIMAL:   t = "DECIMAL(" + std::to_string(c.length) + "," + std::to_string(c.scale) + ")"; break;
+    case ColumnType::TIMESTAMP: t = "TIMESTAMP"; break;
+    }
+    if (c.unsigned_flag) t += " UNSIGNED";
+    return t;
+}
+
+static void text_to_type(const std::string& text, Column& c) {
+    std::string t = to_upper(trim(text));
+    if (t.size() >= 9 && t.compare(t.size() - 9, 9, " UNSIGNED") == 0) {
+        c.unsigned_flag = true;
+        t = trim(t.substr(0, t.size() - 9));
+    }
+    std::string base = t.substr(0, t.find('('));
+    int a = 0, b = 0;
+    auto l = t.find('('), r = t.find(')');
+    if (l != std::string::npos && r != std::string::npos && r > l + 1) {
+        std::string inside = t.substr(l + 1, r - l - 1);
+        auto comma = inside.find(',');
+        try {
+            a = std::stoi(inside.substr(0, comma));
+            if (comma != std::string::npos) b = std::stoi(inside.substr(comma + 1));
+        }
+        catch (...) { a = b = 0; }
+    }
+    c.length = a;
+    if (base == "INT") c.type = ColumnType::INT;
+    else if (base == "TINYINT") c.type = ColumnType::TINYINT;
+    else if (base == "FLOAT") c.type = ColumnType::FLOAT;
+    else if (base == "CHAR") c.type = ColumnType::CHAR;
+    else if (base == "DECIMAL") { c.type = ColumnType::DECIMAL; c.scale = b; }
+    else if (base == "TIMESTAMP") c.type = ColumnType::TIMESTAMP;
+    else c.type = ColumnType::VARCHAR; // VARCHAR(n)，以及旧目录中未写出类型的列
+}
+
+bool CatalogManager::PersistCatalog(const Catalog& cat, const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+
+    // 逐表写： name|file|first|last|col_count|col1|col2|...|fsm=<pid>
+    for (const auto& tname : cat.ListTables()) {
+        const TableInfo* t = cat.GetTable(tname);
+        if (!t) continue;
+
+        std::ostringstream line;
+        line << t->name << "|"
+            << t->file_name << "|"
+            << t->first_pid << "|"
+            << t->last_pid << "|";
+
+        const auto& cols = t->getSchema().GetColumns();
+        line << cols.size();
+        for (auto& c : cols) {
+            // 举例：id:INT 或 name:VARCHAR(64)
+            line << "|" << c.name << ":" << type_to_text(c);
+        }
+        line << "|fsm=" << t->fsm_pid;
+        out << line.str() << "\n";
+    }
+    out.flush();
+    return (bool)out;
+}
+
+CatalogManager::CatalogManager(const std::string& file_path)
+    : file_path(file_path) {}
+
+// Load catalog từ file
+bool CatalogManager::LoadCatalog(Catalog& catalog) {
+    std::ifstream ifs(file_path);
+    if (!ifs) return true; // 没文件视为空目录
+    std::string line;
+    checkpoint_lsn = 0;
+    while (std::getline(ifs, line)) {
+        line = trim(line);
+        if (line.rfind("# checkpoint_lsn=", 0) == 0) {
+            checkpoint_lsn = std::stoull(line.substr(17));
+            continue;
+        }
+        if (line.empty() || line[0] == '#') continue;
+        std::stringstream ss(line);
+        std::string name, file, tok;
+
+        std::getline(ss, name, '|');
+        std::getline(ss, file, '|');
+        std::getline(ss, tok, '|'); uint32_t first_pid = tok.empty() ? 0 : static_cast<uint32_t>(std::stoul(tok));
+        std::getline(ss, tok, '|'); uint32_t last_pid = tok.empty() ? 0 : static_cast<uint32_t>(std::stoul(tok));
+        std::getline(ss, tok, '|'); int col_cnt = tok.empty() ? 0 : std::stoi(tok);
+
+        std::vector<Column> cols;
+        cols.reserve(col_cnt);
+        for (int i = 0; i < col_cnt; ++i) {
+            std::string coldef;
+            if (!std::getline(ss, coldef, '|')) break;
+            // 解析：name:TYPE 或 name:VARCHAR(64) / name:DECIMAL(10,2) UNSIGNED
+            auto pos = coldef.find(':');
+            if (pos == std::string::npos) continue;
+            std::string cname = coldef.substr(0, pos);
+            Column col(cname, ColumnType::VARCHAR, 0, false, false);
+            text_to_type(coldef.substr(pos + 1), col);
+            cols.push_back(col);
+        }
+        // 列定义之后的可选字段：fsm=<pid>（旧目录没有，视为尚未建立FSM）
+        uint32_t fsm_pid = 0;
+        while (std::getline(ss, tok, '|')) {
+            if (tok.rfind("fsm=", 0) == 0) fsm_pid = static_cast<uint32_t>(std::stoul(tok.substr(4)));
+        }
+        Schema schema(cols);
+        catalog.AddTable(name, schema, file, first_pid, last_pid);
+        catalog.GetTable(name)->fsm_pid = fsm_pid;
+    }
+    return true;
+}
+
+// Save catalog xuống file
+// 先在内存中拼好，再持久替换：崩溃时目录文件要么是旧内容要么是新内容
+bool CatalogManager::SaveCatalog(const Catalog& catalog) {
+    std::ostringstream ofs;
+    ofs << "# checkpoint_lsn=" << checkpoint_lsn << "\n";
+
+    // 不能直接访问 map，给 Catalog 增个导出接口更优；这里简化：ListTables + GetTable
+    for (const auto& tname : catalog.ListTables()) {
+        const TableInfo* t = catalog.GetTable(tname);
+        if (!t) continue;
+
+        ofs << t->name << '|'
+            << t->file_name << '|'
+            << t->first_pid << '|'
+            << t->last_pid << '|';
+
+        const auto& cols = t->getSchema().GetColumns();
+        ofs << cols.size();
+        for (const auto& c : cols) {
+            ofs << '|'
+                << c.name << ':';
+            ofs << type_to_text(c);
+        }
+        ofs << "|fsm=" << t->fsm_pid;
+        ofs << "\n";
+    }
+    return replace_file_durably(file_path, ofs.str());
+}
+
+bool CatalogManager::CreateTable(Catalog& catalog,
+    const std::string& tableName,
+    const Schema& schema,
+    const std::string& fileName) {
+    if (catalog.GetTable(tableName)) return false;
+    catalog.AddTable(tableName, schema, fileName, 0, 0);
+    return SaveCatalog(catalog);
+}
+
+bool CatalogManager::DropTable(Catalog& catalog, const std::string& tableName) {
+    if (!catalog.RemoveTable(tableName)) return false;
+    return SaveCatalog(catalog);
+}
+
+bool CatalogManager::UpdateTablePages(Catalog& catalog,
+    const std::string& tableName,
+    uint32_t first_pid,
+    uint32_t last_pid) {
+    TableInfo* t = catalog.GetTable(tableName);
+    if (!t) return false;
+    t->first_pid = first_pid;
+    t->last_pid = last_pid;
+    return SaveCatalog(catalog); // 简单点：每次更新都持久化一次
+}
+
+bool CatalogManager::RenameTable(Catalog& catalog,
+    const std::string& oldName,
+    const std::string& newName) {
+    if (oldName == newName) return true;
+    if (!catalog.GetTable(oldName)) return false;
+    if (catalog.GetTable(newName))  return false;
+
+    TableInfo* t = catalog.GetTable(oldName);
+    TableInfo tmp = *t;         // 拷贝
+    tmp.name = newName;
+    // 可选：文件名跟着改（保留后缀）
+    auto dot = tmp.file_name.rfind('.');
+    if (dot == std::string::npos) tmp.file_name = newName + ".tbl";
+    else                           tmp.file_name = newName + tmp.file_name.substr(dot);
+
+    catalog.RemoveTable(oldName);
+    catalog.AddTable(tmp.name, tmp.schema, tmp.file_name, tmp.first_pid, tmp.last_pid);
+    catalog.GetTable(tmp.name)->fsm_pid = tmp.fsm_pid;
+    return SaveCatalog(catalog);
+}
+
+bool CatalogManager::AlterAddColumn(Catalog& catalog,
+    const std::string& tableName,
+    const Column& newCol,
+    const std::string& afterName) {
+    TableInfo* t = catalog.GetTable(tableName);
+    if (!t) return false;
+
+    auto& cols = t->schema.MutableColumns();
+    for (auto& c : cols) if (c.name == newCol.name) return false; // 重名
+
+    if (afterName.empty()) {
+        cols.push_back(newCol);
+    }
+    else {
+        auto it = std::find_if(cols.begin(), cols.end(),
+            [&](const Column& c) { return c.name == afterName; });
+        if (it == cols.end()) return false;
+        cols.insert(it + 1, newCol);
+    }
+    return SaveCatalog(catalog);
+}
+
+bool CatalogManager::AlterDropColumn(Catalog& catalog,
+    const std::string& tableName,
+    const std::string& colName) {
+    TableInfo* t = catalog.GetTable(tableName);
+    if (!t) return false;
+
+    auto& cols = t->schema.MutableColumns();
+    auto before = cols.size();
+    cols.erase(std::remove_if(cols.begin(), cols.end(),
+        [&](const Column& c) { return c.name == colName; }),
+        cols.end());
+    if (cols.size() == before) return false; // 未找到
+    return SaveCatalog(catalog);
+}
+
+bool CatalogManager::AlterModifyColumn(Catalog& catalog,
+    const std::string& tableName,
+    const std::string& colName,
+    ColumnType newType,
+    int newLen) {
+    TableInfo* t = catalog.GetTable(tableName);
+    if (!t) return false;
+
+    auto& cols = t->schema.MutableColumns();
+    for (auto& c : cols) {
+        if (c.name == colName) {
+            c.type = newType;
+            c.length = (newType == ColumnType::VARCHAR ? newLen : 0);
+            return SaveCatalog(catalog);
+        }
+    }
+    return false;
+}
+
+bool CatalogManager::AlterChangeColumn(Catalog& catalog,
+    const std::string& tableName,
+    const std::string& oldName,
+    const Column& newDef) {
+    TableInfo* t = catalog.GetTable(tableName);
+    if (!t) return false;
+
+    auto& cols = t->schema.MutableColumns();
+    // 新名重名检查（允许与 oldName 相同）
+    if (newDef.name != oldName) {
+        for (auto& c : cols) if (c.name == newDef.name) return false;
+    }
+    for (auto& c : cols) {
+        if (c.name == oldName) { c = newDef; return SaveCatalog(catalog); }
+    }
+    return false;
+}
+
+
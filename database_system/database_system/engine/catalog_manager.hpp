@@ -1,170 +1,178 @@
-﻿// =============================================
-// engine/catalog_manager.hpp   （覆盖此文件）
-// =============================================
-#pragma once
-#include <string>
-#include <vector>
-#include <map>
-#include <memory>
-#include <cstdint>
-#include <filesystem>
-
-// 列类型
-enum class ColumnType {
-    INT,
-    TINYINT,
-    FLOAT,          // 保留旧的
-    CHAR,
-    VARCHAR,
-    DECIMAL,
-    TIMESTAMP
-};
-
-struct Column {
-    std::string name;
-    ColumnType  type{ ColumnType::VARCHAR };
-    int         length{ 0 };        // CHAR/VARCHAR/INT(10) 的宽度（INT 宽度只是展示用）
-    int         scale{ 0 };         // DECIMAL(precision, scale) 的 scale；precision 用 length 存
-
-    // 约束/属性
-    bool        not_null{ false };
-    bool        unsigned_flag{ false };
-    bool        auto_increment{ false };
-    bool        primary_key{ false };     // 简化：单列主键；多列主键可另加 vector<string> 在 Schema 里
-
-    std::string default_value;     // 原样存字符串（未写即空）
-    std::string comment;           // 列注释
-
-    // 兼容你原来的构造
-    Column() = default;
-    Column(std::string n, ColumnType t, int len = 0, bool notNull = false, bool pk = false)
-        : name(std::move(n)), type(t), length(len), not_null(notNull), primary_key(pk) {}
-};
-
-class Schema {
-public:
-    Schema() = default;
-    explicit Schema(const std::vector<Column>& cols) : columns(cols) {}
-    const std::vector<Column>& GetColumns() const { return columns; }
-    std::vector<Column>& MutableColumns() { return columns; }
-    int  GetColumnCount() const { return (int)columns.size(); }
-private:
-    std::vector<Column> columns;
-};
-
-// 表信息：增加页链起止
-struct TableInfo {
-    std::string name;
-    Schema      schema;
-    std::string file_name;
-    uint32_t    first_pid{ 0 };
-    uint32_t    last_pid{ 0 };
-
-    TableInfo(const std::string& n, 
-              const Schema& s, 
-              const std::string& f,
-              uint32_t fp = 0, 
-              uint32_t lp = 0)
-        : name(n), schema(s), file_name(f), first_pid(fp), last_pid(lp) {}
-
-    // —— 这三个 getter 恢复 —— //
-    const std::string& getName() const { return name; }
-    const Schema& getSchema() const { return schema; }
-    const std::string& getFileName() const { return file_name; }
-};
-
-// Catalog：AddTable 支持 5 参（后 2 个有默认值，兼容旧调用）
-class Catalog {
-public:
-    void AddTable(const std::string& name,
-        const Schema& schema,
-        const std::string& fileName,
-        uint32_t first_pid = 0,
-        uint32_t last_pid = 0)
-    {
-        tables[name] = std::make_unique<TableInfo>(name, schema, fileName,
-            first_pid, last_pid);
-    }
-
-    TableInfo* GetTable(const std::string& name) {
-        auto it = tables.find(name);
-        return (it == tables.end()) ? nullptr : it->second.get();
-    }
-
-    // 新增：const 重载（解决“丢失限定符”）
-    const TableInfo* GetTable(const std::string& name) const {
-        auto it = tables.find(name);
-        return (it == tables.end()) ? nullptr : it->second.get();
-    }
-
-    std::vector<std::string> ListTables() const {
-        std::vector<std::string> v;
-        v.reserve(tables.size());
-        for (auto& kv : tables) v.push_back(kv.first);
-        return v;
-    }
-
-    bool RemoveTable(const std::string& name) {
-        return tables.erase(name) > 0;
-    }
-
-private:
-    std::map<std::string, std::unique_ptr<TableInfo>> tables;
-};
-
-class CatalogManager {
-public:
-    explicit CatalogManager(const std::string& file_path);
-
-    bool LoadCatalog(Catalog& catalog);
-    bool SaveCatalog(const Catalog& catalog);
-
-    bool CreateTable(Catalog& catalog,
-        const std::string& tableName,
-        const Schema& schema,
-        const std::string& fileName);
-
-    bool DropTable(Catalog& catalog, const std::string& tableName);
-
-    // 新增：更新页链（存储层分配/扩展后回写）
-    bool UpdateTablePages(Catalog& catalog,
-        const std::string& tableName,
-        uint32_t first_pid,
-        uint32_t last_pid);
-
-    // === 新增：把内存中的 Catalog 持久化到 catalog.txt ===
-    // 若你已有 SaveCatalog/Flush，请把名字改成你现有的函数名，并在 StorageEngine 调用它。
-    bool PersistCatalog(const Catalog& cat, const std::string& path = "catalog.txt");
-
-    // --- NEW: 表重命名 ---
-    bool RenameTable(Catalog& catalog,
-        const std::string& oldName,
-        const std::string& newName);
-
-    // --- NEW: 增列（afterName为空则末尾添加）---
-    bool AlterAddColumn(Catalog& catalog,
-        const std::string& tableName,
-        const Column& newCol,
-        const std::string& afterName = "");
-
-    // --- NEW: 删列 ---
-    bool AlterDropColumn(Catalog& catalog,
-        const std::string& tableName,
-        const std::string& colName);
-
-    // --- NEW: 修改列类型/长度 ---
-    bool AlterModifyColumn(Catalog& catalog,
-        const std::string& tableName,
-        const std::string& colName,
-        ColumnType newType,
-        int newLen /*VARCHAR长度，其他类型填0*/);
-
-    // --- NEW: 改名+改类型（等价 MySQL CHANGE oldName newName type）---
-    bool AlterChangeColumn(Catalog& catalog,
-        const std::string& tableName,
-        const std::string& oldName,
-        const Column& newDef);
-
-private:
-    std::string file_path;
-};
+// =============================================
+// engine/catalog_manager.hpp   （覆盖此文件）
+// =============================================
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cstdint>
+#include <filesystem>
+
+// 列类型
+enum class ColumnType {
+    INT,
+    TINYINT,
+    FLOAT,          // 保留旧的
+    CHAR,
+    VARCHAR,
+    DECIMAL,
+    TIMESTAMP
+};
+
+struct Column {
+    std::string name;
+    ColumnType  type{ ColumnType::VARCHAR };
+    int         length{ 0 };        // CHAR/VARCHAR/INT(10) 的宽度（INT 宽度只是展示用）
+    int         scale{ 0 };         // DECIMAL(precision, scale) 的 scale；precision 用 length 存
+
+    // 约束/属性
+    bool        not_null{ false };
+    bool        unsigned_flag{ false };
+    bool        auto_increment{ false };
+    bool        primary_key{ false };     // 简化：单列主键；多列主键可另加 vector<string> 在 Schema 里
+
+    std::string default_value;     // 原样存字符串（未写即空）
+    std::string comment;           // 列注释
+
+    // 兼容你原来的构造
+    Column() = default;
+    Column(std::string n, ColumnType t, int len = 0, bool notNull = false, bool pk = false)
+        : name(std::move(n)), type(t), length(len), not_null(notNull), primary_key(pk) {}
+};
+
+class Schema {
+public:
+    Schema() = default;
+    explicit Schema(const std::vector<Column>& cols) : columns(cols) {}
+    const std::vector<Column>& GetColumns() const { return columns; }
+    std::vector<Column>& MutableColumns() { return columns; }
+    int  GetColumnCount() const { return (int)columns.size(); }
+private:
+    std::vector<Column> columns;
+};
+
+// 表信息：增加页链起止
+struct TableInfo {
+    std::string name;
+    Schema      schema;
+    std::string file_name;
+    uint32_t    first_pid{ 0 };
+    uint32_t    last_pid{ 0 };
+    uint32_t    fsm_pid{ 0 };       // 空闲空间映射（FSM）页链首页，0 表示尚未建立
+
+    TableInfo(const std::string& n, 
+              const Schema& s, 
+              const std::string& f,
+              uint32_t fp = 0, 
+              uint32_t lp = 0)
+        : name(n), schema(s), file_name(f), first_pid(fp), last_pid(lp) {}
+
+    // —— 这三个 getter 恢复 —— //
+    const std::string& getName() const { return name; }
+    const Schema& getSchema() const { return schema; }
+    const std::string& getFileName() const { return file_name; }
+};
+
+// Catalog：AddTable 支持 5 参（后 2 个有默认值，兼容旧调用）
+class Catalog {
+public:
+    void AddTable(const std::string& name,
+        const Schema& schema,
+        const std::string& fileName,
+        uint32_t first_pid = 0,
+        uint32_t last_pid = 0)
+    {
+        tables[name] = std::make_unique<TableInfo>(name, schema, fileName,
+            first_pid, last_pid);
+    }
+
+    TableInfo* GetTable(const std::string& name) {
+        auto it = tables.find(name);
+        return (it == tables.end()) ? nullptr : it->second.get();
+    }
+
+    // 新增：const 重载（解决“丢失限定符”）
+    const TableInfo* GetTable(const std::string& name) const {
+        auto it = tables.find(name);
+        return (it == tables.end()) ? nullptr : it->second.get();
+    }
+
+    std::vector<std::string> ListTables() const {
+        std::vector<std::string> v;
+        v.reserve(tables.size());
+        for (auto& kv : tables) v.push_back(kv.first);
+        return v;
+    }
+
+    bool RemoveTable(const std::string& name) {
+        return tables.erase(name) > 0;
+    }
+
+private:
+    std::map<std::string, std::unique_ptr<TableInfo>> tables;
+};
+
+class CatalogManager {
+public:
+    explicit CatalogManager(const std::string& file_path);
+
+    bool LoadCatalog(Catalog& catalog);
+    // 持久替换目录文件（临时文件同步后改名、再同步目录），首行记下检查点LSN
+    bool SaveCatalog(const Catalog& catalog);
+
+    // 目录对应的检查点LSN：目录包含了该检查点之前的全部修改（由 StorageEngine::Checkpoint 在保存前设置，
+    // 之后的保存只会更新，沿用即可）；打开时小于 meta.dat 的检查点LSN 说明目录落后于检查点，需沿页链修正
+    void SetCheckpointLsn(uint64_t lsn) { checkpoint_lsn = lsn; }
+    uint64_t GetCheckpointLsn() const { return checkpoint_lsn; }
+
+    bool CreateTable(Catalog& catalog,
+        const std::string& tableName,
+        const Schema& schema,
+        const std::string& fileName);
+
+    bool DropTable(Catalog& catalog, const std::string& tableName);
+
+    // 新增：更新页链（存储层分配/扩展后回写）
+    bool UpdateTablePages(Catalog& catalog,
+        const std::string& tableName,
+        uint32_t first_pid,
+        uint32_t last_pid);
+
+    // === 新增：把内存中的 Catalog 持久化到 catalog.txt ===
+    // 若你已有 SaveCatalog/Flush，请把名字改成你现有的函数名，并在 StorageEngine 调用它。
+    bool PersistCatalog(const Catalog& cat, const std::string& path = "catalog.txt");
+
+    // --- NEW: 表重命名 ---
+    bool RenameTable(Catalog& catalog,
+        const std::string& oldName,
+        const std::string& newName);
+
+    // --- NEW: 增列（afterName为空则末尾添加）---
+    bool AlterAddColumn(Catalog& catalog,
+        const std::string& tableName,
+        const Column& newCol,
+        const std::string& afterName = "");
+
+    // --- NEW: 删列 ---
+    bool AlterDropColumn(Catalog& catalog,
+        const std::string& tableName,
+        const std::string& colName);
+
+    // --- NEW: 修改列类型/长度 ---
+    bool AlterModifyColumn(Catalog& catalog,
+        const std::string& tableName,
+        const std::string& colName,
+        ColumnType newType,
+        int newLen /*VARCHAR长度，其他类型填0*/);
+
+    // --- NEW: 改名+改类型（等价 MySQL CHANGE oldName newName type）---
+    bool AlterChangeColumn(Catalog& catalog,
+        const std::string& tableName,
+        const std::string& oldName,
+        const Column& newDef);
+
+private:
+    std::string file_path;
+    uint64_t checkpoint_lsn = 0;    // 旧目录文件没有记录时为0
+};
@@ -0,0 +1,341 @@
+// =============================================
+// engine/csv_loader.cpp
+// =============================================
+#include "csv_loader.hpp"
+#include "tuple_codec.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace {
+    // 读入的一块：若干完整的行
+    struct CsvChunk {
+        uint64_t seq = 0;
+        std::string text;
+    };
+
+    // 一块解析的结果：块内出错时只保留出错行之前的记录
+    struct ParsedChunk {
+        std::vector<std::string> records;   // 已编码的记录
+        uint64_t lines = 0;                 // 块中的行数（含空行）
+        uint64_t bytes = 0;                 // records 对应的字节数
+        uint64_t error_line = 0;            // 出错行在块内的行号（从1开始，0表示没有）
+        std::string error;
+    };
+
+    ParsedChunk parse_chunk(const std::string& text, const TupleCodec& codec, char delimiter) {
+        ParsedChunk r;
+        std::vector<std::string> fields;
+        std::string rec, err;
+        const char* p = text.data();
+        const char* end = p + text.size();
+        while (p < end) {
+            const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+            const char* line_end = nl ? nl : end;
+            const char* e = (line_end > p && line_end[-1] == '\r') ? line_end - 1 : line_end;
+            ++r.lines;
+            if (e > p) {
+                CsvLoader::SplitLine(p, e, delimiter, fields);
+                if ((int)fields.size() > codec.column_count()) {
+                    err = "expected " + std::to_string(codec.column_count()) + " fields, got " + std::to_string(fields.size());
+                }
+                else if (codec.encode(fields, rec, &err)) {
+                    r.records.push_back(rec);
+                    err.clear();
+                }
+                if (!err.empty()) {
+                    r.error_line = r.lines;
+                    r.error = err;
+                    r.bytes = p - text.data();
+                    return r;
+                }
+            }
+            p = nl ? nl + 1 : end;
+        }
+        r.bytes = text.size();
+        return r;
+    }
+}
+
+void CsvLoader::SplitLine(const char* p, const char* end, char delimiter, std::vector<std::string>& out) {
+    out.clear();
+    for (;;) {
+        out.emplace_back();
+        std::string& field = out.back();
+        if (p < end && *p == '"') {
+            // 引号字段："" 表示一个双引号；右引号之后到分隔符之前的字符照常并入
+            for (++p; p < end; ++p) {
+                if (*p != '"') field.push_back(*p);
+                else if (p + 1 < end && p[1] == '"') field.push_back(*p++);
+                else { ++p; break; }
+            }
+        }
+        const char* s = p;
+        while (p < end && *p != delimiter) ++p;
+        field.append(s, p);
+        if (p >= end) break;
+        ++p;
+    }
+}
+
+bool CsvLoader::ParseCommand(const std::string& stmt, std::string& table, std::string& path, CsvLoadOptions& opts,
+    std::string& err) {
+    // 按空白切分，引号内的内容为一个记号
+    std::vector<std::string> tok, up;
+    std::vector<bool> quoted;
+    for (size_t i = 0; i < stmt.size();) {
+        char c = stmt[i];
+        if (isspace((unsigned char)c) || c == ';') { ++i; continue; }
+        std::string t;
+        if (c == '\'' || c == '"') {
+            size_t j = stmt.find(c, i + 1);
+            if (j == std::string::npos) { err = "unterminated quote"; return false; }
+            t = stmt.substr(i + 1, j - i - 1);
+            i = j + 1;
+        }
+        else {
+            while (i < stmt.size() && !isspace((unsigned char)stmt[i]) && stmt[i] != ';') t.push_back(stmt[i++]);
+        }
+        quoted.push_back(c == '\'' || c == '"');
+        if (quoted.back()) up.push_back(t);
+        else {
+            up.emplace_back(t.size(), '\0');
+            std::transform(t.begin(), t.end(), up.back().begin(), [](unsigned char ch) { return (char)std::toupper(ch); });
+        }
+        tok.push_back(std::move(t));
+    }
+    size_t i = 0;
+    auto accept = [&](std::initializer_list<const char*> words) {
+        size_t k = i;
+        for (const char* w : words) {
+            if (k >= tok.size() || quoted[k] || up[k] != w) return false;
+            ++k;
+        }
+        i = k;
+        return true;
+    };
+    auto take = [&](bool want_quoted, std::string& out, const char* what) {
+        if (i >= tok.size() || quoted[i] != want_quoted) { err = std::string("expect ") + what; return false; }
+        out = tok[i++];
+        return true;
+    };
+    auto take_delimiter = [&]() {
+        std::string d;
+        if (!take(true, d, "quoted delimiter")) return false;
+        if (d == "\\t") d = "\t";
+        if (d.size() != 1) { err = "delimiter must be one character"; return false; }
+        opts.delimiter = d[0];
+        return true;
+    };
+
+    if (accept({ "LOAD", "DATA", "INFILE" })) {
+        if (!take(true, path, "quoted file name")) return false;
+        if (!accept({ "INTO", "TABLE" })) { err = "expect INTO TABLE"; return false; }
+        if (!take(false, table, "table name")) return false;
+        while (i < tok.size()) {
+            if (accept({ "FIELDS", "TERMINATED", "BY" })) { if (!take_delimiter()) return false; }
+            else if (accept({ "IGNORE" })) {
+                std::string n;
+                if (!take(false, n, "line count") || n.empty() || !std::all_of(n.begin(), n.end(), ::isdigit) ||
+                    !accept({ "LINES" })) {
+                    err = "expect IGNORE <n> LINES";
+                    return false;
+                }
+                opts.skip_lines = (uint32_t)std::stoul(n);
+            }
+            else { err = "unexpected '" + tok[i] + "'"; return false; }
+        }
+        return true;
+    }
+    if (accept({ "COPY" })) {
+        if (!take(false, table, "table name")) return false;
+        if (!accept({ "FROM" })) { err = "expect FROM"; return false; }
+        if (!take(true, path, "quoted file name")) return false;
+        while (i < tok.size()) {
+            if (accept({ "DELIMITER" })) { if (!take_delimiter()) return false; }
+            else if (accept({ "HEADER" })) opts.skip_lines = 1;
+            else { err = "unexpected '" + tok[i] + "'"; return false; }
+        }
+        return true;
+    }
+    err = "expect LOAD DATA INFILE or COPY";
+    return false;
+}
+
+bool CsvLoader::Load(const std::string& tableName, const std::string& path, const CsvLoadOptions& opts,
+    CsvLoadStats& stats) {
+    stats = CsvLoadStats();
+    TableInfo* t = catalog.GetTable(tableName);
+    if (!t) {
+        stats.error = "table " + tableName + " not found";
+        return false;
+    }
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        stats.error = "cannot open " + path;
+        return false;
+    }
+    std::error_code ec;
+    stats.file_bytes = std::filesystem::file_size(path, ec);
+    stats.threads = opts.threads ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+    const TupleCodec codec(t->getSchema());
+    const auto t0 = std::chrono::steady_clock::now();
+
+    // 跳过 UTF-8 BOM 与开头的行（跳过的字节计入进度）
+    char bom[3] = {};
+    in.read(bom, 3);
+    if (in.gcount() == 3 && memcmp(bom, "\xEF\xBB\xBF", 3) == 0) stats.bytes = 3;
+    else {
+        in.clear();
+        in.seekg(0);
+    }
+    uint64_t line_base = 0;
+    std::string line;
+    while (line_base < opts.skip_lines && std::getline(in, line)) {
+        ++line_base;
+        stats.bytes += line.size() + 1;
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;             // 块读入、块解析完成、写入推进、停止时唤醒
+    std::deque<CsvChunk> todo;              // 待解析的块
+    std::map<uint64_t, ParsedChunk> parsed; // 已解析、待写入的块（按块号）
+    uint64_t read_chunks = 0;               // 已读入的块数
+    uint64_t next_write = 0;                // 下一个写入的块号
+    bool eof = false, stop = false, read_failed = false;
+
+    // 读文件线程：块尾不完整的行留到下一块；未写入的块达到上限时等待
+    std::thread reader([&]() {
+        std::string carry;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(mutex);
+                cv.wait(lk, [&] { return stop || read_chunks - next_write < CSV_LOAD_MAX_INFLIGHT_CHUNKS; });
+                if (stop) break;
+            }
+            std::string buf = std::move(carry);
+            carry.clear();
+            size_t old = buf.size();
+            buf.resize(old + CSV_LOAD_CHUNK_BYTES);
+            in.read(&buf[old], CSV_LOAD_CHUNK_BYTES);
+            buf.resize(old + static_cast<size_t>(in.gcount()));
+            bool last = !in;
+            if (last && in.bad()) {
+                std::lock_guard<std::mutex> lk(mutex);
+                read_failed = true;
+                break;
+            }
+            if (!last) {
+                size_t nl = buf.rfind('\n');
+                if (nl == std::string::npos) {   // 一行比块还长：接着读
+                    carry = std::move(buf);
+                    continue;
+                }
+                carry.assign(buf, nl + 1, std::string::npos);
+                buf.resize(nl + 1);
+            }
+            if (!buf.empty()) {
+                std::lock_guard<std::mutex> lk(mutex);
+                todo.push_back({ read_chunks++, std::move(buf) });
+                cv.notify_all();
+            }
+            if (last) break;
+        }
+        std::lock_guard<std::mutex> lk(mutex);
+        eof = true;
+        cv.notify_all();
+    });
+
+    // 解析线程：块与块之间互不依赖，结果按块号放入 parsed
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < stats.threads; ++i) {
+        workers.emplace_back([&]() {
+            for (;;) {
+                CsvChunk chunk;
+                {
+                    std::unique_lock<std::mutex> lk(mutex);
+                    cv.wait(lk, [&] { return stop || !todo.empty() || eof; });
+                    if (stop || todo.empty()) return;
+                    chunk = std::move(todo.front());
+                    todo.pop_front();
+                }
+                ParsedChunk r = parse_chunk(chunk.text, codec, opts.delimiter);
+                std::lock_guard<std::mutex> lk(mutex);
+                parsed.emplace(chunk.seq, std::move(r));
+                cv.notify_all();
+            }
+        });
+    }
+
+    // 写入（本线程）：按块号顺序取出记录交给批量插入；块内出错时写完出错行之前的记录后结束
+    ParsedChunk cur;
+    size_t idx = 0;
+    bool have = false, failed = false;
+    uint64_t lines_before = line_base;
+    auto last_report = t0;
+    auto next_record = [&](std::string& rec) {
+        for (;;) {
+            if (have && idx < cur.records.size()) {
+                rec = std::move(cur.records[idx++]);
+                ++stats.rows;
+                return true;
+            }
+            if (have) {
+                have = false;
+                stats.bytes += cur.bytes;
+                if (cur.error_line) {
+                    stats.error_line = lines_before + cur.error_line;
+                    stats.error = cur.error;
+                    failed = true;
+                    return false;
+                }
+                lines_before += cur.lines;
+                auto now = std::chrono::steady_clock::now();
+                if (opts.progress && now - last_report >= std::chrono::milliseconds(CSV_LOAD_PROGRESS_MS)) {
+                    last_report = now;
+                    stats.seconds = std::chrono::duration<double>(now - t0).count();
+                    opts.progress(stats);
+                }
+            }
+            std::unique_lock<std::mutex> lk(mutex);
+            cv.wait(lk, [&] { return parsed.count(next_write) || (eof && next_write == read_chunks); });
+            auto it = parsed.find(next_write);
+            if (it == parsed.end()) {
+                if (read_failed) {
+                    stats.error = "read error on " + path;
+                    failed = true;
+                }
+                return false;
+            }
+            cur = std::move(it->second);
+            parsed.erase(it);
+            ++next_write;
+            cv.notify_all();
+            have = true;
+            idx = 0;
+        }
+    };
+    size_t inserted = 0;
+    bool ok = storage.BulkInsertRecords(tableName, next_record, &inserted);
+
+    {
+        std::lock_guard<std::mutex> lk(mutex);
+        stop = true;
+        cv.notify_all();
+    }
+    reader.join();
+    for (auto& w : workers) w.join();
+
+    stats.rows = inserted;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (!ok && stats.error.empty()) stats.error = "writing rows to table " + tableName + " failed";
+    return ok && !failed;
+}
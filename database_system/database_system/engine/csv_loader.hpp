@@ -0,0 +1,62 @@
+// =============================================
+// engine/csv_loader.hpp
+// =============================================
+// CSV 导入（LOAD DATA INFILE / COPY FROM）：
+//   读文件线程按块读入（块在行边界处切开，块尾不完整的行并入下一块），
+//   解析线程并行把块中的行拆成字段、按表模式编码成二进制元组，
+//   调用者的线程按块的顺序把记录交给 StorageEngine::BulkInsertRecords（表中的行序与文件一致）
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "catalog_manager.hpp"
+#include "storage_engine.hpp"
+
+// 每块读入的字节数
+#define CSV_LOAD_CHUNK_BYTES (4u * 1024 * 1024)
+// 已读入、尚未写入表的块数上限（内存占用约为 上限 × 块大小 × 2）
+#define CSV_LOAD_MAX_INFLIGHT_CHUNKS 16
+// 进度回调的最小间隔（毫秒）
+#define CSV_LOAD_PROGRESS_MS 1000
+
+// 导入进度与结果
+struct CsvLoadStats {
+    uint64_t rows = 0;          // 已写入表的行数
+    uint64_t bytes = 0;         // 已写入表的行在文件中占的字节数
+    uint64_t file_bytes = 0;    // 文件大小
+    double seconds = 0;         // 已用时间
+    uint32_t threads = 0;       // 解析线程数
+    uint64_t error_line = 0;    // 出错的行号（从1开始；0表示没有出错的行）
+    std::string error;          // 出错原因
+};
+
+struct CsvLoadOptions {
+    char delimiter = ',';       // 字段分隔符（字段可用双引号括起，"" 表示一个双引号；引号内不能换行）
+    uint32_t skip_lines = 0;    // 跳过文件开头的行数（如表头）
+    uint32_t threads = 0;       // 解析线程数（0 表示按硬件线程数）
+    // 进度回调：每隔 CSV_LOAD_PROGRESS_MS 毫秒（在写入线程中）调用一次，为空时不报告
+    std::function<void(const CsvLoadStats&)> progress;
+};
+
+class CsvLoader {
+public:
+    CsvLoader(Catalog& catalog, StorageEngine& storage) : catalog(catalog), storage(storage) {}
+
+    // 把 path 中的行追加到表 tableName；空行跳过，字段少于列数时缺的列为 NULL
+    // 遇到字段多于列数或与列类型不符的行时停止并返回 false（之前的行保留，stats 中给出行号与原因）
+    bool Load(const std::string& tableName, const std::string& path, const CsvLoadOptions& opts, CsvLoadStats& stats);
+
+    // 按分隔符拆分一行（处理双引号），供解析线程与测试使用
+    static void SplitLine(const char* begin, const char* end, char delimiter, std::vector<std::string>& out);
+
+    // 解析导入语句（不区分大小写，文件名与分隔符用单引号或双引号括起），填入表名、文件与选项：
+    //   LOAD DATA INFILE '<文件>' INTO TABLE <表> [FIELDS TERMINATED BY '<c>'] [IGNORE <n> LINES]
+    //   COPY <表> FROM '<文件>' [DELIMITER '<c>'] [HEADER]
+    // 语法错误时返回 false，err 给出原因
+    static bool ParseCommand(const std::string& stmt, std::string& table, std::string& path, CsvLoadOptions& opts,
+        std::string& err);
+
+private:
+    Catalog& catalog;
+    StorageEngine& storage;
+};
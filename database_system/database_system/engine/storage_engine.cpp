@@ -1,376 +1,1268 @@
-﻿// =============================================
-// engine/storage_engine.cpp  （新增/覆盖）
-// =============================================
-#include "storage_engine.hpp"
-#include <sstream>
-#include <iostream>
-#include <cstring>
-#include <cctype>
-#include <functional> 
-#include <fstream>
-#include <algorithm>
-
-static constexpr uint32_t HEADER = PAGE_HEADER_SIZE;    // 16
-static constexpr uint32_t PAGESZ = PAGE_SIZE;
-
-static inline std::string trim_copy(const std::string& s) {
-    size_t b = 0, e = s.size();
-    while (b < e && std::isspace(static_cast<unsigned char>(s[b]))) ++b;
-    while (e > b && std::isspace(static_cast<unsigned char>(s[e - 1]))) --e;
-    return s.substr(b, e - b);
-}
-
-bool StorageEngine::ensure_table_ready(const std::string & tableName) {
-    TableInfo * t = catalog_.GetTable(tableName);
-    if (!t) return false;
-    // 目录未初始化：分配首页
-    if (t->first_pid == 0) return InitTablePages(tableName);
-    // 目录有页，但物理上读不到 -> 兜底重建一个单页链
-    if (fm_.read_page(t->last_pid) == nullptr) {
-        uint32_t pid = fm_.allocate_page();
-        Page * p = fm_.read_page(pid);
-        if (!p) return false;
-        p->set_page_id(pid);
-        p->set_prev_page_id(INVALID_PAGE_ID);
-        p->set_next_page_id(INVALID_PAGE_ID);
-        p->set_free_offset(HEADER);
-        fm_.write_page(pid, *p);
-        fm_.flush_page(pid); // 关键：落盘
-        return cmgr_.UpdateTablePages(catalog_, tableName, pid, pid);
-    }
-    return true;
-}
-
-
-// 拼/拆 CSV（简单：按逗号分割；值中不含换行）
-std::string StorageEngine::join_csv(const std::vector<std::string>& v) {
-    std::ostringstream os;
-    for (size_t i = 0; i < v.size(); ++i) { if (i) os << ","; os << v[i]; }
-    return os.str();
-}
-void StorageEngine::split_csv_line(const std::string& line, std::vector<std::string>& out) {
-    out.clear();
-    std::stringstream ss(line);
-    std::string val;
-    while (std::getline(ss, val, ',')) {
-        // trim
-        auto ltrim = [](std::string& s) {
-            size_t i = 0;
-            while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r' || s[i] == '\n')) ++i;
-            if (i) s.erase(0, i);
-            };
-        auto rtrim = [](std::string& s) {
-            while (!s.empty()) {
-                char c = s.back();
-                if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ';') s.pop_back();
-                else break;
-            }
-            };
-        ltrim(val);
-        rtrim(val);
-        // 去首尾引号（容忍 INSERT 时写了 'Alice' 或 "Alice"）
-        if (val.size() >= 2) {
-            if ((val.front() == '\'' && val.back() == '\'') ||
-                (val.front() == '"' && val.back() == '"')) {
-                val = val.substr(1, val.size() - 2);
-            }
-        }
-        out.push_back(std::move(val));
-    }
-}
-
-
-template<typename Fn>
-bool StorageEngine::for_each_page(const TableInfo* t, Fn fn) {
-    if (!t || t->first_pid == 0) return true;
-    uint32_t pid = t->first_pid;
-    while (pid != INVALID_PAGE_ID && pid != 0) {
-        Page* p = fm_.read_page(pid);
-        if (!p) return false;
-        if (!fn(pid, *p)) return false;
-        pid = p->get_next_page_id();
-    }
-    return true;
-}
-
-bool StorageEngine::InitTablePages(const std::string& tableName) {
-    TableInfo* t = catalog_.GetTable(tableName);
-    if (!t) return false;
-    if (t->first_pid != 0) return true; // 已初始化
-
-    // 分配首个数据页
-    uint32_t pid = fm_.allocate_page();
-    Page* p = fm_.read_page(pid);
-    if (!p) return false;
-    p->set_page_id(pid);
-    p->set_prev_page_id(INVALID_PAGE_ID);
-    p->set_next_page_id(INVALID_PAGE_ID);
-    p->set_free_offset(HEADER); // 数据从 16 字节后开始
-    fm_.write_page(pid, *p);
-    fm_.flush_page(pid);
-
-    // 目录更新 + 立刻持久化
-    if (!cmgr_.UpdateTablePages(catalog_, tableName, pid, pid)) return false;
-    (void)cmgr_.SaveCatalog(catalog_);   // ★ 改为 SaveCatalog
-    // 回填到 catalog
-    return cmgr_.UpdateTablePages(catalog_, tableName, pid, pid);
-}
-
-bool StorageEngine::append_to_page(uint32_t page_id, const std::string& line,
-    uint32_t& new_free_off, bool& ok_written) {
-    ok_written = false;
-    Page* p = fm_.read_page(page_id);
-    if (!p) return false;
-
-    uint32_t free_off = p->get_free_offset();
-    uint32_t need = 2 + (uint32_t)line.size(); // uint16 len + payload
-    if (free_off + need > PAGESZ) { // 空间不足
-        new_free_off = free_off;
-        return true;
-    }
-    // 写入记录
-    uint16_t len = (uint16_t)line.size();
-    if (!p->write_data(free_off, (const char*)&len, 2)) return false;
-    if (len && !p->write_data(free_off + 2, line.data(), len)) return false;
-    p->set_free_offset(free_off + 2 + len);
-
-    // 关键：把最新的元信息写回到 data[0..15]
-    p->serialize();
-
-    fm_.write_page(page_id, *p);
-
-    ok_written = true;
-    new_free_off = p->get_free_offset();
-    return true;
-}
-
-bool StorageEngine::allocate_linked_page(uint32_t prev_pid, uint32_t& new_pid) {
-    new_pid = fm_.allocate_page();
-    Page* np = fm_.read_page(new_pid);
-    if (!np) return false;
-    np->set_page_id(new_pid);
-    np->set_prev_page_id(prev_pid);
-    np->set_next_page_id(INVALID_PAGE_ID);
-    np->set_free_offset(HEADER);
-    fm_.write_page(new_pid, *np);
-
-    // 链接前页
-    if (prev_pid != INVALID_PAGE_ID && prev_pid != 0) {
-        Page* pp = fm_.read_page(prev_pid);
-        if (!pp) return false;
-        pp->set_next_page_id(new_pid);
-        fm_.write_page(prev_pid, *pp);
-    }
-    fm_.flush_page(new_pid);
-    if (prev_pid) fm_.flush_page(prev_pid);
-    return true;
-}
-
-bool StorageEngine::Insert(const std::string& tableName, const std::vector<std::string>& values) {
-    if (!ensure_table_ready(tableName)) return false;
-    TableInfo* t = catalog_.GetTable(tableName);
-    if (!t) return false;
-
-    std::string payload = join_csv(values);
-
-    // 先尝试当前最后一页
-    uint32_t new_free = 0; bool written = false;
-    if (!append_to_page(t->last_pid, payload, new_free, written)) return false;
-    if (!written) {
-        uint32_t npid = 0;
-        if (!allocate_linked_page(t->last_pid, npid)) return false;
-
-        if (!append_to_page(npid, payload, new_free, written) || !written) return false;
-
-        // 更新 catalog 的 last_pid，并立即持久化
-        if (!cmgr_.UpdateTablePages(catalog_, tableName, t->first_pid, npid)) return false;
-        (void)cmgr_.SaveCatalog(catalog_);   // ★ 改为 SaveCatalog
-    }
-    else {
-        // 写在当前最后页也更新一下（可选，但稳妥）
-        (void)cmgr_.SaveCatalog(catalog_);   // ★ 改为 SaveCatalog
-    }
-    // 更新 catalog 的 last_pid 后……
-    fm_.flush_page(t->last_pid); // 让交互式 SELECT 立即可见
-    return true;
-}
-
-std::vector<std::vector<std::string>> StorageEngine::SelectAll(const std::string& tableName) {
-    std::vector<std::vector<std::string>> rows;
-    TableInfo* t = catalog_.GetTable(tableName);
-    if (!t || t->first_pid == 0) return rows;
-
-    for_each_page(t, [&](uint32_t pid, Page& pg)->bool {
-        uint32_t off = HEADER;
-        uint32_t end = pg.get_free_offset();
-
-        // 健壮性：free_offset 越界时兜底（避免空页被扫成“很多空行”）
-        if (end > PAGESZ) end = PAGESZ;
-        if (end < HEADER) end = HEADER;
-
-        while (off + 2 <= end) {
-            uint16_t len = 0;
-            if (!pg.read_data(off, (char*)&len, 2)) break;
-            off += 2;
-
-            // 关键防御：len==0 或者越界，直接停止扫描当前页
-            if (len == 0) break;
-            if (off + len > end) break;
-
-            std::string line(len, '\0');
-            if (!pg.read_data(off, line.data(), len)) break;
-            off += len;
-
-            std::vector<std::string> rec;
-            split_csv_line(line, rec);
-            rows.push_back(std::move(rec));
-        }
-        return true;
-        });
-    return rows;
-}
-
-bool StorageEngine::DeleteWhere(const std::string& tableName, int whereColIndex, const std::string& whereVal) {
-    TableInfo* t = catalog_.GetTable(tableName);
-    if (!t) return false;
-
-    // 1) 全表扫描，得出需要保留的记录
-    auto all = SelectAll(tableName);
-    std::vector<std::vector<std::string>> kept;
-    kept.reserve(all.size());
-    for (auto& r : all) {
-        if (whereColIndex < 0 || whereColIndex >= (int)r.size()) {
-            // 无 WHERE：全删 => kept 不入
-            continue;
-        }
-        if (r[whereColIndex] != whereVal) kept.push_back(std::move(r));
-    }
-
-    // 2) 释放旧页链（记住 next 再 free）
-    if (t->first_pid != 0) {
-        uint32_t pid = t->first_pid;
-        while (pid != INVALID_PAGE_ID && pid != 0) {
-            Page* p = fm_.read_page(pid);
-            if (!p) break;
-            uint32_t next = p->get_next_page_id();
-            fm_.free_page(pid);
-            pid = next;
-        }
-    }
-
-    // 3) 关键：把目录页链置空，彻底与旧链断开
-    if (!cmgr_.UpdateTablePages(catalog_, tableName, 0, 0)) return false;
-
-    // 4) 新建一个空链（为后续插入或空表 select 做准备）
-    if (!InitTablePages(tableName)) return false;
-
-    // 5) 把保留记录写回
-    for (auto& r : kept) {
-        if (!Insert(tableName, r)) return false;
-    }
-    return true;
-}
-
-
-bool StorageEngine::DropTableData(const std::string& tableName) {
-    // 释放该表所有链页，并把目录中的 first/last 置 0
-    TableInfo* t = catalog_.GetTable(tableName);
-    if (!t) return true; // 视作成功
-
-    // 释放页链
-    uint32_t pid = t->first_pid;
-    while (pid != INVALID_PAGE_ID && pid != 0) {
-        Page* p = fm_.read_page(pid);
-        if (!p) break;
-        uint32_t next = p->get_next_page_id();
-        fm_.free_page(pid);
-        pid = next;
-    }
-
-    // 更新目录并持久化
-    if (!cmgr_.UpdateTablePages(catalog_, tableName, 0, 0)) return false;
-    cmgr_.SaveCatalog(catalog_);
-    return true;
-}
-
-// engine/storage_engine.cpp  （追加实现）
-
-bool StorageEngine::UpdateWhere(
-    const std::string& tableName,
-    const std::function<bool(const std::vector<std::string>&)>& pred,
-    const std::vector<std::pair<int, std::string>>& sets_by_idx)
-{
-    // 1) 拉全表
-    auto rows = SelectAll(tableName);
-    if (rows.empty() && !/*允许空表*/true) return true;
-
-    // 2) 对命中行应用修改
-    size_t changed = 0;
-    for (auto& r : rows) {
-        if (!pred || pred(r)) {
-            for (const auto& kv : sets_by_idx) {
-                const int idx = kv.first;
-                if (idx >= 0) {
-                    if ((size_t)idx >= r.size()) r.resize(idx + 1);
-                    r[idx] = kv.second;
-                }
-            }
-            ++changed;
-        }
-    }
-
-    // 3) 整表覆写
-    if (!OverwriteAll(tableName, rows)) {
-        std::cerr << "StorageEngine::UpdateWhere: overwrite failed\n";
-        return false;
-    }
-
-    // 可选：打印命中行数
-    // std::cout << "[RecordManager] Update matched " << changed << " rows.\n";
-    return true;
-}
-
-bool StorageEngine::OverwriteAll(
-    const std::string& tableName,
-    const std::vector<std::vector<std::string>>& rows)
-{
-    // 1) 清空表所有数据页并把目录清零
-    if (!DropTableData(tableName)) {
-        std::cerr << "OverwriteAll: DropTableData failed\n";
-        return false;
-    }
-    // 2) 重建一个空页链，保证后续 Insert 可用
-    if (!InitTablePages(tableName)) {
-        std::cerr << "OverwriteAll: InitTablePages failed\n";
-        return false;
-    }
-    // 3) 按行重写
-    for (const auto& r : rows) {
-        if (!Insert(tableName, r)) {
-            std::cerr << "OverwriteAll: Insert failed on a row\n";
-            return false;
-        }
-    }
-    return true;
-}
-
-
-bool StorageEngine::TruncateTable(const std::string& tableName) {
-    TableInfo* t = catalog_.GetTable(tableName);
-    if (!t) return true; // 视为成功
-
-    // 释放链页并清零目录
-    uint32_t pid = t->first_pid;
-    while (pid != INVALID_PAGE_ID && pid != 0) {
-        Page* p = fm_.read_page(pid);
-        if (!p) break;
-        uint32_t next = p->get_next_page_id();
-        fm_.free_page(pid);
-        pid = next;
-    }
-    if (!cmgr_.UpdateTablePages(catalog_, tableName, 0, 0)) return false;
-    cmgr_.SaveCatalog(catalog_);
-
-    // 重新建一个空页链
-    return InitTablePages(tableName);
-}
+// =============================================
+// engine/storage_engine.cpp  （新增/覆盖）
+// =============================================
+#include "storage_engine.hpp"
+#include <sstream>
+#include <iostream>
+#include <cstring>
+#include <cctype>
+#include <functional> 
+#include <fstream>
+#include <algorithm>
+#include <set>
+
+static inline std::string trim_copy(const std::string& s) {
+    size_t b = 0, e = s.size();
+    while (b < e && std::isspace(static_cast<unsigned char>(s[b]))) ++b;
+    while (e > b && std::isspace(static_cast<unsigned char>(s[e - 1]))) --e;
+    return s.substr(b, e - b);
+}
+
+bool StorageEngine::ensure_table_ready(const std::string & tableName) {
+    TableInfo * t = catalog_.GetTable(tableName);
+    if (!t) return false;
+    // 目录未初始化：分配首页
+    if (t->first_pid == 0) return InitTablePages(tableName);
+    // 目录有页，但物理上读不到 -> 兜底重建一个单页链
+    // 页仍在用却读不出（校验和不匹配）时不重建：那会丢掉整张表，拒绝写入，交给 --verify 排查
+    if (!fm_.read_page_guard(t->last_pid)) {
+        if (fm_.is_page_in_use(t->last_pid)) {
+            std::cerr << "[StorageEngine] table " << tableName << ": last page " << t->last_pid << " unreadable, write rejected.\n";
+            return false;
+        }
+        drop_table_fsm(t);
+        uint32_t pid = fm_.allocate_page_after(INVALID_PAGE_ID, table_file(t));
+        {
+            WritePageGuard p = fm_.write_page_guard(pid);
+            if (!p) return false;
+            p->set_prev_page_id(INVALID_PAGE_ID);
+            p->set_next_page_id(INVALID_PAGE_ID);
+            p->init_slotted();
+        }
+        return cmgr_.UpdateTablePages(catalog_, tableName, pid, pid);
+    }
+    return true;
+}
+
+
+// 拆 CSV（旧格式：按逗号分割；值中不含换行）
+void StorageEngine::split_csv_line(const std::string& line, std::vector<std::string>& out) {
+    out.clear();
+    std::stringstream ss(line);
+    std::string val;
+    while (std::getline(ss, val, ',')) {
+        // trim
+        auto ltrim = [](std::string& s) {
+            size_t i = 0;
+            while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r' || s[i] == '\n')) ++i;
+            if (i) s.erase(0, i);
+            };
+        auto rtrim = [](std::string& s) {
+            while (!s.empty()) {
+                char c = s.back();
+                if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ';') s.pop_back();
+                else break;
+            }
+            };
+        ltrim(val);
+        rtrim(val);
+        // 去首尾引号（容忍 INSERT 时写了 'Alice' 或 "Alice"）
+        if (val.size() >= 2) {
+            if ((val.front() == '\'' && val.back() == '\'') ||
+                (val.front() == '"' && val.back() == '"')) {
+                val = val.substr(1, val.size() - 2);
+            }
+        }
+        out.push_back(std::move(val));
+    }
+}
+
+
+template<typename Fn>
+bool StorageEngine::for_each_page(const TableInfo* t, Fn fn) {
+    if (!t || t->first_pid == 0) return true;
+    ReadAheadState ra;
+    uint32_t pid = t->first_pid;
+    while (pid != INVALID_PAGE_ID && pid != 0) {
+        ReadPageGuard p = fm_.read_page_guard(pid, AccessHint::SEQUENTIAL);
+        if (!p) return false;
+        uint32_t next = p->get_next_page_id();
+        fm_.read_ahead(ra, pid, next);
+        if (!fn(pid, *p)) return false;
+        pid = next;
+    }
+    return true;
+}
+
+bool StorageEngine::InitTablePages(const std::string& tableName) {
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return false;
+    if (t->first_pid != 0) return true; // 已初始化
+
+    // 在表的页文件中新开一个区段，分配首个数据页
+    uint32_t pid = fm_.allocate_page_after(INVALID_PAGE_ID, table_file(t));
+    {
+        WritePageGuard p = fm_.write_page_guard(pid);
+        if (!p) return false;
+        p->set_prev_page_id(INVALID_PAGE_ID);
+        p->set_next_page_id(INVALID_PAGE_ID);
+        p->init_slotted(); // 空槽页：记录从页尾向前写
+    }
+
+    // 目录更新 + 立刻持久化
+    if (!cmgr_.UpdateTablePages(catalog_, tableName, pid, pid)) return false;
+    (void)cmgr_.SaveCatalog(catalog_);   // ★ 改为 SaveCatalog
+    // 回填到 catalog
+    if (!cmgr_.UpdateTablePages(catalog_, tableName, pid, pid)) return false;
+    return fm_.commit();
+}
+
+bool StorageEngine::append_to_page(uint32_t page_id, const std::string& rec, bool& ok_written, uint32_t& free_after,
+    uint32_t home_pid, uint16_t home_slot, uint16_t* slot_out) {
+    ok_written = false;
+    const bool moved = home_pid != INVALID_PAGE_ID;
+    if (rec.size() + (moved ? FORWARD_REF_SIZE : 0) > Page::max_record_size_of(fm_.get_page_size())) return false;
+    {
+        WritePageGuard p = fm_.write_page_guard(page_id);
+        if (!p) return false;
+
+        // 写入一个槽（页内空间不足时 ok_written=false，由调用者换页）
+        uint16_t slot = 0;
+        if (moved) ok_written = p->insert_moved_record(home_pid, home_slot, rec.data(), (uint32_t)rec.size(), slot);
+        else ok_written = p->insert_record(rec.data(), (uint32_t)rec.size(), slot);
+        if (slot_out) *slot_out = slot;
+        free_after = p->reclaimable_space();
+    }
+    // 守卫释放时已标脏；读页都经过缓存，不需要立即落盘（由后台写线程/检查点写回）
+    return true;
+}
+
+bool StorageEngine::allocate_linked_page(uint32_t prev_pid, uint32_t& new_pid) {
+    // 新页与前页在同一个文件中（表的页链不跨文件），优先取前页所在区段的下一页，使页链在文件中连续
+    new_pid = fm_.allocate_page_after(prev_pid);
+    {
+        // 新页与前页同时固定：链接过程中两页都不会被换出
+        WritePageGuard np = fm_.write_page_guard(new_pid);
+        if (!np) return false;
+        np->set_prev_page_id(prev_pid);
+        np->set_next_page_id(INVALID_PAGE_ID);
+        np->init_slotted();
+
+        // 链接前页
+        if (prev_pid != INVALID_PAGE_ID && prev_pid != 0) {
+            WritePageGuard pp = fm_.write_page_guard(prev_pid);
+            if (!pp) return false;
+            pp->set_next_page_id(new_pid);
+        }
+    }
+    return true;
+}
+
+bool StorageEngine::append_record(const std::string& tableName, const std::string& rec,
+    uint32_t home_pid, uint16_t home_slot, uint32_t* pid_out, uint16_t* slot_out) {
+    if (!ensure_table_ready(tableName)) return false;
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return false;
+    FreeSpaceMap* fsm = table_fsm(t);
+    if (!fsm) return false;
+    const uint32_t need = (uint32_t)rec.size() + (home_pid != INVALID_PAGE_ID ? FORWARD_REF_SIZE : 0);
+
+    // 1) 按FSM找一个放得下的页（删除腾出的空间优先被复用）
+    //    档位只会低估空间，正常情况下一次写入成功；FSM落后于页内容时按实际空间更新后再找
+    uint32_t free_after = 0;
+    for (;;) {
+        uint32_t pid = fsm->find_page(need);
+        if (pid == INVALID_PAGE_ID) break;
+        bool written = false;
+        if (!append_to_page(pid, rec, written, free_after, home_pid, home_slot, slot_out)) return false;
+        fsm->update(pid, free_after);
+        if (written) {
+            if (pid_out) *pid_out = pid;
+            return true;
+        }
+    }
+
+    // 2) 没有放得下的页：在表尾链接新页
+    uint32_t npid = 0;
+    bool written = false;
+    if (!allocate_linked_page(t->last_pid, npid)) return false;
+    if (!append_to_page(npid, rec, written, free_after, home_pid, home_slot, slot_out) || !written) return false;
+    fsm->update(npid, free_after);
+    if (pid_out) *pid_out = npid;
+
+    // 更新 catalog 的 last_pid（只改内存，检查点时保存；崩溃后由 Startup 沿页链修正）
+    t->last_pid = npid;
+    return true;
+}
+
+bool StorageEngine::drop_slot(TableInfo* t, uint32_t pid, uint16_t slot) {
+    uint32_t free_bytes;
+    {
+        WritePageGuard w = fm_.write_page_guard(pid);
+        if (!w) return false;
+        w->delete_record(slot);
+        free_bytes = w->reclaimable_space();
+    }
+    FreeSpaceMap* fsm = table_fsm(t);
+    return !fsm || fsm->update(pid, free_bytes);
+}
+
+bool StorageEngine::forward_record(TableInfo* t, uint32_t pid, uint16_t slot, const std::string& rec) {
+    FreeSpaceMap* fsm = table_fsm(t);
+    // 记录的原位置：迁入记录取其前缀，普通记录即当前位置
+    uint32_t home_pid = pid;
+    uint16_t home_slot = slot;
+    bool updated;
+    uint32_t free_bytes;
+    {
+        WritePageGuard w = fm_.write_page_guard(pid);
+        if (!w) return false;
+        if (!w->get_home(slot, home_pid, home_slot)) {
+            home_pid = pid;
+            home_slot = slot;
+        }
+        // 扫描之后本页可能腾出了空间（其他行已迁走），先再试一次原地更新
+        updated = w->update_record(slot, rec.data(), (uint32_t)rec.size());
+        free_bytes = w->reclaimable_space();
+    }
+    if (updated) return !fsm || fsm->update(pid, free_bytes);
+
+    // 已迁出的记录：原页放得下时迁回原页（转发桩换回记录）
+    if (home_pid != pid) {
+        bool restored;
+        {
+            WritePageGuard h = fm_.write_page_guard(home_pid);
+            if (!h) return false;
+            restored = h->restore_record(home_slot, rec.data(), (uint32_t)rec.size());
+            free_bytes = h->reclaimable_space();
+        }
+        if (restored) {
+            if (fsm && !fsm->update(home_pid, free_bytes)) return false;
+            return drop_slot(t, pid, slot);
+        }
+    }
+
+    // 整条记录迁走、不保留原槽号：删去原位置（及转发桩）后按普通记录追加
+    auto move_whole = [&]() {
+        return (home_pid == pid || drop_slot(t, home_pid, home_slot)) && drop_slot(t, pid, slot) &&
+            append_record(t->name, rec);
+    };
+    // 加上原位置前缀后超过一页能放下的最长记录
+    if (rec.size() + FORWARD_REF_SIZE > Page::max_record_size_of(fm_.get_page_size())) return move_whole();
+
+    // 写成迁入记录，再让原位置的转发桩指向它（原页与当前页都放不下，新位置不会是这两页）
+    uint32_t npid = INVALID_PAGE_ID;
+    uint16_t nslot = 0;
+    if (!append_record(t->name, rec, home_pid, home_slot, &npid, &nslot)) return false;
+    bool linked;
+    {
+        WritePageGuard h = fm_.write_page_guard(home_pid);
+        if (!h) return false;
+        linked = h->set_forward(home_slot, npid, nslot);
+        free_bytes = h->reclaimable_space();
+    }
+    if (linked) {
+        if (fsm && !fsm->update(home_pid, free_bytes)) return false;
+        return home_pid == pid || drop_slot(t, pid, slot);
+    }
+    // 原页连转发桩都放不下（原记录比转发桩还短、页已满）
+    return drop_slot(t, npid, nslot) && move_whole();
+}
+
+FreeSpaceMap* StorageEngine::table_fsm(TableInfo* t) {
+    if (t->fsm_pid != 0) {
+        auto it = fsms_.find(t->fsm_pid);
+        if (it != fsms_.end()) return it->second.get();
+        auto fsm = std::make_unique<FreeSpaceMap>(fm_, t->fsm_pid);
+        if (fsm->load()) {
+            FreeSpaceMap* raw = fsm.get();
+            fsms_[t->fsm_pid] = std::move(fsm);
+            return raw;
+        }
+        std::cerr << "[StorageEngine] free space map of table " << t->name << " is damaged, rebuilding.\n";
+    }
+
+    // 目录中没有FSM（新表或旧库）：走一遍表页链登记每页的可用空间
+    auto fsm = std::make_unique<FreeSpaceMap>(fm_);
+    uint32_t pid = t->first_pid;
+    while (pid != INVALID_PAGE_ID && pid != 0) {
+        uint32_t next, free_bytes;
+        {
+            ReadPageGuard p = fm_.read_page_guard(pid, AccessHint::SEQUENTIAL);
+            if (!p) break;
+            next = p->get_next_page_id();
+            free_bytes = p->reclaimable_space();
+        }
+        if (!fsm->update(pid, free_bytes)) return nullptr;
+        pid = next;
+    }
+    if (fsm->get_first_page_id() == INVALID_PAGE_ID) return nullptr; // 表还没有数据页
+    t->fsm_pid = fsm->get_first_page_id();
+    (void)cmgr_.SaveCatalog(catalog_);
+    FreeSpaceMap* raw = fsm.get();
+    fsms_[t->fsm_pid] = std::move(fsm);
+    return raw;
+}
+
+void StorageEngine::drop_table_fsm(TableInfo* t) {
+    if (t->fsm_pid == 0) return;
+    auto it = fsms_.find(t->fsm_pid);
+    if (it != fsms_.end()) {
+        it->second->release();
+        fsms_.erase(it);
+    }
+    else {
+        FreeSpaceMap fsm(fm_, t->fsm_pid);
+        if (fsm.load()) fsm.release();
+    }
+    t->fsm_pid = 0;
+}
+
+std::vector<uint32_t> StorageEngine::collect_table_pages(const TableInfo* t) {
+    std::vector<uint32_t> pages;
+    for_each_page(t, [&](uint32_t pid, const Page&) {
+        pages.push_back(pid);
+        return true;
+    });
+    return pages;
+}
+
+uint32_t StorageEngine::table_file(const TableInfo* t) {
+    if (t->first_pid != 0) return Page::file_of(t->first_pid);
+    return fm_.open_table_file(t->file_name.empty() ? t->name + ".tbl" : t->file_name);
+}
+
+bool StorageEngine::release_table_pages(TableInfo* t, bool remove_file) {
+    uint32_t file_id = t->first_pid != 0 ? Page::file_of(t->first_pid)
+        : fm_.find_table_file(t->file_name.empty() ? t->name + ".tbl" : t->file_name);
+    if (file_id == SHARED_FILE_ID) {
+        // 共享数据文件中的表：释放FSM与页链
+        drop_table_fsm(t);
+        fm_.free_pages(collect_table_pages(t));
+    }
+    else {
+        // 页文件只属于这张表：删除/清空文件即释放了全部数据页与FSM页
+        fsms_.erase(t->fsm_pid);
+        t->fsm_pid = 0;
+        if (!(remove_file ? fm_.drop_table_file(file_id) : fm_.truncate_table_file(file_id))) return false;
+    }
+    t->first_pid = t->last_pid = 0;
+    return true;
+}
+
+bool StorageEngine::RenameTableFile(const std::string& oldFileName, const std::string& newFileName) {
+    uint32_t file_id = fm_.find_table_file(oldFileName);
+    if (file_id == SHARED_FILE_ID || oldFileName == newFileName) return true; // 没有自己的页文件
+    return fm_.rename_table_file(file_id, newFileName);
+}
+
+bool StorageEngine::repair_table_pages(bool full) {
+    // 页可用于表页链：在用、槽页格式
+    // 在用却读不出来（校验和不匹配等）的页置unreadable：这种页不能当作“页链断开”截掉，该表不做修正
+    bool unreadable = false;
+    auto is_data_page = [&](uint32_t pid, uint32_t& prev, uint32_t& next)->bool {
+        if (!fm_.is_page_in_use(pid)) return false;
+        ReadPageGuard p = fm_.read_page_guard(pid);
+        if (!p) unreadable = true;
+        if (!p || p->get_page_flags() != PAGE_FLAG_SLOTTED) return false;
+        prev = p->get_prev_page_id();
+        next = p->get_next_page_id();
+        return true;
+    };
+
+    bool changed = false;
+    for (const auto& name : catalog_.ListTables()) {
+        TableInfo* t = catalog_.GetTable(name);
+        if (!t) continue;
+        uint32_t prev = 0, next = 0;
+
+        // 1) FSM页号：页已释放或不是FSM页时清零，下次写入时按页链重建
+        if (t->fsm_pid != 0) {
+            bool valid = fm_.is_page_in_use(t->fsm_pid);
+            if (valid) {
+                ReadPageGuard p = fm_.read_page_guard(t->fsm_pid);
+                valid = p && p->get_page_flags() == PAGE_FLAG_FSM;
+            }
+            if (!valid) {
+                fsms_.erase(t->fsm_pid);
+                t->fsm_pid = 0;
+                changed = true;
+            }
+        }
+        if (t->first_pid == 0) continue;
+        unreadable = false;
+        auto skip_unreadable = [&]() {
+            if (!unreadable) return false;
+            std::cerr << "[StorageEngine] table " << name << ": unreadable page in page chain, left unchanged "
+                "(run minidb --verify to check the data file).\n";
+            return true;
+        };
+
+        // 2) 首页无效：目录超前于日志（分配未提交），表视为空（下次写入时重新分配首页）
+        if (!is_data_page(t->first_pid, prev, next) || prev != INVALID_PAGE_ID) {
+            if (skip_unreadable()) continue;
+            std::cerr << "[StorageEngine] table " << name << ": first page " << t->first_pid << " lost, table reset to empty.\n";
+            drop_table_fsm(t);
+            t->first_pid = t->last_pid = 0;
+            changed = true;
+            continue;
+        }
+        // 3) last_pid 仍是链尾：目录与页链一致（没有重做时只做这项检查）
+        if (!full && t->last_pid != 0 && is_data_page(t->last_pid, prev, next) && next == INVALID_PAGE_ID) continue;
+
+        // 4) 沿页链走到链尾；下一页无效（或成环）时在当前页截断
+        unreadable = false;
+        std::set<uint32_t> visited;
+        uint32_t pid = t->first_pid;
+        for (;;) {
+            visited.insert(pid);
+            is_data_page(pid, prev, next);
+            if (next == INVALID_PAGE_ID) break;
+            uint32_t next_prev = 0, next_next = 0;
+            if (visited.count(next) || !is_data_page(next, next_prev, next_next) || next_prev != pid) {
+                if (skip_unreadable()) break;
+                std::cerr << "[StorageEngine] table " << name << ": page chain broken after page " << pid << ", truncated.\n";
+                {
+                    WritePageGuard p = fm_.write_page_guard(pid);
+                    if (!p) return false;
+                    p->set_next_page_id(INVALID_PAGE_ID);
+                }
+                drop_table_fsm(t);
+                changed = true;
+                break;
+            }
+            pid = next;
+        }
+        if (unreadable) continue;
+        if (t->last_pid != pid) {
+            t->last_pid = pid;
+            changed = true;
+        }
+    }
+    if (changed) {
+        std::cout << "[StorageEngine] Catalog page pointers repaired after recovery.\n";
+        if (!cmgr_.SaveCatalog(catalog_)) return false;
+    }
+    return fm_.commit();
+}
+
+bool StorageEngine::Insert(const std::string& tableName, const std::vector<std::string>& values) {
+    maybe_checkpoint();
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return false;
+    std::string rec, err;
+    if (!TupleCodec(t->getSchema()).encode(values, rec, &err)) {
+        std::cerr << "StorageEngine::Insert: " << err << "\n";
+        return false;
+    }
+    // 数据页与 last_pid 都留在内存中，由后台写线程/检查点写回
+    // 提交时只持久化日志（并发语句的提交合并为一次写出+同步），崩溃后按日志重做
+    if (!append_record(tableName, rec)) return false;
+    return fm_.commit();
+}
+
+bool StorageEngine::BulkInsert(const std::string& tableName, const std::vector<std::vector<std::string>>& rows,
+    size_t* inserted) {
+    size_t i = 0;
+    return BulkInsert(tableName, [&](std::vector<std::string>& row) {
+        if (i == rows.size()) return false;
+        row = rows[i++];
+        return true;
+    }, inserted);
+}
+
+bool StorageEngine::BulkInsert(const std::string& tableName,
+    const std::function<bool(std::vector<std::string>&)>& next_row, size_t* inserted) {
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return false;
+    TupleCodec codec(t->getSchema());
+    std::vector<std::string> row;
+    std::string err;
+    size_t count = 0;
+    bool ok = true;
+    // 逐行编码；行与列类型不符时结束记录流（之前的行照常写入）
+    bool written = BulkInsertRecords(tableName, [&](std::string& rec) {
+        if (!next_row(row)) return false;
+        if (!codec.encode(row, rec, &err)) {
+            std::cerr << "StorageEngine::BulkInsert: row " << count + 1 << ": " << err << "\n";
+            ok = false;
+            return false;
+        }
+        ++count;
+        return true;
+    }, inserted);
+    return written && ok;
+}
+
+bool StorageEngine::BulkInsertRecords(const std::string& tableName,
+    const std::function<bool(std::string&)>& next_record, size_t* inserted) {
+    maybe_checkpoint();
+    if (inserted) *inserted = 0;
+    if (!ensure_table_ready(tableName)) return false;
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return false;
+    FreeSpaceMap* fsm = table_fsm(t);
+    if (!fsm) return false;
+    const uint32_t file_id = table_file(t);
+    const uint32_t max_len = Page::max_record_size_of(fm_.get_page_size());
+
+    std::string rec;
+    size_t count = 0;
+    bool ok = true;
+    // 取下一条记录到 rec；没有更多记录或记录超过一页时返回 false（后者 ok 置为 false）
+    auto next = [&]() {
+        if (!next_record(rec)) return false;
+        if (rec.size() > max_len) {
+            std::cerr << "StorageEngine::BulkInsert: row " << count + 1 << ": record too large\n";
+            ok = false;
+            return false;
+        }
+        return true;
+    };
+
+    // 1) 表尾页的剩余空间先填满（整页只记一条页差异日志）
+    bool pending = false;   // rec 中有一条记录尚未写入
+    uint32_t free_bytes;
+    {
+        WritePageGuard last = fm_.write_page_guard(t->last_pid);
+        if (!last) return false;
+        while (next()) {
+            uint16_t slot = 0;
+            if (!last->insert_record(rec.data(), (uint32_t)rec.size(), slot)) {
+                pending = true;
+                break;
+            }
+            ++count;
+        }
+        free_bytes = last->reclaimable_space();
+    }
+    if (!fsm->update(t->last_pid, free_bytes)) return false;
+
+    // 2) 其余记录在内存中装页；攒满一批后一次分配（新页在文件中连续），先写新页再链接到表尾
+    std::vector<Page> pages;
+    auto flush_batch = [&]() {
+        if (pages.empty()) return true;
+        std::vector<uint32_t> pids = fm_.allocate_pages((uint32_t)pages.size(), file_id);
+        if (pids.size() != pages.size()) return false;
+        for (size_t i = 0; i < pages.size(); ++i) {
+            Page& p = pages[i];
+            p.set_page_id(pids[i]);
+            p.set_prev_page_id(i == 0 ? t->last_pid : pids[i - 1]);
+            p.set_next_page_id(i + 1 == pages.size() ? INVALID_PAGE_ID : pids[i + 1]);
+            p.serialize();
+            if (!fm_.write_page(pids[i], p)) return false;
+            if (!fsm->update(pids[i], p.reclaimable_space())) return false;
+        }
+        {
+            WritePageGuard prev = fm_.write_page_guard(t->last_pid);
+            if (!prev) return false;
+            prev->set_next_page_id(pids.front());
+        }
+        t->last_pid = pids.back();
+        pages.clear();
+        // 批已链接进表、目录中的 last_pid 已是新表尾：长时间导入时可在此做检查点（限制日志增长）
+        maybe_checkpoint();
+        return true;
+    };
+    while (ok && (pending || next())) {
+        pending = false;
+        uint16_t slot = 0;
+        if (pages.empty() || !pages.back().insert_record(rec.data(), (uint32_t)rec.size(), slot)) {
+            if (pages.size() == BULK_INSERT_BATCH_PAGES && !flush_batch()) return false;
+            pages.push_back(fm_.new_page());
+            if (!pages.back().insert_record(rec.data(), (uint32_t)rec.size(), slot)) return false;
+        }
+        ++count;
+    }
+    if (!flush_batch()) return false;
+    if (inserted) *inserted = count;
+
+    // 3) 目录只更新一次
+    if (!cmgr_.UpdateTablePages(catalog_, tableName, t->first_pid, t->last_pid)) return false;
+    (void)cmgr_.SaveCatalog(catalog_);
+    return fm_.commit() && ok;
+}
+
+StorageEngine::~StorageEngine() {
+    // 目录中的 last_pid 只在检查点时保存
+    if (!Checkpoint()) std::cerr << "[StorageEngine] checkpoint on close failed.\n";
+}
+
+bool StorageEngine::Checkpoint() {
+    // 目录先于检查点保存：目录引用的页的分配已随提交记入日志，检查点之后这些页一定已经落盘
+    // 目录记下本次检查点的重做起点（提交之后日志的末尾）；目录保存失败时不做检查点，
+    // meta.dat 不会越过目录（重做起点之前的日志仍保留），打开时按日志重做并沿页链修正目录
+    bool ok = fm_.commit();
+    cmgr_.SetCheckpointLsn(fm_.get_wal().get_current_lsn());
+    if (!cmgr_.SaveCatalog(catalog_)) return false;
+    if (!fm_.checkpoint()) ok = false;
+    return ok;
+}
+
+void StorageEngine::maybe_checkpoint() {
+    if (fm_.checkpoint_due() && !Checkpoint()) {
+        std::cerr << "[StorageEngine] checkpoint failed.\n";
+    }
+}
+
+std::vector<std::vector<std::string>> StorageEngine::SelectAll(const std::string& tableName) {
+    std::vector<std::vector<std::string>> rows;
+    ScanTable(tableName, [&](const TupleView& view) {
+        rows.emplace_back();
+        view.decode(rows.back());
+    });
+    return rows;
+}
+
+bool StorageEngine::ScanTable(const std::string& tableName, const std::function<void(const TupleView&)>& fn) {
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return false;
+    if (t->first_pid == 0) return true;
+    TupleCodec codec(t->getSchema());
+
+    // 只读扫描：MMAP模式下按页取只读视图（直接指向映射，无需拷贝进缓存）；
+    // 其他模式固定页后读取（预读线程并发换入页，未固定的缓存页可能被换出），并沿页链预读后续页
+    const bool use_view = fm_.get_io_mode() == IoMode::MMAP;
+    const uint32_t page_size = fm_.get_page_size();
+    ReadAheadState ra;
+    uint32_t pid = t->first_pid;
+    while (pid != INVALID_PAGE_ID && pid != 0) {
+        ReadPageGuard guard;
+        const char* raw = nullptr;
+        if (use_view) {
+            raw = fm_.read_page_view(pid);
+        }
+        else {
+            guard = fm_.read_page_guard(pid, AccessHint::SEQUENTIAL);
+            if (guard) raw = guard->raw_data();
+        }
+        if (!raw) break;
+        uint32_t next = Page::view_next_page_id(raw);
+        fm_.read_ahead(ra, pid, next);
+
+        // 按槽号顺序读出存活记录（墓碑槽跳过）
+        uint16_t slot_count = Page::view_slot_count(raw);
+        for (uint16_t slot = 0; slot < slot_count; ++slot) {
+            const char* rec = nullptr;
+            uint32_t len = 0;
+            if (!Page::view_record(raw, page_size, slot, rec, len)) continue;
+
+            TupleView view(codec, rec, len);
+            if (view.valid()) fn(view);
+        }
+        pid = next;
+    }
+    return true;
+}
+
+bool StorageEngine::DeleteWhere(const std::string& tableName, int whereColIndex, const std::string& whereVal) {
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return false;
+
+    // 无 WHERE：全删，直接释放页链重建空表
+    if (whereColIndex < 0) return TruncateTable(tableName);
+
+    // 条件值只解析一次，扫描时直接与二进制字段比较
+    TupleCodec codec(t->getSchema());
+    bool match_all = whereColIndex >= codec.column_count(); // 条件列越界的记录与原先一样视为命中
+    TupleValue key;
+    if (!match_all && !codec.parse_value(whereColIndex, whereVal, key)) return true; // 与列类型不符：无命中
+    return DeleteIf(tableName, [&](const TupleView& v) { return match_all || v.equals(whereColIndex, key); });
+}
+
+bool StorageEngine::DeleteIf(const std::string& tableName, const std::function<bool(const TupleView&)>& pred,
+    size_t* deleted) {
+    maybe_checkpoint();
+    if (deleted) *deleted = 0;
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return false;
+
+    // 无谓词：全删，直接释放页链重建空表
+    if (!pred) return TruncateTable(tableName);
+    if (t->first_pid == 0) return true;
+
+    // 逐页原地删除：命中记录只打墓碑，只有含命中记录的页会被写回，并在FSM中登记腾出的空间
+    TupleCodec codec(t->getSchema());
+    FreeSpaceMap* fsm = table_fsm(t);
+    ReadAheadState ra;
+    size_t count = 0;
+    std::vector<std::pair<uint32_t, uint16_t>> stubs;
+    uint32_t pid = t->first_pid;
+    while (pid != INVALID_PAGE_ID && pid != 0) {
+        bool dirty = false;
+        uint32_t next, free_bytes;
+        {
+            // 先以读守卫扫描，首次命中时才换成写守卫（没有命中记录的页不会被标脏）
+            // 页帧锁不可升级：先释放读守卫再取写守卫，之后经page继续扫描
+            ReadPageGuard p = fm_.read_page_guard(pid, AccessHint::SEQUENTIAL);
+            if (!p) return false;
+            fm_.read_ahead(ra, pid, p->get_next_page_id());
+            WritePageGuard w;
+            const Page* page = p.get();
+            for (uint16_t slot = 0; slot < page->get_slot_count(); ++slot) {
+                const char* data = nullptr;
+                uint32_t len = 0;
+                if (!page->get_record(slot, data, len)) continue;
+                TupleView view(codec, data, len);
+                if (!view.valid()) continue;
+                if (pred(view)) {
+                    if (!w) {
+                        p.release();
+                        w = fm_.write_page_guard(pid);
+                        if (!w) return false;
+                        page = w.get();
+                    }
+                    // 迁入记录：原位置的转发桩在本页释放后一并删除
+                    uint32_t home_pid;
+                    uint16_t home_slot;
+                    if (w->get_home(slot, home_pid, home_slot)) stubs.emplace_back(home_pid, home_slot);
+                    w->delete_record(slot); // 只打墓碑，不移动记录
+                    dirty = true;
+                    ++count;
+                }
+            }
+            next = page->get_next_page_id();
+            free_bytes = page->reclaimable_space();
+        }
+        if (dirty && fsm) fsm->update(pid, free_bytes);
+        for (const auto& stub : stubs) {
+            if (!drop_slot(t, stub.first, stub.second)) return false;
+        }
+        stubs.clear();
+        pid = next;
+    }
+    if (deleted) *deleted = count;
+    return fm_.commit();
+}
+
+
+bool StorageEngine::DropTableData(const std::string& tableName) {
+    // 删除该表的页文件，并把目录中的 first/last 置 0
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return true; // 视作成功
+
+    // 释放FSM与页链
+    if (!release_table_pages(t, true)) return false;
+
+    // 更新目录并持久化
+    if (!cmgr_.UpdateTablePages(catalog_, tableName, 0, 0)) return false;
+    cmgr_.SaveCatalog(catalog_);
+    return fm_.commit();
+}
+
+// engine/storage_engine.cpp  （追加实现）
+
+bool StorageEngine::UpdateWhere(
+    const std::string& tableName,
+    const std::function<bool(const std::vector<std::string>&)>& pred,
+    const std::vector<std::pair<int, std::string>>& sets_by_idx)
+{
+    if (!pred) return UpdateIf(tableName, nullptr, sets_by_idx);
+    std::vector<std::string> row;
+    return UpdateIf(tableName, [&](const TupleView& v) {
+        v.decode(row);
+        return pred(row);
+    }, sets_by_idx);
+}
+
+bool StorageEngine::UpdateIf(const std::string& tableName, const std::function<bool(const TupleView&)>& pred,
+    const std::vector<std::pair<int, std::string>>& sets_by_idx, size_t* updated)
+{
+    maybe_checkpoint();
+    if (updated) *updated = 0;
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return false;
+    if (t->first_pid == 0) return true;
+
+    // 1) SET 的常量先按列类型解析一次：不合法时直接失败，表保持原样
+    TupleCodec codec(t->getSchema());
+    std::string payload, err;
+    TupleValue value;
+    for (const auto& kv : sets_by_idx) {
+        if (kv.first < 0 || kv.first >= codec.column_count()) {
+            std::cerr << "StorageEngine::UpdateIf: column index " << kv.first << " out of range\n";
+            return false;
+        }
+        if (!codec.parse_value(kv.first, kv.second, value, &err)) {
+            std::cerr << "StorageEngine::UpdateIf: " << err << "\n";
+            return false;
+        }
+    }
+    std::vector<std::string> r;
+    auto apply_sets = [&]() {
+        for (const auto& kv : sets_by_idx) r[kv.first] = kv.second;
+        return codec.encode(r, payload, &err);
+    };
+
+    // 2) 只读扫描：找出命中行，按修改后的内容编码并检查长度；任何一行失败都不修改表
+    //    （之后原地更新与迁移只会因页读写失败而出错）
+    struct Target { uint32_t pid; uint16_t slot; };
+    std::vector<Target> targets;
+    ReadAheadState ra;
+    uint32_t pid = t->first_pid;
+    while (pid != INVALID_PAGE_ID && pid != 0) {
+        ReadPageGuard p = fm_.read_page_guard(pid, AccessHint::SEQUENTIAL);
+        if (!p) return false;
+        fm_.read_ahead(ra, pid, p->get_next_page_id());
+        for (uint16_t slot = 0; slot < p->get_slot_count(); ++slot) {
+            const char* data = nullptr;
+            uint32_t len = 0;
+            if (!p->get_record(slot, data, len)) continue;
+            TupleView view(codec, data, len);
+            if (!view.valid()) continue;
+            if (pred && !pred(view)) continue;
+            view.decode(r);
+            if (!apply_sets()) {
+                std::cerr << "StorageEngine::UpdateIf: " << err << "\n";
+                return false;
+            }
+            if (payload.size() > p->max_record_size()) {
+                std::cerr << "StorageEngine::UpdateIf: record too large\n";
+                return false;
+            }
+            targets.push_back({ pid, slot });
+        }
+        pid = p->get_next_page_id();
+    }
+
+    // 3) 逐页原地更新命中行（同一页的命中行在targets中相邻），只有含命中行的页会被写回
+    //    变长后本页放不下的行先留在原处，全部更新后再迁走（避免迁到后面的页又被当作命中行）
+    struct PendingMove { uint32_t pid; uint16_t slot; std::string rec; };
+    std::vector<PendingMove> moved;
+    FreeSpaceMap* fsm = table_fsm(t);
+    for (size_t i = 0; i < targets.size();) {
+        pid = targets[i].pid;
+        bool dirty = false;
+        uint32_t free_bytes;
+        {
+            WritePageGuard w = fm_.write_page_guard(pid);
+            if (!w) return false;
+            for (; i < targets.size() && targets[i].pid == pid; ++i) {
+                const uint16_t slot = targets[i].slot;
+                const char* data = nullptr;
+                uint32_t len = 0;
+                if (!w->get_record(slot, data, len)) return false;
+                TupleView(codec, data, len).decode(r);
+                if (!apply_sets()) return false;
+                if (w->update_record(slot, payload.data(), (uint32_t)payload.size())) dirty = true;
+                else moved.push_back({ pid, slot, payload });
+            }
+            free_bytes = w->reclaimable_space();
+        }
+        if (dirty && fsm) fsm->update(pid, free_bytes);
+    }
+
+    // 4) 页内放不下的行迁到有空间的页，原位置留转发桩
+    for (const auto& m : moved) {
+        if (!forward_record(t, m.pid, m.slot, m.rec)) {
+            std::cerr << "StorageEngine::UpdateIf: move row failed\n";
+            return false;
+        }
+    }
+
+    if (updated) *updated = targets.size();
+    return fm_.commit();
+}
+
+bool StorageEngine::OverwriteAll(
+    const std::string& tableName,
+    const std::vector<std::vector<std::string>>& rows)
+{
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return false;
+
+    // 1) 先按当前模式编码全部行：任一行不合法或超过一页能放下的长度则直接失败，表保持原样
+    TupleCodec codec(t->getSchema());
+    std::vector<std::string> records(rows.size());
+    std::string err;
+    const uint32_t max_rec = Page::max_record_size_of(fm_.get_page_size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (!codec.encode(rows[i], records[i], &err)) {
+            std::cerr << "OverwriteAll: row " << i + 1 << ": " << err << "\n";
+            return false;
+        }
+        if (records[i].size() > max_rec) {
+            std::cerr << "OverwriteAll: row " << i + 1 << ": record too large\n";
+            return false;
+        }
+    }
+    // 2) 释放旧页链并按行重写
+    if (!rebuild_table(tableName, records)) {
+        std::cerr << "OverwriteAll: rebuild table failed\n";
+        return false;
+    }
+    (void)cmgr_.SaveCatalog(catalog_);
+    return fm_.commit();
+}
+
+bool StorageEngine::write_table_chain(uint32_t file_id, const std::vector<std::string>& records,
+    uint32_t& first_pid, uint32_t& last_pid, std::unique_ptr<FreeSpaceMap>& fsm) {
+    // 1) 先在内存中按顺序装页，得到需要的页数
+    std::vector<Page> pages(1, fm_.new_page());
+    for (const auto& rec : records) {
+        uint16_t slot = 0;
+        if (rec.size() > pages.back().max_record_size()) return false;
+        if (pages.back().insert_record(rec.data(), (uint32_t)rec.size(), slot)) continue;
+        pages.push_back(fm_.new_page());
+        if (!pages.back().insert_record(rec.data(), (uint32_t)rec.size(), slot)) return false;
+    }
+
+    // 2) 一次批量分配全部页（新页连续，文件只扩展一次），链接后逐页写入
+    std::vector<uint32_t> pids = fm_.allocate_pages((uint32_t)pages.size(), file_id);
+    if (pids.size() != pages.size()) return false;
+    fsm = std::make_unique<FreeSpaceMap>(fm_);
+    for (size_t i = 0; i < pages.size(); ++i) {
+        Page& p = pages[i];
+        p.set_page_id(pids[i]);
+        p.set_prev_page_id(i == 0 ? INVALID_PAGE_ID : pids[i - 1]);
+        p.set_next_page_id(i + 1 == pages.size() ? INVALID_PAGE_ID : pids[i + 1]);
+        p.serialize();
+        if (!fm_.write_page(pids[i], p)) return false;
+        if (!fsm->update(pids[i], p.reclaimable_space())) return false;
+    }
+    first_pid = pids.front();
+    last_pid = pids.back();
+    return true;
+}
+
+bool StorageEngine::rebuild_table(const std::string& tableName, const std::vector<std::string>& records) {
+    // 清空表所有数据页（页文件截断为0，之后从文件开头重新写）并把目录清零
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return false;
+    if (!release_table_pages(t, false)) return false;
+    if (!cmgr_.UpdateTablePages(catalog_, tableName, 0, 0)) return false;
+    if (records.empty()) return InitTablePages(tableName);
+
+    uint32_t first = 0, last = 0;
+    std::unique_ptr<FreeSpaceMap> fsm;
+    if (!write_table_chain(table_file(t), records, first, last, fsm)) return false;
+
+    // 登记FSM与页链
+    t->fsm_pid = fsm->get_first_page_id();
+    fsms_[t->fsm_pid] = std::move(fsm);
+    return cmgr_.UpdateTablePages(catalog_, tableName, first, last);
+}
+
+
+bool StorageEngine::TruncateTable(const std::string& tableName) {
+    TableInfo* t = catalog_.GetTable(tableName);
+    if (!t) return true; // 视为成功
+
+    // 清空表的页文件（或释放共享数据文件中的FSM与链页）并清零目录
+    if (!release_table_pages(t, false)) return false;
+    if (!cmgr_.UpdateTablePages(catalog_, tableName, 0, 0)) return false;
+    cmgr_.SaveCatalog(catalog_);
+
+    // 重新建一个空页链
+    return InitTablePages(tableName);
+}
+
+bool StorageEngine::Vacuum(const std::string& tableName, bool full, VacuumState& st) {
+    st = VacuumState();
+    st.table = tableName;
+    st.full = full;
+    while (!st.done) {
+        maybe_checkpoint();
+        if (!VacuumStep(st)) return false;
+    }
+    (void)cmgr_.SaveCatalog(catalog_);
+    return true;
+}
+
+bool StorageEngine::VacuumStep(VacuumState& st, uint32_t max_pages) {
+    TableInfo* t = catalog_.GetTable(st.table);
+    if (!t) return false;
+    if (st.done) return true;
+    if (st.steps++ == 0) st.pages_before = st.pages_after = (uint32_t)collect_table_pages(t).size();
+    if (t->first_pid == 0) {
+        st.done = true;
+        return true;
+    }
+
+    if (st.full) {
+        // FULL：按页链顺序取出全部记录，释放旧页后重写到新分配的连续页中
+        std::vector<std::string> records;
+        bool ok = for_each_page(t, [&](uint32_t, const Page& p) {
+            for (uint16_t slot = 0; slot < p.get_slot_count(); ++slot) {
+                const char* data = nullptr;
+                uint32_t len = 0;
+                if (p.get_record(slot, data, len)) records.emplace_back(data, len);
+            }
+            return true;
+        });
+        if (!ok || !rebuild_table(st.table, records)) return false;
+        st.records_moved = records.size();
+        st.pages_after = (uint32_t)collect_table_pages(catalog_.GetTable(st.table)).size();
+        st.pages_freed = st.pages_before > st.pages_after ? st.pages_before - st.pages_after : 0;
+        st.done = true;
+        (void)cmgr_.SaveCatalog(catalog_);
+        return fm_.commit();
+    }
+
+    FreeSpaceMap* fsm = table_fsm(t);
+    // 上一步之后搬入位置的页可能已不在表中（期间表被清空/重建），从页链首重新开始
+    uint32_t head = st.head_pid;
+    if (head == 0 || !fm_.is_page_in_use(head)) head = t->first_pid;
+    std::vector<uint32_t> freed;   // 本步摘下的尾页，步末一起释放（释放记录只同步一次日志）
+    for (uint32_t n = 0; n < max_pages && !st.done; ++n) {
+        uint32_t tail = t->last_pid;
+        if (head == tail) {
+            st.done = true;
+            break;
+        }
+        bool emptied = true;
+        uint32_t prev, free_bytes;
+        {
+            WritePageGuard tp = fm_.write_page_guard(tail);
+            if (!tp) return false;
+            for (uint16_t slot = 0; slot < tp->get_slot_count() && emptied; ++slot) {
+                // 转发桩与迁入记录：记录搬到搬入位置后成为普通记录，另一端随之删除
+                uint32_t ref_pid = INVALID_PAGE_ID;
+                uint16_t ref_slot = 0;
+                const char* data = nullptr;
+                uint32_t len = 0;
+                std::string rec;
+                if (tp->get_forward(slot, ref_pid, ref_slot)) {
+                    ReadPageGuard rp = fm_.read_page_guard(ref_pid);
+                    if (!rp) return false;
+                    if (!rp->get_record(ref_slot, data, len)) continue;
+                    rec.assign(data, len);
+                }
+                else {
+                    if (!tp->get_record(slot, data, len)) continue;
+                    rec.assign(data, len);
+                    if (!tp->get_home(slot, ref_pid, ref_slot)) ref_pid = INVALID_PAGE_ID;
+                }
+                // 搬入位置的页放不下时向后推进，推进到尾页说明前面已没有空间
+                for (;;) {
+                    bool written = false;
+                    uint32_t head_free = 0;
+                    if (!append_to_page(head, rec, written, head_free)) return false;
+                    if (written) {
+                        if (fsm && !fsm->update(head, head_free)) return false;
+                        break;
+                    }
+                    ReadPageGuard hp = fm_.read_page_guard(head);
+                    if (!hp) return false;
+                    head = hp->get_next_page_id();
+                    if (head == tail || head == INVALID_PAGE_ID) {
+                        emptied = false;
+                        break;
+                    }
+                }
+                if (!emptied) break;
+                tp->delete_record(slot);
+                if (ref_pid != INVALID_PAGE_ID && !drop_slot(t, ref_pid, ref_slot)) return false;
+                ++st.records_moved;
+            }
+            prev = tp->get_prev_page_id();
+            free_bytes = tp->reclaimable_space();
+        }
+        if (!emptied) {
+            // 搬入位置与尾页相遇：表已紧凑
+            if (fsm && !fsm->update(tail, free_bytes)) return false;
+            st.done = true;
+            break;
+        }
+
+        // 尾页已空：从页链摘下并注销FSM条目
+        {
+            WritePageGuard pp = fm_.write_page_guard(prev);
+            if (!pp) return false;
+            pp->set_next_page_id(INVALID_PAGE_ID);
+        }
+        if (fsm && !fsm->remove(tail)) return false;
+        if (!cmgr_.UpdateTablePages(catalog_, st.table, t->first_pid, prev)) return false;
+        freed.push_back(tail);
+    }
+    st.head_pid = head;
+    // 摘下的尾页回到空闲页位图
+    if (!freed.empty() && !fm_.free_pages(freed)) return false;
+    st.pages_freed += (uint32_t)freed.size();
+    st.pages_after -= (uint32_t)freed.size();
+    return fm_.commit();
+}
+
+// ==========================
+// 启动检查与存储格式迁移
+// ==========================
+bool StorageEngine::Startup() {
+    uint32_t version = fm_.get_format_version();
+    // 当前格式：崩溃恢复后目录可能落后于（或超前于）日志重做出的页链，逐表修正
+    if (version >= STORAGE_FORMAT_VERSION) {
+        // 重做过页修改，或目录落后于 meta.dat 的检查点（两个文件不是同一次检查点保存的）：沿页链全面修正目录
+        bool catalog_behind = cmgr_.GetCheckpointLsn() < fm_.get_checkpoint_lsn();
+        if (catalog_behind) {
+            std::cerr << "[StorageEngine] catalog is older than the last checkpoint, checking page chains.\n";
+        }
+        return repair_table_pages(fm_.get_recovery_stats().page_records > 0 || catalog_behind);
+    }
+
+    std::cout << "[StorageEngine] Migrating data file from format " << version
+        << " to " << STORAGE_FORMAT_VERSION << "...\n";
+    if ((version < 2 && !migrate_v1_to_v2()) || (version < 3 && !migrate_v2_to_v3()) ||
+        (version < 4 && !migrate_v3_to_v4()) || (version < 5 && !fm_.stamp_page_checksums()) ||
+        (version < 6 && !migrate_v5_to_v6())) {
+        std::cerr << "[StorageEngine] Migration failed, data file left in format " << version << ".\n";
+        return false;
+    }
+    fm_.set_format_version(STORAGE_FORMAT_VERSION);
+    (void)cmgr_.SaveCatalog(catalog_);
+    (void)fm_.commit();
+    std::cout << "[StorageEngine] Migration finished.\n";
+    return true;
+}
+
+bool StorageEngine::migrate_v1_to_v2() {
+    // 旧版页：16字节页头后顺序排列 [uint16 len][csv]，直到 free_offset
+    const uint32_t LEGACY_HEADER = PAGE_BASE_HEADER_SIZE;
+    for (const auto& name : catalog_.ListTables()) {
+        TableInfo* t = catalog_.GetTable(name);
+        if (!t || t->first_pid == 0) continue;
+        {
+            // 上次迁移在改存储格式版本之前中断：目录已指向新的槽页链，不再迁移
+            ReadPageGuard first = fm_.read_page_guard(t->first_pid);
+            if (first && first->get_page_flags() == PAGE_FLAG_SLOTTED) continue;
+        }
+
+        // 1) 读出旧页链中的全部记录
+        std::vector<std::string> records;
+        std::vector<uint32_t> old_pages;
+        uint32_t pid = t->first_pid;
+        while (pid != INVALID_PAGE_ID && pid != 0) {
+            ReadPageGuard p = fm_.read_page_guard(pid);
+            if (!p) break;
+            old_pages.push_back(pid);
+            uint32_t off = LEGACY_HEADER;
+            uint32_t end = std::min<uint32_t>(p->get_free_offset(), p->get_page_size());
+            while (off + 2 <= end) {
+                uint16_t len = 0;
+                if (!p->read_data(off, (char*)&len, 2)) break;
+                off += 2;
+                if (len == 0 || off + len > end) break;
+                std::string rec(len, '\0');
+                if (!p->read_data(off, rec.data(), len)) break;
+                off += len;
+                records.push_back(std::move(rec));
+            }
+            pid = p->get_next_page_id();
+        }
+
+        // 2) 先按槽页格式写出新页链并提交，再把目录切换到新页链并保存，最后才释放旧页链：
+        //    任何一步失败或中途崩溃，目录都指向一条完整的页链（旧链或新链）
+        uint32_t first = 0, last = 0;
+        std::unique_ptr<FreeSpaceMap> fsm;
+        uint32_t file_id = fm_.open_table_file(t->file_name.empty() ? name + ".tbl" : t->file_name);
+        if (!write_table_chain(file_id, records, first, last, fsm) || !fm_.commit()) return false;
+        if (!cmgr_.UpdateTablePages(catalog_, name, first, last)) return false;
+        t->fsm_pid = fsm->get_first_page_id();
+        fsms_[t->fsm_pid] = std::move(fsm);
+        if (!cmgr_.SaveCatalog(catalog_)) return false;
+        if (!fm_.free_pages(old_pages)) return false;
+        std::cout << "[StorageEngine]   table " << name << ": " << records.size() << " rows\n";
+    }
+    fm_.flush_all_pages();
+    return true;
+}
+
+bool StorageEngine::migrate_v2_to_v3() {
+    // 槽中的 CSV 行按表模式重新编码；与列类型不符的旧值无法编码，改为空值并给出提示
+    for (const auto& name : catalog_.ListTables()) {
+        TableInfo* t = catalog_.GetTable(name);
+        if (!t || t->first_pid == 0) continue;
+        TupleCodec codec(t->getSchema());
+        const int ncols = codec.column_count();
+
+        std::vector<std::string> records;
+        std::vector<std::string> fields;
+        std::string rec;
+        size_t dropped_values = 0;
+        uint32_t pid = t->first_pid;
+        while (pid != INVALID_PAGE_ID && pid != 0) {
+            ReadPageGuard p = fm_.read_page_guard(pid);
+            if (!p) break;
+            for (uint16_t slot = 0; slot < p->get_slot_count(); ++slot) {
+                const char* data = nullptr;
+                uint32_t len = 0;
+                if (!p->get_record(slot, data, len)) continue;
+                split_csv_line(std::string(data, len), fields);
+                if ((int)fields.size() > ncols) {
+                    dropped_values += fields.size() - ncols;
+                    fields.resize(ncols);
+                }
+                TupleValue v;
+                for (int c = 0; c < (int)fields.size(); ++c) {
+                    if (!codec.parse_value(c, fields[c], v)) {
+                        fields[c].clear();
+                        ++dropped_values;
+                    }
+                }
+                if (!codec.encode(fields, rec)) return false;
+                records.push_back(rec);
+            }
+            pid = p->get_next_page_id();
+        }
+
+        if (!rebuild_table(name, records)) return false;
+        std::cout << "[StorageEngine]   table " << name << ": " << records.size() << " rows";
+        if (dropped_values) std::cout << " (" << dropped_values << " values not matching column type set to NULL)";
+        std::cout << "\n";
+    }
+    fm_.flush_all_pages();
+    return true;
+}
+
+bool StorageEngine::migrate_v3_to_v4() {
+    for (const auto& name : catalog_.ListTables()) {
+        TableInfo* t = catalog_.GetTable(name);
+        if (!t) continue;
+
+        // 1) 旧FSM页的条目从第20字节开始，与页LSN重叠：沿页链释放（只看页标志与下一页号，不解析条目）
+        //    目录中的FSM页号清零，下次写入时按表页链重建
+        std::vector<uint32_t> fsm_pages;
+        uint32_t pid = t->fsm_pid;
+        while (pid != INVALID_PAGE_ID && pid != 0) {
+            ReadPageGuard p = fm_.read_page_guard(pid);
+            if (!p || p->get_page_flags() != PAGE_FLAG_FSM) break;
+            fsm_pages.push_back(pid);
+            pid = p->get_next_page_id();
+        }
+        fm_.free_pages(fsm_pages);
+        fsms_.erase(t->fsm_pid);
+        t->fsm_pid = 0;
+
+        // 2) 数据页 [24,32) 原为保留字节，复用的页中可能残留旧内容：页LSN清零
+        pid = t->first_pid;
+        while (pid != INVALID_PAGE_ID && pid != 0) {
+            WritePageGuard p = fm_.write_page_guard(pid);
+            if (!p) return false;
+            p->set_lsn(0);
+            pid = p->get_next_page_id();
+        }
+    }
+    fm_.flush_all_pages();
+    return true;
+}
+
+bool StorageEngine::migrate_v5_to_v6() {
+    // 按页链顺序读出共享数据文件中每张表的记录，重建到表自己的页文件（data.dat中的旧页随之释放）
+    for (const auto& name : catalog_.ListTables()) {
+        TableInfo* t = catalog_.GetTable(name);
+        if (!t || t->first_pid == 0 || Page::file_of(t->first_pid) != SHARED_FILE_ID) continue;
+
+        std::vector<std::string> records;
+        bool ok = for_each_page(t, [&](uint32_t, const Page& p) {
+            for (uint16_t slot = 0; slot < p.get_slot_count(); ++slot) {
+                const char* data = nullptr;
+                uint32_t len = 0;
+                if (p.get_record(slot, data, len)) records.emplace_back(data, len);
+            }
+            return true;
+        });
+        if (!ok || !rebuild_table(name, records)) return false;
+        std::cout << "[StorageEngine]   table " << name << ": " << records.size() << " rows moved to "
+            << fm_.get_table_file_name(table_file(t)) << "\n";
+    }
+    fm_.flush_all_pages();
+    return true;
+}
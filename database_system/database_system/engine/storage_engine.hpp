@@ -1,65 +1,174 @@
-﻿// =============================================
-// engine/storage_engine.hpp  （新增/覆盖）
-// =============================================
-#pragma once
-#include <string>
-#include <vector>
-#include "catalog_manager.hpp"
-#include "../storage/file_manager.hpp"
-#include "../storage/page.hpp"
-#include <functional> 
-
-class StorageEngine {
-public:
-
-    StorageEngine(CatalogManager& cmgr, Catalog& cat, FileManager& fm)
-        : cmgr_(cmgr), catalog_(cat), fm_(fm) {}
-
-    // 初始化表的链表（分配首个数据页）
-    bool InitTablePages(const std::string& tableName);
-
-    // 追加一条记录（values 已为字符串，如 "1", "Alice"）
-    bool Insert(const std::string& tableName, const std::vector<std::string>& values);
-
-    // 全表顺序扫描（按之前 CSV 打印风格返回）
-    std::vector<std::vector<std::string>> SelectAll(const std::string& tableName);
-
-    // 条件删除：whereColIndex == -1 表示全删
-    bool DeleteWhere(const std::string& tableName, int whereColIndex, const std::string& whereVal);
-
-    // 物理丢弃：释放该表所有页（仅演示，简单回收到 free list）
-    bool DropTableData(const std::string& tableName);
-
-    // 条件更新：将满足 where 条件的记录按 sets 更新
-    //  whereColIndex: 参与条件的列索引；若是 IN/BETWEEN，请传 -2 并依赖谓词回调
-    //  返回 true 表示成功
-    bool UpdateWhere(
-        const std::string& tableName,
-        const std::function<bool(const std::vector<std::string>&)>& pred,
-        const std::vector<std::pair<int, std::string>>& sets_by_idx);
-
-    bool OverwriteAll(
-        const std::string& tableName,
-        const std::vector<std::vector<std::string>>& rows);
-
-    // TRUNCATE：清空表数据并重建空页链（不删除表定义）
-    bool TruncateTable(const std::string& tableName);
-
-private:
-    // --- 工具 ---
-    static std::string join_csv(const std::vector<std::string>& values);
-    static void split_csv_line(const std::string& line, std::vector<std::string>& out);
-
-    bool append_to_page(uint32_t page_id, const std::string& line, uint32_t& new_free_off, bool& ok_written);
-    bool allocate_linked_page(uint32_t prev_pid, uint32_t& new_pid);
-    bool ensure_table_ready(const std::string& tableName);  // 新增：确保表有可用数据页
-
-    // 遍历所有链页
-    template<typename Fn>
-    bool for_each_page(const TableInfo* t, Fn fn);
-
-private:
-    CatalogManager& cmgr_;
-    Catalog& catalog_;
-    FileManager& fm_;
-};
+// =============================================
+// engine/storage_engine.hpp  （新增/覆盖）
+// =============================================
+#pragma once
+#include <string>
+#include <vector>
+#include "catalog_manager.hpp"
+#include "tuple_codec.hpp"
+#include "../storage/file_manager.hpp"
+#include "../storage/free_space_map.hpp"
+#include "../storage/page.hpp"
+#include <functional> 
+#include <map>
+#include <memory>
+
+// VACUUM 每一步至多处理的表尾页数（每步结束时提交，步与步之间不持有页）
+#define VACUUM_STEP_PAGES 16
+// 批量插入时在内存中装满多少页后一起分配、链接并写入（与默认区段大小相同）
+#define BULK_INSERT_BATCH_PAGES 64
+
+class StorageEngine {
+public:
+
+    StorageEngine(CatalogManager& cmgr, Catalog& cat, FileManager& fm)
+        : cmgr_(cmgr), catalog_(cat), fm_(fm) {}
+    // 关闭时做一次检查点（保存目录中只在内存里更新的 last_pid）
+    ~StorageEngine();
+
+    // 启动检查：数据文件为旧存储格式时逐表迁移到当前格式（绑定数据库后调用一次）
+    bool Startup();
+
+    // 初始化表的链表（分配首个数据页）
+    bool InitTablePages(const std::string& tableName);
+
+    // 追加一条记录（values 已为字符串，如 "1", "Alice"；按表模式编码，值与列类型不符时失败）
+    bool Insert(const std::string& tableName, const std::vector<std::string>& values);
+
+    // 批量追加：先填满表尾页的剩余空间，其余行在内存中装满整页，每 BULK_INSERT_BATCH_PAGES 页一起分配、
+    // 写入并链接到表尾；全部写完后只更新一次目录、提交一次（导入时间长时批与批之间按需做检查点）
+    //  next_row 每次填入一行并返回 true，没有更多行时返回 false
+    //  遇到与列类型不符（或超过一页）的行时停止并返回 false，之前的行保留；inserted 非空时返回写入的行数
+    bool BulkInsert(const std::string& tableName, const std::function<bool(std::vector<std::string>&)>& next_row,
+        size_t* inserted = nullptr);
+    bool BulkInsert(const std::string& tableName, const std::vector<std::vector<std::string>>& rows,
+        size_t* inserted = nullptr);
+    // 批量追加已按表模式编码的记录（next_record 每次填入一条并返回 true，没有更多记录时返回 false）；
+    // 供并行解析的导入使用（编码在调用者的线程中完成）。记录超过一页时停止并返回 false
+    bool BulkInsertRecords(const std::string& tableName, const std::function<bool(std::string&)>& next_record,
+        size_t* inserted = nullptr);
+
+    // 全表顺序扫描（按之前 CSV 打印风格返回）
+    std::vector<std::vector<std::string>> SelectAll(const std::string& tableName);
+
+    // 全表顺序扫描：逐行回调只读元组视图（零拷贝，不做文本解析）
+    bool ScanTable(const std::string& tableName, const std::function<void(const TupleView&)>& fn);
+
+    // 条件删除：whereColIndex == -1 表示全删
+    bool DeleteWhere(const std::string& tableName, int whereColIndex, const std::string& whereVal);
+
+    // 谓词删除：逐页扫描，pred 命中的记录原地打墓碑（pred 为空表示全删）；deleted 非空时返回删除行数
+    bool DeleteIf(const std::string& tableName, const std::function<bool(const TupleView&)>& pred,
+        size_t* deleted = nullptr);
+
+    // 物理丢弃：删除该表的页文件（旧库中放在共享数据文件里的表逐页释放，回收到空闲页位图）
+    bool DropTableData(const std::string& tableName);
+
+    // 表改名后页文件随之改名（oldFileName/newFileName 为改名前后目录中的 file_name）
+    bool RenameTableFile(const std::string& oldFileName, const std::string& newFileName);
+
+    // 谓词更新：pred 命中的记录按 sets_by_idx（列下标, 文本值）修改（pred 为空表示全部命中）；updated 非空时返回更新行数
+    //  先只读扫描一遍：SET 值不合法或修改后的记录超过一页时失败，表保持原样
+    //  再逐页原地改写命中行，只有含命中行的页会被写回；页内放不下的行迁到有空间的页，原位置留转发桩
+    bool UpdateIf(const std::string& tableName, const std::function<bool(const TupleView&)>& pred,
+        const std::vector<std::pair<int, std::string>>& sets_by_idx, size_t* updated = nullptr);
+
+    // 条件更新：同 UpdateIf，谓词按解码后的整行（文本值）判断
+    bool UpdateWhere(
+        const std::string& tableName,
+        const std::function<bool(const std::vector<std::string>&)>& pred,
+        const std::vector<std::pair<int, std::string>>& sets_by_idx);
+
+    // 用 rows 整体替换表数据（先按当前模式编码全部行，任一行不合法则不改动表）
+    bool OverwriteAll(
+        const std::string& tableName,
+        const std::vector<std::vector<std::string>>& rows);
+
+    // TRUNCATE：清空表数据并重建空页链（不删除表定义）
+    bool TruncateTable(const std::string& tableName);
+
+    // VACUUM 的进度与统计：table/full 由调用者设置，其余在 VacuumStep 之间累计
+    struct VacuumState {
+        std::string table;
+        bool full = false;          // FULL：按页链顺序把全部记录重写到连续的新页中
+        bool done = false;
+        uint32_t steps = 0;
+        uint32_t pages_before = 0;
+        uint32_t pages_after = 0;
+        uint32_t pages_freed = 0;
+        uint64_t records_moved = 0;
+        uint32_t head_pid = 0;      // 搬入位置：从页链首向后推进，与从表尾向前推进的搬出位置相遇时结束
+    };
+
+    // VACUUM 的一步：把表尾页的记录搬进页链前部有空间的页（每条记录至多搬一次），搬空的尾页从页链摘下并释放，
+    // 至多处理 max_pages 个尾页后提交返回；步与步之间不持有页，调用者可以在其间执行其他语句。
+    // 尾页中有记录放不进其他页时结束（st.done）；FULL 在一步内重写整张表（页在文件中连续）
+    bool VacuumStep(VacuumState& st, uint32_t max_pages = VACUUM_STEP_PAGES);
+    // VACUUM [FULL]：逐步执行到结束（步与步之间按需做检查点），统计写入 st
+    bool Vacuum(const std::string& tableName, bool full, VacuumState& st);
+
+    // 检查点：保存目录，再刷新所有脏页、原子替换 meta.dat（CHECKPOINT 命令、定期检查点与关闭时调用）
+    bool Checkpoint();
+
+private:
+    // --- 工具 ---
+    // 拆分旧格式（版本1/2）的 CSV 行，仅迁移时使用
+    static void split_csv_line(const std::string& line, std::vector<std::string>& out);
+
+    // 向页追加一条记录（写入一个新槽）；页内空间不足时 ok_written=false
+    // free_after 返回写入后页的可用空间（供调用者更新FSM，无需再读一次页）
+    // home_pid 有效时写成迁入记录（带原位置 home_pid/home_slot）；slot_out 非空时返回槽号
+    bool append_to_page(uint32_t page_id, const std::string& rec, bool& ok_written, uint32_t& free_after,
+        uint32_t home_pid = INVALID_PAGE_ID, uint16_t home_slot = 0, uint16_t* slot_out = nullptr);
+    bool allocate_linked_page(uint32_t prev_pid, uint32_t& new_pid);
+    // 追加一条已编码的记录：按FSM选一个放得下的页，都放不下时在表尾链接新页（只更新内存中的目录）
+    // home_pid 有效时写成迁入记录；pid_out/slot_out 非空时返回写入位置
+    bool append_record(const std::string& tableName, const std::string& rec,
+        uint32_t home_pid = INVALID_PAGE_ID, uint16_t home_slot = 0, uint32_t* pid_out = nullptr, uint16_t* slot_out = nullptr);
+    // 删除页中的一个槽（转发桩或迁入记录的另一端）并更新该页的FSM条目
+    bool drop_slot(TableInfo* t, uint32_t pid, uint16_t slot);
+    // 更新后页内放不下的记录：迁到有空间的页，原位置改为转发桩（已迁出的记录只改写转发桩，
+    // 不形成转发链；原页腾出空间时迁回原页）
+    bool forward_record(TableInfo* t, uint32_t pid, uint16_t slot, const std::string& rec);
+    // 表的空闲空间映射（目录中没有或已损坏时按表页链重建）
+    FreeSpaceMap* table_fsm(TableInfo* t);
+    // 释放表的FSM页（删表/清空表/重建页链时调用）
+    void drop_table_fsm(TableInfo* t);
+    // 沿页链收集表的全部数据页号（读不到的页之后不再继续）
+    std::vector<uint32_t> collect_table_pages(const TableInfo* t);
+    // 表的页所在文件号：已有页时取首页所在文件，否则按目录中的 file_name 打开（不存在则创建）表的页文件
+    uint32_t table_file(const TableInfo* t);
+    // 释放表的全部页（含FSM页）：表有自己的页文件时删除（remove_file）或清空该文件，
+    // 页在共享数据文件中时沿页链逐页释放；目录中的 first/last/fsm 置 0（不保存目录）
+    bool release_table_pages(TableInfo* t, bool remove_file);
+    // 崩溃恢复后修正目录：FSM页号/首页号指向无效页时清零，页链断在无效页处，last_pid 取链尾
+    //  full=false 时只检查 last_pid 所指页仍是链尾的表不再遍历
+    bool repair_table_pages(bool full);
+    // 按 records（已编码）在 file_id 号文件中写一条新页链（不改动表现有的页与目录）：
+    // 先在内存中装页，再批量分配页并逐页写入；成功时返回首尾页号与新页链的FSM
+    bool write_table_chain(uint32_t file_id, const std::vector<std::string>& records,
+        uint32_t& first_pid, uint32_t& last_pid, std::unique_ptr<FreeSpaceMap>& fsm);
+    // 释放表的页链，按 records（已编码）重建（见 write_table_chain）
+    bool rebuild_table(const std::string& tableName, const std::vector<std::string>& records);
+    // 存储格式迁移：旧版行追加页 -> 槽页
+    bool migrate_v1_to_v2();
+    // 存储格式迁移：CSV 行 -> 二进制元组
+    bool migrate_v2_to_v3();
+    // 存储格式迁移：页头 [24,32) 改为页LSN（旧FSM页条目区与之重叠，释放后按新布局重建）
+    bool migrate_v3_to_v4();
+    // 存储格式迁移：共享数据文件中的表逐表搬到各自的页文件
+    bool migrate_v5_to_v6();
+    bool ensure_table_ready(const std::string& tableName);  // 新增：确保表有可用数据页
+    // 距上次检查点超过 CHECKPOINT_INTERVAL_SEC 时做一次检查点（写操作开始前调用）
+    void maybe_checkpoint();
+
+    // 遍历所有链页
+    template<typename Fn>
+    bool for_each_page(const TableInfo* t, Fn fn);
+
+private:
+    CatalogManager& cmgr_;
+    Catalog& catalog_;
+    FileManager& fm_;
+    std::map<uint32_t, std::unique_ptr<FreeSpaceMap>> fsms_;   // 已加载的FSM，按FSM首页号索引（表改名后仍有效）
+};
@@ -0,0 +1,508 @@
+// =============================================
+// engine/tuple_codec.cpp
+// =============================================
+#include "tuple_codec.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+static constexpr int DECIMAL_MAX_DIGITS = 18; // int64 能完整表示的十进制位数
+
+static int64_t pow10_i64(int n) {
+    int64_t r = 1;
+    while (n-- > 0) r *= 10;
+    return r;
+}
+
+static std::string upper_copy(std::string s) {
+    for (auto& c : s) c = (char)std::toupper((unsigned char)c);
+    return s;
+}
+
+static uint16_t fixed_width(ColumnType t) {
+    switch (t) {
+    case ColumnType::INT:       return 4;
+    case ColumnType::TINYINT:   return 1;
+    case ColumnType::FLOAT:     return 8;
+    case ColumnType::DECIMAL:   return 8;
+    case ColumnType::TIMESTAMP: return 8;
+    default:                    return 0;
+    }
+}
+
+// -------------------------- 日期换算（公历，不做时区换算） --------------------------
+static int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+static void civil_from_days(int64_t z, int64_t& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = (unsigned)(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = (int64_t)yoe + era * 400 + (m <= 2);
+}
+
+static unsigned days_in_month(int64_t y, unsigned m) {
+    static const unsigned dm[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    return (m == 2 && leap) ? 29 : dm[m - 1];
+}
+
+// 读取 [p, end) 中恰好 n 位数字
+static bool read_digits(const char*& p, const char* end, int n, int& out) {
+    out = 0;
+    for (int i = 0; i < n; ++i) {
+        if (p >= end || !std::isdigit((unsigned char)*p)) return false;
+        out = out * 10 + (*p++ - '0');
+    }
+    return true;
+}
+
+// YYYY-MM-DD[( |T)HH:MM[:SS]]
+static bool parse_timestamp(const std::string& s, int64_t& encoded) {
+    const char* p = s.data();
+    const char* end = p + s.size();
+    int y, mo, d, h = 0, mi = 0, sec = 0;
+    if (!read_digits(p, end, 4, y) || p >= end || *p++ != '-') return false;
+    // 月、日允许一位数字
+    auto read_1or2 = [&](int& out) {
+        if (!read_digits(p, end, 1, out)) return false;
+        if (p < end && std::isdigit((unsigned char)*p)) out = out * 10 + (*p++ - '0');
+        return true;
+    };
+    if (!read_1or2(mo) || p >= end || *p++ != '-' || !read_1or2(d)) return false;
+    bool has_time = false;
+    if (p < end) {
+        if (*p != ' ' && *p != 'T') return false;
+        ++p;
+        if (!read_1or2(h) || p >= end || *p++ != ':' || !read_1or2(mi)) return false;
+        if (p < end) {
+            if (*p++ != ':' || !read_1or2(sec)) return false;
+        }
+        if (p != end) return false;
+        has_time = true;
+    }
+    if (y < 1 || mo < 1 || mo > 12 || d < 1 || (unsigned)d > days_in_month(y, (unsigned)mo)) return false;
+    if (h > 23 || mi > 59 || sec > 59) return false;
+
+    int64_t secs = days_from_civil(y, (unsigned)mo, (unsigned)d) * 86400 + h * 3600 + mi * 60 + sec;
+    encoded = secs * 2 + (has_time ? 1 : 0);
+    return true;
+}
+
+static std::string format_timestamp(int64_t encoded) {
+    int64_t has_time = encoded & 1;
+    int64_t secs = (encoded - has_time) / 2;
+    int64_t days = secs >= 0 ? secs / 86400 : -((-secs + 86399) / 86400);
+    int64_t rem = secs - days * 86400;
+    int64_t y; unsigned m, d;
+    civil_from_days(days, y, m, d);
+    char buf[64];
+    if (has_time) {
+        std::snprintf(buf, sizeof(buf), "%04lld-%02u-%02u %02d:%02d:%02d", (long long)y, m, d,
+            (int)(rem / 3600), (int)(rem / 60 % 60), (int)(rem % 60));
+    }
+    else {
+        std::snprintf(buf, sizeof(buf), "%04lld-%02u-%02u", (long long)y, m, d);
+    }
+    return buf;
+}
+
+// 当前本地时间（显式写 CURRENT_TIMESTAMP / NOW() 时使用）
+static int64_t current_timestamp() {
+    std::time_t t = std::time(nullptr);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    int64_t secs = days_from_civil(tm.tm_year + 1900, (unsigned)tm.tm_mon + 1, (unsigned)tm.tm_mday) * 86400
+        + tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+    return secs * 2 + 1;
+}
+
+// -------------------------- 数值解析/格式化 --------------------------
+static bool parse_integer(const std::string& s, int64_t& out) {
+    if (s.empty()) return false;
+    errno = 0;
+    char* endp = nullptr;
+    long long v = std::strtoll(s.c_str(), &endp, 10);
+    if (errno != 0 || endp != s.c_str() + s.size()) return false;
+    out = v;
+    return true;
+}
+
+// 定点数：[+-]digits[.digits]，小数超过 scale 位时四舍五入
+static bool parse_decimal(const std::string& s, int precision, int scale, int64_t& out) {
+    size_t i = 0;
+    bool neg = false;
+    if (i < s.size() && (s[i] == '+' || s[i] == '-')) neg = (s[i++] == '-');
+    const int max_digits = (precision > 0 && precision < DECIMAL_MAX_DIGITS) ? precision : DECIMAL_MAX_DIGITS;
+    const int64_t limit = pow10_i64(max_digits);
+
+    int64_t mag = 0;
+    int digits = 0;
+    for (; i < s.size() && std::isdigit((unsigned char)s[i]); ++i, ++digits) {
+        mag = mag * 10 + (s[i] - '0');
+        if (mag >= limit) return false; // 提前判断，避免溢出
+    }
+    int frac = 0;
+    bool round_up = false;
+    if (i < s.size() && s[i] == '.') {
+        for (++i; i < s.size() && std::isdigit((unsigned char)s[i]); ++i, ++digits) {
+            if (frac < scale) {
+                mag = mag * 10 + (s[i] - '0');
+                if (mag >= limit) return false;
+                ++frac;
+            }
+            else if (frac == scale && !round_up && s[i] >= '5') {
+                round_up = true;
+                ++frac; // 只看舍入位
+            }
+            else if (frac == scale) {
+                ++frac;
+            }
+        }
+    }
+    if (i != s.size() || digits == 0) return false;
+    for (int k = std::min(frac, scale); k < scale; ++k) {
+        mag *= 10;
+        if (mag >= limit) return false;
+    }
+    if (round_up) ++mag;
+    if (mag >= limit) return false;
+    out = neg ? -mag : mag;
+    return true;
+}
+
+static std::string format_decimal(int64_t v, int scale) {
+    bool neg = v < 0;
+    uint64_t mag = neg ? (uint64_t)0 - (uint64_t)v : (uint64_t)v;
+    uint64_t div = (uint64_t)pow10_i64(scale);
+    std::string r = std::to_string(mag / div);
+    if (scale > 0) {
+        std::string f = std::to_string(mag % div);
+        r += '.';
+        r.append(scale - f.size(), '0');
+        r += f;
+    }
+    return neg ? "-" + r : r;
+}
+
+// 最短的可精确还原的表示（"3.14" 仍输出 "3.14" 而不是 "3.1400000000000001"）
+// 常见量级按定点输出（1000 而不是 1e+03），过大/过小才用科学计数法
+static std::string format_double(double v) {
+    char buf[64];
+    int prec = 1;
+    for (; prec < 17; ++prec) {
+        std::snprintf(buf, sizeof(buf), "%.*g", prec, v);
+        if (std::strtod(buf, nullptr) == v) break;
+    }
+    double mag = std::fabs(v);
+    if (mag == 0.0 || (mag >= 1e-4 && mag < 1e15)) {
+        int exp10 = mag == 0.0 ? 0 : (int)std::floor(std::log10(mag));
+        std::snprintf(buf, sizeof(buf), "%.*f", std::max(0, prec - 1 - exp10), v);
+        return buf;
+    }
+    std::snprintf(buf, sizeof(buf), "%.*g", prec, v);
+    return buf;
+}
+
+// -------------------------- TupleCodec --------------------------
+TupleCodec::TupleCodec(const Schema& schema) {
+    const auto& cols = schema.GetColumns();
+    layout.reserve(cols.size());
+    for (const auto& c : cols) {
+        ColumnLayout l{};
+        l.type = c.type;
+        l.is_unsigned = c.unsigned_flag;
+        l.precision = c.type == ColumnType::DECIMAL ? c.length : 0;
+        l.scale = c.type == ColumnType::DECIMAL ? std::max(0, std::min(c.scale, DECIMAL_MAX_DIGITS)) : 0;
+        uint16_t w = fixed_width(c.type);
+        l.is_var = (w == 0);
+        if (l.is_var) {
+            l.pos = var_count++;
+        }
+        else {
+            l.pos = fixed_bytes;
+            fixed_bytes = (uint16_t)(fixed_bytes + w);
+        }
+        layout.push_back(l);
+    }
+    bitmap_bytes = (uint16_t)((cols.size() + 7) / 8);
+}
+
+std::string TupleCodec::normalize_text(const std::string& text) {
+    size_t b = 0, e = text.size();
+    while (b < e && std::isspace((unsigned char)text[b])) ++b;
+    while (e > b && (std::isspace((unsigned char)text[e - 1]) || text[e - 1] == ';')) --e;
+    if (e - b >= 2 && ((text[b] == '\'' && text[e - 1] == '\'') || (text[b] == '"' && text[e - 1] == '"'))) {
+        ++b; --e;
+    }
+    return text.substr(b, e - b);
+}
+
+bool TupleCodec::parse_value(int col, const std::string& text, TupleValue& out, std::string* err) const {
+    out = TupleValue{};
+    if (col < 0 || col >= (int)layout.size()) {
+        if (err) *err = "column index out of range";
+        return false;
+    }
+    const ColumnLayout& l = layout[col];
+    std::string s = normalize_text(text);
+
+    if (l.is_var) {
+        out.is_null = false;
+        out.s = std::move(s);
+        return true;
+    }
+    // 非字符串列：空串与 NULL 为空值
+    if (s.empty() || upper_copy(s) == "NULL") return true;
+
+    bool ok = false;
+    switch (l.type) {
+    case ColumnType::INT:
+    case ColumnType::TINYINT: {
+        int64_t v = 0;
+        ok = parse_integer(s, v);
+        if (ok) {
+            int64_t lo, hi;
+            if (l.type == ColumnType::INT) { lo = l.is_unsigned ? 0 : INT32_MIN; hi = l.is_unsigned ? UINT32_MAX : INT32_MAX; }
+            else { lo = l.is_unsigned ? 0 : INT8_MIN; hi = l.is_unsigned ? UINT8_MAX : INT8_MAX; }
+            ok = v >= lo && v <= hi;
+        }
+        out.i = v;
+        break;
+    }
+    case ColumnType::FLOAT: {
+        char* endp = nullptr;
+        out.d = std::strtod(s.c_str(), &endp);
+        ok = endp == s.c_str() + s.size() && std::isfinite(out.d);
+        break;
+    }
+    case ColumnType::DECIMAL:
+        ok = parse_decimal(s, l.precision, l.scale, out.i);
+        break;
+    case ColumnType::TIMESTAMP: {
+        std::string u = upper_copy(s);
+        if (u == "CURRENT_TIMESTAMP" || u == "NOW()") {
+            out.i = current_timestamp();
+            ok = true;
+        }
+        else {
+            ok = parse_timestamp(s, out.i);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    if (!ok) {
+        if (err) *err = "invalid value '" + s + "' for column " + std::to_string(col);
+        return false;
+    }
+    out.is_null = false;
+    return true;
+}
+
+std::string TupleCodec::format_value(int col, const TupleValue& v) const {
+    if (v.is_null) return std::string();
+    const ColumnLayout& l = layout[col];
+    switch (l.type) {
+    case ColumnType::INT:
+    case ColumnType::TINYINT:   return std::to_string(v.i);
+    case ColumnType::FLOAT:     return format_double(v.d);
+    case ColumnType::DECIMAL:   return format_decimal(v.i, l.scale);
+    case ColumnType::TIMESTAMP: return format_timestamp(v.i);
+    default:                    return v.s;
+    }
+}
+
+bool TupleCodec::encode(const std::vector<std::string>& values, std::string& out, std::string* err) const {
+    const int ncols = (int)layout.size();
+    if ((int)values.size() > ncols) {
+        if (err) *err = "too many values (" + std::to_string(values.size()) + " for " + std::to_string(ncols) + " columns)";
+        return false;
+    }
+
+    // 先解析全部值，任何一列不合法都不产生记录
+    std::vector<TupleValue> vals(ncols);
+    size_t var_bytes = 0;
+    for (int c = 0; c < ncols; ++c) {
+        if (c < (int)values.size() && !parse_value(c, values[c], vals[c], err)) return false;
+        if (layout[c].is_var) var_bytes += vals[c].s.size();
+    }
+    size_t total = (size_t)var_data_offset() + var_bytes;
+    if (total > UINT16_MAX) {
+        if (err) *err = "record too large";
+        return false;
+    }
+
+    out.assign(total, '\0');
+    char* base = &out[0];
+    uint16_t n = (uint16_t)ncols;
+    std::memcpy(base, &n, 2);
+    char* bitmap = base + 2;
+    char* fixed = bitmap + bitmap_bytes;
+    char* var_table = base + var_table_offset();
+    char* var_data = base + var_data_offset();
+
+    uint16_t var_end = 0;
+    for (int c = 0; c < ncols; ++c) {
+        const ColumnLayout& l = layout[c];
+        const TupleValue& v = vals[c];
+        if (v.is_null) bitmap[c / 8] |= (char)(1u << (c % 8));
+        if (l.is_var) {
+            std::memcpy(var_data + var_end, v.s.data(), v.s.size());
+            var_end = (uint16_t)(var_end + v.s.size());
+            std::memcpy(var_table + 2 * l.pos, &var_end, 2);
+            continue;
+        }
+        if (v.is_null) continue; // 定长区保持为0
+        char* dst = fixed + l.pos;
+        switch (l.type) {
+        case ColumnType::INT:
+            if (l.is_unsigned) { uint32_t x = (uint32_t)v.i; std::memcpy(dst, &x, 4); }
+            else { int32_t x = (int32_t)v.i; std::memcpy(dst, &x, 4); }
+            break;
+        case ColumnType::TINYINT:
+            if (l.is_unsigned) { uint8_t x = (uint8_t)v.i; std::memcpy(dst, &x, 1); }
+            else { int8_t x = (int8_t)v.i; std::memcpy(dst, &x, 1); }
+            break;
+        case ColumnType::FLOAT:
+            std::memcpy(dst, &v.d, 8);
+            break;
+        default: // DECIMAL / TIMESTAMP
+            std::memcpy(dst, &v.i, 8);
+            break;
+        }
+    }
+    return true;
+}
+
+// -------------------------- TupleView --------------------------
+TupleView::TupleView(const TupleCodec& c, const char* d, uint32_t l)
+    : codec(c), data(d), len(l), ok(false) {
+    if (!data || len < codec.var_data_offset()) return;
+    uint16_t n = 0;
+    std::memcpy(&n, data, 2);
+    if (n != codec.layout.size()) return;
+    // 最后一个变长列的结束偏移必须落在记录内
+    if (codec.var_count > 0) {
+        uint16_t last = 0;
+        std::memcpy(&last, data + codec.var_table_offset() + 2 * (codec.var_count - 1), 2);
+        if ((uint32_t)codec.var_data_offset() + last > len) return;
+    }
+    ok = true;
+}
+
+bool TupleView::is_null(int col) const {
+    const char* bitmap = data + 2;
+    return (bitmap[col / 8] >> (col % 8)) & 1;
+}
+
+int64_t TupleView::get_int(int col) const {
+    const auto& l = codec.layout[col];
+    const char* src = data + 2 + codec.bitmap_bytes + l.pos;
+    switch (l.type) {
+    case ColumnType::INT:
+        if (l.is_unsigned) { uint32_t x; std::memcpy(&x, src, 4); return x; }
+        else { int32_t x; std::memcpy(&x, src, 4); return x; }
+    case ColumnType::TINYINT:
+        if (l.is_unsigned) { uint8_t x; std::memcpy(&x, src, 1); return x; }
+        else { int8_t x; std::memcpy(&x, src, 1); return x; }
+    case ColumnType::DECIMAL:
+    case ColumnType::TIMESTAMP: {
+        int64_t x; std::memcpy(&x, src, 8); return x;
+    }
+    default:
+        return 0;
+    }
+}
+
+double TupleView::get_double(int col) const {
+    const auto& l = codec.layout[col];
+    if (l.type != ColumnType::FLOAT) return (double)get_int(col);
+    double x;
+    std::memcpy(&x, data + 2 + codec.bitmap_bytes + l.pos, 8);
+    return x;
+}
+
+std::string_view TupleView::get_string(int col) const {
+    const auto& l = codec.layout[col];
+    if (!l.is_var) return std::string_view();
+    const char* var_table = data + codec.var_table_offset();
+    uint16_t begin = 0, end = 0;
+    if (l.pos > 0) std::memcpy(&begin, var_table + 2 * (l.pos - 1), 2);
+    std::memcpy(&end, var_table + 2 * l.pos, 2);
+    if (end < begin) return std::string_view();
+    return std::string_view(data + codec.var_data_offset() + begin, end - begin);
+}
+
+void TupleView::get_value(int col, TupleValue& out) const {
+    out = TupleValue{};
+    if (is_null(col)) return;
+    out.is_null = false;
+    const auto& l = codec.layout[col];
+    if (l.is_var) out.s.assign(get_string(col));
+    else if (l.type == ColumnType::FLOAT) out.d = get_double(col);
+    else out.i = get_int(col);
+}
+
+bool TupleView::equals(int col, const TupleValue& v) const {
+    bool n = is_null(col);
+    if (n || v.is_null) return n == v.is_null;
+    const auto& l = codec.layout[col];
+    if (l.is_var) return get_string(col) == v.s;
+    if (l.type == ColumnType::FLOAT) return get_double(col) == v.d;
+    return get_int(col) == v.i;
+}
+
+bool TupleView::compare(int col, const TupleValue& v, int& cmp) const {
+    if (is_null(col) || v.is_null) return false;
+    const auto& l = codec.layout[col];
+    if (l.is_var) {
+        int c = get_string(col).compare(v.s);
+        cmp = c < 0 ? -1 : (c > 0 ? 1 : 0);
+    }
+    else if (l.type == ColumnType::FLOAT) {
+        double a = get_double(col);
+        cmp = a < v.d ? -1 : (a > v.d ? 1 : 0);
+    }
+    else {
+        int64_t a = get_int(col);
+        cmp = a < v.i ? -1 : (a > v.i ? 1 : 0);
+    }
+    return true;
+}
+
+std::string TupleView::to_text(int col) const {
+    TupleValue v;
+    get_value(col, v);
+    if (codec.layout[col].is_var) return std::move(v.s);
+    return codec.format_value(col, v);
+}
+
+void TupleView::decode(std::vector<std::string>& out) const {
+    out.resize(codec.layout.size());
+    for (int c = 0; c < (int)codec.layout.size(); ++c) {
+        if (codec.layout[c].is_var && !is_null(c)) out[c].assign(get_string(c));
+        else out[c] = to_text(c);
+    }
+}
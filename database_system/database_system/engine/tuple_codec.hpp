@@ -0,0 +1,105 @@
+// =============================================
+// engine/tuple_codec.hpp
+// =============================================
+// 按表模式（Schema）编码/解码二进制元组，取代逗号拼接的文本行
+//
+// 记录布局：
+//   [uint16 列数][空值位图 ceil(列数/8) 字节][定长区][uint16 变长列结束偏移 × 变长列数][变长数据]
+//   定长区按列顺序存放数值/时间列（空值列同样占位，内容为0）：
+//     INT       4 字节（UNSIGNED 时按 uint32 解释）
+//     TINYINT   1 字节（UNSIGNED 时按 uint8 解释）
+//     FLOAT     8 字节 double
+//     DECIMAL   8 字节 int64，按 10^scale 放大后的定点数
+//     TIMESTAMP 8 字节 int64，(秒数 << 1) | 是否带时分秒（不做时区换算）
+//   CHAR/VARCHAR 为变长列：结束偏移相对变长数据起点，第 i 列起点即第 i-1 列的结束偏移
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "catalog_manager.hpp"
+
+// 一个字段的类型化值（用于谓词常量：只解析一次，扫描时直接与二进制字段比较）
+struct TupleValue {
+    bool        is_null{ true };
+    int64_t     i{ 0 };         // INT/TINYINT/DECIMAL（放大后）/TIMESTAMP（编码后）
+    double      d{ 0 };         // FLOAT
+    std::string s;              // CHAR/VARCHAR
+};
+
+class TupleView;
+
+class TupleCodec {
+public:
+    explicit TupleCodec(const Schema& schema);
+
+    int column_count() const { return (int)layout.size(); }
+
+    // 一行文本值 -> 二进制记录（values 少于列数时缺的列按 NULL 处理）
+    // 值与列类型不符时返回 false，err 中给出原因
+    bool encode(const std::vector<std::string>& values, std::string& out, std::string* err = nullptr) const;
+
+    // 把一个文本值按第 col 列的类型解析（空串、非字符串列上的 NULL 视为空值）
+    bool parse_value(int col, const std::string& text, TupleValue& out, std::string* err = nullptr) const;
+
+    // 把一个类型化值格式化为文本（与 SelectAll 返回的字符串一致）
+    std::string format_value(int col, const TupleValue& v) const;
+
+    // 按旧 CSV 行的规则整理文本值：去首尾空白（及尾部分号），去成对的首尾引号
+    static std::string normalize_text(const std::string& text);
+
+private:
+    friend class TupleView;
+
+    struct ColumnLayout {
+        ColumnType type;
+        bool       is_unsigned;
+        int        precision;   // DECIMAL 精度（0 表示不限，最多 18 位）
+        int        scale;       // DECIMAL 小数位
+        bool       is_var;      // CHAR/VARCHAR
+        uint16_t   pos;         // 定长列：定长区内偏移；变长列：变长列序号
+    };
+
+    std::vector<ColumnLayout> layout;
+    uint16_t bitmap_bytes{ 0 };
+    uint16_t fixed_bytes{ 0 };
+    uint16_t var_count{ 0 };
+
+    // 变长列结束偏移表在记录中的起点
+    uint16_t var_table_offset() const { return (uint16_t)(2 + bitmap_bytes + fixed_bytes); }
+    // 变长数据在记录中的起点
+    uint16_t var_data_offset() const { return (uint16_t)(var_table_offset() + 2 * var_count); }
+};
+
+// 只读元组视图：直接指向页内（或映射内）的记录字节，不做拷贝
+// 视图只在记录所在页未被修改/替换期间有效
+class TupleView {
+public:
+    TupleView(const TupleCodec& codec, const char* data, uint32_t len);
+
+    // 记录列数与模式一致且长度足够
+    bool valid() const { return ok; }
+
+    bool is_null(int col) const;
+    // INT/TINYINT/DECIMAL（放大后）/TIMESTAMP（编码后）
+    int64_t get_int(int col) const;
+    double get_double(int col) const;
+    std::string_view get_string(int col) const;
+
+    // 读出一列为类型化值
+    void get_value(int col, TupleValue& out) const;
+    // 与类型化值比较是否相等（空值只与空值相等）
+    bool equals(int col, const TupleValue& v) const;
+    // 与类型化值比较大小，cmp 为 -1/0/1（字符串按字节序）；任一方为空值时不可比较，返回 false
+    bool compare(int col, const TupleValue& v, int& cmp) const;
+
+    // 一列格式化为文本 / 整行格式化为文本（空值为空串）
+    std::string to_text(int col) const;
+    void decode(std::vector<std::string>& out) const;
+
+private:
+    const TupleCodec& codec;
+    const char* data;
+    uint32_t len;
+    bool ok;
+};
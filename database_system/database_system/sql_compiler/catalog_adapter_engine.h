@@ -1,10 +1,10 @@
 // =============================================
 // sql_compiler/catalog_adapter_engine.h
-// 棺ʵ ICatalog ӿ
+// 修正版：实现 ICatalog 完整接口
 // =============================================
 #pragma once
-#include "catalog_iface.h"                // Ŀ ICatalog ӿ
-#include "../engine/catalog_manager.hpp"  // ѵ Catalog / CatalogManager
+#include "catalog_iface.h"                // 你项目里的 ICatalog 接口
+#include "../engine/catalog_manager.hpp"  // 队友的 Catalog / CatalogManager
 #include <optional>
 #include <string>
 #include <vector>
@@ -23,7 +23,7 @@ namespace minidb {
         CatalogEngineAdapter(CatalogManager& mgr, Catalog& cat)
             : mgr_(mgr), cat_(cat) {}
 
-        // ע⣺ const Աǩ ICatalog ȫһ
+        // 注意：这里是 const 成员函数，签名需与 ICatalog 完全一致
         std::optional<TableDef> get_table(const std::string& name) const override {
             TableInfo* ti = const_cast<Catalog&>(cat_).GetTable(name);
             if (!ti) return std::nullopt;
@@ -35,9 +35,9 @@ namespace minidb {
             return td;
         }
 
-        // ׶οõĽеͬѧ/עᣩ
+        // 供语义阶段可能用到的建表（有的同学在语义里会检查/注册）
         Status create_table(const TableDef& tdef) override {
-            std::vector<::Column> cols;  // עʹ ::Columnȫ֣
+            std::vector<::Column> cols;  // 注意使用 ::Column（全局）
             cols.reserve(tdef.columns.size());
             for (auto& c : tdef.columns) {
                 cols.emplace_back(c.name, to_engine_type(c.type), /*length*/64);
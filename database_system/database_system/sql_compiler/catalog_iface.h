@@ -7,7 +7,7 @@
 
 namespace minidb {
 
-    // Ŀ¼ӿڣС
+    // 抽象目录接口（语义分析最小需求）
     class ICatalog {
     public:
         virtual ~ICatalog() = default;
@@ -15,7 +15,7 @@ namespace minidb {
         virtual Status create_table(const TableDef& t) = 0;
     };
 
-    //  sql_compiler ڴʵ֣СдУ
+    // 仅用于 sql_compiler 独立联调的内存实现（大小写不敏感）
     class InMemoryCatalog : public ICatalog {
     public:
         std::optional<TableDef> get_table(const std::string& name) const override {
@@ -26,12 +26,12 @@ namespace minidb {
         Status create_table(const TableDef& t) override {
             std::string key = to_lower(t.name);
             if (tables_.count(key)) return Status::Error("Table exists");
-            tables_[key] = t; // ʵ TableDef.name 
+            tables_[key] = t; // 实名保存在 TableDef.name 内
             return Status::OK();
         }
         void clear() { tables_.clear(); }
     private:
-        std::unordered_map<std::string, TableDef> tables_; // key ΪСд
+        std::unordered_map<std::string, TableDef> tables_; // key 为小写表名
     };
 
 } // namespace minidb
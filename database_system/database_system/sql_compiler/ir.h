@@ -1,5 +1,5 @@
 // =============================================
-// sql_compiler/ir.h   Ԫʽ IR׶β
+// sql_compiler/ir.h  —— 四元式 IR（语义阶段产生）
 // =============================================
 #pragma once
 #include "../utils/common.h"
@@ -17,7 +17,7 @@ namespace minidb {
 
     struct IR {
         std::vector<Quad> quads;
-        // ͳһӡ  [i] (op, arg1, arg2, result)
+        // 统一打印：  [i] (op, arg1, arg2, result)
         void print(std::ostream& os) const {
             for (size_t i = 0; i < quads.size(); ++i) {
                 const auto& q = quads[i];
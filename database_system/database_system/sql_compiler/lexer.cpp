@@ -1,5 +1,5 @@
 // =============================================
-// sql_compiler/lexer.cpp ʷ
+// sql_compiler/lexer.cpp 词法分析
 // =============================================
 #include "lexer.h"
 #include <cassert>
@@ -10,26 +10,26 @@ namespace minidb {
     static std::unordered_set<std::string> KW = {
         "SELECT","FROM","WHERE","CREATE","TABLE",
         "INSERT","INTO","VALUES","DELETE",
-        // DML/ѯչ
+        // DML/查询扩展
         "UPDATE","SET",
         "JOIN","INNER","LEFT","RIGHT","FULL","ON",
         "ORDER","BY","GROUP","HAVING","ASC","DESC",
         "LIMIT",
-        // ޸Ĺؼ
+        // 新增（本次修复的关键）
         "DROP","IF","EXISTS",
-        // 
+        // 类型
         "INT","TINYINT","CHAR","VARCHAR","DECIMAL","TIMESTAMP","FLOAT",
-        //  KW ﲹ루ûӣ
-        "SHOW","USE","DATABASE","DATABASES","TABLES","DESCRIBE", // DESC Ѿе ORDER 
+        // 在 KW 集合里补齐（如果还没加）：
+        "SHOW","USE","DATABASE","DATABASES","TABLES","DESCRIBE", // DESC 已经有但在 ORDER 场景
         "ALTER","RENAME","TO","CHAR","AFTER"
-        // ߼ / Լ
+        // 逻辑 / 约束
         "AND","OR","NOT","NULL","UNSIGNED","DEFAULT","COMMENT",
         "PRIMARY","KEY","AUTO_INCREMENT",
     };
 
     bool is_keyword_upper(const std::string& up) { return KW.count(up) > 0; }
 
-    // ߣ TokenType ӳΪγԪʽ LexCategory
+    // 工具：把 TokenType 映射为“课程四元式”的 LexCategory
     static LexCategory category_of(TokenType t, const std::string& lexeme_upper) {
         switch (t) {
         case TokenType::IDENT:     return LexCategory::IDENTIFIER;
@@ -53,7 +53,7 @@ namespace minidb {
         case TokenType::END:       return LexCategory::UNKNOWN;
         case TokenType::INVALID:   return LexCategory::UNKNOWN;
 
-        case TokenType::KEYWORD:   // ؼ ident_or_kw 
+        case TokenType::KEYWORD:   // 关键字在 ident_or_kw 里设置
             return LexCategory::KEYWORD;
         }
         return LexCategory::UNKNOWN;
@@ -67,18 +67,18 @@ namespace minidb {
         }
     }
 
-    // հ/עͣ /* ... */ 
+    // 空白/注释：加入对 /* ... */ 的跳过
     void Lexer::skip_ws() {
         while (i_ < s_.size()) {
             char c = s_[i_];
-            // -- ע
+            // -- 行注释
             if (c == '-' && i_ + 1 < s_.size() && s_[i_ + 1] == '-') {
                 while (i_ < s_.size() && s_[i_] != '\n') adv();
                 continue;
             }
-            // /* ע */
+            // /* 块注释 */
             if (c == '/' && i_ + 1 < s_.size() && s_[i_ + 1] == '*') {
-                adv(); adv(); // Ե "/*"
+                adv(); adv(); // 吃掉 "/*"
                 while (i_ < s_.size()) {
                     if (s_[i_] == '*' && i_ + 1 < s_.size() && s_[i_ + 1] == '/') { adv(); adv(); break; }
                     adv();
@@ -90,16 +90,16 @@ namespace minidb {
         }
     }
 
-    //  keep_comments_==trueҵǰλעͣͷ COMMENT token򷵻 nullopt
+    // 如果 keep_comments_==true，并且当前位置是注释，就返回 COMMENT token；否则返回 nullopt
     std::optional<Token> Lexer::try_comment() {
         int sl = line_, sc = col_;
-        // ע
+        // 行注释
         if (look() == '-' && look_ahead(1) == '-') {
             std::string buf;
             while (i_ < s_.size() && look() != '\n') { buf.push_back(look()); adv(); }
             return Token{ TokenType::COMMENT, buf, sl, sc };
         }
-        // ע֧ͣǶף
+        // 块注释（不支持嵌套）
         if (look() == '/' && look_ahead(1) == '*') {
             std::string buf;
             buf.push_back(look()); adv();
@@ -142,49 +142,49 @@ namespace minidb {
         int sl = line_, sc = col_;
         std::string buf;
 
-        // 
+        // 整数部分
         while (i_ < s_.size() && std::isdigit((unsigned char)look())) {
             buf.push_back(look()); adv();
         }
 
-        // ѡС
+        // 可选：小数部分
         if (i_ < s_.size() && look() == '.') {
-            // ȿһ֣ '.' ظϲΪ token
+            // 先看后面至少有一个数字，否则把 '.' 交回给上层作为单独 token
             if (std::isdigit((unsigned char)look_ahead(1))) {
-                buf.push_back(look()); adv(); // Ե '.'
+                buf.push_back(look()); adv(); // 吃掉 '.'
                 while (i_ < s_.size() && std::isdigit((unsigned char)look())) {
                     buf.push_back(look()); adv();
                 }
-                //  Parser/ASTСĳԡַ
-                //  UPDATE/INSERT  66.66 ᱻ STRCONSTִʱֵȽ
+                // 不动 Parser/AST：带小数的常量以“字符串常量”交回
+                // 这样 UPDATE/INSERT 里的 66.66 会被当作 STRCONST，后端执行时会做数值比较
                 return Token{ TokenType::STRCONST, buf, sl, sc, LexCategory::CONSTANT };
             }
-            // Ͱֵ INTCONST أ'.' ϲ㴦
+            // 否则就把整数部分当 INTCONST 返回，'.' 留给上层处理
         }
 
         return Token{ TokenType::INTCONST, buf, sl, sc, LexCategory::CONSTANT };
     }
 
 
-    // ֧֣
-    // 1) бת壺\' \\ \n \t ...
-    // 2) SQL ת壺'' -> һ
-    // ԭȵ string() Ϊת
+    // 支持：
+    // 1) 反斜杠转义：\' \\ \n \t ...
+    // 2) SQL 单引号转义：'' -> 一个单引号
+    // 原先的 string() 定义改为简单转调：
     Token Lexer::string() {
         return string_with('\'');
     }
 
     Token Lexer::string_with(char quote_char) {
         int sl = line_, sc = col_;
-        // ǰ look()==quote_char
-        adv(); // Ե
+        // 当前 look()==quote_char
+        adv(); // 吃掉开引号
         std::string buf;
         bool closed = false;
 
         while (i_ < s_.size()) {
             char c = look();
             if (c == '\\') {
-                // C ת
+                // C 风格转义
                 adv();
                 char e = look();
                 switch (e) {
@@ -199,12 +199,12 @@ namespace minidb {
                 continue;
             }
             if (c == quote_char) {
-                // SQL ''  "" -> һ
+                // SQL 风格：'' 或 "" -> 一个引号
                 if (look_ahead(1) == quote_char) {
                     buf.push_back(quote_char); adv(); adv();
                     continue;
                 }
-                // ر
+                // 关闭
                 adv();
                 closed = true;
                 break;
@@ -223,7 +223,7 @@ namespace minidb {
         if (has_) { has_ = false; return la_; }
 
         if (keep_comments_) {
-            // עͣհףעͣٳԶע
+            // 保留注释：先跳过空白（不跨过注释），再尝试读注释
             while (i_ < s_.size() && std::isspace((unsigned char)look())) adv();
             if (auto com = try_comment(); com.has_value()) return *com;
         }
@@ -233,24 +233,24 @@ namespace minidb {
 
         if (i_ >= s_.size()) return { TokenType::END, "", line_, col_ };
 
-        if (keep_comments_) { // ٳһעͣ׾עͣ
+        if (keep_comments_) { // 再尝试一次注释（例如行首就是注释）
             if (auto com = try_comment(); com.has_value()) return *com;
         }
 
         int sl = line_, sc = col_;
         char c = look();
 
-        // ʶ/ؼ
+        // 标识符/关键字
         if (std::isalpha((unsigned char)c) || c == '_') {
             return ident_or_kw();
         }
 
-        // 
+        // 常数（仅整数）
         if (std::isdigit((unsigned char)c)) {
             return number();
         }
 
-        // ַ / ˫ַ & ָ
+        // 单字符 / 双字符运算符 & 分隔符
         switch (c) {
         case ',': adv(); return make_simple(TokenType::COMMA, ",", sl, sc, LexCategory::DELIMITER);
         case ';': adv(); return make_simple(TokenType::SEMI, ";", sl, sc, LexCategory::DELIMITER);
@@ -265,7 +265,7 @@ namespace minidb {
         case '+': adv(); return make_simple(TokenType::PLUS, "+", sl, sc, LexCategory::OPERATOR);
         case '-':
             if (look_ahead(1) == '-' && keep_comments_ == false) {
-                // עͣ keep=false  skip_ws ûԵļΣԵβȡ token
+                // 行注释（在 keep=false 且 skip_ws 没吃掉的极端情形），吃到行尾并再取 token
                 while (i_ < s_.size() && look() != '\n') adv();
                 return next();
             }
@@ -275,7 +275,7 @@ namespace minidb {
         case '*': adv(); return make_simple(TokenType::STAR, "*", sl, sc, LexCategory::OPERATOR);
         case '/':
             if (look_ahead(1) == '*' && keep_comments_ == false) {
-                // עͣԵ next skip_ws Ѿ
+                // 块注释；吃掉再 next（理论上 skip_ws 已经处理）
                 adv(); adv();
                 while (i_ < s_.size()) {
                     if (look() == '*' && look_ahead(1) == '/') { adv(); adv(); break; }
@@ -299,11 +299,11 @@ namespace minidb {
             if (look_ahead(1) == '=') { adv(); adv(); return make_simple(TokenType::GE, ">=", sl, sc, LexCategory::OPERATOR); }
             adv(); return make_simple(TokenType::GT, ">", sl, sc, LexCategory::OPERATOR);
 
-        case '\'': return string();                 // űֲ
-        case '"':  return string_with('"');         // ˫
+        case '\'': return string();                 // 单引号保持不变
+        case '"':  return string_with('"');         // 新增：双引号
         }
 
-        // Ƿַ
+        // 其它非法字符
         adv();
         return Token{ TokenType::INVALID, "Unexpected character", sl, sc, LexCategory::UNKNOWN };
     }
@@ -1,5 +1,5 @@
 // =============================================
-// sql_compiler/parser.cpp ﷨
+// sql_compiler/parser.cpp 语法分析
 // =============================================
 #define MINIDB_IMPL_PARSER
 #include "parser.h"
@@ -8,7 +8,7 @@
 
 namespace minidb {
 
-    // ---------- С ----------
+    // ---------- 小工具 ----------
     static std::string pos_str(const Token& tk) {
         std::ostringstream os;
         os << tk.line << ":" << tk.col;
@@ -44,14 +44,14 @@ namespace minidb {
         return true;
     }
 
-    // ---------- ʷǰհ ----------
+    // ---------- 词法前瞻 ----------
     Token Parser::cur() {
         if (!has_) { t_ = lx_.next(); has_ = true; }
         return t_;
     }
     bool Parser::is(TokenType t) { return cur().type == t; }
 
-    // Щƥ亯**ֻıα**ٴӡ־ͳһ trace_match ɶ־
+    // 这些匹配函数现在**只改变游标**，不再打印日志；统一由 trace_match 输出人类可读日志
     bool Parser::accept(TokenType t) {
         Token tk = cur();
         if (tk.type == t) { has_ = false; return true; }
@@ -93,7 +93,7 @@ namespace minidb {
             << " : expected " << expected_msg
             << ", got \"" << tk.lexeme << "\"";
         st = Status::Error(os.str());
-        // ׷һд󣨲ǿƣŲ飩
+        // 追踪一行错误（不强制，但便于排查）
         if (trace_on_) {
             ++step_;
             std::cout << "[" << step_ << "] "
@@ -101,10 +101,10 @@ namespace minidb {
                 << ", ERROR " << expected_msg
                 << " but got \"" << tk.lexeme << "\"]\n";
         }
-        sync_to_semi(); // ؼͬ ';'
+        sync_to_semi(); // 关键：同步到 ';'
     }
 
-    // ============  ============
+    // ============ 跟踪输出 ============
     void Parser::trace_print_header_once() {
         if (!trace_on_ || printed_header_) return;
         printed_header_ = true;
@@ -116,13 +116,13 @@ namespace minidb {
         s += "]";
         return s;
     }
-    // ʾջӡ "';'" ѺûΪ ";"
+    // 新增：显示栈“反向打印”，并把 "';'" 友好化输出为 ";"
     static std::string join_vec_rev(const std::vector<std::string>& v) {
         auto fmt = [](const std::string& x) -> std::string {
-            return (x == "';'") ? ";" : x;  // ȥֺŵţ
+            return (x == "';'") ? ";" : x;  // 仅去掉分号的引号，其他保持
             };
         std::string s = "[";
-        // ջջң PPT չʾ
+        // 反向输出：栈底在左，栈顶在右（符合 PPT 展示）
         for (size_t k = 0; k < v.size(); ++k) {
             const std::string& sym = v[v.size() - 1 - k];
             s += fmt(sym);
@@ -132,37 +132,37 @@ namespace minidb {
         return s;
     }
     std::string Parser::snapshot_input_until_semi() {
-        // 1) ȱʷ״̬ lookahead
+        // 1) 先保存词法器的完整状态（含其自身 lookahead）
         auto saved = lx_.save();
 
         auto fmt = [](const Token& t) -> std::string {
             if (t.type == TokenType::KEYWORD) return t.lexeme;
             if (t.type == TokenType::IDENT)   return std::string("ID:") + t.lexeme;
-            return t.lexeme; //  ",", "(", ")", ";", 
+            return t.lexeme; // 包含 ",", "(", ")", ";", 常量等
             };
 
         std::vector<std::string> parts;
 
-        // 2) ǰšԴֻӰʵα꣩
-        //    -  Parser ǰհ棨has_==trueǰž t_
-        //      ʱ Lexer ڲαѾ t_ ֮ˣֱӴӵǰλüӺ token
-        //    -  Parser ûл棨has_==false Lexer.peek() ȿһΪǰţ
-        //      Ȼʱ next() һ°ԵӺ token
-        bool used_parser_cache = has_;   // סǷʹ Parser  t_ Ϊǰ
+        // 2) 决定“当前符号”的来源（只读，不影响真实游标）
+        //    - 若 Parser 里已有前瞻缓存（has_==true），当前符号就是 t_；
+        //      此时 Lexer 的内部游标已经在 t_ 之后了，所以直接从当前位置继续窥视后续 token。
+        //    - 若 Parser 里没有缓存（has_==false），用 Lexer.peek() 先看一眼作为当前符号，
+        //      然后临时 next() 一下把它“吃掉”，继续窥视后续 token。
+        bool used_parser_cache = has_;   // 记住我们是否使用了 Parser 的 t_ 作为当前符号
         if (used_parser_cache) {
-            // ǰž t_Ҫ Parser::cur()ֻӡ
+            // 当前符号就是 t_，不要调用 Parser::cur()；只打印
             parts.push_back(fmt(t_));
-            // ע⣺ʱ lx_ ״̬Ѿ t_ ֮Ϊù Parser::cur()  t_ ȡˣ
-            // ֱӼ
+            // 注意：此时 lx_ 的状态已经在 t_ 之后（因为当初调用过 Parser::cur() 把 t_ 取出来了）
+            // 所以直接向后窥视即可
         }
         else {
-            // û parser 棬ôʷ peek() һ
-            Token first = lx_.peek();          // ıʷλãԼ la_
+            // 没有 parser 缓存，用词法器的 peek() 看一眼
+            Token first = lx_.peek();          // 不改变词法器的位置（有自己的 la_）
             parts.push_back(fmt(first));
-            (void)lx_.next();                  // ʱǰһ֮ restore 
+            (void)lx_.next();                  // 临时前进一步，之后会 restore 回来
         }
 
-        // 3) ڡʱƽĻ ';' ENDΪֹ
+        // 3) 在“临时推进”的环境里，继续看到 ';'（或 END）为止
         while (true) {
             Token t = lx_.next();
             if (t.type == TokenType::END) break;
@@ -170,10 +170,10 @@ namespace minidb {
             if (t.type == TokenType::SEMI) break;
         }
 
-        // 4) ԭʷǰ״̬Ӱ Parser  has_/t_
+        // 4) 还原词法器到窥视前的状态（不影响 Parser 的 has_/t_）
         lx_.restore(saved);
 
-        // 5) װʾ
+        // 5) 组装显示串
         std::string s = "(";
         for (size_t i = 0; i < parts.size(); ++i) {
             if (i) s += " ";
@@ -183,11 +183,11 @@ namespace minidb {
         return s;
     }
 
-    //  ѡոƥ tokenΪյĵһԪʾ
+    // ★ 新增：把“刚刚匹配的 token”作为快照的第一个元素显示出来
     void Parser::trace_match_tok(const Token& matched, const std::string& what) {
         if (!trace_on_) return;
 
-        // 1) ʷ״̬
+        // 1) 保存词法器状态
         auto saved = lx_.save();
 
         auto fmt = [](const Token& t) -> std::string {
@@ -196,11 +196,11 @@ namespace minidb {
             return t.lexeme;
             };
 
-        // 2)  partsȷšոƥ tokenƴӡ˿ʣ롱ӵǰʷλÿӣ
+        // 2) 构造 parts：先放“刚刚匹配的 token”，再拼接“此刻剩余输入”（从当前词法位置窥视）
         std::vector<std::string> parts;
         parts.push_back(fmt(matched));
 
-        // ʱƽֱ ';'  ENDע⣺ֻôʷ restore
+        // 临时推进窥视直到 ';' 或 END（注意：只用词法器，最后 restore）
         while (true) {
             Token t = lx_.next();
             if (t.type == TokenType::END) break;
@@ -210,7 +210,7 @@ namespace minidb {
 
         lx_.restore(saved);
 
-        // 3) װַ
+        // 3) 组装字符串
         std::string snap = "(";
         for (size_t i = 0; i < parts.size(); ++i) {
             if (i) snap += " ";
@@ -218,12 +218,12 @@ namespace minidb {
         }
         snap += ")";
 
-        // 4) ӡһ
+        // 4) 打印一步
         ++step_;
         std::cout << "[" << step_ << "] " << join_vec_rev(stack_) << ", "
-            << snap << ", ƥ " << what << "]\n";
+            << snap << ", 匹配 " << what << "]\n";
 
-        // 5) ջһҲŶӦ
+        // 5) 栈弹出一个（与右部符号对应）
         if (!stack_.empty()) stack_.pop_back();
     }
 
@@ -237,12 +237,12 @@ namespace minidb {
         ++step_;
 
         std::cout << "[" << step_ << "] " << join_vec_rev(stack_) << ", "
-            << snapshot_input_until_semi() << ", (" << rule_no << ") " << rule << "]\n";
+            << snapshot_input_until_semi() << ", 用(" << rule_no << ") " << rule << "]\n";
 
-        // 󲿣stack_ ǽҪչķս
+        // 弹出左部（stack_ 顶就是将要展开的非终结符）
         if (!stack_.empty()) stack_.pop_back();
 
-        //  "A -> B C ';'" Ҳѹʾջ
+        // 解析 "A -> B C ';'" 的右部，逆序压入显示栈
         auto p = rule.find("->");
         std::string rhs = (p == std::string::npos) ? "" : trim(rule.substr(p + 2));
         std::istringstream iss(rhs);
@@ -256,18 +256,18 @@ namespace minidb {
         if (!trace_on_) return;
         ++step_;
         std::cout << "[" << step_ << "] " << join_vec_rev(stack_) << ", "
-            << snapshot_input_until_semi() << ", ƥ " << what << "]\n";
-        // һʾջԪأջҲŶӦ
+            << snapshot_input_until_semi() << ", 匹配 " << what << "]\n";
+        // 弹出一个显示栈元素（与我们上面入栈的右部符号对应）
         if (!stack_.empty()) stack_.pop_back();
     }
     void Parser::trace_accept() {
         if (!trace_on_) return;
         ++step_;
         std::cout << "[" << step_ << "] " << join_vec_rev(stack_) << ", "
-            << snapshot_input_until_semi() << ", (Accept)]\n";
+            << snapshot_input_until_semi() << ", 接受(Accept)]\n";
     }
 
-    // ---------- ָͬ ----------
+    // ---------- 同步恢复 ----------
     void Parser::sync_to_semi() {
         while (true) {
             Token tk = cur();
@@ -277,7 +277,7 @@ namespace minidb {
         }
     }
 
-    // ----------  ----------
+    // ---------- 顶层 ----------
     StmtPtr Parser::parse_statement(Status& st) {
         clear_trace();
         printed_header_ = false;
@@ -294,7 +294,7 @@ namespace minidb {
         if (tk.lexeme == "INSERT") return parse_insert(st);
         if (tk.lexeme == "SELECT") return parse_select(st);
         if (tk.lexeme == "DELETE") return parse_delete(st);
-        if (tk.lexeme == "UPDATE") return parse_update(st);   // <== 
+        if (tk.lexeme == "UPDATE") return parse_update(st);   // <== 新增
         if (tk.lexeme == "DROP")   return parse_drop(st);
 
         st = Status::Error("Unknown statement at " + pos_str(tk) + " : " + tk.lexeme);
@@ -306,7 +306,7 @@ namespace minidb {
     StmtPtr Parser::parse_create(Status& st) {
         if (trace_on_) {
             std::cout
-                << " ============== 嵥 ==============\n"
+                << " ============== 规则清单 ==============\n"
                 << "(1) Prog -> Create ';'\n"
                 << "(2) Create -> CREATE TABLE ID '(' ColDefs ')'\n"
                 << "(3) ColDefs -> ColDef (',' ColDef)*\n"
@@ -315,7 +315,7 @@ namespace minidb {
         }
 
         trace_push("Prog");
-        trace_use_rule(1, "Prog -> Create ';'");              // չ Prog
+        trace_use_rule(1, "Prog -> Create ';'");              // 展开 Prog
         trace_use_rule(2, "Create -> CREATE TABLE ID '(' ColDefs ')'");
 
         // CREATE
@@ -326,7 +326,7 @@ namespace minidb {
         Token kwTable = expect_kw("TABLE", st, "TABLE"); if (!st.ok) return nullptr;
         trace_match_tok(kwTable, "TABLE");
 
-        // 
+        // 表名
         Token name = expect(TokenType::IDENT, st, "table name"); if (!st.ok) return nullptr;
         trace_match_tok(name, "ID(" + name.lexeme + ")");
 
@@ -356,7 +356,7 @@ namespace minidb {
             else if (ty.lexeme == "VARCHAR") {
                 dt = DataType::VARCHAR;
 
-                // ֳдVARCHAR(64)  VARCHAR 64
+                // 兼容两种长度写法：VARCHAR(64) 或 VARCHAR 64
                 if (is(TokenType::LPAREN)) {
                     // VARCHAR(64)
                     Token lp = expect(TokenType::LPAREN, st, "'('");
@@ -365,24 +365,24 @@ namespace minidb {
 
                     Token len = expect(TokenType::INTCONST, st, "varchar length");
                     if (!st.ok) return nullptr;
-                    // ʱѳȵһͨչʾ
+                    // 跟踪时把长度当作一个普通数字展示
                     trace_match_tok(len, len.lexeme);
 
                     Token rp = expect(TokenType::RPAREN, st, "')'");
                     if (!st.ok) return nullptr;
                     trace_match_tok(rp, "')'");
-                    // ǰʵֲʹóֵɺ len.lexeme
+                    // 当前实现不使用长度值，可忽略 len.lexeme
                 }
                 else if (is(TokenType::INTCONST)) {
                     // VARCHAR 64
                     Token len = expect(TokenType::INTCONST, st, "varchar length");
                     if (!st.ok) return nullptr;
                     trace_match_tok(len, len.lexeme);
-                    // ͬԾ峤
+                    // 同样忽略具体长度
                 }
                 else {
-                    // ǿҪдȣд VARCHARҲڴ˷ſ
-                    // ҪǿƣΪ expect_or_sync 
+                    // 不强制要求写长度（如仅写 VARCHAR），也可在此放宽
+                    // 若要强制，请改为 expect_or_sync 报错：
                     // expect_or_sync(st, "varchar length like '(N)' or ' N'");
                     // return nullptr;
                 }
@@ -394,11 +394,11 @@ namespace minidb {
 
             td.columns.push_back({ cn.lexeme, dt });
 
-            // ',' ColDef 
+            // ',' ColDef 继续
             if (is(TokenType::COMMA)) {
                 Token comma = expect(TokenType::COMMA, st, "','"); if (!st.ok) return nullptr;
                 trace_match_tok(comma, "','");
-                // ص while һ ColDef 
+                // 回到 while 顶继续打一条 ColDef 规则
                 continue;
             }
             break;
@@ -422,11 +422,11 @@ namespace minidb {
     StmtPtr Parser::parse_insert(Status& st) {
         if (trace_on_) {
             std::cout
-                << " ============== 嵥 ==============\n"
+                << " ============== 规则清单 ==============\n"
                 << "(1) Prog -> Insert ';'\n"
                 << "(2) Insert -> INSERT INTO Tbl OptCols VALUES '(' ValList ')'\n"
                 << "(3) Tbl -> ID\n"
-                << "(4) OptCols -> '(' ColList ')' | \n"
+                << "(4) OptCols -> '(' ColList ')' | ε\n"
                 << "(5) ColList -> ID (',' ID)*\n"
                 << "(6) ValList -> Expr (',' Expr)*\n";
         }
@@ -450,7 +450,7 @@ namespace minidb {
 
         std::vector<std::string> cols;
 
-        // OptCols -> '(' ColList ')' | 
+        // OptCols -> '(' ColList ')' | ε
         if (is(TokenType::LPAREN)) {
             trace_use_rule(4, "OptCols -> '(' ColList ')'");
             Token lp = expect(TokenType::LPAREN, st, "'('"); if (!st.ok) return nullptr;
@@ -474,7 +474,7 @@ namespace minidb {
             trace_match_tok(rp, "')'");
         }
         else {
-            trace_use_rule(4, "OptCols -> ");
+            trace_use_rule(4, "OptCols -> ε");
         }
 
         // VALUES
@@ -490,15 +490,15 @@ namespace minidb {
 
         std::vector<std::unique_ptr<Expr>> vals;
 
-        // һ Expr
+        // 第一个 Expr
         {
             auto e = parse_expr(st); if (!st.ok) return nullptr;
-            // Ϊ˴ӡƥ exprһ tokenչʾ
+            // 这里为了打印“匹配 expr”，做一个虚拟 token（仅用于展示）
             Token exprTok{ TokenType::IDENT, "expr", cur().line, cur().col };
             trace_match_tok(exprTok, "expr");
             vals.push_back(std::move(e));
         }
-        //  , Expr*
+        // 其后 , Expr*
         while (is(TokenType::COMMA)) {
             Token comma = expect(TokenType::COMMA, st, "','"); if (!st.ok) return nullptr;
             trace_match_tok(comma, "','");
@@ -524,17 +524,17 @@ namespace minidb {
 
     // ---------- SELECT ----------
     StmtPtr Parser::parse_select(Status& st) {
-        // 嵥ԭ
+        // 规则清单（保持原样）
         if (trace_on_) {
             std::cout
-                << " ============== 嵥 ==============\n"
+                << " ============== 规则清单 ==============\n"
                 << "(1) Prog -> Query ';'\n"
                 << "(2) Query -> SELECT SelList FROM Tbl\n"
                 << "(3) SelList -> ID\n"
                 << "(4) Tbl -> ID\n";
         }
 
-        //  SelectStmt 󣨣ǳؼԱ joins/group/order õ
+        // 构造 SelectStmt 对象（！！非常关键，以便后面 joins/group/order 能引用到）
         auto s = std::make_unique<SelectStmt>();
 
         trace_push("Prog");
@@ -559,7 +559,7 @@ namespace minidb {
         else {
             trace_use_rule(3, "SelList -> ID");
 
-            // һѡ֧ ID('.'ID)?
+            // 解析第一个选择项：支持 ID('.'ID)?
             {
                 Token c1 = expect(TokenType::IDENT, st, "column");
                 if (!st.ok) return nullptr;
@@ -582,7 +582,7 @@ namespace minidb {
                 cols.push_back(item);
             }
 
-            // , ID('.'ID)? ظ
+            // 后续：, ID('.'ID)? 重复
             while (is(TokenType::COMMA)) {
                 Token comma = expect(TokenType::COMMA, st, "','");
                 if (!st.ok) return nullptr;
@@ -623,15 +623,15 @@ namespace minidb {
         if (!st.ok) return nullptr;
         trace_match_tok(tn, "ID(" + tn.lexeme + ")");
 
-        // FROM ѡ**** ASTֻԵԱ JOIN/ORDER ʶ
+        // FROM 后可选**别名**（不存 AST，只吃掉以便后续 JOIN/ORDER 能正常识别）
         if (is(TokenType::IDENT)) {
             Token alias = expect(TokenType::IDENT, st, "alias");
             if (!st.ok) return nullptr;
-            //  trace չʾ AST
+            // 仅用于 trace 展示，避免改 AST
             trace_match_tok(alias, "ID(" + alias.lexeme + ")");
         }
 
-        // WHEREѡ
+        // WHERE（可选）
         std::unique_ptr<Expr> where;
         if (is(TokenType::KEYWORD) && cur().lexeme == "WHERE") {
             Token whereTk = expect(TokenType::KEYWORD, st, "WHERE");
@@ -641,19 +641,19 @@ namespace minidb {
             where = parse_expr(st);
             if (!st.ok) return nullptr;
 
-            // һƥ exprıʷα
+            // 仅用于输出一步“匹配 expr”，不改变词法游标
             Token fakeExpr{ TokenType::IDENT, "expr", cur().line, cur().col };
             trace_match_tok(fakeExpr, "expr");
         }
 
-        // ====== ǹؼ s ֶ£չ s  ======
+        // ====== 这里是关键：把 s 的字段先落下，后续扩展都往 s 上填 ======
         s->table = tn.lexeme;
         s->columns = std::move(cols);
         s->star = star;
         s->where = std::move(where);
 
-        // ====== ؼSELECT βչ ======
-    // 1) JOIN 
+        // ====== 关键新增：SELECT 尾部扩展 ======
+    // 1) JOIN 串
         if (!parse_joins(st, s->joins)) return nullptr;
         if (!st.ok) return nullptr;
 
@@ -661,7 +661,7 @@ namespace minidb {
         if (!parse_group_by(st, s->group_by)) return nullptr;
         if (!st.ok) return nullptr;
 
-        // 2.5) HAVINGнӿⲹһ䣬СĶ
+        // 2.5) HAVING（在你现有接口外补一句，极小改动）
         if (accept_kw("HAVING")) {
             Token kwHaving{ TokenType::KEYWORD, "HAVING", tn.line, tn.col };
             trace_match_tok(kwHaving, "HAVING");
@@ -682,7 +682,7 @@ namespace minidb {
             trace_match_tok(semi, "';'");
         }
 
-        // 
+        // 接受
         trace_accept();
 
         return s;
@@ -692,11 +692,11 @@ namespace minidb {
     StmtPtr Parser::parse_delete(Status& st) {
         if (trace_on_) {
             std::cout
-                << " ============== 嵥 ==============\n"
+                << " ============== 规则清单 ==============\n"
                 << "(1) Prog -> Delete ';'\n"
                 << "(2) Delete -> DELETE FROM Tbl OptWhere\n"
                 << "(3) Tbl -> ID\n"
-                << "(4) OptWhere -> WHERE Expr | \n";
+                << "(4) OptWhere -> WHERE Expr | ε\n";
         }
 
         trace_push("Prog");
@@ -718,9 +718,9 @@ namespace minidb {
 
         std::unique_ptr<Expr> where;
 
-        // OptWhere -> WHERE Expr | 
+        // OptWhere -> WHERE Expr | ε
         if (accept_kw("WHERE")) {
-            // û expect_kw õ tokenһչʾ token:
+            // 手里没有 expect_kw 拿到的 token；补一个展示用 token:
             Token kwWhere{ TokenType::KEYWORD, "WHERE", tn.line, tn.col };
             trace_use_rule(4, "OptWhere -> WHERE Expr");
             trace_match_tok(kwWhere, "WHERE");
@@ -729,7 +729,7 @@ namespace minidb {
             trace_match_tok(exprTok, "expr");
         }
         else {
-            trace_use_rule(4, "OptWhere -> ");
+            trace_use_rule(4, "OptWhere -> ε");
         }
 
         // ';'
@@ -746,13 +746,13 @@ namespace minidb {
     StmtPtr Parser::parse_update(Status& st) {
         if (trace_on_) {
             std::cout
-                << " ============== 嵥 ==============\n"
+                << " ============== 规则清单 ==============\n"
                 << "(1) Prog -> Update ';'\n"
                 << "(2) Update -> UPDATE Tbl SET AssignList OptWhere\n"
                 << "(3) Tbl -> ID\n"
                 << "(4) AssignList -> Assign (',' Assign)*\n"
                 << "(5) Assign -> ID '=' Expr\n"
-                << "(6) OptWhere -> WHERE Expr | \n";
+                << "(6) OptWhere -> WHERE Expr | ε\n";
         }
 
         trace_push("Prog");
@@ -787,7 +787,7 @@ namespace minidb {
             trace_match_tok(eq, "'='");
 
             auto e = parse_expr(st); if (!st.ok) return nullptr;
-            // չʾ
+            // 展示用
             Token exprTok{ TokenType::IDENT, "expr", cur().line, cur().col };
             trace_match_tok(exprTok, "expr");
 
@@ -812,7 +812,7 @@ namespace minidb {
             trace_match_tok(exprTok, "expr");
         }
         else {
-            trace_use_rule(6, "OptWhere -> ");
+            trace_use_rule(6, "OptWhere -> ε");
         }
 
         // ';'
@@ -859,30 +859,30 @@ namespace minidb {
     }
 
 
-    //  JOIN б (INNER|LEFT|RIGHT|FULL)? JOIN ID ON Expr   
+    // —— JOIN 列表： (INNER|LEFT|RIGHT|FULL)? JOIN ID ON Expr 反复 —— 
     bool Parser::parse_joins(Status& st, std::vector<SelectJoin>& joins) {
         while (true) {
-            // ԤǷ JOIN
+            // 预判是否出现 JOIN
             Token tk = cur();
             if (tk.type != TokenType::KEYWORD) break;
 
-            JoinType jt = JoinType::INNER; // Ĭ INNER
+            JoinType jt = JoinType::INNER; // 默认 INNER
             if (accept_kw("INNER")) jt = JoinType::INNER;
             else if (accept_kw("LEFT"))  jt = JoinType::LEFT;
             else if (accept_kw("RIGHT")) jt = JoinType::RIGHT;
             else if (accept_kw("FULL"))  jt = JoinType::FULL;
-            // else: ޶ʣΪֱ JOIN
+            // else: 无限定词，视为直接 JOIN
 
             if (!accept_kw("JOIN")) {
-                // û JOINǰﵱ JOIN 
-                //Ϊǰ INNER/LEFT/RIGHT/FULL ֵû JOIN expect_kw("JOIN") ʱ
+                // 没 JOIN，回退前面错误？这里当作无 JOIN 结束
+                //（因为前面的 INNER/LEFT/RIGHT/FULL 如果出现但后面没有 JOIN，会在 expect_kw("JOIN") 时报错）
                 if (jt != JoinType::INNER) { expect_or_sync(st, "JOIN"); return false; }
                 break;
             }
             Token fakeJoin{ TokenType::KEYWORD, "JOIN", tk.line, tk.col };
             trace_match_tok(fakeJoin, "JOIN");
 
-            // 
+            // 表名
             Token tb = expect(TokenType::IDENT, st, "table"); if (!st.ok) return false;
             trace_match_tok(tb, "ID(" + tb.lexeme + ")");
 
@@ -897,16 +897,16 @@ namespace minidb {
             SelectJoin sj;
             sj.type = jt;
             sj.table = tb.lexeme;
-            //  SelectJoin  alias ֶ˱ѡsj.alias = alias;
+            // 如果你的 SelectJoin 里有 alias 字段且你在上面读了别名，可选：sj.alias = alias;
             sj.on = std::move(e);
             joins.push_back(std::move(sj));
         }
         return true;
     }
 
-    //  GROUP BY col (, col)* (HAVING Expr)?  
+    // —— GROUP BY col (, col)* (HAVING Expr)? —— 
     bool Parser::parse_group_by(Status& st, std::vector<std::string>& out) {
-        if (!accept_kw("GROUP")) return true;    // û GROUP -> 
+        if (!accept_kw("GROUP")) return true;    // 没有 GROUP -> 正常返回
         Token kwG{ TokenType::KEYWORD, "GROUP", cur().line, cur().col };
         trace_match_tok(kwG, "GROUP");
 
@@ -927,16 +927,16 @@ namespace minidb {
         return true;
     }
 
-    //  ORDER BY col (ASC|DESC)? (, ...)*  
+    // —— ORDER BY col (ASC|DESC)? (, ...)* —— 
     bool Parser::parse_order_by(Status& st, std::vector<OrderItem>& out) {
-        if (!accept_kw("ORDER")) return true;    // û ORDER -> 
+        if (!accept_kw("ORDER")) return true;    // 没有 ORDER -> 正常返回
         Token kwO{ TokenType::KEYWORD, "ORDER", cur().line, cur().col };
         trace_match_tok(kwO, "ORDER");
 
         Token kwB = expect_kw("BY", st, "BY"); if (!st.ok) return false;
         trace_match_tok(kwB, "BY");
 
-        // һ
+        // 第一项
         Token c1 = expect(TokenType::IDENT, st, "order-by column"); if (!st.ok) return false;
         trace_match_tok(c1, "ID(" + c1.lexeme + ")");
         bool asc = true;
@@ -958,17 +958,17 @@ namespace minidb {
         return true;
     }
 
-    // ---------- ʽ ----------
-    // ====  parse_primary֧ a.b ====
+    // ---------- 表达式 ----------
+    // ==== 覆盖 parse_primary：支持 a.b ====
     std::unique_ptr<Expr> Parser::parse_primary(Status& st) {
         Token tk = cur();
         if (tk.type == TokenType::IDENT) {
-            // ȳԵһ ident
+            // 先吃掉第一个 ident
             has_ = false;
             std::string name = tk.lexeme;
-            // Ƿ "."
+            // 看是否跟着 "."
             if (cur().type == TokenType::DOT) {
-                has_ = false; // Ե DOT
+                has_ = false; // 吃掉 DOT
                 Token id2 = expect(TokenType::IDENT, st, "identifier"); if (!st.ok) return nullptr;
                 name += ".";
                 name += id2.lexeme;
@@ -17,7 +17,7 @@ namespace minidb {
         if (!s) return make_error("null CreateTableStmt");
         auto n = std::make_unique<PlanNode>();
         n->op = PlanOp::CREATE;
-        n->create_def = s->def;   // ֱӴϱ
+        n->create_def = s->def;   // 直接带上表定义
         return n;
     }
 
@@ -27,13 +27,13 @@ namespace minidb {
         auto n = std::make_unique<PlanNode>();
         n->op = PlanOp::INSERT;
         n->table = s->table;
-        n->insert_cols = s->columns;  // Ϊգʾ˳
-        // ʽ AST 룻ִֵ
+        n->insert_cols = s->columns;  // 可能为空（表示按表定义顺序）
+        // 深拷贝表达式（保持与 AST 分离；后续执行器可做求值）
         for (const auto& e : s->values) {
             if (!e) return make_error("INSERT contains null expr");
-            // ֻǳ¡Ϊûṩͨ cloneֱӰȨƹȥҲ
-            //  plan_from_stmt Իᱣ AST  Pretty/ӡԲ move ԭ AST
-            // ̳ӱʽΪ ERROR
+            // 这里只做浅层克隆：因为我们没有提供通用 clone，这里直接把所有权移过去也可
+            // 但 plan_from_stmt 仍会保留 AST 用在 Pretty/打印，所以不能 move 原 AST。
+            // 简易做法：复刻常见字面量与列名；复杂表达式保持为 ERROR。
             if (auto c = dynamic_cast<ColRef*>(e.get())) {
                 n->insert_values.emplace_back(std::make_unique<ColRef>(c->name));
             }
@@ -54,21 +54,21 @@ namespace minidb {
     std::unique_ptr<PlanNode> Planner::plan_select(const SelectStmt* s) {
         if (!s) return make_error("null SelectStmt");
 
-        // 1) ɨ
+        // 1) 扫描
         auto scan = std::make_unique<PlanNode>();
         scan->op = PlanOp::SEQSCAN;
         scan->table = s->table;
 
         std::unique_ptr<PlanNode> cur = std::move(scan);
 
-        // 2) ν
+        // 2) 谓词
         if (s->where) {
             auto fil = std::make_unique<PlanNode>();
             fil->op = PlanOp::FILTER;
 
-            // ͬС¡Աƻ AST Ȩ
+            // 同样做最小“克隆”，以避免破坏 AST 所有权
             if (auto c = dynamic_cast<CmpExpr*>(s->where.get())) {
-                // ¡ CmpExpr֧//ַ
+                // 深克隆 CmpExpr（支持列名/整型/字符串）
                 auto clone_side = [](const Expr* e) -> std::unique_ptr<Expr> {
                     if (auto x = dynamic_cast<const ColRef*>(e)) return std::make_unique<ColRef>(x->name);
                     if (auto x = dynamic_cast<const IntLit*>(e)) return std::make_unique<IntLit>(x->v);
@@ -81,7 +81,7 @@ namespace minidb {
                 fil->predicate = std::make_unique<CmpExpr>(std::move(L), c->op, std::move(R));
             }
             else {
-                // ʽݲ֧
+                // 其它表达式类型暂不支持
                 return make_error("WHERE expr not supported in planner");
             }
 
@@ -89,7 +89,7 @@ namespace minidb {
             cur = std::move(fil);
         }
 
-        // 3) ͶӰ
+        // 3) 投影
         auto proj = std::make_unique<PlanNode>();
         proj->op = PlanOp::PROJECT;
         proj->project = s->star ? std::vector<std::string>{} : s->columns;
@@ -140,7 +140,7 @@ namespace minidb {
         n->op = PlanOp::UPDATE;
         n->table = s->table;
 
-        //  SET б֧ ColRef/IntLit/StrLit
+        // 复制 SET 列表（仅支持 ColRef/IntLit/StrLit）
         for (const auto& kv : s->sets) {
             const auto& col = kv.first;
             const Expr* e = kv.second.get();
@@ -152,7 +152,7 @@ namespace minidb {
             n->update_sets.emplace_back(col, std::move(val));
         }
 
-        // WHEREּ֧򵥱Ƚ CmpExpr 
+        // WHERE（仅支持简单比较 CmpExpr 左列右字面量）
         if (s->where) {
             if (auto c = dynamic_cast<CmpExpr*>(s->where.get())) {
                 auto clone_side = [](const Expr* e)->std::unique_ptr<Expr> {
@@ -174,7 +174,7 @@ namespace minidb {
     }
 
 
-    // 
+    // 入口
     Plan Planner::plan_from_stmt(Stmt* s) {
         Plan p;
         if (auto c = dynamic_cast<CreateTableStmt*>(s)) { p.root = plan_create(c); return p; }
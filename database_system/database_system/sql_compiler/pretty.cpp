@@ -6,7 +6,7 @@
 
 namespace minidb {
 
-    //  TokenType + 棬ӳ䵽γֱ̡롱
+    // 将 TokenType + 词面，映射到课程“种别码”
     int LexCategoryCode(TokenType t, const std::string& lexeme_upper) {
         switch (t) {
         case TokenType::KEYWORD:   return 1;
@@ -17,13 +17,13 @@ namespace minidb {
         case TokenType::STAR: case TokenType::SLASH: case TokenType::PERCENT:
         case TokenType::EQ: case TokenType::NEQ: case TokenType::LT:
         case TokenType::LE: case TokenType::GT: case TokenType::GE:
-            return 4; // 
+            return 4; // 运算符
         case TokenType::COMMA: case TokenType::SEMI: case TokenType::DOT:
         case TokenType::LPAREN: case TokenType::RPAREN:
         case TokenType::LBRACE: case TokenType::RBRACE:
         case TokenType::LBRACKET: case TokenType::RBRACKET:
-            return 5; // 
-        case TokenType::COMMENT: return 6;       // ע
+            return 5; // 界符
+        case TokenType::COMMENT: return 6;       // 注释
         default: return 99;
         }
     }
@@ -43,9 +43,9 @@ namespace minidb {
     }
 
 
-    // ӡԪʽ [ֱ, "", , ]
+    // 打印四元式 [种别码, "词素", 行, 列]
     void PrintTokenQuads(const std::string& sql, int start_line, std::ostream& os) {
-        //  Lexer ֧ (sql, start_line) 
+        // 你的 Lexer 支持 (sql, start_line) 构造
         Lexer lx(sql, start_line, /*start_col*/0, /*keep_comments*/true);
         while (true) {
             Token t = lx.next();
@@ -54,7 +54,7 @@ namespace minidb {
                 os << "[LEX ERROR, \"" << t.lexeme << "\", " << t.line << ", " << t.col << "]\n";
                 break;
             }
-            // شдڹؼַʾıԭأ
+            // 词素大写副本，用于关键字分类显示（不改变原词素）
             std::string up = t.lexeme;
             for (auto& ch : up) ch = std::toupper((unsigned char)ch);
 
@@ -206,7 +206,7 @@ namespace minidb {
     // ---------------- Plan (JSON-ish) ----------------
     static std::string Indent(int n) { return std::string(n, ' '); }
 
-    // JSON ַת
+    // JSON 字符串转义
     static std::string JsonEscape(const std::string& s) {
         std::string out;
         out.reserve(s.size() + 8);
@@ -247,7 +247,7 @@ namespace minidb {
         }
     }
 
-    //  JSON Ⱦ  //
+    // —— JSON 渲染 —— //
     static void to_json(const PlanNode* n, std::ostream& os, int ind) {
         auto pad = [&](int k) { for (int i = 0; i < k; ++i) os << ' '; };
         pad(ind); os << "{ \"type\": \"" << OpName(n->op) << "\"";
@@ -288,7 +288,7 @@ namespace minidb {
             break;
 
         case PlanOp::FILTER:
-            os << ", \"filter\": \"(predicate)\""; // ʾ
+            os << ", \"filter\": \"(predicate)\""; // 简化显示
             break;
 
         case PlanOp::PROJECT:
@@ -340,7 +340,7 @@ namespace minidb {
         os << " }";
     }
 
-    //  S-ʽȾ  //
+    // —— S-表达式渲染 —— //
     static void to_sexpr(const PlanNode* n, std::ostream& os) {
         os << "(" << OpName(n->op);
         switch (n->op) {
@@ -420,7 +420,7 @@ namespace minidb {
             os << "\n";
         }
         else {
-            // Ĭ JSON
+            // 默认 JSON
             to_json(p.root.get(), os, 0);
             os << "\n";
         }
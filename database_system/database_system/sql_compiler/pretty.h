@@ -13,23 +13,23 @@
 
 namespace minidb {
 
-	// Ԫʽֱ루1ؼ/2ʶ/3/4/5/6עͣ
+	// 四元式：种别码（1关键字/2标识符/3常量/4运算符/5界符/6注释）
 	int  LexCategoryCode(TokenType t, const std::string& lexeme_upper);
-	// ӡʷԪʽ֧ʼУ
+	// 打印词法四元式（支持起始行）
 	void PrintTokenQuads(const std::string& sql, int start_line, std::ostream& os);
 
-	// ---------- Token ӡ ----------
+	// ---------- Token 打印 ----------
 	const char* TokName(TokenType t);
 	void PrintTokens(const std::string& sql, std::ostream& os);
 
-	// ---------- AST ӡS-ʽ ----------
+	// ---------- AST 打印（S-表达式） ----------
 	std::string ExprSexpr(const Expr* e);
 	std::string StmtSexpr(const Stmt* s);
 	void PrintAST(const Stmt* s, std::ostream& os);
 
-	// ---------- ִмƻӡJSON  ----------
+	// ---------- 执行计划打印（JSON 风格） ----------
 	std::string PlanJson(const PlanNode* n, int indent = 0);
-	// fmt: "json"  "sexpr"
+	// fmt: "json" 或 "sexpr"
 	void PrintPlan(const Plan& p, std::ostream& os, const char* fmt = "json");
 
 } // namespace minidb
\ No newline at end of file
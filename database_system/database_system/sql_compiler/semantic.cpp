@@ -6,7 +6,7 @@
 #include <unordered_set>
 #include <sstream>
 
-// ---- Ƚתַ + ʽתַԪʽӡ ----
+// ---- 辅助：比较运算符转字符串 + 表达式转字符串（用于四元式打印） ----
 namespace {
     using namespace minidb;
 
@@ -22,11 +22,11 @@ namespace {
         return "?";
     }
 
-    //  ʽƶ  //
-// ֧֣
+    // —— 表达式类型推断 —— //
+// 支持：
 //  - IntLit => INT32
-//  - StrLit ı 123  66.66ֳ FLOAT/DECIMAL ƥ䣩
-//  - ColRef => ж
+//  - StrLit 若文本形如 123 或 66.66，可视作数字常量（用于与 FLOAT/DECIMAL 匹配）
+//  - ColRef => 列定义的类型
     static bool is_integer_like(const std::string& s) {
         if (s.empty()) return false;
         size_t i = 0;
@@ -47,7 +47,7 @@ namespace {
         return digits > 0 && dots == 1;
     }
 
-    //  SELECT/DELETE/UPDATE Ԫʽõ render_expr 
+    // 你在 SELECT/DELETE/UPDATE 的四元式里调用的 render_expr 就是它
     static std::string render_expr(const Expr* e) {
         if (!e) return "-";
         if (auto c = dynamic_cast<const ColRef*>(e))  return c->name;
@@ -67,13 +67,13 @@ namespace {
 
 namespace minidb {
 
-    // ȡеġҶȥ a.b ǰ׺
+    // 新增：取列的“叶子名”（去掉 a.b 前缀）
     static std::string leaf_col(const std::string& s) {
         auto p = s.rfind('.');
         return (p == std::string::npos) ? s : s.substr(p + 1);
     }
 
-    // 滻ԭ find_colҶ
+    // 替换原来的 find_col：按叶子名找
     static std::optional<size_t> find_col(const TableDef& td, const std::string& n) {
         std::string leaf = leaf_col(n);
         for (size_t i = 0; i < td.columns.size(); ++i)
@@ -81,7 +81,7 @@ namespace minidb {
         return std::nullopt;
     }
 
-    //  ʽƶ  //
+    // —— 表达式类型推断 —— //
     std::optional<DataType> SemanticAnalyzer::expr_type(const Expr* e, const TableDef& td, Status& st) {
         if (auto c = dynamic_cast<const ColRef*>(e)) {
             auto idx = find_col_ci(td, c->name);
@@ -107,7 +107,7 @@ namespace minidb {
         return std::nullopt;
     }
 
-    //  CREATE  //
+    // —— CREATE —— //
     static const char* DtName(DataType dt) {
         switch (dt) {
         case DataType::INT32:     return "INT";
@@ -154,14 +154,14 @@ namespace minidb {
         return Status::OK();
     }
 
-    //  INSERT  //
+    // —— INSERT —— //
     Status SemanticAnalyzer::check_insert(const InsertStmt* s, std::vector<Quad>& q) {
         auto tdopt = cat_.get_table(to_lower(s->table));
         if (!tdopt)
             return Status::Error("[SemanticError, table, Unknown table: " + s->table + "]");
         auto td = *tdopt;
 
-        // жλδ嵥 -> ˳ȫУ嵥 -> ӳ
+        // 列定位：未给列清单 -> 顺序全列；给列清单 -> 映射
         std::vector<size_t> pos;
         if (s->columns.empty()) {
             if (s->values.size() != td.columns.size())
@@ -179,10 +179,10 @@ namespace minidb {
             }
         }
 
-        // ͼ飨INSERT δŵıʶΪ VARCHAR + ֵſ
+        // 类型检查（INSERT 里允许未加引号的标识符作为 VARCHAR 字面量）+ 数值放宽
         auto is_numeric_compatible = [](DataType want, DataType got) {
             if (want == got) return true;
-            //  INT32  FLOAT/DECIMAL תСſ
+            // 允许 INT32 和 FLOAT/DECIMAL 互转（最小放宽）
             if ((want == DataType::INT32 || want == DataType::FLOAT || want == DataType::DECIMAL) &&
                 (got == DataType::INT32 || got == DataType::FLOAT || got == DataType::DECIMAL))
                 return true;
@@ -210,14 +210,14 @@ namespace minidb {
         }
 
 
-        // ̣ÿֵ CONSTõ T?ٰ INSERT col, <literal>, T?
+        // 过程：对每个值先生成 CONST，拿到 T?；再按列生成 INSERT col, <literal>, T?
         auto next_tmp = [&]() {
             return std::string("T") + std::to_string((int)q.size());
             };
         std::vector<std::string> value_tmps;
         value_tmps.reserve(s->values.size());
 
-        // 1) CONST ԪʽȾ arg1
+        // 1) CONST 四元式：把字面量渲染到 arg1
         auto render_expr = [](const Expr* e) -> std::string {
             if (auto i = dynamic_cast<const IntLit*>(e))  return std::to_string(i->v);
             if (auto s = dynamic_cast<const StrLit*>(e))  return "'" + s->v + "'";
@@ -232,14 +232,14 @@ namespace minidb {
             value_tmps.push_back(t);
         }
 
-        // 2) INSERT  ֵT?
+        // 2) INSERT（列 ← 值T?）
         for (size_t j = 0; j < s->values.size(); ++j) {
             const auto& col = td.columns[pos[j]].name;
             std::string t = next_tmp();
             q.push_back(Quad{ "INSERT", col, value_tmps[j], t });
         }
 
-        // 3) INTOֵ T? 
+        // 3) INTO：把所有值 T? 串起来
         std::string arg1;
         for (size_t i = 0; i < value_tmps.size(); ++i) {
             if (i) arg1 += ",";
@@ -250,14 +250,14 @@ namespace minidb {
         return Status::OK();
     }
 
-    //  SELECT棺 where/޶* ֧֣  //
+    // —— SELECT（单表版：含 where/限定列名；* 支持） —— //
     Status SemanticAnalyzer::check_select(const SelectStmt* s, std::vector<Quad>& q) {
         auto tdopt = cat_.get_table(to_lower(s->table));
         if (!tdopt)
             return Status::Error("[SemanticError, table, Unknown table: " + s->table + "]");
         auto td = *tdopt;
 
-        // ¼ÿһʱ T*
+        // 记录每一步产生的临时名 T*
         std::vector<std::string> t_list;
         auto next_tmp = [&]() {
             return std::string("T") + std::to_string((int)q.size());
@@ -285,14 +285,14 @@ namespace minidb {
             t_list.push_back(t);
         }
 
-        // WHEREеĻͼ飬ټ¼νʲ T
+        // WHERE（如果有的话，先做类型检查，再记录谓词产生的 T）
         std::string pred_tmp;
         if (s->where) {
             Status st = Status::OK();
             (void)expr_type(s->where.get(), td, st);
             if (!st.ok) return st;
 
-            // ȾһıȽԪʽ
+            // 渲染一个简洁的比较四元式
             if (auto cmp = dynamic_cast<const CmpExpr*>(s->where.get())) {
                 auto lhs = dynamic_cast<ColRef*>(cmp->lhs.get());
                 auto rhs_i = dynamic_cast<IntLit*>(cmp->rhs.get());
@@ -314,7 +314,7 @@ namespace minidb {
             }
         }
 
-        //  RESULT t_list öƴӣ where ʱ׷ " WHERE T?"
+        // 生成 RESULT：把 t_list 用逗号拼接；有 where 时追加 " WHERE T?"
         std::string arg1;
         for (size_t i = 0; i < t_list.size(); ++i) {
             if (i) arg1 += ",";
@@ -329,7 +329,7 @@ namespace minidb {
         return Status::OK();
     }
 
-    //  DELETE where  //
+    // —— DELETE（单表 where） —— //
     Status SemanticAnalyzer::check_delete(const DeleteStmt* s, std::vector<Quad>& q) {
         auto tdopt = cat_.get_table(to_lower(s->table));
         if (!tdopt)
@@ -344,14 +344,14 @@ namespace minidb {
         std::string t_from = next_tmp();
         q.push_back(Quad{ "FROM", td.name, "-", t_from });
 
-        // WHEREѡ
+        // WHERE（可选）
         std::string t_pred;
         if (s->where) {
             Status st = Status::OK();
             (void)expr_type(s->where.get(), td, st);
             if (!st.ok) return st;
 
-            // ȽԪʽ
+            // 简洁比较四元式
             if (auto cmp = dynamic_cast<const CmpExpr*>(s->where.get())) {
                 auto lhs = dynamic_cast<ColRef*>(cmp->lhs.get());
                 auto rhs_i = dynamic_cast<IntLit*>(cmp->rhs.get());
@@ -373,7 +373,7 @@ namespace minidb {
             }
         }
 
-        // RESULTT_from [WHERE T_pred]
+        // RESULT：T_from [WHERE T_pred]
         std::string arg1 = t_from;
         if (!t_pred.empty()) {
             arg1 += " WHERE ";
@@ -381,12 +381,12 @@ namespace minidb {
         }
         q.push_back(Quad{ "RESULT", arg1, "-", "-" });
 
-        // ɾ
+        // 最后给出删除动作
         q.push_back(Quad{ "DELETE", td.name, "-", "-" });
         return Status::OK();
     }
 
-    //  UPDATE  //
+    // —— UPDATE —— //
     Status SemanticAnalyzer::check_update(const UpdateStmt* s, std::vector<Quad>& q) {
         auto tdopt = cat_.get_table(to_lower(s->table));
         if (!tdopt)
@@ -415,7 +415,7 @@ namespace minidb {
         }
 
 
-        // WHERE ʽͼ
+        // WHERE 表达式类型检查
         if (s->where) {
             Status st = Status::OK();
             (void)expr_type(s->where.get(), td, st);
@@ -427,7 +427,7 @@ namespace minidb {
         return Status::OK();
     }
 
-    //  DROP  //
+    // —— DROP —— //
     Status SemanticAnalyzer::check_drop(const DropTableStmt* s, std::vector<Quad>& q) {
         auto tdopt = cat_.get_table(to_lower(s->table));
         if (!tdopt) {
@@ -438,7 +438,7 @@ namespace minidb {
         return Status::OK();
     }
 
-    //    //
+    // —— 顶层调度 —— //
     SemanticResult SemanticAnalyzer::analyze(Stmt* s) {
         std::vector<Quad> q;
         if (auto c = dynamic_cast<CreateTableStmt*>(s)) return { check_create(c,q), std::move(q) };
@@ -1,219 +1,591 @@
 // =============================================
 // storage/cache_manager.cpp
 // =============================================
-//ʵCacheManagerгԱ滻߼־
+//实现CacheManager类的所有成员函数（缓存操作、替换逻辑、日志输出）
 #include "cache_manager.hpp"
 #include <algorithm>
 #include <iomanip>
 #include <ctime>
 #include <sstream>
 #include<iostream>
+#include <thread>
 
 using namespace std;
 
-// -------------------------- ˽ид־ --------------------------
-void CacheManager::write_log(const string& log_content) {
-    // ־ļ׷ģʽд롰ʱ+ݡ
-    ofstream log_file(log_file_path, ios::app);
-    if (!log_file) {
-        cerr << "Cache log write failed: cannot open log file - " << log_file_path << endl;
-        return;
+// -------------------------- 私有辅助函数：写回页帧 --------------------------
+bool CacheManager::write_back(uint32_t page_id, CacheNode& node) {
+    // 持有分片锁时只尝试加页帧读锁：写守卫正在修改该页时跳过，避免拷出写了一半的页
+    if (!node.frame_latch.try_lock_shared()) return false;
+    bool ok = (!wal || wal->flush(node.page.get_lsn())) && page_manager.write_page(page_id, node.page);
+    node.frame_latch.unlock_shared();
+    if (ok) {
+        node.is_dirty = false;
+        shard_of(page_id).write_backs.fetch_add(1, memory_order_relaxed);
     }
-    // ȡǰʱ䣨ʽYYYY-MM-DD HH:MM:SS
+    return ok;
+}
 
-    time_t now = time(nullptr);
-    tm local_tm;
-    localtime_s(&local_tm, &now);
+bool CacheManager::write_back_pinned(Shard& shard, uint32_t page_id, CacheNode& node) {
+    // 不持有分片锁：刷日志与写页期间同分片的其他页照常访问；页已固定，不会被换出
+    bool latched = node.frame_latch.try_lock_shared();
+    bool ok = latched && (!wal || wal->flush(node.page.get_lsn())) && page_manager.write_page(page_id, node.page);
+    // 先加分片锁再释放页帧锁：写者在页帧锁释放后做的修改，其脏标记不会被下面清掉
+    lock_guard<mutex> lock(shard.latch);
+    if (latched) node.frame_latch.unlock_shared();
+    if (ok) {
+        node.is_dirty = false;
+        shard.write_backs.fetch_add(1, memory_order_relaxed);
+    }
+    --node.pin_count;
+    return ok;
+}
 
-    char time_buf[64];
-    strftime(time_buf, sizeof(time_buf), "[%Y-%m-%d %H:%M:%S]", &local_tm);
-    // д־
-    log_file << time_buf << " " << log_content << endl;
-    log_file.close();
+void CacheManager::set_dirty(CacheNode& node) {
+    if (!node.is_dirty) {
+        node.is_dirty = true;
+        node.dirty_since = chrono::steady_clock::now();
+    }
 }
 
-// -------------------------- ˽滻ԣLRUƳ --------------------------
-void CacheManager::lru_evict() {
-    if (cache_map.empty()) return;
+// -------------------------- 幽灵队列 --------------------------
+void CacheManager::GhostList::push_front(uint32_t page_id) {
+    erase(page_id);
+    order.push_front(page_id);
+    index[page_id] = order.begin();
+}
 
-    // 棬ҵʱ硱ҳ
-    auto least_recent_it = cache_map.begin();
-    for (auto it = cache_map.begin(); it != cache_map.end(); ++it) {
-        if (it->second.access_time < least_recent_it->second.access_time) {
-            least_recent_it = it;
-        }
-    }
+bool CacheManager::GhostList::erase(uint32_t page_id) {
+    auto it = index.find(page_id);
+    if (it == index.end()) return false;
+    order.erase(it->second);
+    index.erase(it);
+    return true;
+}
+
+uint32_t CacheManager::GhostList::pop_back() {
+    if (order.empty()) return INVALID_PAGE_ID;
+    uint32_t page_id = order.back();
+    order.pop_back();
+    index.erase(page_id);
+    return page_id;
+}
 
-    // Ϊҳˢ
-    uint32_t evict_page_id = least_recent_it->first;
-    if (least_recent_it->second.is_dirty) {
-        if (page_manager.write_page(evict_page_id, least_recent_it->second.page)) {
-            write_log("LRU evict: dirty page " + to_string(evict_page_id) + " flushed to disk");
+// -------------------------- 私有辅助函数：移除缓存页 --------------------------
+void CacheManager::remove_node(Shard& shard, NodeIter it) {
+    // 若为脏页，先刷盘（被替换的页未固定，不会有人持有页帧锁）
+    uint32_t evict_page_id = it->first;
+    CacheNode& node = it->second;
+    uint8_t policy_tag = static_cast<uint8_t>(policy);
+    if (node.is_dirty) {
+        if (write_back(evict_page_id, node)) {
+            event_log.log(StorageEvent::EVICT_FLUSH, evict_page_id, policy_tag);
         }
         else {
-            write_log("LRU evict warning: dirty page " + to_string(evict_page_id) + " flush failed");
+            event_log.log(StorageEvent::EVICT_FLUSH_FAILED, evict_page_id, policy_tag);
         }
     }
+    // 清理替换策略状态（扫描读入、未被普通访问过的页不进幽灵队列）
+    if (node.queue_id == QUEUE_COLD) {
+        shard.cold_queue.erase(node.queue_pos);
+    }
+    else if (policy == ReplacePolicy::CLOCK) {
+        shard.clock_ring[node.clock_slot] = INVALID_PAGE_ID;
+        shard.clock_free_slots.push_back(node.clock_slot);
+    }
+    else if (policy == ReplacePolicy::LRU_2 && node.queue_id == QUEUE_SECOND) {
+        shard.lruk_order.erase({ node.penult_access, evict_page_id });
+    }
+    else if (node.queue_id == QUEUE_SECOND) {
+        shard.queue2.erase(node.queue_pos);
+    }
+    else {
+        shard.queue.erase(node.queue_pos);
+    }
 
-    // Ƴҳ¼־
-    write_log("LRU evict: page " + to_string(evict_page_id) + " removed from cache");
-    cache_map.erase(least_recent_it);
+    if (node.queue_id != QUEUE_COLD) {
+        if (policy == ReplacePolicy::TWO_Q) {
+            // 只有从A1in换出的页进A1out：再次读入时说明不是只用一次的页
+            if (node.queue_id == QUEUE_MAIN) {
+                shard.ghost1.push_front(evict_page_id);
+                size_t limit = max<size_t>(1, static_cast<size_t>(shard.capacity * TWO_Q_OUT_RATIO));
+                while (shard.ghost1.size() > limit) shard.ghost1.pop_back();
+            }
+        }
+        else if (policy == ReplacePolicy::LRU_2) {
+            // 保留最近访问时间：再次读入时与这次访问一起构成两次访问
+            shard.ghost1.push_front(evict_page_id);
+            shard.lruk_history[evict_page_id] = node.last_access;
+            while (shard.ghost1.size() > shard.capacity) shard.lruk_history.erase(shard.ghost1.pop_back());
+        }
+        else if (policy == ReplacePolicy::ARC) {
+            if (node.queue_id == QUEUE_MAIN) shard.ghost1.push_front(evict_page_id);
+            else shard.ghost2.push_front(evict_page_id);
+            arc_trim(shard);
+        }
+    }
+    // 移除缓存页，记录日志
+    event_log.log(StorageEvent::EVICT, evict_page_id, policy_tag);
+    shard.cache_map.erase(it);
 }
 
-// -------------------------- ˽滻ԣFIFOƳ --------------------------
-void CacheManager::fifo_evict() {
-    if (cache_map.empty()) return;
-
-    // 棬ҵ롱ҳis_new=falseʾȼ룩
-    auto oldest_it = cache_map.begin();
-    for (auto it = cache_map.begin(); it != cache_map.end(); ++it) {
-        if (!it->second.is_new) {
-            oldest_it = it;
-            break; // FIFOֻҵһis_new=falseҳ
+// -------------------------- 私有辅助函数：新页登记到替换策略 --------------------------
+void CacheManager::track_new_node(Shard& shard, uint32_t page_id, CacheNode& node, AccessHint hint) {
+    // 顺序扫描读入的页：放入冷队列，不参与替换策略（被普通访问时再登记）
+    if (hint == AccessHint::SEQUENTIAL) {
+        shard.cold_queue.push_front(page_id);
+        node.queue_pos = shard.cold_queue.begin();
+        node.queue_id = QUEUE_COLD;
+        return;
+    }
+    node.queue_id = QUEUE_MAIN;
+    if (policy == ReplacePolicy::CLOCK) {
+        // 优先复用被腾空的槽位，否则环扩展一格（环长不超过分片容量）
+        if (!shard.clock_free_slots.empty()) {
+            node.clock_slot = shard.clock_free_slots.back();
+            shard.clock_free_slots.pop_back();
+            shard.clock_ring[node.clock_slot] = page_id;
+        }
+        else {
+            node.clock_slot = static_cast<uint32_t>(shard.clock_ring.size());
+            shard.clock_ring.push_back(page_id);
         }
+        node.ref_bit = false; // 新页需被再次访问才获得“第二次机会”
     }
+    else if (policy == ReplacePolicy::LRU_2) {
+        node.last_access = ++shard.access_clock;
+        auto hist = shard.lruk_history.find(page_id);
+        if (hist != shard.lruk_history.end()) {
+            // 换出前的访问与这次访问构成两次访问
+            node.penult_access = hist->second;
+            node.queue_id = QUEUE_SECOND;
+            shard.lruk_order.insert({ node.penult_access, page_id });
+            shard.lruk_history.erase(hist);
+            shard.ghost1.erase(page_id);
+        }
+        else {
+            node.penult_access = 0;
+            shard.queue.push_front(page_id);
+            node.queue_pos = shard.queue.begin();
+        }
+    }
+    else if ((policy == ReplacePolicy::TWO_Q && shard.ghost1.erase(page_id)) ||
+        (policy == ReplacePolicy::ARC && (shard.ghost1.erase(page_id) || shard.ghost2.erase(page_id)))) {
+        // 2Q：A1out中的页直接进Am；ARC：幽灵命中的页进T2
+        node.queue_id = QUEUE_SECOND;
+        shard.queue2.push_front(page_id);
+        node.queue_pos = shard.queue2.begin();
+    }
+    else {
+        // LRU/FIFO/2Q的A1in/ARC的T1：新页都放在队头
+        shard.queue.push_front(page_id);
+        node.queue_pos = shard.queue.begin();
+    }
+}
 
-    // Ϊҳˢ
-    uint32_t evict_page_id = oldest_it->first;
-    if (oldest_it->second.is_dirty) {
-        if (page_manager.write_page(evict_page_id, oldest_it->second.page)) {
-            write_log("FIFO evict: dirty page " + to_string(evict_page_id) + " flushed to disk");
+// -------------------------- 私有辅助函数：命中时更新替换状态 --------------------------
+void CacheManager::touch_node(Shard& shard, uint32_t page_id, CacheNode& node, AccessHint hint) {
+    if (node.queue_id == QUEUE_COLD) {
+        // 扫描读入的页被普通访问：离开冷队列，按新页登记到替换策略
+        if (hint == AccessHint::SEQUENTIAL) return;
+        shard.cold_queue.erase(node.queue_pos);
+        track_new_node(shard, page_id, node);
+        return;
+    }
+    if (hint == AccessHint::SEQUENTIAL) return; // 顺序扫描不提升
+    switch (policy) {
+    case ReplacePolicy::LRU:
+        shard.queue.splice(shard.queue.begin(), shard.queue, node.queue_pos); // O(1)，迭代器保持有效
+        break;
+    case ReplacePolicy::CLOCK:
+        node.ref_bit = true;
+        break;
+    case ReplacePolicy::TWO_Q:
+        // A1in中的页命中不调整（FIFO），Am中的页移到队头
+        if (node.queue_id == QUEUE_SECOND) shard.queue2.splice(shard.queue2.begin(), shard.queue2, node.queue_pos);
+        break;
+    case ReplacePolicy::LRU_2:
+        if (node.queue_id == QUEUE_MAIN) {
+            shard.queue.erase(node.queue_pos);
+            node.queue_id = QUEUE_SECOND;
+        }
+        else {
+            shard.lruk_order.erase({ node.penult_access, page_id });
+        }
+        node.penult_access = node.last_access;
+        node.last_access = ++shard.access_clock;
+        shard.lruk_order.insert({ node.penult_access, page_id });
+        break;
+    case ReplacePolicy::ARC:
+        // T1中的页第二次被访问移到T2，T2中的页移到队头
+        if (node.queue_id == QUEUE_MAIN) {
+            shard.queue.erase(node.queue_pos);
+            shard.queue2.push_front(page_id);
+            node.queue_pos = shard.queue2.begin();
+            node.queue_id = QUEUE_SECOND;
         }
         else {
-            write_log("FIFO evict warning: dirty page " + to_string(evict_page_id) + " flush failed");
+            shard.queue2.splice(shard.queue2.begin(), shard.queue2, node.queue_pos);
+        }
+        break;
+    default: // FIFO：命中不调整
+        break;
+    }
+}
+
+// -------------------------- 私有替换策略：LRU移除 --------------------------
+bool CacheManager::lru_evict(Shard& shard) {
+    // 队尾即“最久未使用”的页，无需遍历；被固定的页跳过
+    return evict_from_tail(shard, shard.queue);
+}
+
+// -------------------------- 私有替换策略：FIFO移除 --------------------------
+bool CacheManager::fifo_evict(Shard& shard) {
+    // 队尾即“最早加入”的页（命中时不调整队列顺序）；被固定的页跳过
+    return evict_from_tail(shard, shard.queue);
+}
+
+bool CacheManager::evict_from_tail(Shard& shard, list<uint32_t>& queue) {
+    for (auto pos = queue.rbegin(); pos != queue.rend(); ++pos) {
+        auto it = shard.cache_map.find(*pos);
+        if (it->second.pin_count > 0) continue;
+        remove_node(shard, it);
+        return true;
+    }
+    return false;
+}
+
+// -------------------------- 私有替换策略：CLOCK移除 --------------------------
+bool CacheManager::clock_evict(Shard& shard) {
+    if (shard.cache_map.empty() || shard.clock_ring.empty()) return false;
+    // 指针转动：引用位为1则清零并跳过，遇到引用位为0的页即为替换目标（被固定的页直接跳过）
+    // 最坏情况转一圈后所有引用位都已清零，因此最多扫描两圈
+    uint32_t ring_size = static_cast<uint32_t>(shard.clock_ring.size());
+    for (uint32_t step = 0; step < 2 * ring_size; ++step) {
+        uint32_t slot = shard.clock_hand;
+        shard.clock_hand = (shard.clock_hand + 1) % ring_size;
+        uint32_t page_id = shard.clock_ring[slot];
+        if (page_id == INVALID_PAGE_ID) continue; // 空槽
+        auto it = shard.cache_map.find(page_id);
+        if (it->second.pin_count > 0) continue;
+        if (it->second.ref_bit) {
+            it->second.ref_bit = false;
+            continue;
         }
+        remove_node(shard, it);
+        return true;
+    }
+    return false;
+}
+
+// -------------------------- 私有替换策略：2Q移除 --------------------------
+bool CacheManager::two_q_evict(Shard& shard) {
+    // A1in超过其份额时从A1in队尾换出（只被访问过一次的页先走），否则从Am队尾换出
+    size_t in_limit = max<size_t>(1, static_cast<size_t>(shard.capacity * TWO_Q_IN_RATIO));
+    if (shard.queue.size() > in_limit || shard.queue2.empty()) {
+        return evict_from_tail(shard, shard.queue) || evict_from_tail(shard, shard.queue2);
     }
+    return evict_from_tail(shard, shard.queue2) || evict_from_tail(shard, shard.queue);
+}
 
-    // Ƴҳ¼־
-    write_log("FIFO evict: page " + to_string(evict_page_id) + " removed from cache");
-    cache_map.erase(oldest_it);
+// -------------------------- 私有替换策略：LRU-2移除 --------------------------
+bool CacheManager::lru2_evict(Shard& shard) {
+    // 只访问过一次的页倒数第二次访问时间视为无穷远，优先换出（其中按LRU顺序）；
+    // 其余页按倒数第二次访问时间从早到晚换出
+    if (evict_from_tail(shard, shard.queue)) return true;
+    for (const auto& entry : shard.lruk_order) {
+        auto it = shard.cache_map.find(entry.second);
+        if (it->second.pin_count > 0) continue;
+        remove_node(shard, it);
+        return true;
+    }
+    return false;
+}
 
-    // ʣ໺ҳis_newǣ¼ıΪtrueΪfalse
-    for (auto& entry : cache_map) {
-        entry.second.is_new = false;
+// -------------------------- 私有替换策略：ARC移除 --------------------------
+void CacheManager::arc_adapt(Shard& shard, uint32_t page_id) {
+    // 命中B1说明T1太小，命中B2说明T2太小：按两个幽灵队列的长度比调整目标p
+    uint32_t c = shard.capacity;
+    size_t b1 = shard.ghost1.size(), b2 = shard.ghost2.size();
+    if (shard.ghost1.contains(page_id)) {
+        size_t delta = max<size_t>(1, b1 ? b2 / b1 : 1);
+        shard.arc_target = static_cast<uint32_t>(min<size_t>(c, shard.arc_target + delta));
+    }
+    else if (shard.ghost2.contains(page_id)) {
+        size_t delta = max<size_t>(1, b2 ? b1 / b2 : 1);
+        shard.arc_target = shard.arc_target > delta ? static_cast<uint32_t>(shard.arc_target - delta) : 0;
     }
 }
 
-// -------------------------- ˽ͨ滻߼ --------------------------
-void CacheManager::evict_page() {
-    if (policy == ReplacePolicy::LRU) {
-        lru_evict();
+void CacheManager::arc_trim(Shard& shard) {
+    // |T1|+|B1| <= c，|T1|+|T2|+|B1|+|B2| <= 2c
+    size_t c = shard.capacity;
+    while (!shard.ghost1.order.empty() && shard.queue.size() + shard.ghost1.size() > c) {
+        shard.ghost1.pop_back();
     }
-    else if (policy == ReplacePolicy::FIFO) {
-        fifo_evict();
+    while (!shard.ghost2.order.empty() &&
+        shard.queue.size() + shard.queue2.size() + shard.ghost1.size() + shard.ghost2.size() > 2 * c) {
+        shard.ghost2.pop_back();
     }
 }
 
-// -------------------------- 캯 --------------------------
-CacheManager::CacheManager(PageManager& pm, uint32_t cap, ReplacePolicy pol, const string& log_path)
-    : page_manager(pm), cache_capacity(cap), policy(pol),
-    log_file_path(log_path), hit_count(0), miss_count(0) {
-    // ʼ־ļдϢ
-    write_log("CacheManager initialized: capacity=" + to_string(cap) +
-        ", policy=" + (policy == ReplacePolicy::LRU ? "LRU" : "FIFO"));
+bool CacheManager::arc_evict(Shard& shard, uint32_t incoming_page_id) {
+    // T1超过目标p（或新页命中B2且T1恰为p）时从T1换出，否则从T2换出
+    size_t t1 = shard.queue.size();
+    bool from_t1 = t1 >= 1 &&
+        (t1 > shard.arc_target || (shard.ghost2.contains(incoming_page_id) && t1 == shard.arc_target));
+    if (from_t1) {
+        return evict_from_tail(shard, shard.queue) || evict_from_tail(shard, shard.queue2);
+    }
+    return evict_from_tail(shard, shard.queue2) || evict_from_tail(shard, shard.queue);
 }
 
-// -------------------------- Ľӿڣget_page --------------------------
-Page* CacheManager::get_page(uint32_t page_id) {
-    // 1. 黺Ƿ
-    auto it = cache_map.find(page_id);
-    if (it != cache_map.end()) {
-        // У·ϢLRUʱ䣬FIFO޲
-        hit_count++;
-        if (policy == ReplacePolicy::LRU) {
-            it->second.access_time = time(nullptr); // ʱ
+// -------------------------- 私有通用替换逻辑 --------------------------
+bool CacheManager::evict_page(Shard& shard, uint32_t incoming_page_id) {
+    // 顺序扫描读入的页优先换出，不挤占替换策略管理的工作集
+    if (evict_from_tail(shard, shard.cold_queue)) return true;
+    switch (policy) {
+    case ReplacePolicy::LRU: return lru_evict(shard);
+    case ReplacePolicy::FIFO: return fifo_evict(shard);
+    case ReplacePolicy::CLOCK: return clock_evict(shard);
+    case ReplacePolicy::TWO_Q: return two_q_evict(shard);
+    case ReplacePolicy::LRU_2: return lru2_evict(shard);
+    case ReplacePolicy::ARC: return arc_evict(shard, incoming_page_id);
+    }
+    return false;
+}
+
+// 按换出顺序（最先被换出的在前）遍历分片内的页：冷队列、然后按策略
+template <typename Fn>
+void CacheManager::for_each_in_evict_order(Shard& shard, Fn visit) {
+    for (auto pos = shard.cold_queue.rbegin(); pos != shard.cold_queue.rend(); ++pos) {
+        if (!visit(*pos)) return;
+    }
+    if (policy == ReplacePolicy::CLOCK) {
+        // 从指针处开始转一圈
+        size_t ring_size = shard.clock_ring.size();
+        for (size_t step = 0; step < ring_size; ++step) {
+            uint32_t page_id = shard.clock_ring[(shard.clock_hand + step) % ring_size];
+            if (page_id != INVALID_PAGE_ID && !visit(page_id)) return;
         }
-        // ¼־
-        string log = "Cache hit: page " + to_string(page_id);
-        write_log(log);
-        return &(it->second.page); // ػҳָ
+        return;
+    }
+    for (auto pos = shard.queue.rbegin(); pos != shard.queue.rend(); ++pos) {
+        if (!visit(*pos)) return;
+    }
+    if (policy == ReplacePolicy::LRU_2) {
+        for (const auto& entry : shard.lruk_order) {
+            if (!visit(entry.second)) return;
+        }
+        return;
+    }
+    for (auto pos = shard.queue2.rbegin(); pos != shard.queue2.rend(); ++pos) {
+        if (!visit(*pos)) return;
     }
+}
 
-    // 2. δУӴ̶ȡҳ
-    miss_count++;
-    Page disk_page(page_id);
-    if (!page_manager.read_page(page_id, disk_page)) {
-        // ̶ȡʧܣҳЧ
-        string log = "Cache miss: page " + to_string(page_id) + " read from disk failed";
-        write_log(log);
-        return nullptr;
+// -------------------------- 构造函数 --------------------------
+CacheManager::CacheManager(PageManager& pm, uint32_t cap, ReplacePolicy pol, const string& log_path,
+    LogLevel log_level, uint32_t log_sample, uint32_t shard_count)
+    : page_manager(pm), cache_capacity(cap), policy(pol), hit_count(0), miss_count(0),
+    event_log(log_path, log_level, log_sample), wal(nullptr), writer_stopping(false), writer_next_shard(0),
+    prefetch_stopping(false), prefetch_count(0), prefetch_hit_count(0) {
+    // 分片数：不超过硬件线程数（或指定值），且每个分片至少CACHE_MIN_FRAMES_PER_SHARD帧
+    uint32_t wanted = shard_count;
+    if (wanted == 0) wanted = max(1u, thread::hardware_concurrency());
+    uint32_t n = max(1u, min(wanted, cap / CACHE_MIN_FRAMES_PER_SHARD));
+    for (uint32_t i = 0; i < n; ++i) {
+        shards.push_back(make_unique<Shard>());
+        Shard& shard = *shards.back();
+        // 容量平均分配，余数分给前几个分片
+        shard.capacity = cap / n + (i < cap % n ? 1 : 0);
+        // 预留哈希桶，避免缓存填满过程中反复rehash
+        shard.cache_map.reserve(shard.capacity);
+        if (policy == ReplacePolicy::CLOCK) {
+            shard.clock_ring.reserve(shard.capacity);
+        }
     }
-    write_log("Cache miss: page " + to_string(page_id) + " read from disk");
+    // 记录启动信息
+    event_log.log(StorageEvent::CACHE_INIT, 0, static_cast<uint8_t>(policy), cap);
+}
+
+CacheManager::~CacheManager() {
+    stop_read_ahead();
+    stop_background_writer();
+}
 
-    // 3. ִ滻
-    if (cache_map.size() >= cache_capacity) {
-        write_log("Cache full: trigger evict policy");
-        evict_page();
+// -------------------------- 私有辅助函数：取缓存节点 --------------------------
+CacheNode* CacheManager::fetch_node(Shard& shard, unique_lock<mutex>& lock, uint32_t page_id, AccessHint hint) {
+    // 1. 检查缓存是否命中
+    auto it = shard.cache_map.find(page_id);
+    if (it != shard.cache_map.end()) {
+        // 命中：更新替换策略状态（顺序扫描的访问不提升）
+        hit_count.fetch_add(1, memory_order_relaxed);
+        touch_node(shard, page_id, it->second, hint);
+        if (it->second.prefetched) {
+            it->second.prefetched = false;
+            prefetch_hit_count.fetch_add(1, memory_order_relaxed);
+        }
+        // 记录命中日志
+        event_log.log(StorageEvent::CACHE_HIT, page_id);
+        return &it->second;
     }
 
-    // 4. ҳ뻺棨FIFOΪ¼룩
-    auto insert_it = cache_map.emplace(page_id, CacheNode(disk_page)).first;
-    if (policy == ReplacePolicy::FIFO) {
-        // Ƚлҳis_newΪfalseٱǵǰҳΪtrue
-        for (auto& entry : cache_map) {
-            entry.second.is_new = false;
+    // 2. 缓存未命中：释放分片锁后从磁盘读取页（读盘期间同分片的其他页仍可访问）
+    miss_count.fetch_add(1, memory_order_relaxed);
+    Page disk_page = page_manager.new_page(page_id);
+    for (;;) {
+        uint64_t write_backs = shard.write_backs.load(memory_order_relaxed);
+        lock.unlock();
+        bool read_ok = page_manager.read_page(page_id, disk_page);
+        lock.lock();
+        if (!read_ok) {
+            // 磁盘读取失败（如页号无效）
+            event_log.log(StorageEvent::CACHE_MISS_FAILED, page_id);
+            return nullptr;
         }
-        insert_it->second.is_new = true;
+
+        // 读盘期间其他线程可能已把同一页放入缓存：直接使用已有的节点
+        it = shard.cache_map.find(page_id);
+        if (it != shard.cache_map.end()) return &it->second;
+        // 读盘期间本分片有页写回：可能是别的线程读入、修改、写回并换出了这一页，读到的是旧内容，重读
+        if (shard.write_backs.load(memory_order_relaxed) == write_backs) break;
+    }
+    event_log.log(StorageEvent::CACHE_MISS, page_id);
+
+    // 3. 分片满：执行替换策略（超出容量的部分在固定页解除后逐步换出）
+    if (policy == ReplacePolicy::ARC && hint == AccessHint::NORMAL) arc_adapt(shard, page_id);
+    while (shard.cache_map.size() >= shard.capacity) {
+        event_log.log(StorageEvent::CACHE_FULL, page_id);
+        if (!evict_page(shard, page_id)) break; // 所有页都被固定：暂时超出容量
+    }
+
+    // 4. 将磁盘页加入缓存（原地构造节点），并登记到替换策略
+    it = shard.cache_map.emplace(piecewise_construct, forward_as_tuple(page_id), forward_as_tuple(disk_page)).first;
+    track_new_node(shard, page_id, it->second, hint);
+    event_log.log(StorageEvent::CACHE_ADD, page_id);
+    return &it->second;
+}
+
+// -------------------------- 核心接口：get_page --------------------------
+Page* CacheManager::get_page(uint32_t page_id, AccessHint hint) {
+    Shard& shard = shard_of(page_id);
+    unique_lock<mutex> lock(shard.latch);
+    CacheNode* node = fetch_node(shard, lock, page_id, hint);
+    // 返回缓存页的指针
+    return node ? &node->page : nullptr;
+}
+
+// -------------------------- 页固定 --------------------------
+Page* CacheManager::pin_page(uint32_t page_id, FrameLatch latch, AccessHint hint) {
+    Shard& shard = shard_of(page_id);
+    CacheNode* node;
+    {
+        unique_lock<mutex> lock(shard.latch);
+        node = fetch_node(shard, lock, page_id, hint);
+        if (!node) return nullptr;
+        ++node->pin_count;
     }
-    write_log("Cache add: page " + to_string(page_id) + " added to cache");
+    // 已固定：节点不会被移除，可以在分片锁外等待页帧锁
+    if (latch == FrameLatch::SHARED) node->frame_latch.lock_shared();
+    else if (latch == FrameLatch::EXCLUSIVE) node->frame_latch.lock();
+    return &node->page;
+}
+
+void CacheManager::unpin_page(uint32_t page_id, bool dirty, FrameLatch latch) {
+    Shard& shard = shard_of(page_id);
+    lock_guard<mutex> lock(shard.latch);
+    auto it = shard.cache_map.find(page_id);
+    if (it == shard.cache_map.end()) return;
+    if (latch == FrameLatch::SHARED) it->second.frame_latch.unlock_shared();
+    else if (latch == FrameLatch::EXCLUSIVE) it->second.frame_latch.unlock();
+    if (it->second.pin_count > 0) --it->second.pin_count;
+    if (dirty) set_dirty(it->second);
+}
 
-    // 5. ػҳָ
-    return &(insert_it->second.page);
+uint32_t CacheManager::get_pin_count(uint32_t page_id) const {
+    const Shard& shard = shard_of(page_id);
+    lock_guard<mutex> lock(shard.latch);
+    auto it = shard.cache_map.find(page_id);
+    return it == shard.cache_map.end() ? 0 : it->second.pin_count;
 }
 
-// -------------------------- Ľӿڣflush_page --------------------------
+// -------------------------- 核心接口：flush_page --------------------------
 bool CacheManager::flush_page(uint32_t page_id) {
-    // 1. ҳǷڻ
-    auto it = cache_map.find(page_id);
-    if (it != cache_map.end()) {
-        // ҳڻУΪҳд̲Ϊҳ
+    // 1. 检查页是否在缓存中
+    Shard& shard = shard_of(page_id);
+    unique_lock<mutex> lock(shard.latch);
+    auto it = shard.cache_map.find(page_id);
+    if (it != shard.cache_map.end()) {
+        // 页在缓存中：若为脏页，固定后在分片锁外写入磁盘并标记为非脏页
         if (it->second.is_dirty) {
-            if (page_manager.write_page(page_id, it->second.page)) {
-                it->second.is_dirty = false;
-                string log = "Flush page success: page " + to_string(page_id) + " flushed to disk";
-                write_log(log);
+            CacheNode& node = it->second;
+            ++node.pin_count;
+            lock.unlock();
+            if (write_back_pinned(shard, page_id, node)) {
+                event_log.log(StorageEvent::FLUSH_PAGE, page_id);
                 return true;
             }
             else {
-                string log = "Flush page failed: page " + to_string(page_id) + " flush to disk error";
-                write_log(log);
+                event_log.log(StorageEvent::FLUSH_PAGE_FAILED, page_id);
                 return false;
             }
         }
         else {
-            // ҳд
-            string log = "Flush page skipped: page " + to_string(page_id) + " is not dirty";
-            write_log(log);
+            // 非脏页，无需写入
+            event_log.log(StorageEvent::FLUSH_PAGE_SKIPPED, page_id);
             return true;
         }
     }
+    lock.unlock();
 
-    // 2. ҳڻУֱӴӴ̶ȡˢ,ʵֽӿ
-    Page disk_page(page_id);
+    // 2. 页不在缓存中：直接从磁盘读取后刷新,实现接口完整性
+    Page disk_page = page_manager.new_page(page_id);
     if (page_manager.read_page(page_id, disk_page)) {
         if (page_manager.write_page(page_id, disk_page)) {
-            string log = "Flush page success: page " + to_string(page_id) + " (not in cache) flushed to disk";
-            write_log(log);
+            event_log.log(StorageEvent::FLUSH_PAGE, page_id, 1);
             return true;
         }
     }
-
-    string log = "Flush page failed: page " + to_string(page_id) + " (not in cache) read/write error";
-    write_log(log);
+    event_log.log(StorageEvent::FLUSH_PAGE_FAILED, page_id, 1);
     return false;
 }
 
-// -------------------------- չӿڣflush_all --------------------------
+// -------------------------- 丢弃页 --------------------------
+uint32_t CacheManager::discard_pages(uint32_t first_page_id, uint32_t last_page_id) {
+    uint32_t discarded = 0;
+    for (auto& shard : shards) {
+        lock_guard<mutex> lock(shard->latch);
+        for (auto it = shard->cache_map.begin(); it != shard->cache_map.end();) {
+            auto cur = it++;
+            if (cur->first < first_page_id || cur->first > last_page_id || cur->second.pin_count > 0) continue;
+            // 清掉脏标记后按普通换出移除（不写回）
+            cur->second.is_dirty = false;
+            remove_node(*shard, cur);
+            ++discarded;
+        }
+    }
+    return discarded;
+}
+
+// -------------------------- 扩展接口：flush_all --------------------------
 void CacheManager::flush_all() {
-    write_log("Flush all dirty pages start");
+    event_log.log(StorageEvent::FLUSH_ALL_BEGIN);
     uint32_t flush_success = 0;
     uint32_t flush_failed = 0;
-
-    // лҳˢҳ
-    for (auto& entry : cache_map) {
-        if (entry.second.is_dirty) {
-            if (page_manager.write_page(entry.first, entry.second.page)) {
-                entry.second.is_dirty = false;
+    // 逐个分片：在分片锁内固定全部脏页，解锁后逐页刷新
+    vector<pair<uint32_t, CacheNode*>> victims;
+    for (auto& shard : shards) {
+        victims.clear();
+        {
+            lock_guard<mutex> lock(shard->latch);
+            for (auto& entry : shard->cache_map) {
+                if (!entry.second.is_dirty) continue;
+                ++entry.second.pin_count;
+                victims.emplace_back(entry.first, &entry.second);
+            }
+        }
+        for (auto& v : victims) {
+            if (write_back_pinned(*shard, v.first, *v.second)) {
                 flush_success++;
             }
             else {
@@ -221,30 +593,344 @@ void CacheManager::flush_all() {
             }
         }
     }
+    // 记录刷新结果日志
+    event_log.log(StorageEvent::FLUSH_ALL_END, 0, 0, flush_success, flush_failed);
+}
+
+// -------------------------- 后台写回：一轮 --------------------------
+uint32_t CacheManager::write_dirty_pages(double dirty_ratio, uint32_t max_age_ms, uint32_t max_pages) {
+    auto now = chrono::steady_clock::now();
+    auto max_age = chrono::milliseconds(max_age_ms);
+    uint32_t written = 0;
+    uint32_t remaining = 0;
+    // 每轮从不同的分片开始，避免每轮的写回额度总被前几个分片用完
+    uint32_t first = writer_next_shard.fetch_add(1, memory_order_relaxed) % shards.size();
+    vector<pair<uint32_t, CacheNode*>> victims;
+    for (size_t i = 0; i < shards.size() && written < max_pages; ++i) {
+        Shard& shard = *shards[(first + i) % shards.size()];
+        uint32_t dirty = 0;
+        victims.clear();
+        {
+            // 分片锁内只挑选并固定要写回的页，写回在锁外进行（不阻塞前台对本分片的访问）
+            lock_guard<mutex> lock(shard.latch);
+            for (const auto& entry : shard.cache_map) {
+                if (entry.second.is_dirty) ++dirty;
+            }
+            uint32_t target = static_cast<uint32_t>(shard.capacity * dirty_ratio);
+            uint32_t left = dirty;
+
+            // 按替换顺序访问：先写回即将被换出的页，替换时就不必再同步刷盘
+            for_each_in_evict_order(shard, [&](uint32_t page_id) {
+                if (written + victims.size() >= max_pages) return false;
+                CacheNode& node = shard.cache_map.find(page_id)->second;
+                if (!node.is_dirty) return true;
+                if (left <= target && now - node.dirty_since < max_age) return true;
+                ++node.pin_count;
+                victims.emplace_back(page_id, &node);
+                --left;
+                return true;
+            });
+        }
+        for (auto& v : victims) {
+            if (write_back_pinned(shard, v.first, *v.second)) {
+                ++written;
+                --dirty;
+            }
+        }
+        remaining += dirty;
+    }
+    if (written > 0) {
+        event_log.log(StorageEvent::BGWRITER_ROUND, 0, 0, written, remaining);
+    }
+    return written;
+}
+
+// -------------------------- 后台写线程 --------------------------
+void CacheManager::writer_loop(uint32_t interval_ms, double dirty_ratio, uint32_t max_age_ms, uint32_t max_pages) {
+    unique_lock<mutex> lock(writer_mutex);
+    while (!writer_stopping) {
+        writer_cv.wait_for(lock, chrono::milliseconds(interval_ms), [this]() { return writer_stopping; });
+        if (writer_stopping) break;
+        lock.unlock();
+        write_dirty_pages(dirty_ratio, max_age_ms, max_pages);
+        lock.lock();
+    }
+}
+
+void CacheManager::start_background_writer(uint32_t interval_ms, double dirty_ratio, uint32_t max_age_ms, uint32_t max_pages) {
+    if (writer_thread.joinable()) return;
+    {
+        lock_guard<mutex> lock(writer_mutex);
+        writer_stopping = false;
+    }
+    writer_thread = thread(&CacheManager::writer_loop, this, max(1u, interval_ms), dirty_ratio, max_age_ms, max_pages);
+}
+
+void CacheManager::stop_background_writer() {
+    if (!writer_thread.joinable()) return;
+    {
+        lock_guard<mutex> lock(writer_mutex);
+        writer_stopping = true;
+    }
+    writer_cv.notify_all();
+    writer_thread.join();
+}
+
+// -------------------------- 顺序预读：扫描侧 --------------------------
+void CacheManager::read_ahead(ReadAheadState& state, uint32_t page_id, uint32_t next_page_id) {
+    if (!prefetch_thread.joinable()) return;
+    uint32_t max_window = min<uint32_t>(READAHEAD_MAX_WINDOW, cache_capacity / 4);
+    if (max_window < READAHEAD_MIN_WINDOW) return;
+
+    // 1. 检测顺序扫描：当前页正是上一页的下一页；跳到别处则从头检测
+    if (page_id == state.expected_page) {
+        ++state.sequential;
+    }
+    else {
+        state.sequential = 1;
+        state.window = 0;
+        state.remaining = 0;
+    }
+    state.expected_page = next_page_id;
+    if (state.remaining > 0) --state.remaining;
+    if (next_page_id == INVALID_PAGE_ID) return;
+
+    // 2. 刚判定为扫描：预读最小窗口
+    if (state.window == 0) {
+        if (state.sequential < READAHEAD_TRIGGER_PAGES) return;
+        state.window = READAHEAD_MIN_WINDOW;
+        submit_prefetch(next_page_id, state.window);
+        state.remaining = state.window;
+        return;
+    }
+    // 3. 走到异步预读标记：上一窗口还剩一半时接着预读下一窗口，窗口翻倍
+    uint32_t continue_from = take_readahead_mark(page_id);
+    if (continue_from != INVALID_PAGE_ID) {
+        state.window = min(state.window * 2, max_window);
+        submit_prefetch(continue_from, state.window);
+        state.remaining += state.window;
+    }
+    else if (state.remaining == 0) {
+        // 已走完预读过的页却没遇到标记（标记页被换出或请求被丢弃）：从下一页重新预读
+        submit_prefetch(next_page_id, state.window);
+        state.remaining = state.window;
+    }
+}
+
+void CacheManager::submit_prefetch(uint32_t first_page_id, uint32_t count) {
+    {
+        lock_guard<mutex> lock(prefetch_mutex);
+        if (prefetch_queue.size() >= READAHEAD_MAX_PENDING) return;
+        prefetch_queue.push_back({ first_page_id, count, count / 2 });
+    }
+    prefetch_cv.notify_one();
+}
+
+void CacheManager::set_readahead_mark(uint32_t page_id, uint32_t next_page_id) {
+    Shard& shard = shard_of(page_id);
+    lock_guard<mutex> lock(shard.latch);
+    auto it = shard.cache_map.find(page_id);
+    if (it != shard.cache_map.end()) it->second.readahead_next = next_page_id;
+}
+
+uint32_t CacheManager::take_readahead_mark(uint32_t page_id) {
+    Shard& shard = shard_of(page_id);
+    lock_guard<mutex> lock(shard.latch);
+    auto it = shard.cache_map.find(page_id);
+    if (it == shard.cache_map.end()) return INVALID_PAGE_ID;
+    uint32_t next_page_id = it->second.readahead_next;
+    it->second.readahead_next = INVALID_PAGE_ID;
+    return next_page_id;
+}
+
+// -------------------------- 顺序预读：I/O线程 --------------------------
+bool CacheManager::cached_next_page(uint32_t page_id, bool& in_cache, uint32_t& next_page_id) {
+    Shard& shard = shard_of(page_id);
+    lock_guard<mutex> lock(shard.latch);
+    auto it = shard.cache_map.find(page_id);
+    in_cache = (it != shard.cache_map.end());
+    if (!in_cache) return true;
+    // 与write_back相同：持有分片锁时只尝试加页帧读锁
+    if (!it->second.frame_latch.try_lock_shared()) return false;
+    next_page_id = it->second.page.get_next_page_id();
+    it->second.frame_latch.unlock_shared();
+    return true;
+}
+
+bool CacheManager::insert_prefetched(const Page& page, const vector<uint64_t>& write_backs) {
+    uint32_t page_id = page.get_page_id();
+    uint32_t index = page_id % shards.size();
+    Shard& shard = *shards[index];
+    lock_guard<mutex> lock(shard.latch);
+    if (shard.cache_map.count(page_id)) return true;
+    // 读盘期间本分片有脏页写回：该页可能刚被换入、修改并写回后换出，读到的是旧内容
+    if (shard.write_backs.load(memory_order_relaxed) != write_backs[index]) return false;
+    // 预读不让缓存超出容量：无页可换出时放弃
+    while (shard.cache_map.size() >= shard.capacity) {
+        if (!evict_page(shard)) return false;
+    }
+    // 预读的页来自顺序扫描：放入冷队列，不挤占工作集
+    auto it = shard.cache_map.emplace(piecewise_construct, forward_as_tuple(page_id), forward_as_tuple(page)).first;
+    track_new_node(shard, page_id, it->second, AccessHint::SEQUENTIAL);
+    it->second.prefetched = true;
+    prefetch_count.fetch_add(1, memory_order_relaxed);
+    return true;
+}
+
+void CacheManager::run_prefetch(const PrefetchJob& job) {
+    uint32_t page_id = job.first_page_id;
+    uint32_t mark_page = INVALID_PAGE_ID;
+    uint32_t loaded = 0;
+    // 一次读盘得到的连续页：页链落在连续区段上时（下一页号=当前页号+1），把窗口剩余部分一次读出
+    vector<Page> batch;
+    uint32_t batch_first = INVALID_PAGE_ID;
+    vector<uint64_t> write_backs(shards.size());
+    uint32_t prev_page = INVALID_PAGE_ID;
+    bool complete = true;
+    for (uint32_t i = 0; i < job.count && page_id != INVALID_PAGE_ID; ++i) {
+        if (i == job.mark_offset) mark_page = page_id;
+        bool in_cache = false;
+        uint32_t next_page_id = INVALID_PAGE_ID;
+        if (!cached_next_page(page_id, in_cache, next_page_id)) {
+            complete = false;
+            break;
+        }
+        if (!in_cache) {
+            if (batch_first == INVALID_PAGE_ID || page_id < batch_first || page_id - batch_first >= batch.size()) {
+                for (size_t s = 0; s < shards.size(); ++s) write_backs[s] = shards[s]->write_backs.load(memory_order_relaxed);
+                uint32_t count = (prev_page != INVALID_PAGE_ID && page_id == prev_page + 1) ? job.count - i : 1;
+                batch_first = page_id;
+                if (page_manager.read_pages(page_id, count, batch) == 0) {
+                    complete = false;
+                    break;
+                }
+            }
+            const Page& page = batch[page_id - batch_first];
+            if (!insert_prefetched(page, write_backs)) {
+                complete = false;
+                break;
+            }
+            next_page_id = page.get_next_page_id();
+            ++loaded;
+        }
+        prev_page = page_id;
+        page_id = next_page_id;
+    }
+    // 窗口读完且页链未结束：在窗口中部放标记，扫描走到那里时从窗口之后继续
+    if (complete && page_id != INVALID_PAGE_ID && mark_page != INVALID_PAGE_ID) {
+        set_readahead_mark(mark_page, page_id);
+    }
+    event_log.log(StorageEvent::READ_AHEAD, job.first_page_id, 0, loaded, job.count);
+}
 
-    // ¼ˢ½־
-    string log = "Flush all dirty pages end: success=" + to_string(flush_success) +
-        ", failed=" + to_string(flush_failed);
-    write_log(log);
+void CacheManager::prefetch_loop() {
+    unique_lock<mutex> lock(prefetch_mutex);
+    while (!prefetch_stopping) {
+        prefetch_cv.wait(lock, [this]() { return prefetch_stopping || !prefetch_queue.empty(); });
+        if (prefetch_stopping) break;
+        PrefetchJob job = prefetch_queue.front();
+        prefetch_queue.pop_front();
+        lock.unlock();
+        run_prefetch(job);
+        lock.lock();
+    }
+}
+
+void CacheManager::start_read_ahead() {
+    if (prefetch_thread.joinable()) return;
+    {
+        lock_guard<mutex> lock(prefetch_mutex);
+        prefetch_stopping = false;
+    }
+    prefetch_thread = thread(&CacheManager::prefetch_loop, this);
 }
 
-// -------------------------- ͳϢ --------------------------
+void CacheManager::stop_read_ahead() {
+    if (!prefetch_thread.joinable()) return;
+    {
+        lock_guard<mutex> lock(prefetch_mutex);
+        prefetch_stopping = true;
+        prefetch_queue.clear();
+    }
+    prefetch_cv.notify_all();
+    prefetch_thread.join();
+}
+
+// -------------------------- 辅助接口 --------------------------
+uint32_t CacheManager::get_current_size() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        lock_guard<mutex> lock(shard->latch);
+        total += shard->cache_map.size();
+    }
+    return static_cast<uint32_t>(total);
+}
+
+uint32_t CacheManager::get_dirty_count() const {
+    uint32_t total = 0;
+    for (const auto& shard : shards) {
+        lock_guard<mutex> lock(shard->latch);
+        for (const auto& entry : shard->cache_map) {
+            if (entry.second.is_dirty) ++total;
+        }
+    }
+    return total;
+}
+
+Page* CacheManager::peek_page(uint32_t page_id) {
+    Shard& shard = shard_of(page_id);
+    lock_guard<mutex> lock(shard.latch);
+    auto it = shard.cache_map.find(page_id);
+    return it == shard.cache_map.end() ? nullptr : &it->second.page;
+}
+
+bool CacheManager::contains(uint32_t page_id) const {
+    const Shard& shard = shard_of(page_id);
+    lock_guard<mutex> lock(shard.latch);
+    return shard.cache_map.count(page_id) > 0;
+}
+
+bool CacheManager::is_dirty(uint32_t page_id) const {
+    const Shard& shard = shard_of(page_id);
+    lock_guard<mutex> lock(shard.latch);
+    auto it = shard.cache_map.find(page_id);
+    return it != shard.cache_map.end() && it->second.is_dirty;
+}
+
+void CacheManager::mark_dirty(uint32_t page_id) {
+    Shard& shard = shard_of(page_id);
+    lock_guard<mutex> lock(shard.latch);
+    auto it = shard.cache_map.find(page_id);
+    if (it != shard.cache_map.end()) {
+        set_dirty(it->second);
+    }
+}
+
+// -------------------------- 缓存统计信息 --------------------------
 void CacheManager::get_cache_stats(uint32_t& hit, uint32_t& miss, double& hit_rate) const {
-    hit = hit_count;
-    miss = miss_count;
+    hit = hit_count.load(memory_order_relaxed);
+    miss = miss_count.load(memory_order_relaxed);
     uint32_t total = hit + miss;
     hit_rate = (total == 0) ? 0.0 : static_cast<double>(hit) / total;
 }
 
+void CacheManager::get_prefetch_stats(uint32_t& prefetched, uint32_t& prefetch_hits) const {
+    prefetched = prefetch_count.load(memory_order_relaxed);
+    prefetch_hits = prefetch_hit_count.load(memory_order_relaxed);
+}
+
 void CacheManager::print_stats() const {
     uint32_t hit, miss;
     double hit_rate;
     get_cache_stats(hit, miss, hit_rate);
+    uint32_t prefetched, prefetch_hits;
+    get_prefetch_stats(prefetched, prefetch_hits);
 
     cout << "=== Cache Statistics ===" << endl;
     cout << "Total Access: " << hit + miss << endl;
     cout << "Hit Count:    " << hit << endl;
     cout << "Miss Count:   " << miss << endl;
     cout << "Hit Rate:     " << fixed << setprecision(2) << hit_rate * 100 << "%" << endl;
+    cout << "Prefetched:   " << prefetched << " (hits " << prefetch_hits << ")" << endl;
     cout << "=======================" << endl;
 }
\ No newline at end of file
@@ -1,96 +1,344 @@
 // =============================================
 // storage/cache_manager.hpp
-// =============================================//CacheManagerࣨṹLRU/FIFO ԡͳơĽӿڣ
+// =============================================//定义CacheManager类（缓存结构、LRU/FIFO 策略、命中统计、核心接口）
 #ifndef CACHE_MANAGER_H
 #define CACHE_MANAGER_H
 
 #include "page_manager.hpp"
 #include "page.hpp"
+#include "event_log.hpp"
+#include "wal_manager.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
 #include <unordered_map>
 #include <list>
+#include <vector>
 #include <string>
 #include <time.h>
 #include <fstream>
 #include <stdexcept>
+#include <thread>
 
-// 滻
+// 缓存替换策略（后三种抗扫描：只访问一次的页不会把反复访问的页挤出缓存）
 enum class ReplacePolicy {
-    LRU,    // ʹ
-    FIFO    // Ƚȳ
+    LRU,    // 最近最少使用（链表+哈希索引，O(1)）
+    FIFO,   // 先进先出
+    CLOCK,  // 时钟/第二次机会
+    TWO_Q,  // 2Q：新页先进FIFO试用队列A1in，被换出后页号进幽灵队列A1out；再次读入时进LRU主队列Am
+    LRU_2,  // LRU-K（K=2）：换出倒数第二次访问最早的页，只访问过一次的页最先换出；换出的页保留访问时间
+    ARC     // 自适应替换：T1（访问一次）/T2（访问多次）两个LRU队列及各自的幽灵队列B1/B2，按幽灵命中调整T1的目标大小
 };
 
-// ҳڵ㣺洢ҳĻϢ
+// 访问提示（取页/固定页时传入）
+enum class AccessHint {
+    NORMAL,     // 普通访问：按替换策略提升
+    SEQUENTIAL  // 顺序扫描：命中时不提升；未命中读入的页放入冷队列，先于其他页按FIFO换出
+};
+
+// 固定页时对页帧加的锁
+enum class FrameLatch {
+    NONE,       // 只固定不加锁（单线程使用）
+    SHARED,     // 读锁：多个读者可同时持有
+    EXCLUSIVE   // 写锁：独占
+};
+
+// 2Q：试用队列A1in的目标大小（占分片容量的比例），幽灵队列A1out的长度（占分片容量的比例）
+#define TWO_Q_IN_RATIO 0.25
+#define TWO_Q_OUT_RATIO 0.5
+
+// 每个分片至少管理的帧数（容量较小时分片数相应减少，小缓存只有一个分片，替换顺序与全局策略一致）
+#define CACHE_MIN_FRAMES_PER_SHARD 64
+// 默认最大分片数（0表示按硬件线程数）
+#define CACHE_DEFAULT_SHARDS 0
+
+// 后台写线程默认参数：每隔BGWRITER_INTERVAL_MS醒来一次，写回脏了超过BGWRITER_MAX_AGE_MS的页；
+// 分片内脏页比例超过BGWRITER_DIRTY_RATIO时，按替换顺序（最先被换出的在前）继续写回直到比例回落；
+// 每轮最多写回BGWRITER_MAX_PAGES页，避免一轮占满磁盘带宽
+#define BGWRITER_INTERVAL_MS 100
+#define BGWRITER_MAX_AGE_MS 1000
+#define BGWRITER_DIRTY_RATIO 0.25
+#define BGWRITER_MAX_PAGES 64
+
+// 顺序预读：沿页链连续访问READAHEAD_TRIGGER_PAGES页后判定为扫描，开始预读READAHEAD_MIN_WINDOW页；
+// 扫描走到窗口中部的标记页时接着预读下一窗口，窗口翻倍，最大READAHEAD_MAX_WINDOW页（且不超过缓存容量的1/4）
+#define READAHEAD_TRIGGER_PAGES 2
+#define READAHEAD_MIN_WINDOW 4
+#define READAHEAD_MAX_WINDOW 64
+// 排队中的预读请求上限（I/O线程跟不上时丢弃新请求，扫描照常按需读页）
+#define READAHEAD_MAX_PENDING 8
+
+// 缓存页节点：存储页的缓存信息
+// 节点只在分片哈希表中原地构造（含锁，不可拷贝/移动），地址在被替换前保持不变
 struct CacheNode {
-    Page page;          // ҳ
-    time_t access_time; // ʱ䣨LRUã
-    bool is_dirty;      // ҳǣ޸ĺδˢ̣
-    bool is_new;        // ˳ǣFIFOãtrue=ȼ룩
+    Page page;          // 缓存的页对象
+    bool is_dirty;      // 脏页标记（修改后未刷盘）
+    std::list<uint32_t>::iterator queue_pos; // 在所属队列中的位置（O(1)移动与删除）
+    uint8_t queue_id;   // 所属队列（CacheManager::QUEUE_*）
+    uint64_t last_access;   // 最近一次访问的逻辑时间（LRU_2用）
+    uint64_t penult_access; // 倒数第二次访问的逻辑时间，0表示只访问过一次（LRU_2用）
+    uint32_t clock_slot; // 在CLOCK环中的槽位（CLOCK用）
+    bool ref_bit;       // 引用位：命中后置位，时钟指针扫过时清零（CLOCK用）
+    uint32_t pin_count; // 固定计数：大于0时不会被替换（由页守卫PageGuard维护）
+    std::chrono::steady_clock::time_point dirty_since; // 由干净变脏的时间（后台写线程按脏页年龄写回）
+    std::shared_mutex frame_latch; // 页帧读写锁（页守卫持有期间加锁，保护页内容）
+    bool prefetched;    // 由预读读入、尚未被访问（首次访问时计一次预读命中）
+    uint32_t readahead_next; // 异步预读标记：扫描访问到该页时从这里继续预读（INVALID_PAGE_ID表示无标记）
 
     CacheNode(const Page& p)
-        : page(p), access_time(time(nullptr)),
-        is_dirty(false), is_new(true) {}
+        : page(p), is_dirty(false), queue_id(0), last_access(0), penult_access(0), clock_slot(0), ref_bit(false),
+        pin_count(0), prefetched(false), readahead_next(INVALID_PAGE_ID) {}
+    CacheNode(const CacheNode&) = delete;
+    CacheNode& operator=(const CacheNode&) = delete;
+};
+
+// 一次页链扫描的预读状态（由扫描者持有，每访问一页交给CacheManager::read_ahead更新）
+struct ReadAheadState {
+    uint32_t expected_page = INVALID_PAGE_ID; // 页链上预期的下一页
+    uint32_t sequential = 0;    // 连续按页链访问的页数
+    uint32_t window = 0;        // 当前预读窗口（页数），0表示尚未开始预读
+    uint32_t remaining = 0;     // 已请求预读、扫描尚未走到的页数
 };
 
 class CacheManager {
 private:
-    PageManager& page_manager;          // ҳڻδʱ̡ҳˢ̣
-    std::unordered_map<uint32_t, CacheNode> cache_map;// ϣҳţֵڵ㣩
-    uint32_t cache_capacity;            // ҳָδָûã
-    ReplacePolicy policy;               // 滻ԣLRU/FIFO
-    // ͳϢָҪĻͳƣ
-    uint32_t hit_count;                 // д
-    uint32_t miss_count;                // δд
-    std::string log_file_path;            // ־ļ·ָҪ滻־
-
-    // -------------------------- 滻Ժĺ˽Уڲã --------------------------
-    // LRUԣƳʱ硱Ļҳ
-    void lru_evict();
-    // FIFOԣƳ뻺桱Ļҳ
-    void fifo_evict();
-    // ͨ滻߼ݲԵöӦevict
-    void evict_page();
-    // д־ļָҪ滻־
-    void write_log(const string& log_content);
+    // 节点所属队列
+    static const uint8_t QUEUE_MAIN = 0;    // LRU/FIFO队列；2Q的A1in；LRU_2中只访问过一次的页；ARC的T1
+    static const uint8_t QUEUE_SECOND = 1;  // 2Q的Am；LRU_2中访问过两次以上的页（lruk_order）；ARC的T2
+    static const uint8_t QUEUE_COLD = 2;    // 顺序扫描读入、尚未被普通访问的页
+
+    // 幽灵队列：只记页号（已换出的页），表头最新；用于2Q的A1out、ARC的B1/B2与LRU_2的访问历史
+    struct GhostList {
+        std::list<uint32_t> order;
+        std::unordered_map<uint32_t, std::list<uint32_t>::iterator> index;
+
+        bool contains(uint32_t page_id) const { return index.count(page_id) > 0; }
+        size_t size() const { return order.size(); }
+        void push_front(uint32_t page_id);
+        bool erase(uint32_t page_id);
+        // 移除最旧的页号，返回该页号（为空时返回INVALID_PAGE_ID）
+        uint32_t pop_back();
+    };
+
+    // 缓存分片：按页号哈希划分，每个分片有独立的锁、哈希表和替换策略状态
+    // 锁顺序：分片锁 -> 页帧锁（持有分片锁时只try_lock页帧锁，避免与持有页帧锁、等待分片锁的线程互等）
+    struct Shard {
+        mutable std::mutex latch;                         // 分片锁（保护以下全部成员与节点的元信息）
+        std::unordered_map<uint32_t, CacheNode> cache_map; // 分片哈希表（键：页号，值：缓存节点）
+        uint32_t capacity;                                // 分片容量
+        std::list<uint32_t> queue;          // LRU：表头最近使用、表尾最久未用；FIFO：表头最新加入、表尾最早加入
+                                            // 2Q：A1in（FIFO）；LRU_2：只访问过一次的页（按访问先后）；ARC：T1（LRU）
+        std::list<uint32_t> queue2;         // 2Q：Am（LRU）；ARC：T2（LRU）
+        std::list<uint32_t> cold_queue;     // 顺序扫描读入的页（FIFO，表尾最先换出）
+        std::set<std::pair<uint64_t, uint32_t>> lruk_order; // LRU_2：访问过两次以上的页，按（倒数第二次访问时间, 页号）排序
+        std::unordered_map<uint32_t, uint64_t> lruk_history; // LRU_2：已换出页的最近访问时间（页号由ghost1限定数量）
+        uint64_t access_clock;              // LRU_2：逻辑时钟（每次访问+1）
+        GhostList ghost1;                   // 2Q：A1out；ARC：B1；LRU_2：保留访问历史的已换出页
+        GhostList ghost2;                   // ARC：B2
+        uint32_t arc_target;                // ARC：T1的目标大小p
+        std::vector<uint32_t> clock_ring;   // CLOCK环：槽位 -> 页号（INVALID_PAGE_ID表示空槽）
+        std::vector<uint32_t> clock_free_slots; // CLOCK环中被腾空、可复用的槽位
+        uint32_t clock_hand;                // CLOCK指针当前位置
+        std::atomic<uint64_t> write_backs;  // 脏页写回次数（未命中/预读读盘期间本分片有页写回时，读到的页可能已过时）
+
+        Shard() : capacity(0), access_clock(0), arc_target(0), clock_hand(0), write_backs(0) {}
+    };
+    using NodeIter = std::unordered_map<uint32_t, CacheNode>::iterator;
+
+    PageManager& page_manager;          // 关联的页管理器（用于缓存未命中时读磁盘、脏页刷盘）
+    std::vector<std::unique_ptr<Shard>> shards; // 缓存分片
+    uint32_t cache_capacity;            // 缓存最大容量（页数量，指导书未指定，用户可配置），各分片容量之和
+    ReplacePolicy policy;               // 缓存替换策略（LRU/FIFO）
+    // 统计信息（指导书要求的缓存命中统计），多线程下原子累加
+    std::atomic<uint32_t> hit_count;    // 命中次数
+    std::atomic<uint32_t> miss_count;   // 未命中次数
+    EventLog event_log;                 // 事件日志（异步写文件，指导书要求的替换日志输出）
+    WalManager* wal;                    // 写前日志（nullptr表示不记日志）：脏页写回前日志须已持久化到页LSN
+
+    // 后台写线程（按脏页年龄与脏页比例把脏页逐步写回，减少替换时的同步刷盘）
+    std::thread writer_thread;
+    std::mutex writer_mutex;
+    std::condition_variable writer_cv;
+    bool writer_stopping;
+    std::atomic<uint32_t> writer_next_shard; // 下一轮写回从哪个分片开始
+
+    // 预读I/O线程：沿页链（或连续区段）把后续页读入缓存
+    struct PrefetchJob {
+        uint32_t first_page_id;   // 起始页
+        uint32_t count;           // 沿页链预读的页数
+        uint32_t mark_offset;     // 在第几页放异步预读标记
+    };
+    std::thread prefetch_thread;
+    std::mutex prefetch_mutex;
+    std::condition_variable prefetch_cv;
+    std::deque<PrefetchJob> prefetch_queue;
+    bool prefetch_stopping;
+    std::atomic<uint32_t> prefetch_count;     // 预读读入的页数
+    std::atomic<uint32_t> prefetch_hit_count; // 预读读入后被访问的页数
+
+    Shard& shard_of(uint32_t page_id) { return *shards[page_id % shards.size()]; }
+    const Shard& shard_of(uint32_t page_id) const { return *shards[page_id % shards.size()]; }
+
+    // -------------------------- 替换策略核心函数（私有，内部调用，调用者持有分片锁） --------------------------
+    // 以下替换函数都跳过被固定的页；所有页都被固定时不移除任何页，返回false
+    // LRU策略：移除队尾“最久未使用”的缓存页，O(1)（队尾有固定页时向前跳过）
+    bool lru_evict(Shard& shard);
+    // FIFO策略：移除队尾“最早加入缓存”的缓存页，O(1)（队尾有固定页时向前跳过）
+    bool fifo_evict(Shard& shard);
+    // CLOCK策略：指针扫过引用位为1的页时清零，移除第一个引用位为0且未固定的页（均摊O(1)）
+    bool clock_evict(Shard& shard);
+    // 从队列表尾起移除第一个未固定的页
+    bool evict_from_tail(Shard& shard, std::list<uint32_t>& queue);
+    // 2Q策略：A1in超过目标大小（或Am中无页可换出）时换出A1in表尾，否则换出Am表尾
+    bool two_q_evict(Shard& shard);
+    // LRU_2策略：先换出只访问过一次的页（最早访问的在前），再按倒数第二次访问时间从早到晚换出
+    bool lru2_evict(Shard& shard);
+    // ARC策略：T1超过目标大小（或即将读入的页在B2中且T1恰为目标大小）时换出T1表尾，否则换出T2表尾
+    bool arc_evict(Shard& shard, uint32_t incoming_page_id);
+    // ARC：未命中的页在幽灵队列中时调整T1的目标大小（在换出之前调用）
+    void arc_adapt(Shard& shard, uint32_t page_id);
+    // ARC：限制幽灵队列长度（|T1|+|B1| <= c，总长 <= 2c）
+    void arc_trim(Shard& shard);
+    // 通用替换逻辑：先换出冷队列中的页，再根据策略调用对应evict函数
+    // incoming_page_id-即将读入的页（ARC据此选择换出的队列）
+    bool evict_page(Shard& shard, uint32_t incoming_page_id = INVALID_PAGE_ID);
+    // 移除指定缓存页（脏页先刷盘），并清理替换策略状态（2Q/ARC/LRU_2把页号记入幽灵队列）
+    void remove_node(Shard& shard, NodeIter it);
+    // 新页加入缓存后登记到替换策略（hint为SEQUENTIAL时放入冷队列）
+    void track_new_node(Shard& shard, uint32_t page_id, CacheNode& node, AccessHint hint = AccessHint::NORMAL);
+    // 命中时更新替换状态（LRU移到队头、CLOCK置引用位、2Q/ARC/LRU_2按访问次数提升）
+    void touch_node(Shard& shard, uint32_t page_id, CacheNode& node, AccessHint hint);
+    // 按替换顺序（最先被换出的在前）访问分片中的页，visit返回false时停止
+    template<typename Fn>
+    void for_each_in_evict_order(Shard& shard, Fn visit);
+    // 取缓存节点：命中时更新替换状态；未命中时释放分片锁读磁盘，再加锁放入缓存
+    // （读盘期间本分片有脏页写回时重读，避免放入写回前的旧内容）
+    // 调用前后都持有分片锁；失败返回nullptr
+    CacheNode* fetch_node(Shard& shard, std::unique_lock<std::mutex>& lock, uint32_t page_id,
+        AccessHint hint = AccessHint::NORMAL);
+    // 把节点写回磁盘（调用者持有分片锁，只用于换出）；页帧正被写者锁定时不写，返回false
+    // 写前日志规则：先把日志持久化到页LSN，再写页
+    bool write_back(uint32_t page_id, CacheNode& node);
+    // 把已固定的节点写回磁盘（调用者不持有分片锁，刷日志与写页在锁外进行），完成后解除固定
+    // 页帧正被写者锁定时不写，返回false（flush_page/flush_all/后台写回使用）
+    bool write_back_pinned(Shard& shard, uint32_t page_id, CacheNode& node);
+    // 标记脏页（调用者持有分片锁），由干净变脏时记录时间
+    static void set_dirty(CacheNode& node);
+    // 后台写线程主循环
+    void writer_loop(uint32_t interval_ms, double dirty_ratio, uint32_t max_age_ms, uint32_t max_pages);
+    // 预读线程主循环与单个请求的执行
+    void prefetch_loop();
+    void run_prefetch(const PrefetchJob& job);
+    // 提交预读请求（队列满时丢弃），mark_offset取窗口中部
+    void submit_prefetch(uint32_t first_page_id, uint32_t count);
+    // 预读：页在缓存中时取其下一页号（页帧正被写者锁定时返回false，本次预读到此为止）
+    // 页不在缓存中时in_cache=false
+    bool cached_next_page(uint32_t page_id, bool& in_cache, uint32_t& next_page_id);
+    // 预读：把读到的页放入缓存（已在缓存中时不覆盖）
+    // write_backs-读盘前各分片的写回次数；读盘期间该页所在分片有脏页写回过，或分片满且无页可换出时放弃，返回false
+    bool insert_prefetched(const Page& page, const std::vector<uint64_t>& write_backs);
+    // 预读：在页上放/取异步预读标记
+    void set_readahead_mark(uint32_t page_id, uint32_t next_page_id);
+    uint32_t take_readahead_mark(uint32_t page_id);
 
 public:
-    // 캯ʼҳԡ־·
-    CacheManager(PageManager& pm, uint32_t cap, ReplacePolicy pol, const string& log_path);
+    // 构造函数：初始化缓存管理器（关联页管理器、设置容量、策略、日志路径）
+    // log_level-日志级别（默认只记录替换等关键事件），log_sample-命中/未命中等事件的采样率
+    // shard_count-最大分片数（0表示按硬件线程数），实际分片数不超过 容量/CACHE_MIN_FRAMES_PER_SHARD
+    CacheManager(PageManager& pm, uint32_t cap, ReplacePolicy pol, const std::string& log_path,
+        LogLevel log_level = LogLevel::EVICTIONS, uint32_t log_sample = 1,
+        uint32_t shard_count = CACHE_DEFAULT_SHARDS);
+    // 析构函数：停止后台写线程（不刷盘，刷盘由上层flush_all/检查点负责）
+    ~CacheManager();
+
+    // -------------------------- 指导书核心接口：获取页（get_page） --------------------------
+    // 功能：先查缓存，命中则更新访问信息；未命中则读磁盘，加入缓存（满则替换）
+    // 注意：返回的指针不固定页，多线程访问、需要长时间持有或预读线程运行时应使用页守卫（PageGuard）
+    Page* get_page(uint32_t page_id, AccessHint hint = AccessHint::NORMAL);
 
-    // -------------------------- ָĽӿڣȡҳget_page --------------------------
-    // ܣȲ黺棬·Ϣδ̣뻺棨滻
-    Page* get_page(uint32_t page_id);
+    // -------------------------- 页固定（供PageGuard调用） --------------------------
+    // 功能：取页并固定（固定计数+1），固定期间页不会被替换，返回的指针一直有效；失败返回nullptr
+    // latch-固定后对页帧加的锁（在释放分片锁之后获取，不阻塞同分片的其他页）
+    // 所有缓存页都被固定时，新页仍会加入缓存（缓存暂时超出容量，解除固定后的替换中恢复）
+    // hint-访问提示（顺序扫描传SEQUENTIAL：不提升页，扫描读入的页优先换出）
+    Page* pin_page(uint32_t page_id, FrameLatch latch = FrameLatch::NONE, AccessHint hint = AccessHint::NORMAL);
+    // 功能：释放页帧锁并解除固定（固定计数-1），dirty为true时同时标记为脏页
+    void unpin_page(uint32_t page_id, bool dirty, FrameLatch latch = FrameLatch::NONE);
+    // 功能：查询页的固定计数（不在缓存中返回0）
+    uint32_t get_pin_count(uint32_t page_id) const;
 
-    // -------------------------- ָĽӿڣˢҳflush_page --------------------------
-    // ܣеҳд̣ΪҳҳڻֱӶˢ
+    // -------------------------- 指导书核心接口：刷新页（flush_page） --------------------------
+    // 功能：将缓存中的脏页写入磁盘，并标记为非脏页；页不在缓存则直接读磁盘刷新
+    // 页正被写守卫锁定时不刷盘，返回false（页保持为脏页）
     bool flush_page(uint32_t page_id);
 
-    // -------------------------- ָչӿڣˢҳflush_all --------------------------
-    // ܣˢ»ҳ̣˳ʱãȷݳ־û
+    // -------------------------- 丢弃页 --------------------------
+    // 功能：把页号在[first_page_id, last_page_id]内的缓存页移出缓存，脏页不写回（删除/清空表的页文件前调用）
+    //      被固定的页保留；返回移出的页数
+    uint32_t discard_pages(uint32_t first_page_id, uint32_t last_page_id);
+
+    // -------------------------- 指导书扩展接口：刷新所有页（flush_all） --------------------------
+    // 功能：刷新缓存中所有脏页到磁盘（程序退出时调用，确保数据持久化）
     void flush_all();
 
-    // -------------------------- ָҪ󣺻ͳϢӿ --------------------------
-    // ܣȡдδд
+    // -------------------------- 后台写回 --------------------------
+    // 功能：执行一轮写回：写回脏了至少max_age_ms的页；分片脏页比例超过dirty_ratio时按替换顺序继续写回
+    //      直到比例回落；最多写回max_pages页，返回实际写回的页数（被写守卫锁定的页跳过）
+    uint32_t write_dirty_pages(double dirty_ratio, uint32_t max_age_ms, uint32_t max_pages);
+    // 功能：启动后台写线程，每隔interval_ms执行一轮write_dirty_pages（已启动时不重复启动）
+    //      写线程只写回已分配的页，调用方需保证数据文件不会在写回期间重新映射（MMAP模式下不要启动）
+    void start_background_writer(uint32_t interval_ms = BGWRITER_INTERVAL_MS, double dirty_ratio = BGWRITER_DIRTY_RATIO,
+        uint32_t max_age_ms = BGWRITER_MAX_AGE_MS, uint32_t max_pages = BGWRITER_MAX_PAGES);
+    // 功能：停止后台写线程并等待其退出（未启动时为空操作）
+    void stop_background_writer();
+    bool is_background_writer_running() const { return writer_thread.joinable(); }
+
+    // -------------------------- 顺序预读 --------------------------
+    // 功能：启动/停止预读I/O线程（未启动时read_ahead为空操作）；与后台写线程一样，MMAP模式下不要启动
+    void start_read_ahead();
+    void stop_read_ahead();
+    bool is_read_ahead_running() const { return prefetch_thread.joinable(); }
+    // 功能：扫描者沿页链每访问一页调用一次（page_id-当前页，next_page_id-页链上的下一页）
+    //      检测到顺序扫描后在I/O线程上预读后续的页，窗口随持续的顺序访问增长
+    void read_ahead(ReadAheadState& state, uint32_t page_id, uint32_t next_page_id);
+    // 功能：预读统计：预读读入的页数、其中被访问到的页数
+    void get_prefetch_stats(uint32_t& prefetched, uint32_t& prefetch_hits) const;
+
+    // -------------------------- 指导书要求：缓存统计信息接口 --------------------------
+    // 功能：获取命中次数、未命中次数、命中率
     void get_cache_stats(uint32_t& hit, uint32_t& miss, double& hit_rate) const;
-    // ܣͳϢ̨ԣ
+    // 功能：输出统计信息到控制台（辅助调试）
     void print_stats() const;
 
-    // -------------------------- ӿڣ/ã --------------------------
-    // ȡ浱ǰС
-    uint32_t get_current_size() const { return static_cast<uint32_t>(cache_map.size()); }
-    // ȡ
+    // -------------------------- 辅助接口（供测试/调试用） --------------------------
+    // 获取缓存当前大小（各分片之和）
+    uint32_t get_current_size() const;
+    // 获取当前脏页数（各分片之和）
+    uint32_t get_dirty_count() const;
+    // 获取缓存容量
     uint32_t get_capacity() const { return cache_capacity; }
+    // 获取分片数
+    uint32_t get_shard_count() const { return static_cast<uint32_t>(shards.size()); }
+    // 获取事件日志（运行时调整级别/采样率/轮转阈值）
+    EventLog& get_event_log() { return event_log; }
+    // 关联写前日志（由FileManager在打开日志后设置）
+    void set_wal(WalManager* w) { wal = w; }
+    WalManager* get_wal() const { return wal; }
 
 
-    // Ըӿڣȡϣã
-    std::unordered_map<uint32_t, CacheNode>& get_cache_map() { return cache_map; }
+    // 只查缓存不读磁盘（不计入命中统计、不调整替换顺序），不在缓存中返回nullptr
+    Page* peek_page(uint32_t page_id);
+    // 测试辅助接口：页是否在缓存中 / 是否为脏页（不在缓存中返回false）
+    bool contains(uint32_t page_id) const;
+    bool is_dirty(uint32_t page_id) const;
 
-    // ǻҳΪҳFileManagerwrite_pageã
-    void mark_dirty(uint32_t page_id) {
-        auto it = cache_map.find(page_id);
-        if (it != cache_map.end()) {
-            it->second.is_dirty = true;
-        }
-    }
+    // 标记缓存页为脏页（供FileManager的write_page调用）
+    void mark_dirty(uint32_t page_id);
 };
 
 #endif // CACHE_MANAGER_H
\ No newline at end of file
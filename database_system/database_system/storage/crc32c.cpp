@@ -0,0 +1,118 @@
+// =============================================
+// storage/crc32c.cpp
+// =============================================
+//实现CRC32C校验（SSE4.2 crc32指令；不支持时使用查表法，每次处理8字节）
+#include "crc32c.hpp"
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <nmmintrin.h>
+#define CRC32C_X86 1
+#define CRC32C_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <nmmintrin.h>
+#define CRC32C_X86 1
+#define CRC32C_TARGET __attribute__((target("sse4.2")))
+#endif
+
+// 反射多项式 0x82F63B78（Castagnoli）
+static const uint32_t CRC32C_POLY = 0x82F63B78u;
+
+// 8张表：entries[k][b]为字节b后再跟k个零字节的CRC，一次查8张表处理8字节（slicing-by-8）
+struct Crc32cTable {
+    uint32_t entries[8][256];
+    Crc32cTable() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+            }
+            entries[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int k = 1; k < 8; ++k) {
+                entries[k][i] = entries[0][entries[k - 1][i] & 0xFF] ^ (entries[k - 1][i] >> 8);
+            }
+        }
+    }
+};
+
+uint32_t crc32c_software(const void* buf, size_t len, uint32_t crc) {
+    static const Crc32cTable table;
+    const uint8_t* p = static_cast<const uint8_t*>(buf);
+    crc = ~crc;
+    while (len >= 8) {
+        // 按小端序取低4字节与crc异或（与逐字节处理的顺序一致）
+        uint32_t lo = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+            (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        lo ^= crc;
+        crc = table.entries[7][lo & 0xFF] ^ table.entries[6][(lo >> 8) & 0xFF] ^
+            table.entries[5][(lo >> 16) & 0xFF] ^ table.entries[4][lo >> 24] ^
+            table.entries[3][p[4]] ^ table.entries[2][p[5]] ^ table.entries[1][p[6]] ^ table.entries[0][p[7]];
+        p += 8;
+        len -= 8;
+    }
+    while (len-- > 0) {
+        crc = table.entries[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+#ifdef CRC32C_X86
+CRC32C_TARGET static uint32_t crc32c_sse42(const void* buf, size_t len, uint32_t crc) {
+    const uint8_t* p = static_cast<const uint8_t*>(buf);
+    crc = ~crc;
+#if defined(_M_X64) || defined(__x86_64__)
+    uint64_t crc64 = crc;
+    while (len >= 8) {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        crc64 = _mm_crc32_u64(crc64, v);
+        p += 8;
+        len -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    while (len >= 4) {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        crc = _mm_crc32_u32(crc, v);
+        p += 4;
+        len -= 4;
+    }
+    while (len-- > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return ~crc;
+}
+
+static bool cpu_has_sse42() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    return (ecx & bit_SSE4_2) != 0;
+#endif
+}
+#endif
+
+bool crc32c_hardware_enabled() {
+#ifdef CRC32C_X86
+    static const bool enabled = cpu_has_sse42();
+    return enabled;
+#else
+    return false;
+#endif
+}
+
+uint32_t crc32c(const void* buf, size_t len, uint32_t crc) {
+#ifdef CRC32C_X86
+    if (crc32c_hardware_enabled()) return crc32c_sse42(buf, len, crc);
+#endif
+    return crc32c_software(buf, len, crc);
+}
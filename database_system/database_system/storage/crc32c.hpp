@@ -0,0 +1,19 @@
+// =============================================
+// storage/crc32c.hpp
+// =============================================
+//定义CRC32C校验函数（Castagnoli多项式，用于日志记录与页校验和）
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 计算buf[0, len)的CRC32C；crc为之前部分的结果（分段计算时传入，首段为0）
+// CPU支持SSE4.2时使用crc32指令，否则使用软件实现（两者结果相同）
+uint32_t crc32c(const void* buf, size_t len, uint32_t crc = 0);
+// 软件实现（查表法，每次处理8字节），供基准测试对比
+uint32_t crc32c_software(const void* buf, size_t len, uint32_t crc = 0);
+// 当前CPU是否使用硬件指令计算
+bool crc32c_hardware_enabled();
+
+#endif // CRC32C_H
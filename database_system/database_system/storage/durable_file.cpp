@@ -0,0 +1,68 @@
+// =============================================
+// storage/durable_file.cpp
+// =============================================
+//实现小文件的持久替换（Windows：FlushFileBuffers + MoveFileEx写穿；POSIX：fsync + rename + 目录fsync）
+#include "durable_file.hpp"
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+bool replace_file_durably(const string& path, const string& content) {
+    string temp_path = path + ".tmp";
+    HANDLE h = CreateFileA(temp_path.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE) return false;
+    bool ok = true;
+    size_t done = 0;
+    while (ok && done < content.size()) {
+        DWORD chunk = static_cast<DWORD>(min<size_t>(content.size() - done, 1u << 30));
+        DWORD written = 0;
+        ok = WriteFile(h, content.data() + done, chunk, &written, NULL) != 0 && written > 0;
+        done += written;
+    }
+    ok = ok && FlushFileBuffers(h) != 0;
+    CloseHandle(h);
+    // MOVEFILE_WRITE_THROUGH：改名落盘后才返回（NTFS上不需要另外同步目录）
+    ok = ok && MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    if (!ok) DeleteFileA(temp_path.c_str());
+    return ok;
+}
+#else
+bool replace_file_durably(const string& path, const string& content) {
+    string temp_path = path + ".tmp";
+    int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool ok = true;
+    size_t done = 0;
+    while (ok && done < content.size()) {
+        ssize_t n = ::write(fd, content.data() + done, content.size() - done);
+        ok = n > 0;
+        if (ok) done += static_cast<size_t>(n);
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    ok = ok && ::rename(temp_path.c_str(), path.c_str()) == 0;
+    if (!ok) {
+        ::unlink(temp_path.c_str());
+        return false;
+    }
+    // 改名记录在目录中：同步目录后新内容才算持久
+    size_t slash = path.find_last_of('/');
+    string dir = slash == string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dir_fd = ::open(dir.c_str(), O_RDONLY);
+    if (dir_fd < 0) return false;
+    ok = ::fsync(dir_fd) == 0;
+    ::close(dir_fd);
+    return ok;
+}
+#endif
@@ -0,0 +1,14 @@
+// =============================================
+// storage/durable_file.hpp
+// =============================================
+//定义持久替换小文件的函数（meta.dat、catalog.txt：写临时文件并同步，改名替换后同步目录）
+#ifndef DURABLE_FILE_H
+#define DURABLE_FILE_H
+
+#include <string>
+
+// 用content替换path的内容：先写 path.tmp 并同步到磁盘，再改名为path，最后同步所在目录（使改名持久化）
+// 任何时刻崩溃，path要么是完整的旧内容，要么是完整的新内容；失败返回false（path保持不变）
+bool replace_file_durably(const std::string& path, const std::string& content);
+
+#endif // DURABLE_FILE_H
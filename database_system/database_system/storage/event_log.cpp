@@ -0,0 +1,243 @@
+// =============================================
+// storage/event_log.cpp
+// =============================================
+//实现EventLog类（无锁入队、后台格式化与写文件、日志轮转）
+#include "event_log.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+
+// 替换策略名称（与ReplacePolicy枚举顺序一致）
+static const char* policy_name(uint8_t tag) {
+    static const char* names[] = { "LRU", "FIFO", "CLOCK", "2Q", "LRU-2", "ARC" };
+    return tag < sizeof(names) / sizeof(names[0]) ? names[tag] : "UNKNOWN";
+}
+
+// -------------------------- 构造/析构 --------------------------
+EventLog::EventLog(const string& log_path, LogLevel lvl, uint32_t sample,
+    uint64_t max_bytes, uint32_t ring_capacity)
+    : log_file_path(log_path), log_file_size(0), ring_mask(0), enqueue_pos(0), dequeue_pos(0),
+    level(static_cast<int>(lvl)), sample_rate(sample == 0 ? 1 : sample), sample_counter(0),
+    max_file_size(max_bytes), dropped_count(0), reported_dropped(0), stopping(false) {
+    // 容量向上取整为2的幂，便于用掩码取槽位
+    uint64_t capacity = 2;
+    while (capacity < ring_capacity) capacity <<= 1;
+    ring_mask = capacity - 1;
+    ring.reset(new Slot[capacity]);
+    for (uint64_t i = 0; i < capacity; ++i) {
+        ring[i].seq.store(i, memory_order_relaxed);
+    }
+
+    log_file.open(log_file_path, ios::app);
+    if (!log_file) {
+        cerr << "Cache log open failed: cannot open log file - " << log_file_path << endl;
+    }
+    else {
+        log_file.seekp(0, ios::end);
+        streamoff pos = log_file.tellp();
+        log_file_size = pos > 0 ? static_cast<uint64_t>(pos) : 0;
+    }
+
+    flusher = thread(&EventLog::flusher_loop, this);
+}
+
+EventLog::~EventLog() {
+    {
+        lock_guard<mutex> lock(flusher_mutex);
+        stopping = true;
+    }
+    flusher_cv.notify_one();
+    if (flusher.joinable()) flusher.join();
+    // 写出剩余事件
+    drain();
+    if (log_file.is_open()) log_file.close();
+}
+
+// -------------------------- 事件级别 --------------------------
+LogLevel EventLog::level_of(StorageEvent type) {
+    switch (type) {
+    case StorageEvent::CACHE_HIT:
+    case StorageEvent::CACHE_MISS:
+    case StorageEvent::CACHE_ADD:
+    case StorageEvent::CACHE_FULL:
+    case StorageEvent::FLUSH_PAGE:
+    case StorageEvent::FLUSH_PAGE_SKIPPED:
+    case StorageEvent::READ_AHEAD:
+        return LogLevel::ALL;
+    default:
+        return LogLevel::EVICTIONS;
+    }
+}
+
+// -------------------------- 生产者：无锁入队 --------------------------
+void EventLog::log(StorageEvent type, uint32_t page_id, uint8_t tag, uint32_t a, uint32_t b) {
+    LogLevel event_level = level_of(type);
+    if (static_cast<int>(event_level) > level.load(memory_order_relaxed)) return;
+    // 热路径事件按采样率记录，关键事件全部记录
+    if (event_level == LogLevel::ALL) {
+        uint32_t rate = sample_rate.load(memory_order_relaxed);
+        if (rate > 1 && sample_counter.fetch_add(1, memory_order_relaxed) % rate != 0) return;
+    }
+
+    // 抢占一个槽位：槽位序号等于写入位置时可写，否则缓冲已满
+    uint64_t pos = enqueue_pos.load(memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &ring[pos & ring_mask];
+        uint64_t seq = slot->seq.load(memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+        }
+        else if (diff < 0) {
+            // 缓冲已满：丢弃事件而不是阻塞访问路径
+            dropped_count.fetch_add(1, memory_order_relaxed);
+            return;
+        }
+        else {
+            pos = enqueue_pos.load(memory_order_relaxed);
+        }
+    }
+
+    slot->record.timestamp = time(nullptr);
+    slot->record.type = type;
+    slot->record.tag = tag;
+    slot->record.page_id = page_id;
+    slot->record.a = a;
+    slot->record.b = b;
+    slot->seq.store(pos + 1, memory_order_release);
+}
+
+// -------------------------- 消费者：后台线程 --------------------------
+void EventLog::flusher_loop() {
+    unique_lock<mutex> lock(flusher_mutex);
+    while (!stopping) {
+        flusher_cv.wait_for(lock, chrono::milliseconds(100));
+        drain();
+    }
+}
+
+void EventLog::flush() {
+    lock_guard<mutex> lock(flusher_mutex);
+    drain();
+}
+
+uint32_t EventLog::drain() {
+    uint32_t written = 0;
+    for (;;) {
+        Slot& slot = ring[dequeue_pos & ring_mask];
+        uint64_t seq = slot.seq.load(memory_order_acquire);
+        if (seq != dequeue_pos + 1) break; // 该槽位尚未写完或缓冲为空
+        EventRecord record = slot.record;
+        slot.seq.store(dequeue_pos + ring_mask + 1, memory_order_release); // 归还槽位
+        ++dequeue_pos;
+
+        if (log_file.is_open()) {
+            string line = format_record(record);
+            log_file << line << '\n';
+            log_file_size += line.size() + 1;
+            rotate_if_needed();
+        }
+        ++written;
+    }
+
+    // 报告丢弃的事件（只在有新丢弃时写一行）
+    uint64_t dropped = dropped_count.load(memory_order_relaxed);
+    if (dropped != reported_dropped && log_file.is_open()) {
+        log_file << "Event log: " << (dropped - reported_dropped) << " events dropped (buffer full)\n";
+        reported_dropped = dropped;
+    }
+    if (written > 0 && log_file.is_open()) log_file.flush();
+    return written;
+}
+
+// -------------------------- 格式化与轮转 --------------------------
+string EventLog::format_record(const EventRecord& record) const {
+    // 时间格式：[YYYY-MM-DD HH:MM:SS]
+    tm local_tm;
+#ifdef _WIN32
+    localtime_s(&local_tm, &record.timestamp);
+#else
+    localtime_r(&record.timestamp, &local_tm);
+#endif
+    char time_buf[64];
+    strftime(time_buf, sizeof(time_buf), "[%Y-%m-%d %H:%M:%S]", &local_tm);
+
+    string page = to_string(record.page_id);
+    string text;
+    switch (record.type) {
+    case StorageEvent::CACHE_INIT:
+        text = "CacheManager initialized: capacity=" + to_string(record.a) + ", policy=" + policy_name(record.tag);
+        break;
+    case StorageEvent::CACHE_HIT:
+        text = "Cache hit: page " + page;
+        break;
+    case StorageEvent::CACHE_MISS:
+        text = "Cache miss: page " + page + " read from disk";
+        break;
+    case StorageEvent::CACHE_MISS_FAILED:
+        text = "Cache miss: page " + page + " read from disk failed";
+        break;
+    case StorageEvent::CACHE_ADD:
+        text = "Cache add: page " + page + " added to cache";
+        break;
+    case StorageEvent::CACHE_FULL:
+        text = "Cache full: trigger evict policy";
+        break;
+    case StorageEvent::EVICT:
+        text = string(policy_name(record.tag)) + " evict: page " + page + " removed from cache";
+        break;
+    case StorageEvent::EVICT_FLUSH:
+        text = string(policy_name(record.tag)) + " evict: dirty page " + page + " flushed to disk";
+        break;
+    case StorageEvent::EVICT_FLUSH_FAILED:
+        text = string(policy_name(record.tag)) + " evict warning: dirty page " + page + " flush failed";
+        break;
+    case StorageEvent::FLUSH_PAGE:
+        text = "Flush page success: page " + page + (record.tag ? " (not in cache)" : "") + " flushed to disk";
+        break;
+    case StorageEvent::FLUSH_PAGE_SKIPPED:
+        text = "Flush page skipped: page " + page + " is not dirty";
+        break;
+    case StorageEvent::FLUSH_PAGE_FAILED:
+        text = record.tag ? "Flush page failed: page " + page + " (not in cache) read/write error"
+            : "Flush page failed: page " + page + " flush to disk error";
+        break;
+    case StorageEvent::FLUSH_ALL_BEGIN:
+        text = "Flush all dirty pages start";
+        break;
+    case StorageEvent::FLUSH_ALL_END:
+        text = "Flush all dirty pages end: success=" + to_string(record.a) + ", failed=" + to_string(record.b);
+        break;
+    case StorageEvent::BGWRITER_ROUND:
+        text = "Background writer: " + to_string(record.a) + " dirty pages written, " + to_string(record.b) + " still dirty";
+        break;
+    case StorageEvent::CHECKPOINT:
+        text = record.tag ? "Checkpoint failed" : "Checkpoint done: " + to_string(record.a) + " dirty pages flushed";
+        break;
+    case StorageEvent::RECOVERY:
+        text = "Recovery done: " + to_string(record.a) + " page records replayed in " + to_string(record.b) +
+            " ms with " + to_string(record.tag) + " threads";
+        break;
+    case StorageEvent::READ_AHEAD:
+        text = "Read-ahead from page " + page + ": " + to_string(record.a) +
+            " pages loaded, window=" + to_string(record.b);
+        break;
+    }
+    return string(time_buf) + " " + text;
+}
+
+void EventLog::rotate_if_needed() {
+    uint64_t limit = max_file_size.load(memory_order_relaxed);
+    if (limit == 0 || log_file_size < limit) return;
+
+    // 只保留一个历史文件：xxx.txt.1
+    log_file.close();
+    string backup = log_file_path + ".1";
+    remove(backup.c_str());
+    rename(log_file_path.c_str(), backup.c_str());
+    log_file.open(log_file_path, ios::out | ios::trunc);
+    log_file_size = 0;
+}
@@ -0,0 +1,125 @@
+// =============================================
+// storage/event_log.hpp
+// =============================================
+//定义EventLog类（存储层事件日志：无锁环形缓冲、后台刷盘线程、日志级别、采样、按大小轮转）
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 日志级别
+enum class LogLevel {
+    OFF = 0,        // 关闭
+    EVICTIONS = 1,  // 只记录替换、刷盘失败、初始化等关键事件（默认）
+    ALL = 2         // 记录全部事件（命中/未命中/加入等热路径事件按采样率记录）
+};
+
+// 存储层事件类型（热路径只记录类型和数值，文本在后台线程格式化）
+enum class StorageEvent : uint8_t {
+    CACHE_INIT,          // 缓存初始化：a=容量，tag=替换策略
+    CACHE_HIT,           // 缓存命中
+    CACHE_MISS,          // 缓存未命中，已从磁盘读取
+    CACHE_MISS_FAILED,   // 缓存未命中，磁盘读取失败
+    CACHE_ADD,           // 页加入缓存
+    CACHE_FULL,          // 缓存已满，触发替换
+    EVICT,               // 页被替换出缓存：tag=替换策略
+    EVICT_FLUSH,         // 替换前脏页刷盘成功：tag=替换策略
+    EVICT_FLUSH_FAILED,  // 替换前脏页刷盘失败：tag=替换策略
+    FLUSH_PAGE,          // 刷新页成功：tag=1表示页不在缓存中
+    FLUSH_PAGE_SKIPPED,  // 刷新页跳过（非脏页）
+    FLUSH_PAGE_FAILED,   // 刷新页失败：tag=1表示页不在缓存中
+    FLUSH_ALL_BEGIN,     // 刷新所有脏页开始
+    FLUSH_ALL_END,       // 刷新所有脏页结束：a=成功数，b=失败数
+    BGWRITER_ROUND,      // 后台写线程一轮写回：a=写回页数，b=剩余脏页数
+    CHECKPOINT,          // 检查点完成：a=检查点前的脏页数，tag=1表示失败
+    RECOVERY,            // 崩溃恢复完成：a=重做的页记录数，b=耗时（毫秒），tag=重做线程数
+    READ_AHEAD           // 一次预读完成：page_id=起始页，a=从磁盘读入的页数，b=预读窗口
+};
+
+// 环形缓冲中的一条事件记录（定长，无堆分配）
+struct EventRecord {
+    time_t timestamp;
+    StorageEvent type;
+    uint8_t tag;
+    uint32_t page_id;
+    uint32_t a;
+    uint32_t b;
+};
+
+class EventLog {
+private:
+    // 环形缓冲槽位：seq为槽位序号（多生产者/单消费者无锁队列）
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        EventRecord record;
+    };
+
+    std::string log_file_path;              // 日志文件路径
+    std::ofstream log_file;                 // 常驻打开的日志文件（仅后台线程访问）
+    uint64_t log_file_size;                 // 当前日志文件大小（仅后台线程访问）
+
+    std::unique_ptr<Slot[]> ring;           // 环形缓冲
+    uint64_t ring_mask;                     // 容量-1（容量为2的幂）
+    std::atomic<uint64_t> enqueue_pos;      // 生产者写入位置
+    uint64_t dequeue_pos;                   // 消费者读取位置（仅后台线程访问）
+
+    std::atomic<int> level;                 // 当前日志级别
+    std::atomic<uint32_t> sample_rate;      // 采样率：热路径事件每N条记录1条
+    std::atomic<uint32_t> sample_counter;   // 采样计数
+    std::atomic<uint64_t> max_file_size;    // 日志文件轮转阈值（字节，0表示不轮转）
+    std::atomic<uint64_t> dropped_count;    // 缓冲满时丢弃的事件数
+    uint64_t reported_dropped;              // 已写入日志的丢弃数（仅消费者访问）
+
+    // 后台刷盘线程
+    std::thread flusher;
+    std::mutex flusher_mutex;
+    std::condition_variable flusher_cv;
+    bool stopping;
+
+    // 后台线程主循环：周期性取出缓冲中的事件，格式化后写入文件
+    void flusher_loop();
+    // 取出并写入当前缓冲中的全部事件，返回写出条数
+    uint32_t drain();
+    // 格式化一条事件记录
+    std::string format_record(const EventRecord& record) const;
+    // 日志文件超过阈值时轮转：xxx.txt -> xxx.txt.1，重新打开新文件
+    void rotate_if_needed();
+    // 事件所属的日志级别
+    static LogLevel level_of(StorageEvent type);
+
+public:
+    // 构造函数：打开日志文件并启动后台刷盘线程
+    // 参数说明：log_path-日志文件路径，lvl-日志级别，sample-热路径采样率，
+    //          max_bytes-轮转阈值，ring_capacity-环形缓冲容量（向上取整为2的幂）
+    EventLog(const std::string& log_path, LogLevel lvl = LogLevel::EVICTIONS, uint32_t sample = 1,
+        uint64_t max_bytes = 4 * 1024 * 1024, uint32_t ring_capacity = 8192);
+    // 析构函数：停止后台线程，写出剩余事件并关闭文件
+    ~EventLog();
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    // 记录一条事件（热路径调用，无锁；级别不够、未被采样或缓冲已满时直接返回）
+    void log(StorageEvent type, uint32_t page_id = 0, uint8_t tag = 0, uint32_t a = 0, uint32_t b = 0);
+
+    // 立即写出缓冲中的全部事件（测试/退出时调用）
+    void flush();
+
+    // -------------------------- 运行时配置 --------------------------
+    void set_level(LogLevel lvl) { level.store(static_cast<int>(lvl), std::memory_order_relaxed); }
+    LogLevel get_level() const { return static_cast<LogLevel>(level.load(std::memory_order_relaxed)); }
+    void set_sample_rate(uint32_t sample) { sample_rate.store(sample == 0 ? 1 : sample, std::memory_order_relaxed); }
+    void set_max_file_size(uint64_t max_bytes) { max_file_size.store(max_bytes, std::memory_order_relaxed); }
+    // 获取因缓冲满而丢弃的事件数
+    uint64_t get_dropped_count() const { return dropped_count.load(std::memory_order_relaxed); }
+};
+
+#endif // EVENT_LOG_H
@@ -1,7 +1,7 @@
 // =============================================
 // storage/file_manager.hpp
 // =============================================
-//FileManagerࣨļʼԪݶдͳһ洢ӿڡģЭͬ
+//定义FileManager类（文件初始化、元数据读写、统一存储接口、模块协同）
 #ifndef FILE_MANAGER_H
 #define FILE_MANAGER_H
 
@@ -9,65 +9,232 @@
 #define NOMINMAX
 
 #include "page_manager.hpp"
+#include "wal_manager.hpp"
 #include "cache_manager.hpp"
+#include "page_guard.hpp"
+#include <chrono>
 #include <string>
+#include <vector>
 
-// ݿļĬ
-#define DATA_FILE_NAME "data.dat"    // ļ洢ҳݣ
-#define META_FILE_NAME "meta.dat"    // Ԫļ洢ҳԪݣ
+// 数据库文件默认名称
+#define DATA_FILE_NAME "data.dat"    // 数据文件（存储页数据）
+#define META_FILE_NAME "meta.dat"    // 元数据文件（存储页管理元数据）
+
+// meta.dat 文件头：魔数 + 存储格式版本（旧版meta.dat没有文件头，首4字节即next_page_id）
+//   META_MAGIC        头部之后为 next_page_id + 空闲页列表（空闲页数、页号...）
+//   META_MAGIC_BITMAP 头部之后为 next_page_id + 位图页列表（位图页数、页号...），空闲页保存在位图页中，
+//                     之后为检查点的重做起点LSN(u64，没有写前日志的旧版meta.dat中不存在，视为0)
+//                     与页大小(u32，可选页大小之前的meta.dat中不存在，视为DEFAULT_PAGE_SIZE)，
+//                     再之后为各表的页文件（u32文件数，每个文件：文件号 | 文件名长度 | 文件名 | next_page_id |
+//                     位图页数 | 位图页的文件内页号...；没有表页文件的meta.dat中不存在，视为0个）
+#define META_MAGIC 0x4D42444Du       // "MDBM"
+#define META_MAGIC_BITMAP 0x4242444Du // "MDBB"
+// 存储格式版本：1-旧版行追加格式（[uint16 len][csv]顺序排列），2-槽页格式（CSV行），
+//              3-槽页格式（按表模式编码的二进制元组），
+//              4-页头[24,32)为页LSN（FSM页条目区改从PAGE_HEADER_SIZE开始），
+//              5-页头[32,38)为页校验和（数据文件中的非全零页都带校验和），
+//              6-每张表的页在各自的页文件（表目录中的file_name）中，data.dat不再存放表页，
+//              7-槽标志的第二位表示转发（转发桩/迁入记录；之前的页中该位总为0，无需改写页）
+#define STORAGE_FORMAT_VERSION 7
+// 两次检查点的最小间隔（秒）：上层在写操作时调用checkpoint_due判断是否需要做检查点
+#define CHECKPOINT_INTERVAL_SEC 30
+// 崩溃恢复的默认重做线程数：0表示按硬件线程数（MMAP模式下总是单线程）
+#define REDO_DEFAULT_THREADS 0
+// 校验数据文件时每次读入的页数
+#define VERIFY_BATCH_PAGES 64u
+
+// 一次崩溃恢复（打开时从检查点重做日志）的统计
+struct RecoveryStats {
+    uint64_t start_lsn = 0;      // 重做起点（上一次检查点）
+    uint64_t end_lsn = 0;        // 日志末尾
+    uint64_t records = 0;        // 扫描到的日志记录数
+    uint64_t page_records = 0;   // 其中的页记录数（页差异/分配/释放）；为0表示上次正常关闭，无需重做
+    uint64_t applied = 0;        // 实际应用到页上的记录数（页LSN不小于记录LSN的修改已在磁盘上，跳过）
+    uint32_t threads = 0;        // 重做线程数
+    double seconds = 0;          // 恢复耗时
+};
+
+// 一次数据文件校验（逐页检查校验和）的结果
+struct VerifyStats {
+    uint64_t pages = 0;          // 检查的页数（各数据文件的文件内页号1 ~ next_page_id-1）
+    uint64_t ok = 0;             // 校验和正确的页数
+    uint64_t empty = 0;          // 全零页数（预扩展、从未写过）
+    uint64_t unstamped = 0;      // 没有校验和的页数（旧格式数据文件中的页；当前格式下计为损坏）
+    std::vector<uint32_t> corrupt; // 损坏的页号（带文件号，升序）
+    uint32_t threads = 0;        // 校验线程数
+    double seconds = 0;          // 耗时
+};
 
 class FileManager {
 private:
-    std::string db_dir;              // ݿļĿ¼
-    std::string data_file_path;      // ļ·db_dir + DATA_FILE_NAME
-    std::string meta_file_path;      // Ԫļ·db_dir + META_FILE_NAME
-
-    // ĵײģ
-    PageManager page_manager;        // ҳԽļ
-    CacheManager cache_manager;      // Խҳ
-
-    // -------------------------- Ԫݶд˽Уڲά --------------------------
-    // meta.datȡԪݣnext_page_idfree_page_listʼPageManager
-    void load_metadata();
-    // PageManagerԪݣnext_page_idfree_page_listдmeta.datʵֳ־û
+    std::string db_dir;              // 数据库文件根目录
+    std::string data_file_path;      // 数据文件完整路径（db_dir + DATA_FILE_NAME）
+    std::string meta_file_path;      // 元数据文件完整路径（db_dir + META_FILE_NAME）
+
+    // 关联的底层模块
+    PageManager page_manager;        // 页管理器（对接共享数据文件，并挂接各表的页文件）
+    std::vector<std::string> table_files; // 各表页文件的文件名（下标为文件号，空串表示未使用；文件在db_dir中）
+    WalManager wal;                  // 写前日志（段文件在数据库目录中；先于缓存构造、后于缓存析构）
+    CacheManager cache_manager;      // 缓存管理器（对接页管理器）
+    uint32_t format_version;         // 数据文件的存储格式版本（旧库需由上层迁移）
+    std::chrono::steady_clock::time_point last_checkpoint; // 上一次检查点的时间
+    uint64_t checkpoint_lsn;         // 上一次检查点的重做起点（此前的日志记录对应的修改都已写入数据文件）
+    bool synchronous_commit;         // 提交时是否等待日志持久化
+    RecoveryStats recovery_stats;    // 打开时的崩溃恢复统计
+
+    // -------------------------- 元数据读写（私有：仅内部维护） --------------------------
+    // 从meta.dat读取元数据（next_page_id、空闲页位图页号、检查点LSN、页大小、各表页文件），初始化PageManager
+    // 旧版meta.dat中的空闲页列表在加载时转换为位图；meta.dat不存在且数据文件为空时按new_page_size建库
+    void load_metadata(uint32_t new_page_size);
+    // 写回位图页，并将PageManager的元数据（各文件的next_page_id、位图页号）与检查点LSN写入meta.dat，实现持久化
+    // 先写临时文件再改名替换，崩溃时meta.dat要么是旧内容要么是新内容
     void save_metadata();
-    // ʼݿĿ¼򴴽
+    // 初始化数据库目录（若不存在则创建）
     void init_db_directory();
+    // 崩溃恢复：从检查点LSN起重做日志（在关联写前日志之前调用，重做本身不再记日志）
+    // 页分配/释放按日志顺序在本线程重做；页内容的修改按页号分给threads个线程并行重做
+    void recover(uint32_t threads);
+    // 页文件被删除/清空前：停止预读（预读线程读盘时不持有缓存锁），丢弃缓存中该文件的页；返回之前预读是否在运行
+    bool discard_file_pages(uint32_t file_id);
+    // 新分配的页：记录PAGE_ALLOC日志，并在缓存中整页重置为空槽页（返回page_id）
+    uint32_t track_new_page(uint32_t page_id);
 
 public:
-    // 캯ʼĿ¼ļ·ײģ飬Ԫ
-    // ˵db_dir-ݿĿ¼cache_cap-policy-滻
-    FileManager(const std::string& db_dir, uint32_t cache_cap, ReplacePolicy policy);
+    // 构造函数：初始化目录、文件路径、底层模块，加载元数据
+    // 参数说明：db_dir-数据库目录，cache_cap-缓存容量，policy-缓存替换策略，
+    //          io_mode-数据文件访问方式（STREAM定位读写 / MMAP内存映射），redo_threads-崩溃恢复的重做线程数，
+    //          page_size-新建数据库的页大小（已有数据库按meta.dat中记录的页大小打开，忽略该参数）
+    // 打开时先从上一次检查点重做日志（有页被重做时随后做一次检查点）
+    // STREAM模式下同时启动缓存的后台写线程与预读线程（MMAP模式下文件扩展会重新映射，不与这些线程并发）
+    // 打开写前日志失败或页大小不合法时抛出runtime_error
+    FileManager(const std::string& db_dir, uint32_t cache_cap, ReplacePolicy policy,
+        IoMode io_mode = IoMode::STREAM, uint32_t redo_threads = REDO_DEFAULT_THREADS,
+        uint32_t page_size = DEFAULT_PAGE_SIZE);
 
-    // Ԫݣˢлҳȷݳ־ûָҪ
+    // 析构函数：停止预读线程与后台写线程，并做一次检查点（确保数据持久化，指导书核心要求）
     ~FileManager();
 
-    // -------------------------- ָҪͳһ洢ӿڣݿģã --------------------------
-    // 1. ҳPageManagerҳҳ
-    uint32_t allocate_page();
-    // 2. ͷҳPageManagerͷҳҳżб
+    // -------------------------- 指导书要求：统一存储接口（供数据库模块调用） --------------------------
+    // 1. 分配页：调用PageManager在file_id号文件中分配页，返回页号
+    uint32_t allocate_page(uint32_t file_id = SHARED_FILE_ID);
+    // 1.1 批量分配页：一次取得count个页（新页在文件末尾连续分配，文件最多扩展一次），返回页号列表
+    std::vector<uint32_t> allocate_pages(uint32_t count, uint32_t file_id = SHARED_FILE_ID);
+    // 1.2 区段分配：页链中接在prev_page_id之后的新页（尽量与之在文件中相邻，见PageManager::allocate_page_after）；
+    //     prev_page_id为INVALID_PAGE_ID时在file_id号文件中开始一条新页链
+    uint32_t allocate_page_after(uint32_t prev_page_id, uint32_t file_id = SHARED_FILE_ID);
+    // 2. 释放页：释放记录先持久化到日志，再调用PageManager释放页，在空闲页位图中标记为空闲
     bool free_page(uint32_t page_id);
-    // 3. ҳȴӻδļҳָ루 nullptrʾʧܣ
+    // 2.1 批量释放页：所有释放记录只同步一次日志；有页释放失败返回false
+    bool free_pages(const std::vector<uint32_t>& page_ids);
+    // 页是否在使用中（已分配、未释放）
+    bool is_page_in_use(uint32_t page_id) const;
+    // 3. 读页：优先从缓存读，未命中则读文件，返回页指针（ nullptr表示失败）
+    //    返回的页不固定：后台写线程或预读运行时可能被换出，引擎代码应使用read_page_guard
     Page* read_page(uint32_t page_id);
-    // 4. дҳд뻺沢ҳӳˢ̣Чʣ
+    // 4. 写页：写入缓存并标记脏页（延迟刷盘，由后台写线程/替换/检查点写回），修改记入写前日志
+    //    写入期间固定页并持有页帧独占锁；调用者不能持有该页的页守卫
     bool write_page(uint32_t page_id, const Page& page);
-    // 5. ˢҳָҳĻҳдļΪҳ
+    // 5. 刷新页：将指定页的缓存脏页写入文件，标记为非脏页
     bool flush_page(uint32_t page_id);
-    // 6. ˢУˢ»ҳļ˳/ύʱã
+    // 6. 刷新所有：刷新缓存中所有脏页到文件（程序退出/事务提交时调用）
     void flush_all_pages();
+    // 6.1 检查点：刷新所有脏页并同步数据文件，再原子替换meta.dat（记录新的重做起点），之后删除不再需要的日志段；
+    //     有页未能写回时不替换meta.dat（重做起点不前移），返回false。表目录由上层在检查点之前保存（StorageEngine::Checkpoint）
+    bool checkpoint();
+    // 距上一次检查点是否已超过CHECKPOINT_INTERVAL_SEC
+    bool checkpoint_due() const;
+    // 6.2 提交：追加提交记录；同步提交时等待日志持久化（并发提交共用一次写出+同步，即组提交）
+    //     上层每条修改语句结束时调用；返回false表示日志写入失败
+    bool commit();
+    // 同步/异步提交（默认同步）；异步提交时由后台线程每WAL_ASYNC_FLUSH_MS写出一次日志，
+    // 崩溃时可能丢失最近提交的语句，但不会破坏数据一致性
+    void set_synchronous_commit(bool on);
+    bool get_synchronous_commit() const { return synchronous_commit; }
+    // 6.3 表的页文件：每张表的页放在数据库目录下各自的文件中（页号带文件号），共用一个缓存
+    //     open_table_file：按文件名取文件号，没有时创建文件并立即做一次检查点（meta.dat记下文件号与文件名，
+    //     之后的日志记录在崩溃恢复时才能找到该文件）；文件号用完或创建失败时返回SHARED_FILE_ID（页放在data.dat中）
+    uint32_t open_table_file(const std::string& file_name);
+    // 按文件名查文件号，没有返回SHARED_FILE_ID
+    uint32_t find_table_file(const std::string& file_name) const;
+    // 删除/清空表的页文件：丢弃缓存中该文件的页（不写回），删除文件或截断为0字节，再做一次检查点
+    // （重做起点移到此后，之前对该文件的日志记录不再重做）
+    bool drop_table_file(uint32_t file_id);
+    bool truncate_table_file(uint32_t file_id);
+    // 表改名时页文件随之改名（文件号不变），并保存meta.dat
+    bool rename_table_file(uint32_t file_id, const std::string& new_name);
+    // 文件号对应的文件名（SHARED_FILE_ID为DATA_FILE_NAME，未使用的文件号返回空串）
+    std::string get_table_file_name(uint32_t file_id) const;
+    // 页文件当前大小（字节）
+    uint64_t get_file_size(uint32_t file_id) const;
 
-    // -------------------------- ӿڣ/ã --------------------------
-    // ȡͳϢдδдʣ
+    // 7. 只读页视图：返回一整页字节（含页头）的只读指针，供顺序扫描使用
+    //    缓存中有该页时返回缓存页（可能含未刷盘修改）；MMAP模式下返回映射内指针（零拷贝）；
+    //    否则经缓存读入。指针在下一次读写页之前有效
+    const char* read_page_view(uint32_t page_id);
+
+    // 8. 页守卫：取页并固定在缓存中，守卫存活期间页指针一直有效、页不会被替换
+    //    写守卫释放时自动标记脏页（不立即刷盘，需要落盘时再调用flush_page）；取页失败时守卫为空
+    //    顺序扫描传AccessHint::SEQUENTIAL：扫过的页放入冷队列优先换出，不挤掉热点页
+    ReadPageGuard read_page_guard(uint32_t page_id, AccessHint hint = AccessHint::NORMAL) {
+        return ReadPageGuard(cache_manager, page_id, hint);
+    }
+    WritePageGuard write_page_guard(uint32_t page_id) { return WritePageGuard(cache_manager, page_id); }
+
+    // 9. 顺序预读：沿页链扫描时每访问一页调用一次（next_page_id-页链上的下一页），
+    //    检测到顺序扫描后由缓存的预读线程提前读入后续页（STREAM模式下打开时启动）
+    //    预读线程会并发换入换出页：扫描中的页应以页守卫固定，不要只持有read_page返回的指针
+    void read_ahead(ReadAheadState& state, uint32_t page_id, uint32_t next_page_id) {
+        cache_manager.read_ahead(state, page_id, next_page_id);
+    }
+    // 开启/关闭顺序预读（关闭时等待预读线程退出；MMAP模式下不开启）
+    void set_read_ahead(bool on);
+
+    // -------------------------- 辅助接口（供测试/调试用） --------------------------
+    // 获取缓存统计信息（命中次数、未命中次数、命中率）
     void get_cache_stats(uint32_t& hit, uint32_t& miss, double& hit_rate) const;
-    // ӡͳϢ̨
+    // 获取预读统计信息（预读读入的页数、其中被访问到的页数）
+    void get_prefetch_stats(uint32_t& prefetched, uint32_t& prefetch_hits) const {
+        cache_manager.get_prefetch_stats(prefetched, prefetch_hits);
+    }
+    // 打印缓存统计信息到控制台
     void print_cache_stats() const;
-    // ȡļ·
+    // 数据文件访问方式
+    IoMode get_io_mode() const { return page_manager.get_io_mode(); }
+    // 页大小（建库时确定）；构造要写入本库的页对象时用new_page，保证页大小一致
+    uint32_t get_page_size() const { return page_manager.get_page_size(); }
+    Page new_page(uint32_t page_id = INVALID_PAGE_ID) const { return page_manager.new_page(page_id); }
+    // 获取数据文件路径
     std::string get_data_file_path() const { return data_file_path; }
-    // ȡԪļ·
+    // 获取元数据文件路径
     std::string get_meta_file_path() const { return meta_file_path; }
 
-    // ԸӿڣȡPageManagerãã
+    // 设置数据文件扩展区段大小（页数，默认DEFAULT_EXTENT_PAGES；各表的页文件相同）
+    void set_extent_pages(uint32_t pages) { page_manager.set_extent_pages(pages); }
+
+    // 获取数据文件的存储格式版本（小于STORAGE_FORMAT_VERSION表示需要迁移）
+    uint32_t get_format_version() const { return format_version; }
+    // 迁移完成后更新存储格式版本，并立即做一次检查点写入meta.dat
+    void set_format_version(uint32_t version);
+    // 升级到带页校验和的格式：写回脏页后给数据文件中没有校验和的页写入校验和
+    // （直接改写数据文件，需在没有其他线程修改页时调用）
+    bool stamp_page_checksums();
+    // 校验数据文件（含各表的页文件）：多线程并行读出所有页并检查校验和（先写回脏页，检查的是磁盘上的内容）
+    // threads为0时按硬件线程数
+    VerifyStats verify_data_file(uint32_t threads = 0);
+
+    // 获取缓存事件日志（调整日志级别、采样率、轮转阈值）
+    EventLog& get_event_log() { return cache_manager.get_event_log(); }
+    // 获取写前日志（统计、组提交等待时间设置）
+    WalManager& get_wal() { return wal; }
+    // 上一次检查点的重做起点
+    uint64_t get_checkpoint_lsn() const { return checkpoint_lsn; }
+    // 打开时的崩溃恢复统计
+    const RecoveryStats& get_recovery_stats() const { return recovery_stats; }
+
+    // 测试辅助接口：获取PageManager引用（仅测试用）
     const PageManager& get_page_manager() const { return page_manager; }
+    // 测试辅助接口：获取CacheManager引用（仅测试用，如检查脏页、停止后台写线程）
+    CacheManager& get_cache_manager() { return cache_manager; }
 };
 
 
@@ -0,0 +1,171 @@
+// =============================================
+// storage/free_page_bitmap.cpp
+// =============================================
+//实现FreePageBitmap类（两层位图的置位/清位、首次适配、连续段查找）
+#include "free_page_bitmap.hpp"
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// 最低置位的位序号（bits != 0）
+static inline uint32_t lowest_bit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(bits));
+#endif
+}
+
+FreePageBitmap::FreePageBitmap() : free_count(0) {}
+
+// -------------------------- 摘要层维护 --------------------------
+void FreePageBitmap::refresh_summary(uint32_t w) {
+    uint64_t mask = 1ULL << (w % 64);
+    if (words[w] != 0) any_free[w / 64] |= mask; else any_free[w / 64] &= ~mask;
+    if (words[w] != ~0ULL) not_full[w / 64] |= mask; else not_full[w / 64] &= ~mask;
+}
+
+void FreePageBitmap::grow_to_chunk(uint32_t chunk) {
+    if (chunk < chunk_count()) return;
+    size_t old_words = words.size();
+    words.resize(static_cast<size_t>(chunk + 1) * BITMAP_WORDS_PER_PAGE, 0);
+    size_t summary_words = (words.size() + 63) / 64;
+    any_free.resize(summary_words, 0);
+    not_full.resize(summary_words, 0);
+    for (size_t w = old_words; w < words.size(); ++w) {
+        not_full[w / 64] |= 1ULL << (w % 64);
+    }
+}
+
+// -------------------------- 置位/清位 --------------------------
+bool FreePageBitmap::is_free(uint32_t page_id) const {
+    size_t w = page_id / 64;
+    return w < words.size() && (words[w] >> (page_id % 64) & 1);
+}
+
+void FreePageBitmap::set_free(uint32_t page_id) {
+    if (page_id == INVALID_PAGE_ID || is_free(page_id)) return;
+    grow_to_chunk(chunk_of(page_id));
+    words[page_id / 64] |= 1ULL << (page_id % 64);
+    refresh_summary(page_id / 64);
+    ++free_count;
+    dirty_chunks.insert(chunk_of(page_id));
+}
+
+void FreePageBitmap::set_used(uint32_t page_id) {
+    if (!is_free(page_id)) return;
+    words[page_id / 64] &= ~(1ULL << (page_id % 64));
+    refresh_summary(page_id / 64);
+    --free_count;
+    dirty_chunks.insert(chunk_of(page_id));
+}
+
+void FreePageBitmap::set_used_range(uint32_t first, uint32_t count) {
+    for (uint32_t pid = first; pid < first + count; ++pid) set_used(pid);
+}
+
+// -------------------------- 查找 --------------------------
+uint32_t FreePageBitmap::next_free(uint32_t bit) const {
+    size_t w = bit / 64;
+    if (w >= words.size()) return UINT32_MAX;
+    uint64_t bits = words[w] & (~0ULL << (bit % 64));
+    if (bits) return static_cast<uint32_t>(w * 64 + lowest_bit(bits));
+
+    // 当前字之后：按摘要找下一个含空闲位的字
+    size_t s = (w + 1) / 64;
+    if (s >= any_free.size()) return UINT32_MAX;
+    uint64_t summary = (w + 1) % 64 ? any_free[s] & (~0ULL << ((w + 1) % 64)) : any_free[s];
+    for (;;) {
+        if (summary) {
+            size_t next_w = s * 64 + lowest_bit(summary);
+            return static_cast<uint32_t>(next_w * 64 + lowest_bit(words[next_w]));
+        }
+        if (++s >= any_free.size()) return UINT32_MAX;
+        summary = any_free[s];
+    }
+}
+
+uint32_t FreePageBitmap::next_used(uint32_t bit) const {
+    size_t w = bit / 64;
+    uint32_t limit = static_cast<uint32_t>(words.size() * 64);
+    if (w >= words.size()) return limit;
+    uint64_t bits = ~words[w] & (~0ULL << (bit % 64));
+    if (bits) return static_cast<uint32_t>(w * 64 + lowest_bit(bits));
+
+    size_t s = (w + 1) / 64;
+    if (s >= not_full.size()) return limit;
+    uint64_t summary = (w + 1) % 64 ? not_full[s] & (~0ULL << ((w + 1) % 64)) : not_full[s];
+    for (;;) {
+        if (summary) {
+            size_t next_w = s * 64 + lowest_bit(summary);
+            if (next_w >= words.size()) return limit;
+            return static_cast<uint32_t>(next_w * 64 + lowest_bit(~words[next_w]));
+        }
+        if (++s >= not_full.size()) return limit;
+        summary = not_full[s];
+    }
+}
+
+uint32_t FreePageBitmap::find_first() const {
+    uint32_t bit = next_free(0);
+    return bit == UINT32_MAX ? INVALID_PAGE_ID : bit;
+}
+
+uint32_t FreePageBitmap::find_run(uint32_t count) const {
+    if (count == 0 || count > free_count) return INVALID_PAGE_ID;
+    // 在空闲段之间跳跃：段起点用any_free摘要找，段终点用not_full摘要找
+    uint32_t start = next_free(0);
+    while (start != UINT32_MAX) {
+        uint32_t end = next_used(start);
+        if (end - start >= count) return start;
+        start = next_free(end);
+    }
+    return INVALID_PAGE_ID;
+}
+
+uint32_t FreePageBitmap::find_aligned_run(uint32_t count) const {
+    if (count == 0 || count > free_count) return INVALID_PAGE_ID;
+    const uint32_t limit = static_cast<uint32_t>(words.size() * 64);
+    uint32_t start = next_free(0);
+    while (start != UINT32_MAX) {
+        // 空闲段内第一个区段起点（页号0无效，区段为[k*count+1, (k+1)*count]）
+        uint32_t aligned = (start - 1 + count - 1) / count * count + 1;
+        if (aligned >= limit) break;
+        uint32_t end = next_used(aligned);
+        if (end - aligned >= count) return aligned;
+        start = next_free(end);
+    }
+    return INVALID_PAGE_ID;
+}
+
+// -------------------------- 位图页读写 --------------------------
+void FreePageBitmap::store_chunk(uint32_t chunk, char* page_data) const {
+    memcpy(page_data + BITMAP_PAGE_HEADER_SIZE, &words[static_cast<size_t>(chunk) * BITMAP_WORDS_PER_PAGE],
+        BITMAP_WORDS_PER_PAGE * sizeof(uint64_t));
+}
+
+void FreePageBitmap::load_chunk(uint32_t chunk, const char* page_data) {
+    grow_to_chunk(chunk);
+    size_t base = static_cast<size_t>(chunk) * BITMAP_WORDS_PER_PAGE;
+    for (uint32_t i = 0; i < BITMAP_WORDS_PER_PAGE; ++i) {
+        uint64_t word;
+        memcpy(&word, page_data + BITMAP_PAGE_HEADER_SIZE + i * sizeof(uint64_t), sizeof(word));
+        if (base + i == 0) word &= ~1ULL; // 页号0无效
+        for (uint64_t bits = words[base + i]; bits; bits &= bits - 1) --free_count;
+        for (uint64_t bits = word; bits; bits &= bits - 1) ++free_count;
+        words[base + i] = word;
+        refresh_summary(static_cast<uint32_t>(base + i));
+    }
+}
+
+void FreePageBitmap::truncate(uint32_t end_page) {
+    for (uint32_t pid = next_free(end_page); pid != UINT32_MAX; pid = next_free(pid + 1)) {
+        set_used(pid);
+    }
+}
@@ -0,0 +1,75 @@
+// =============================================
+// storage/free_page_bitmap.hpp
+// =============================================
+//定义FreePageBitmap类（数据文件级空闲页位图：每页一位，带摘要层，支持首次适配与连续页段查找）
+#ifndef FREE_PAGE_BITMAP_H
+#define FREE_PAGE_BITMAP_H
+
+#include "page.hpp"
+#include <cstdint>
+#include <set>
+#include <vector>
+
+// 位图页布局：
+//   [0,16)   基础页头
+//   [16,18)  保留
+//   [18,20)  页标志 PAGE_FLAG_BITMAP
+//   [20,40)  保留（与槽页头等长，位图区从PAGE_HEADER_SIZE开始）
+//   [40, MIN_PAGE_SIZE) 位图区：第k个位图页的第i位对应页号 k * BITMAP_BITS_PER_PAGE + i，置1表示空闲
+//   位图区大小与页大小无关（按最小页大小计），大页中之后的字节不使用，位图与页大小解耦
+#define BITMAP_PAGE_HEADER_SIZE PAGE_HEADER_SIZE
+#define BITMAP_WORDS_PER_PAGE ((MIN_PAGE_SIZE - BITMAP_PAGE_HEADER_SIZE) / 8)
+#define BITMAP_BITS_PER_PAGE (BITMAP_WORDS_PER_PAGE * 64)
+
+class FreePageBitmap {
+private:
+    // 第0层：每页一位（1=空闲）；页号0无效，对应位恒为0
+    std::vector<uint64_t> words;
+    // 第1层摘要：每个字一位
+    std::vector<uint64_t> any_free;   // words[w] != 0，首次适配时跳过全占用的字
+    std::vector<uint64_t> not_full;   // words[w] != ~0，找连续段末尾时跳过全空闲的字
+    uint32_t free_count;
+    std::set<uint32_t> dirty_chunks;  // 内容有变化、需要写回的位图页序号
+
+    // 更新第w个字的摘要位
+    void refresh_summary(uint32_t w);
+    // 确保位图覆盖到第chunk个位图页（按整页扩展，新位均为占用）
+    void grow_to_chunk(uint32_t chunk);
+    // 从bit开始第一个空闲位/占用位（越过位图末尾：空闲位返回UINT32_MAX，占用位返回位图长度）
+    uint32_t next_free(uint32_t bit) const;
+    uint32_t next_used(uint32_t bit) const;
+
+public:
+    FreePageBitmap();
+
+    // 位图当前覆盖的位图页数（每个位图页覆盖BITMAP_BITS_PER_PAGE个页号）
+    uint32_t chunk_count() const { return static_cast<uint32_t>(words.size() / BITMAP_WORDS_PER_PAGE); }
+    static uint32_t chunk_of(uint32_t page_id) { return page_id / BITMAP_BITS_PER_PAGE; }
+    uint32_t get_free_count() const { return free_count; }
+
+    bool is_free(uint32_t page_id) const;
+    // 标记空闲/占用（O(1)，会把所在位图页记为脏）
+    void set_free(uint32_t page_id);
+    void set_used(uint32_t page_id);
+    // 把[first, first+count)全部标记为占用
+    void set_used_range(uint32_t first, uint32_t count);
+
+    // 首次适配：页号最小的空闲页，没有返回INVALID_PAGE_ID
+    uint32_t find_first() const;
+    // 首次适配：起始页号最小的count个连续空闲页，没有返回INVALID_PAGE_ID
+    uint32_t find_run(uint32_t count) const;
+    // 整段空闲的区段：起始页号为 k*count+1 的count个连续空闲页中起始页号最小的，没有返回INVALID_PAGE_ID
+    uint32_t find_aligned_run(uint32_t count) const;
+
+    // -------------------------- 位图页读写 --------------------------
+    // 把第chunk个位图页的位图区写入/读出page_data（page_data为一整页字节）
+    void store_chunk(uint32_t chunk, char* page_data) const;
+    void load_chunk(uint32_t chunk, const char* page_data);
+    // 脏位图页序号（写回后调用clear_dirty）
+    const std::set<uint32_t>& get_dirty_chunks() const { return dirty_chunks; }
+    void clear_dirty() { dirty_chunks.clear(); }
+    // 把页号不小于end_page的位全部标记为占用（这些页号尚未分配过）
+    void truncate(uint32_t end_page);
+};
+
+#endif // FREE_PAGE_BITMAP_H
@@ -0,0 +1,216 @@
+// =============================================
+// storage/free_space_map.cpp
+// =============================================
+//实现FreeSpaceMap类（档位索引、FSM页读写）
+#include "free_space_map.hpp"
+#include <cstring>
+
+using namespace std;
+
+// -------------------------- 构造函数 --------------------------
+FreeSpaceMap::FreeSpaceMap(FileManager& fm, uint32_t first_page_id) : file_manager(fm), page_size(fm.get_page_size()) {
+    memset(nonempty, 0, sizeof(nonempty));
+    if (first_page_id != INVALID_PAGE_ID) fsm_pages.push_back(first_page_id);
+}
+
+// -------------------------- 档位换算 --------------------------
+uint8_t FreeSpaceMap::category_of(uint32_t free_bytes, uint32_t page_size) {
+    uint32_t slot_size = Page::slot_size_of(page_size);
+    uint32_t usable = free_bytes > slot_size ? free_bytes - slot_size : 0;
+    uint32_t category = usable / category_bytes_of(page_size);
+    return static_cast<uint8_t>(category >= FSM_CATEGORIES ? FSM_CATEGORIES - 1 : category);
+}
+
+// -------------------------- 档位桶维护 --------------------------
+void FreeSpaceMap::bucket_remove(uint32_t page_id, Entry& entry) {
+    vector<uint32_t>& bucket = buckets[entry.category];
+    // 与桶尾交换后弹出，O(1)
+    uint32_t last = bucket.back();
+    bucket[entry.bucket_pos] = last;
+    entries[last].bucket_pos = entry.bucket_pos;
+    bucket.pop_back();
+    if (bucket.empty()) nonempty[entry.category / 64] &= ~(1ULL << (entry.category % 64));
+    (void)page_id;
+}
+
+void FreeSpaceMap::bucket_add(uint32_t page_id, Entry& entry) {
+    vector<uint32_t>& bucket = buckets[entry.category];
+    entry.bucket_pos = static_cast<uint32_t>(bucket.size());
+    bucket.push_back(page_id);
+    nonempty[entry.category / 64] |= 1ULL << (entry.category % 64);
+}
+
+int FreeSpaceMap::first_nonempty_from(uint32_t category) const {
+    for (uint32_t word = category / 64; word < FSM_CATEGORIES / 64; ++word) {
+        uint64_t bits = nonempty[word];
+        if (word == category / 64) bits &= ~0ULL << (category % 64);
+        if (bits == 0) continue;
+        int bit = 0;
+        while (!(bits & 1)) { bits >>= 1; ++bit; }
+        return static_cast<int>(word * 64 + bit);
+    }
+    return -1;
+}
+
+// -------------------------- 加载 --------------------------
+bool FreeSpaceMap::load() {
+    if (fsm_pages.empty()) return true;
+    uint32_t pid = fsm_pages.front();
+    fsm_pages.clear();
+    entries.clear();
+    for (auto& bucket : buckets) bucket.clear();
+    memset(nonempty, 0, sizeof(nonempty));
+
+    uint32_t index = 0;
+    while (pid != INVALID_PAGE_ID) {
+        ReadPageGuard page = file_manager.read_page_guard(pid);
+        if (!page || page->get_page_flags() != PAGE_FLAG_FSM) return false;
+        fsm_pages.push_back(pid);
+
+        uint16_t count = 0;
+        page->read_data(16, reinterpret_cast<char*>(&count), sizeof(count));
+        if (count > FSM_ENTRIES_PER_PAGE) return false;
+        for (uint16_t i = 0; i < count; ++i, ++index) {
+            char raw[FSM_ENTRY_SIZE];
+            if (!page->read_data(FSM_PAGE_HEADER_SIZE + i * FSM_ENTRY_SIZE, raw, FSM_ENTRY_SIZE)) return false;
+            uint32_t data_pid;
+            memcpy(&data_pid, raw, sizeof(data_pid));
+            Entry entry{ static_cast<uint8_t>(raw[4]), 0, index };
+            entries[data_pid] = entry;
+            bucket_add(data_pid, entries[data_pid]);
+        }
+        // 只有最后一页可以不满
+        uint32_t next = page->get_next_page_id();
+        if (next != INVALID_PAGE_ID && count != FSM_ENTRIES_PER_PAGE) return false;
+        pid = next;
+    }
+    return true;
+}
+
+// -------------------------- 查找 --------------------------
+uint32_t FreeSpaceMap::find_page(uint32_t record_len) const {
+    // 需要的最小档位：向上取整
+    uint32_t category_bytes = category_bytes_of(page_size);
+    uint32_t need = (record_len + category_bytes - 1) / category_bytes;
+    if (need >= FSM_CATEGORIES) return INVALID_PAGE_ID;
+    int category = first_nonempty_from(need);
+    if (category < 0) return INVALID_PAGE_ID;
+    return buckets[category].back();
+}
+
+bool FreeSpaceMap::get_category(uint32_t page_id, uint8_t& category) const {
+    auto it = entries.find(page_id);
+    if (it == entries.end()) return false;
+    category = it->second.category;
+    return true;
+}
+
+// -------------------------- 更新 --------------------------
+bool FreeSpaceMap::update(uint32_t page_id, uint32_t free_bytes) {
+    uint8_t category = category_of(free_bytes, page_size);
+    auto it = entries.find(page_id);
+    if (it != entries.end()) {
+        if (it->second.category == category) return true; // 档位未变，不写FSM页
+        bucket_remove(page_id, it->second);
+        it->second.category = category;
+        bucket_add(page_id, it->second);
+        return persist_entry(page_id, it->second);
+    }
+
+    // 新登记的数据页：条目追加到FSM页链末尾，末页满时链接新FSM页（与数据页在同一个文件中，按区段分配）
+    uint32_t index = static_cast<uint32_t>(entries.size());
+    if (index / FSM_ENTRIES_PER_PAGE >= fsm_pages.size()) {
+        // FSM页自成一条页链，按区段分配：不占用数据页链所在区段中接下来的页
+        uint32_t new_pid = file_manager.allocate_page_after(fsm_pages.empty() ? INVALID_PAGE_ID : fsm_pages.back(),
+            Page::file_of(page_id));
+        {
+            // 新页与前页同时固定：链接过程中两页都不会被换出
+            WritePageGuard page = file_manager.write_page_guard(new_pid);
+            if (!page) return false;
+            page->set_page_flags(PAGE_FLAG_FSM);
+            uint16_t zero = 0;
+            page->write_data(16, reinterpret_cast<const char*>(&zero), sizeof(zero));
+            if (!fsm_pages.empty()) {
+                page->set_prev_page_id(fsm_pages.back());
+                WritePageGuard prev = file_manager.write_page_guard(fsm_pages.back());
+                if (!prev) return false;
+                prev->set_next_page_id(new_pid);
+            }
+        }
+        fsm_pages.push_back(new_pid);
+    }
+    Entry& entry = entries[page_id];
+    entry.category = category;
+    entry.index = index;
+    bucket_add(page_id, entry);
+    return persist_entry(page_id, entry);
+}
+
+bool FreeSpaceMap::remove(uint32_t page_id) {
+    auto it = entries.find(page_id);
+    if (it == entries.end()) return true;
+    uint32_t index = it->second.index;
+    bucket_remove(page_id, it->second);
+    entries.erase(it);
+
+    // 末尾条目（序号为移除后的条目数）移到空出的位置；条目只在FSM页中，按序号读出其数据页号
+    uint32_t last = static_cast<uint32_t>(entries.size());
+    uint16_t last_slot = static_cast<uint16_t>(last % FSM_ENTRIES_PER_PAGE);
+    WritePageGuard page = file_manager.write_page_guard(fsm_pages[last / FSM_ENTRIES_PER_PAGE]);
+    if (!page) return false;
+    if (index != last) {
+        uint32_t moved;
+        page->read_data(FSM_PAGE_HEADER_SIZE + last_slot * FSM_ENTRY_SIZE, reinterpret_cast<char*>(&moved), sizeof(moved));
+        auto mit = entries.find(moved);
+        if (mit == entries.end()) return false;
+        mit->second.index = index;
+        page.release(); // 移到的位置可能在同一FSM页上
+        if (!persist_entry(moved, mit->second)) return false;
+        page = file_manager.write_page_guard(fsm_pages[last / FSM_ENTRIES_PER_PAGE]);
+        if (!page) return false;
+    }
+    if (last_slot != 0 || fsm_pages.size() == 1) {
+        page->write_data(16, reinterpret_cast<const char*>(&last_slot), sizeof(last_slot));
+        return true;
+    }
+    // 末尾FSM页已无条目：从FSM页链摘下并释放（只有最后一页可以不满）
+    page.release();
+    uint32_t empty_pid = fsm_pages.back();
+    fsm_pages.pop_back();
+    {
+        WritePageGuard prev = file_manager.write_page_guard(fsm_pages.back());
+        if (!prev) return false;
+        prev->set_next_page_id(INVALID_PAGE_ID);
+    }
+    return file_manager.free_page(empty_pid);
+}
+
+bool FreeSpaceMap::persist_entry(uint32_t page_id, const Entry& entry) {
+    uint32_t fsm_pid = fsm_pages[entry.index / FSM_ENTRIES_PER_PAGE];
+    uint16_t slot = static_cast<uint16_t>(entry.index % FSM_ENTRIES_PER_PAGE);
+    WritePageGuard page = file_manager.write_page_guard(fsm_pid);
+    if (!page) return false;
+
+    char raw[FSM_ENTRY_SIZE];
+    memcpy(raw, &page_id, sizeof(page_id));
+    raw[4] = static_cast<char>(entry.category);
+    page->write_data(FSM_PAGE_HEADER_SIZE + slot * FSM_ENTRY_SIZE, raw, FSM_ENTRY_SIZE);
+
+    // 追加条目时条目数随之增长（移除条目时由remove减小）
+    uint16_t count = 0;
+    page->read_data(16, reinterpret_cast<char*>(&count), sizeof(count));
+    if (slot + 1 > count) {
+        count = slot + 1;
+        page->write_data(16, reinterpret_cast<const char*>(&count), sizeof(count));
+    }
+    return true;
+}
+
+// -------------------------- 释放 --------------------------
+void FreeSpaceMap::release() {
+    file_manager.free_pages(fsm_pages);
+    fsm_pages.clear();
+    entries.clear();
+    for (auto& bucket : buckets) bucket.clear();
+    memset(nonempty, 0, sizeof(nonempty));
+}
@@ -0,0 +1,85 @@
+// =============================================
+// storage/free_space_map.hpp
+// =============================================
+//定义FreeSpaceMap类（表级空闲空间映射：每个数据页一个空闲档位，持久化在独立的FSM页链中）
+#ifndef FREE_SPACE_MAP_H
+#define FREE_SPACE_MAP_H
+
+#include "file_manager.hpp"
+#include "page.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// FSM页布局：
+//   [0,16)   基础页头（next_page_id 串起FSM页链）
+//   [16,18)  本页条目数(u16)
+//   [18,20)  页标志 PAGE_FLAG_FSM
+//   [20,40)  保留（[24,32)为页LSN，与槽页头等长）
+//   [40, ...) 条目数组，每条5字节：数据页号(u32) | 空闲档位(u8)
+//   每页条目数按最小页大小计（与位图页相同，大页中之后的字节不使用）
+#define FSM_PAGE_HEADER_SIZE PAGE_HEADER_SIZE
+#define FSM_ENTRY_SIZE 5
+#define FSM_ENTRIES_PER_PAGE ((MIN_PAGE_SIZE - FSM_PAGE_HEADER_SIZE) / FSM_ENTRY_SIZE)
+// 空闲档位：可用字节数 / 档位粒度（页大小 / FSM_CATEGORIES），共256档（一个字节）
+#define FSM_CATEGORIES 256
+
+class FreeSpaceMap {
+private:
+    // 一个数据页在内存索引中的位置
+    struct Entry {
+        uint8_t category;    // 空闲档位
+        uint32_t bucket_pos; // 在 buckets[category] 中的下标
+        uint32_t index;      // 在FSM页链中的条目序号（决定写回到哪一页哪个位置）
+    };
+
+    FileManager& file_manager;
+    uint32_t page_size;                              // 数据页大小（决定档位粒度）
+    std::vector<uint32_t> fsm_pages;                 // FSM页链（按顺序）
+    std::unordered_map<uint32_t, Entry> entries;     // 数据页号 -> 条目
+    std::vector<uint32_t> buckets[FSM_CATEGORIES];   // 每个档位下的数据页
+    uint64_t nonempty[FSM_CATEGORIES / 64];          // 非空档位位图，用于O(1)找到满足需求的最小档位
+
+    // 把条目写回FSM页（只改缓存页并标记为脏，随缓存刷盘）
+    bool persist_entry(uint32_t page_id, const Entry& entry);
+    // 从档位桶中摘除/加入一个数据页
+    void bucket_remove(uint32_t page_id, Entry& entry);
+    void bucket_add(uint32_t page_id, Entry& entry);
+    // 大于等于 category 的第一个非空档位，没有返回-1
+    int first_nonempty_from(uint32_t category) const;
+
+public:
+    // first_page_id 为 INVALID_PAGE_ID 时表示空映射（首次登记数据页时再分配FSM页）
+    FreeSpaceMap(FileManager& fm, uint32_t first_page_id = INVALID_PAGE_ID);
+
+    FreeSpaceMap(const FreeSpaceMap&) = delete;
+    FreeSpaceMap& operator=(const FreeSpaceMap&) = delete;
+
+    // 从FSM页链加载条目；页链损坏返回false（调用者可按表页链重建）
+    bool load();
+
+    // FSM页链首页号（保存在表目录中，空映射为INVALID_PAGE_ID）
+    uint32_t get_first_page_id() const { return fsm_pages.empty() ? INVALID_PAGE_ID : fsm_pages.front(); }
+    // 已登记的数据页数
+    size_t size() const { return entries.size(); }
+
+    // 档位粒度：每档代表的字节数
+    static uint32_t category_bytes_of(uint32_t page_size) { return page_size / FSM_CATEGORIES; }
+    // 可用字节数 -> 档位（扣除新槽的槽宽度，向下取整，保证档位只会低估空间）
+    static uint8_t category_of(uint32_t free_bytes, uint32_t page_size);
+
+    // 找一个至少能放下 record_len 字节记录的数据页（O(1)），没有返回INVALID_PAGE_ID
+    uint32_t find_page(uint32_t record_len) const;
+    // 登记/更新数据页的可用空间（free_bytes 为页压缩后可得的空闲字节，即 Page::reclaimable_space）
+    bool update(uint32_t page_id, uint32_t free_bytes);
+    // 注销数据页（页从表中移除时调用）：FSM页链末尾的条目移到它的位置，条目数减一，
+    // 末尾FSM页因此变空时释放该页；未登记返回true
+    bool remove(uint32_t page_id);
+    // 查询数据页的档位（未登记返回false）
+    bool get_category(uint32_t page_id, uint8_t& category) const;
+
+    // 释放全部FSM页（删表/清空表时调用），之后为空映射
+    void release();
+};
+
+#endif // FREE_SPACE_MAP_H
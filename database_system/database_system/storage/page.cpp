@@ -2,8 +2,10 @@
 // storage/page.cpp
 // =============================================
 #include "page.hpp"
+#include "crc32c.hpp"
 #include <stdexcept>
 #include <cstring>
+#include <memory>
 
 using namespace std;
 
@@ -16,31 +18,309 @@ struct PageHeaderPack {
 };
 #pragma pack(pop)
 
-// лҳͷԪϢҳšƫơҳţдdataǰ16ֽ
+// -------------------------- 拷贝与移动（页数据在堆上，按页大小分配） --------------------------
+Page::Page(const Page& other)
+    : page_id(other.page_id), free_offset(other.free_offset),
+    prev_page_id(other.prev_page_id), next_page_id(other.next_page_id),
+    page_size(other.page_size), data(new char[other.page_size]) {
+    memcpy(data, other.data, page_size);
+}
+
+Page::Page(Page&& other) noexcept
+    : page_id(other.page_id), free_offset(other.free_offset),
+    prev_page_id(other.prev_page_id), next_page_id(other.next_page_id),
+    page_size(other.page_size), data(other.data) {
+    other.data = nullptr;
+    other.page_size = 0;
+}
+
+Page& Page::operator=(const Page& other) {
+    if (this == &other) return *this;
+    if (page_size != other.page_size) {
+        char* buf = new char[other.page_size];
+        delete[] data;
+        data = buf;
+        page_size = other.page_size;
+    }
+    memcpy(data, other.data, page_size);
+    page_id = other.page_id;
+    free_offset = other.free_offset;
+    prev_page_id = other.prev_page_id;
+    next_page_id = other.next_page_id;
+    return *this;
+}
+
+Page& Page::operator=(Page&& other) noexcept {
+    if (this == &other) return *this;
+    delete[] data;
+    data = other.data;
+    page_size = other.page_size;
+    page_id = other.page_id;
+    free_offset = other.free_offset;
+    prev_page_id = other.prev_page_id;
+    next_page_id = other.next_page_id;
+    other.data = nullptr;
+    other.page_size = 0;
+    return *this;
+}
+
+// 序列化：将页头元信息（页号、空闲偏移、上下页号）写入data数组前16字节
 void Page::serialize() {
     PageHeaderPack h{ page_id, free_offset, prev_page_id, next_page_id };
     std::memcpy(data, &h, sizeof(h));
-    // data׵ַתΪuint32_tָ룬˳дԪϢ
+    // 将data数组首地址转为uint32_t指针，按顺序写入元信息
     uint32_t* header_ptr = reinterpret_cast<uint32_t*>(data);
-    *header_ptr++ = page_id;       // 1-4ֽڣҳ
-    *header_ptr++ = free_offset;   // 5-8ֽڣƫ
-    *header_ptr++ = prev_page_id;  // 9-12ֽڣһҳ
-    *header_ptr = next_page_id;    // 13-16ֽڣһҳ
+    *header_ptr++ = page_id;       // 第1-4字节：页号
+    *header_ptr++ = free_offset;   // 第5-8字节：空闲偏移
+    *header_ptr++ = prev_page_id;  // 第9-12字节：上一页号
+    *header_ptr = next_page_id;    // 第13-16字节：下一页号
 }
 
-// лӴ̶ȡֽdisk_dataҳͷµǰPage
+// 反序列化：从磁盘读取的字节流（disk_data）解析页头，更新当前Page对象
 void Page::deserialize(const char* disk_data) {
     if (disk_data == nullptr) {
-        throw invalid_argument("page.cppлʧ: ֽΪ");
+        throw invalid_argument("page.cpp——反序列化失败: 字节流为空");
     }
-    // Ƚݿǰҳdata
-    memcpy(data, disk_data, PAGE_SIZE);
+    // 先将磁盘数据拷贝到当前页的data数组
+    memcpy(data, disk_data, page_size);
+
+    // 再把页头解包到成员变量
+    reload_header();
+}
 
-    // ٰҳͷԱ
+void Page::reload_header() {
     PageHeaderPack h{};
     std::memcpy(&h, data, sizeof(h));
     page_id = h.page_id;
     free_offset = h.free_offset;
     prev_page_id = h.prev_page_id;
     next_page_id = h.next_page_id;
-}
\ No newline at end of file
+}
+
+// -------------------------- 页校验和 --------------------------
+uint32_t Page::compute_checksum(const char* raw, uint32_t page_size) {
+    // 跳过校验和字段本身，其余字节（含页号与校验和标志）全部参与计算
+    uint32_t crc = crc32c(raw, PAGE_CHECKSUM_OFFSET);
+    return crc32c(raw + PAGE_CHECKSUM_OFFSET + 4, page_size - PAGE_CHECKSUM_OFFSET - 4, crc);
+}
+
+void Page::stamp_checksum(char* raw, uint32_t page_size) {
+    uint16_t flag = PAGE_CHECKSUM_FLAG;
+    memcpy(raw + PAGE_CHECKSUM_FLAG_OFFSET, &flag, sizeof(flag));
+    uint32_t crc = compute_checksum(raw, page_size);
+    memcpy(raw + PAGE_CHECKSUM_OFFSET, &crc, sizeof(crc));
+}
+
+PageCheck Page::check_page(const char* raw, uint32_t page_size, uint32_t page_id) {
+    uint16_t flag;
+    memcpy(&flag, raw + PAGE_CHECKSUM_FLAG_OFFSET, sizeof(flag));
+    if (flag != PAGE_CHECKSUM_FLAG) {
+        for (uint32_t i = 0; i < page_size; ++i) {
+            if (raw[i] != 0) return PageCheck::UNSTAMPED;
+        }
+        return PageCheck::EMPTY;
+    }
+    uint32_t stored, stored_page_id;
+    memcpy(&stored, raw + PAGE_CHECKSUM_OFFSET, sizeof(stored));
+    memcpy(&stored_page_id, raw, sizeof(stored_page_id));
+    if (stored != compute_checksum(raw, page_size) || stored_page_id != page_id) return PageCheck::CORRUPT;
+    return PageCheck::OK;
+}
+
+// -------------------------- 槽页：初始化 --------------------------
+void Page::init_slotted() {
+    set_slot_count(0);
+    uint16_t flags = PAGE_FLAG_SLOTTED;
+    memcpy(data + 18, &flags, sizeof(flags));
+    set_free_end(page_size);
+    free_offset = PAGE_HEADER_SIZE;
+}
+
+void Page::set_slot(uint16_t slot, uint32_t off, uint32_t len) {
+    if (page_size > NARROW_SLOT_MAX_PAGE_SIZE) {
+        memcpy(data + PAGE_HEADER_SIZE + slot * WIDE_SLOT_SIZE, &off, 4);
+        memcpy(data + PAGE_HEADER_SIZE + slot * WIDE_SLOT_SIZE + 4, &len, 4);
+        return;
+    }
+    uint16_t off16 = static_cast<uint16_t>(off);
+    uint16_t len16 = static_cast<uint16_t>((len & NARROW_SLOT_LEN_MASK) | ((len & ~SLOT_LEN_MASK) >> NARROW_SLOT_FLAG_SHIFT));
+    memcpy(data + PAGE_HEADER_SIZE + slot * SLOT_SIZE, &off16, 2);
+    memcpy(data + PAGE_HEADER_SIZE + slot * SLOT_SIZE + 2, &len16, 2);
+}
+
+// -------------------------- 槽页：空间统计 --------------------------
+uint32_t Page::contiguous_free_space() const {
+    uint32_t slot_end = PAGE_HEADER_SIZE + get_slot_count() * slot_size();
+    uint32_t free_end = get_free_end();
+    return free_end > slot_end ? free_end - slot_end : 0;
+}
+
+uint32_t Page::reclaimable_space() const {
+    // 存活记录总长
+    uint32_t live_bytes = 0;
+    uint16_t count = get_slot_count();
+    for (uint16_t i = 0; i < count; ++i) {
+        uint32_t off, len;
+        get_slot(i, off, len);
+        if (!slot_is_free(len)) live_bytes += len & SLOT_LEN_MASK;
+    }
+    uint32_t used = PAGE_HEADER_SIZE + count * slot_size() + live_bytes;
+    return used < page_size ? page_size - used : 0;
+}
+
+// -------------------------- 槽页：压缩 --------------------------
+void Page::compact() {
+    // 按原偏移从大到小搬移存活记录，使其紧贴页尾；槽号保持不变
+    // 大页的临时区放在栈上会占用过多栈空间，按页大小分配
+    unique_ptr<char[]> tmp(new char[page_size]);
+    uint32_t write_end = page_size;
+    uint16_t count = get_slot_count();
+    for (uint16_t i = 0; i < count; ++i) {
+        uint32_t off, len;
+        get_slot(i, off, len);
+        if (slot_is_free(len)) {
+            set_slot(i, 0, SLOT_TOMBSTONE);
+            continue;
+        }
+        uint32_t n = len & SLOT_LEN_MASK;
+        write_end -= n;
+        memcpy(tmp.get() + write_end, data + off, n);
+        set_slot(i, write_end, len);
+    }
+    memcpy(data + write_end, tmp.get() + write_end, page_size - write_end);
+    set_free_end(write_end);
+}
+
+// -------------------------- 槽页：插入记录 --------------------------
+bool Page::insert_record(const char* rec, uint32_t len, uint16_t& slot_out) {
+    return insert_slot(rec, len, 0, slot_out);
+}
+
+bool Page::insert_slot(const char* rec, uint32_t len, uint32_t flags, uint16_t& slot_out) {
+    if (rec == nullptr && len > 0) return false;
+    if (len > max_record_size()) return false;
+
+    // 优先复用墓碑槽（无需新增槽空间）
+    uint16_t count = get_slot_count();
+    uint16_t slot = count;
+    for (uint16_t i = 0; i < count; ++i) {
+        uint32_t off, slot_len;
+        get_slot(i, off, slot_len);
+        if (slot_is_free(slot_len)) { slot = i; break; }
+    }
+    uint32_t need = len + (slot == count ? slot_size() : 0);
+
+    if (contiguous_free_space() < need) {
+        if (reclaimable_space() < need) return false;
+        compact();
+    }
+
+    uint32_t rec_off = get_free_end() - len;
+    memcpy(data + rec_off, rec, len);
+    set_free_end(rec_off);
+    if (slot == count) {
+        set_slot_count(static_cast<uint16_t>(count + 1));
+        free_offset = PAGE_HEADER_SIZE + (count + 1) * slot_size();
+    }
+    set_slot(slot, rec_off, len | flags);
+    slot_out = slot;
+    return true;
+}
+
+// -------------------------- 槽页：删除记录 --------------------------
+bool Page::delete_record(uint16_t slot) {
+    if (slot >= get_slot_count()) return false;
+    uint32_t off, len;
+    get_slot(slot, off, len);
+    if (slot_is_free(len)) return false;
+    set_slot(slot, off, (len & SLOT_LEN_MASK) | SLOT_TOMBSTONE);
+    return true;
+}
+
+// -------------------------- 槽页：更新记录 --------------------------
+bool Page::update_record(uint16_t slot, const char* rec, uint32_t len) {
+    if (slot >= get_slot_count() || (rec == nullptr && len > 0)) return false;
+    uint32_t off, old_len;
+    get_slot(slot, off, old_len);
+    uint32_t flags = old_len & SLOT_FLAG_MASK;
+    if (flags == SLOT_TOMBSTONE || flags == SLOT_FORWARD) return false;
+    if (flags != SLOT_MOVED) return replace_slot(slot, rec, len, 0);
+
+    // 迁入记录：保留原位置前缀
+    string tmp(data + off, FORWARD_REF_SIZE);
+    tmp.append(rec, len);
+    return replace_slot(slot, tmp.data(), static_cast<uint32_t>(tmp.size()), SLOT_MOVED);
+}
+
+bool Page::replace_slot(uint16_t slot, const char* rec, uint32_t len, uint32_t flags) {
+    if (len > max_record_size()) return false;
+    uint32_t off, old_len;
+    get_slot(slot, off, old_len);
+    uint32_t old_bytes = old_len & SLOT_LEN_MASK;
+
+    // 1) 不变长：原地覆盖（缩短留下的尾部碎片在压缩时回收）
+    if (len <= old_bytes) {
+        memmove(data + off, rec, len);
+        set_slot(slot, off, len | flags);
+        return true;
+    }
+
+    // 2) 变长：先看页内放不放得下（旧记录的空间压缩后可回收）
+    uint32_t available = reclaimable_space() + old_bytes;
+    if (available < len) return false;
+
+    // 新内容可能指向本页（调用者传入get_record的结果），先拷出
+    string tmp(rec, len);
+    if (contiguous_free_space() < len) {
+        set_slot(slot, off, old_bytes | SLOT_TOMBSTONE); // 让压缩释放旧记录
+        compact();
+    }
+    uint32_t rec_off = get_free_end() - len;
+    memcpy(data + rec_off, tmp.data(), len);
+    set_free_end(rec_off);
+    set_slot(slot, rec_off, len | flags);
+    return true;
+}
+
+// -------------------------- 转发 --------------------------
+static void encode_ref(char* out, uint32_t pid, uint16_t slot) {
+    memcpy(out, &pid, 4);
+    memcpy(out + 4, &slot, 2);
+}
+
+bool Page::read_ref(uint16_t slot, uint32_t want_flags, uint32_t& pid, uint16_t& ref_slot) const {
+    if (slot >= get_slot_count()) return false;
+    uint32_t off, len;
+    get_slot(slot, off, len);
+    if ((len & SLOT_FLAG_MASK) != want_flags || (len & SLOT_LEN_MASK) < FORWARD_REF_SIZE) return false;
+    memcpy(&pid, data + off, 4);
+    memcpy(&ref_slot, data + off + 4, 2);
+    return true;
+}
+
+bool Page::set_forward(uint16_t slot, uint32_t target_pid, uint16_t target_slot) {
+    if (slot >= get_slot_count()) return false;
+    uint32_t off, len;
+    get_slot(slot, off, len);
+    uint32_t flags = len & SLOT_FLAG_MASK;
+    if (flags != 0 && flags != SLOT_FORWARD) return false;
+    char ref[FORWARD_REF_SIZE];
+    encode_ref(ref, target_pid, target_slot);
+    return replace_slot(slot, ref, FORWARD_REF_SIZE, SLOT_FORWARD);
+}
+
+bool Page::insert_moved_record(uint32_t home_pid, uint16_t home_slot, const char* rec, uint32_t len, uint16_t& slot_out) {
+    if (rec == nullptr && len > 0) return false;
+    string tmp(FORWARD_REF_SIZE, '\0');
+    encode_ref(&tmp[0], home_pid, home_slot);
+    tmp.append(rec, len);
+    return insert_slot(tmp.data(), static_cast<uint32_t>(tmp.size()), SLOT_MOVED, slot_out);
+}
+
+bool Page::restore_record(uint16_t slot, const char* rec, uint32_t len) {
+    if (slot >= get_slot_count() || (rec == nullptr && len > 0)) return false;
+    uint32_t off, old_len;
+    get_slot(slot, off, old_len);
+    if ((old_len & SLOT_FLAG_MASK) != SLOT_FORWARD) return false;
+    return replace_slot(slot, rec, len, 0);
+}
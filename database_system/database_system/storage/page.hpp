@@ -8,40 +8,137 @@
 #include <cstring>
 #include <string>
 
-// ĳ
-#define PAGE_SIZE 4096          // ÿҳ̶С4KB
-#define PAGE_HEADER_SIZE 16     // ҳͷС16ֽڣ洢4uint32_tԪϢ
-#define INVALID_PAGE_ID 0       // ЧҳţҳŴ1ʼ
+// 核心常量定义
+// 页大小按数据库选择（建库时确定，记录在meta.dat中），取MIN_PAGE_SIZE~MAX_PAGE_SIZE之间的2的幂
+#define DEFAULT_PAGE_SIZE 4096  // 默认页大小：4KB
+#define MIN_PAGE_SIZE 4096
+#define MAX_PAGE_SIZE 65536
+#define PAGE_HEADER_SIZE 40     // 页头大小：40字节（基础页头16字节 + 槽页头24字节）
+#define PAGE_BASE_HEADER_SIZE 16 // 基础页头：4个uint32_t元信息（页号、空闲偏移、上下页号）
+#define INVALID_PAGE_ID 0       // 无效页号（页号从1开始）
+// 页号按数据文件划分：高8位为文件号，低24位为文件内页号（从1开始，每个文件最多16M页）
+//   文件0为共享数据文件data.dat（旧库的页都在这里，文件内页号即页号），1~255为各表的页文件
+#define PAGE_FILE_SHIFT 24
+#define PAGE_NO_MASK 0x00FFFFFFu
+#define MAX_DATA_FILES 256
+#define SHARED_FILE_ID 0
+
+// 槽页（slotted page）布局：
+//   [0,16)   基础页头：page_id | free_offset | prev_page_id | next_page_id
+//   [16,40)  槽页头：slot_count(u16) | page_flags(u16) | free_end(u32) | page_lsn(u64) | checksum(u32) |
+//            checksum_flag(u16) | 保留2字节
+//   [40, free_offset)          槽数组
+//   [free_offset, free_end)    空闲空间
+//   [free_end, 页大小)          记录区，从页尾向前增长
+// 槽号在页内稳定：删除只打墓碑标记，压缩只移动记录字节，不改变槽号
+// 槽宽度由页大小决定：不超过16KB的页用窄槽（与4KB页的旧格式相同），更大的页偏移和长度超出u16，用宽槽
+//   窄槽4字节：offset(u16) | len(u16，高两位为标志位)
+//   宽槽8字节：offset(u32) | len(u32，高两位为标志位)
+#define SLOT_SIZE 4
+#define WIDE_SLOT_SIZE 8
+#define NARROW_SLOT_MAX_PAGE_SIZE 16384
+// 槽标志与长度掩码按宽槽的位置表示，读写窄槽时把高两位左移/右移16位换算
+#define SLOT_TOMBSTONE 0x80000000u  // 槽标志：记录已删除
+#define SLOT_FORWARD 0x40000000u    // 槽标志：转发桩（记录已迁到其他页，槽中只存新位置）
+#define SLOT_MOVED (SLOT_TOMBSTONE | SLOT_FORWARD) // 两位同时置位：迁入记录（记录前带原位置）
+#define SLOT_FLAG_MASK 0xC0000000u
+#define SLOT_LEN_MASK 0x3FFFFFFFu   // 槽长度掩码（高两位为标志位）
+// 记录在页内放不下时迁到其他页，原槽改为转发桩，原槽号保持为记录的位置：
+//   转发桩内容：新位置的页号(u32) | 槽号(u16)
+//   迁入记录内容：原位置的页号(u32) | 槽号(u16) | 记录（顺序扫描在迁入处读到记录，跳过转发桩，每条记录只读到一次）
+#define FORWARD_REF_SIZE 6
+#define NARROW_SLOT_LEN_MASK 0x3FFF
+#define NARROW_SLOT_FLAG_SHIFT 16
+#define PAGE_FLAG_SLOTTED 0x0001 // 页标志：槽页格式
+#define PAGE_FLAG_FSM 0x0002     // 页标志：空闲空间映射页（不含记录）
+#define PAGE_FLAG_BITMAP 0x0004  // 页标志：空闲页位图页（不含记录）
+// 页LSN：最后一次修改本页的日志记录的结束位置（所有页类型共用[24,32)，0表示从未记录日志）
+#define PAGE_LSN_OFFSET 24
+// 页校验和（所有页类型共用）：[32,36)为整页的CRC32C（计算时跳过这4字节），[36,38)为校验和标志
+// 校验和只在写盘时计算、读盘时校验，缓存中的页不维护这两个字段
+#define PAGE_CHECKSUM_OFFSET 32
+#define PAGE_CHECKSUM_FLAG_OFFSET 36
+#define PAGE_CHECKSUM_FLAG 0x5343  // "CS"：页已带校验和
+
+// 磁盘页的校验结果
+enum class PageCheck {
+    OK,         // 校验和正确
+    EMPTY,      // 全零页（按区段预扩展、从未写过）
+    UNSTAMPED,  // 没有校验和标志（旧格式写入的页）
+    CORRUPT     // 校验和不匹配，或页号与所在位置不符
+};
 
 class Page {
-    // PageManagerΪԪ࣬˽гԱ
+    // 声明PageManager为友元类，允许其访问所有私有成员
     friend class PageManager;
     friend class FileManager;
+    friend class WritePageGuard;
 
 private:
-    uint32_t page_id;          // Ψһҳţ1
-    uint32_t free_offset;      // пռʼƫƣPAGE_HEADER_SIZEʼ
-    uint32_t prev_page_id;     // һҳţݱҳ֯ʵݱӳ䣩
-    uint32_t next_page_id;     // һҳ
-    char data[PAGE_SIZE];      // ҳݣҳͷ+4KB
+    uint32_t page_id;          // 唯一页编号（≥1）
+    uint32_t free_offset;      // 数据区空闲空间起始偏移（槽页中即槽数组末尾，从PAGE_HEADER_SIZE开始）
+    uint32_t prev_page_id;     // 上一页编号（用于数据表的页链表组织，实现数据表映射）
+    uint32_t next_page_id;     // 下一页编号
+    uint32_t page_size;        // 页大小（字节），由所属数据库决定
+    char* data;                // 页完整数据（页头+数据区，共page_size字节，堆上分配）
+
+    // 槽页头字段读写（直接存放在data中，serialize只覆盖前16字节基础页头）
+    void set_slot_count(uint16_t n) { memcpy(data + 16, &n, sizeof(n)); }
+    uint32_t get_free_end() const {
+        uint32_t v;
+        memcpy(&v, data + 20, sizeof(v));
+        return (v == 0 || v > page_size) ? page_size : v; // 全零页视为记录区为空
+    }
+    void set_free_end(uint32_t v) { memcpy(data + 20, &v, sizeof(v)); }
+    // len含标志位（SLOT_TOMBSTONE等，按宽槽的位置表示）
+    void get_slot(uint16_t slot, uint32_t& off, uint32_t& len) const { view_slot(data, page_size, slot, off, len); }
+    void set_slot(uint16_t slot, uint32_t off, uint32_t len);
+    // 在新槽或墓碑槽中放入记录，flags为槽标志
+    bool insert_slot(const char* rec, uint32_t len, uint32_t flags, uint16_t& slot_out);
+    // 替换存活槽的内容与标志：放不下时在页内重新放置（必要时压缩），页内放不下返回false
+    bool replace_slot(uint16_t slot, const char* rec, uint32_t len, uint32_t flags);
+    // 转发桩/迁入记录前缀中的位置
+    bool read_ref(uint16_t slot, uint32_t want_flags, uint32_t& pid, uint16_t& ref_slot) const;
 
 public:
-    // 캯ʼҳţĬϿƫΪҳͷʼλã
-    Page(uint32_t pid = INVALID_PAGE_ID)
+    // 构造函数：初始化页号与页大小，默认空闲偏移为页头后（数据区起始位置）
+    Page(uint32_t pid = INVALID_PAGE_ID, uint32_t size = DEFAULT_PAGE_SIZE)
         : page_id(pid), free_offset(PAGE_HEADER_SIZE),
-        prev_page_id(INVALID_PAGE_ID), next_page_id(INVALID_PAGE_ID) {
-        memset(data, 0, PAGE_SIZE); // ʼΪ0ݲ
+        prev_page_id(INVALID_PAGE_ID), next_page_id(INVALID_PAGE_ID),
+        page_size(size), data(new char[size]) {
+        memset(data, 0, page_size); // 初始化数据区为0，避免脏数据残留
+        init_slotted();
+    }
+    Page(const Page& other);
+    Page(Page&& other) noexcept;
+    Page& operator=(const Page& other);
+    Page& operator=(Page&& other) noexcept;
+    ~Page() { delete[] data; }
+
+    // 页大小是否合法（MIN_PAGE_SIZE~MAX_PAGE_SIZE之间的2的幂）
+    static bool is_valid_page_size(uint32_t size) {
+        return size >= MIN_PAGE_SIZE && size <= MAX_PAGE_SIZE && (size & (size - 1)) == 0;
     }
+    static uint32_t slot_size_of(uint32_t size) { return size > NARROW_SLOT_MAX_PAGE_SIZE ? WIDE_SLOT_SIZE : SLOT_SIZE; }
+    // 一页能放下的最长记录（空页、只有一个槽）
+    static uint32_t max_record_size_of(uint32_t size) { return size - PAGE_HEADER_SIZE - slot_size_of(size); }
+    // 页号的组成：所在数据文件号、文件内页号；由两者拼出页号
+    static uint32_t file_of(uint32_t page_id) { return page_id >> PAGE_FILE_SHIFT; }
+    static uint32_t number_of(uint32_t page_id) { return page_id & PAGE_NO_MASK; }
+    static uint32_t make_page_id(uint32_t file_id, uint32_t page_no) { return (file_id << PAGE_FILE_SHIFT) | page_no; }
+    uint32_t get_page_size() const { return page_size; }
+    uint32_t slot_size() const { return slot_size_of(page_size); }
+    uint32_t max_record_size() const { return max_record_size_of(page_size); }
 
-    // -------------------------- ҳԪϢʽӿڣPageManagerã --------------------------
+    // -------------------------- 页元信息访问接口（供PageManager调用） --------------------------
     uint32_t get_page_id() const { return page_id; }
     void set_page_id(uint32_t pid) { page_id = pid; }
 
 
     uint32_t get_free_offset() const { return free_offset; }
-    // ¿ƫƣȷҳС
+    // 更新空闲偏移（确保不超出页大小，避免数据溢出）
     bool set_free_offset(uint32_t offset) {
-        if (offset < PAGE_HEADER_SIZE || offset > PAGE_SIZE) return false;
+        if (offset < PAGE_HEADER_SIZE || offset > page_size) return false;
         free_offset = offset;
         return true;
     }
@@ -52,27 +149,145 @@ public:
     uint32_t get_next_page_id() const { return next_page_id; }
     void set_next_page_id(uint32_t pid) { next_page_id = pid; }
 
-    // -------------------------- ҳݶдӿڣݿ洢ã --------------------------
-    // дݣָƫƿʼȷҳС
+    // -------------------------- 页数据读写接口（供数据库存储引擎调用） --------------------------
+    // 向数据区写入数据（从指定偏移开始，需确保不超出页大小）
     bool write_data(uint32_t offset, const char* data_buf, uint32_t len) {
-        if (offset + len > PAGE_SIZE || data_buf == nullptr) return false;
+        if (offset + len > page_size || data_buf == nullptr) return false;
         memcpy(data + offset, data_buf, len);
         return true;
     }
 
-    // ȡݣָƫƿʼȷҳС
+    // 从数据区读取数据（从指定偏移开始，需确保不超出页大小）
     bool read_data(uint32_t offset, char* data_buf, uint32_t len) const {
-        if (offset + len > PAGE_SIZE || data_buf == nullptr) return false;
+        if (offset + len > page_size || data_buf == nullptr) return false;
         memcpy(data_buf, data + offset, len);
         return true;
     }
 
-    // -------------------------- л/лҳļĸʽת --------------------------
-    // лҳͷԪϢдdata飨ǰ16ֽڣд
+    // 页LSN（写前日志：页写回磁盘前，日志必须已持久化到该位置）
+    uint64_t get_lsn() const {
+        uint64_t v;
+        memcpy(&v, data + PAGE_LSN_OFFSET, sizeof(v));
+        return v;
+    }
+    void set_lsn(uint64_t lsn) { memcpy(data + PAGE_LSN_OFFSET, &lsn, sizeof(lsn)); }
+
+    // 页标志（PAGE_FLAG_*）
+    uint16_t get_page_flags() const { return view_page_flags(data); }
+    void set_page_flags(uint16_t flags) { memcpy(data + 18, &flags, sizeof(flags)); }
+
+    // -------------------------- 槽页记录接口（供数据库存储引擎调用） --------------------------
+    // 清空为空槽页（无槽、记录区为空）
+    void init_slotted();
+    // 槽数量（含墓碑槽）
+    uint16_t get_slot_count() const { return view_slot_count(data); }
+    // 连续空闲空间（槽数组末尾到记录区起点）
+    uint32_t contiguous_free_space() const;
+    // 压缩后可得到的空闲空间（连续空闲 + 已删除/被缩短记录留下的碎片）
+    uint32_t reclaimable_space() const;
+    // 插入记录：优先复用墓碑槽，空间不连续时先压缩；空间不足返回false
+    bool insert_record(const char* rec, uint32_t len, uint16_t& slot_out);
+    // 读取记录：返回页内指针（在下一次修改本页前有效），槽无效或已删除返回false
+    bool get_record(uint16_t slot, const char*& rec, uint32_t& len) const {
+        return view_record(data, page_size, slot, rec, len);
+    }
+    // 删除记录：只打墓碑标记，空间在压缩时回收（转发桩/迁入记录同样删除，另一端由调用者处理）
+    bool delete_record(uint16_t slot);
+    // 原地更新记录：新记录不长于旧记录时直接覆盖，否则在页内重新放置（必要时压缩），
+    // 页内放不下返回false（记录保持不变，由调用者移动到其他页）；迁入记录保留原位置前缀，转发桩返回false
+    bool update_record(uint16_t slot, const char* rec, uint32_t len);
+    // 页内压缩：把存活记录紧凑地移到页尾，槽号不变
+    void compact();
+
+    // -------------------------- 转发（记录迁到其他页后原槽号仍有效） --------------------------
+    // 存活槽（普通记录或转发桩）改为指向target_pid/target_slot的转发桩；页内放不下返回false
+    bool set_forward(uint16_t slot, uint32_t target_pid, uint16_t target_slot);
+    // 读取转发桩指向的位置（不是转发桩返回false）
+    bool get_forward(uint16_t slot, uint32_t& target_pid, uint16_t& target_slot) const {
+        return read_ref(slot, SLOT_FORWARD, target_pid, target_slot);
+    }
+    // 插入迁入记录（带原位置home_pid/home_slot）；空间不足返回false
+    bool insert_moved_record(uint32_t home_pid, uint16_t home_slot, const char* rec, uint32_t len, uint16_t& slot_out);
+    // 读取迁入记录的原位置（不是迁入记录返回false）
+    bool get_home(uint16_t slot, uint32_t& home_pid, uint16_t& home_slot) const {
+        return read_ref(slot, SLOT_MOVED, home_pid, home_slot);
+    }
+    // 转发桩换回普通记录（记录迁回原页）；页内放不下返回false
+    bool restore_record(uint16_t slot, const char* rec, uint32_t len);
+
+    // -------------------------- 只读页视图（零拷贝读取时直接解析原始字节） --------------------------
+    // raw为一整页字节（含16字节页头），布局与serialize写入的一致；page_size决定槽宽度与越界检查
+    // 缓存页的原始字节（页头成员修改后需serialize才反映到这里）
+    const char* raw_data() const { return data; }
+    static uint32_t view_free_offset(const char* raw) {
+        uint32_t v;
+        memcpy(&v, raw + 4, sizeof(v));
+        return v;
+    }
+    static uint32_t view_next_page_id(const char* raw) {
+        uint32_t v;
+        memcpy(&v, raw + 12, sizeof(v));
+        return v;
+    }
+    static uint16_t view_slot_count(const char* raw) {
+        uint16_t v;
+        memcpy(&v, raw + 16, sizeof(v));
+        return v;
+    }
+    static uint16_t view_page_flags(const char* raw) {
+        uint16_t v;
+        memcpy(&v, raw + 18, sizeof(v));
+        return v;
+    }
+    // 读取槽的偏移与长度（长度含标志位，窄槽的标志位换算到宽槽的位置）
+    static void view_slot(const char* raw, uint32_t page_size, uint16_t slot, uint32_t& off, uint32_t& len) {
+        if (page_size > NARROW_SLOT_MAX_PAGE_SIZE) {
+            memcpy(&off, raw + PAGE_HEADER_SIZE + slot * WIDE_SLOT_SIZE, 4);
+            memcpy(&len, raw + PAGE_HEADER_SIZE + slot * WIDE_SLOT_SIZE + 4, 4);
+            return;
+        }
+        uint16_t off16, len16;
+        memcpy(&off16, raw + PAGE_HEADER_SIZE + slot * SLOT_SIZE, 2);
+        memcpy(&len16, raw + PAGE_HEADER_SIZE + slot * SLOT_SIZE + 2, 2);
+        off = off16;
+        len = (len16 & NARROW_SLOT_LEN_MASK) |
+            (static_cast<uint32_t>(len16 & ~NARROW_SLOT_LEN_MASK) << NARROW_SLOT_FLAG_SHIFT);
+    }
+    // 槽是否可复用（已删除）；转发桩与迁入记录都是存活槽
+    static bool slot_is_free(uint32_t slot_len) { return (slot_len & SLOT_FLAG_MASK) == SLOT_TOMBSTONE; }
+    // 读取槽中的记录（墓碑槽、转发桩、越界槽返回false；迁入记录返回去掉原位置前缀后的记录）
+    static bool view_record(const char* raw, uint32_t page_size, uint16_t slot, const char*& rec, uint32_t& len) {
+        if (slot >= view_slot_count(raw)) return false;
+        uint32_t slot_off, slot_len;
+        view_slot(raw, page_size, slot, slot_off, slot_len);
+        uint32_t flags = slot_len & SLOT_FLAG_MASK;
+        if (flags == SLOT_TOMBSTONE || flags == SLOT_FORWARD) return false;
+        len = slot_len & SLOT_LEN_MASK;
+        if (static_cast<uint64_t>(slot_off) + len > page_size) return false;
+        rec = raw + slot_off;
+        if (flags == SLOT_MOVED) {
+            if (len < FORWARD_REF_SIZE) return false;
+            rec += FORWARD_REF_SIZE;
+            len -= FORWARD_REF_SIZE;
+        }
+        return true;
+    }
+
+    // -------------------------- 页校验和（写盘前设置，读盘后校验） --------------------------
+    static uint32_t compute_checksum(const char* raw, uint32_t page_size);
+    // 在一整页字节上写入校验和标志与校验和
+    static void stamp_checksum(char* raw, uint32_t page_size);
+    // 校验读出的一整页字节；page_id为页所在位置（带校验和的页，其页号必须与之相同）
+    static PageCheck check_page(const char* raw, uint32_t page_size, uint32_t page_id);
+
+    // -------------------------- 序列化/反序列化（页与磁盘文件的格式转换） --------------------------
+    // 序列化：将页头元信息写入data数组（前16字节），用于写入磁盘
     void serialize();
 
-    // лӴ̶ȡֽнҳͷԪϢֵǰPage
+    // 反序列化：从磁盘读取的字节流（page_size字节）中解析页头元信息，赋值给当前Page对象
     void deserialize(const char* disk_data);
+    // 直接改写data后（如重做日志），按data前16字节刷新页头成员变量
+    void reload_header();
 };
 
 #endif // PAGE_H
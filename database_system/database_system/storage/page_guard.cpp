@@ -0,0 +1,79 @@
+// =============================================
+// storage/page_guard.cpp
+// =============================================
+//实现页守卫（固定/解除固定、写守卫释放时记录日志并标记脏页）
+#include "page_guard.hpp"
+#include <cstring>
+
+using namespace std;
+
+// -------------------------- 基类：固定与解除固定 --------------------------
+PageGuard::PageGuard() : cache_manager(nullptr), page_id(INVALID_PAGE_ID), page(nullptr), latch(FrameLatch::NONE) {}
+
+PageGuard::PageGuard(CacheManager& cm, uint32_t pid, FrameLatch frame_latch, AccessHint hint)
+    : cache_manager(&cm), page_id(pid), page(nullptr), latch(frame_latch) {
+    page = cm.pin_page(pid, latch, hint);
+    if (!page) cache_manager = nullptr;
+}
+
+PageGuard::PageGuard(PageGuard&& other) noexcept
+    : cache_manager(other.cache_manager), page_id(other.page_id), page(other.page), latch(other.latch) {
+    other.cache_manager = nullptr;
+    other.page = nullptr;
+}
+
+void PageGuard::unpin(bool dirty) {
+    if (!page) return;
+    cache_manager->unpin_page(page_id, dirty, latch);
+    cache_manager = nullptr;
+    page = nullptr;
+}
+
+// -------------------------- 读守卫 --------------------------
+ReadPageGuard& ReadPageGuard::operator=(ReadPageGuard&& other) noexcept {
+    if (this != &other) {
+        release();
+        cache_manager = other.cache_manager;
+        page_id = other.page_id;
+        page = other.page;
+        latch = other.latch;
+        other.cache_manager = nullptr;
+        other.page = nullptr;
+    }
+    return *this;
+}
+
+// -------------------------- 写守卫 --------------------------
+WritePageGuard::WritePageGuard(CacheManager& cm, uint32_t pid) : PageGuard(cm, pid, FrameLatch::EXCLUSIVE) {
+    if (page && cm.get_wal()) {
+        before_image.reset(new char[page->get_page_size()]);
+        memcpy(before_image.get(), page->data, page->get_page_size());
+    }
+}
+
+WritePageGuard& WritePageGuard::operator=(WritePageGuard&& other) noexcept {
+    if (this != &other) {
+        release();
+        cache_manager = other.cache_manager;
+        page_id = other.page_id;
+        page = other.page;
+        latch = other.latch;
+        before_image = std::move(other.before_image);
+        other.cache_manager = nullptr;
+        other.page = nullptr;
+    }
+    return *this;
+}
+
+void WritePageGuard::release() {
+    if (!page) return;
+    // 页头元信息（页号、上下页号等）可能只改了成员变量，写回data后再标脏
+    page->serialize();
+    // 先记日志再解除页帧锁：脏页被写回之前，页LSN已经是最新修改的日志位置
+    if (before_image) {
+        uint64_t lsn = cache_manager->get_wal()->log_page_changes(page_id, before_image.get(), page->data);
+        if (lsn != 0) page->set_lsn(lsn);
+        before_image.reset();
+    }
+    unpin(true);
+}
@@ -0,0 +1,78 @@
+// =============================================
+// storage/page_guard.hpp
+// =============================================
+//定义页守卫类（RAII固定缓存页：持有期间页不会被替换，写守卫释放时自动标记脏页）
+//读守卫持有页帧共享锁、写守卫持有页帧独占锁；同一线程不要对同一页同时持有读守卫和写守卫
+#ifndef PAGE_GUARD_H
+#define PAGE_GUARD_H
+
+#include "page.hpp"
+#include "cache_manager.hpp"
+#include <cstdint>
+#include <memory>
+
+// 页守卫基类：构造时固定页（固定计数+1），析构或release时解除固定
+// 只能移动不能拷贝；取页失败时守卫为空（operator bool 为false）
+class PageGuard {
+protected:
+    CacheManager* cache_manager; // 所属缓存（空守卫为nullptr）
+    uint32_t page_id;            // 固定的页号
+    Page* page;                  // 缓存页指针（固定期间有效）
+    FrameLatch latch;            // 持有的页帧锁类型
+
+    PageGuard();
+    PageGuard(CacheManager& cm, uint32_t pid, FrameLatch frame_latch, AccessHint hint = AccessHint::NORMAL);
+    PageGuard(PageGuard&& other) noexcept;
+    ~PageGuard() = default;
+    // 释放页帧锁并解除固定（dirty为true时同时标记脏页），之后守卫为空
+    void unpin(bool dirty);
+
+public:
+    PageGuard(const PageGuard&) = delete;
+    PageGuard& operator=(const PageGuard&) = delete;
+
+    explicit operator bool() const { return page != nullptr; }
+    uint32_t get_page_id() const { return page_id; }
+};
+
+// 读守卫：只读访问（多个读守卫可同时持有同一页）
+class ReadPageGuard : public PageGuard {
+public:
+    ReadPageGuard() = default;
+    // hint为SEQUENTIAL时（顺序扫描）页不在替换策略中提升
+    ReadPageGuard(CacheManager& cm, uint32_t pid, AccessHint hint = AccessHint::NORMAL)
+        : PageGuard(cm, pid, FrameLatch::SHARED, hint) {}
+    ReadPageGuard(ReadPageGuard&& other) noexcept = default;
+    ReadPageGuard& operator=(ReadPageGuard&& other) noexcept;
+    ~ReadPageGuard() { release(); }
+
+    const Page* get() const { return page; }
+    const Page* operator->() const { return page; }
+    const Page& operator*() const { return *page; }
+
+    // 提前解除固定
+    void release() { unpin(false); }
+};
+
+// 写守卫：独占访问，可修改页内容，释放时把页头元信息写回data并标记为脏页（刷盘由缓存替换/flush负责）
+// 缓存关联了写前日志时，固定时保存页的修改前内容，释放时把字节差异记入日志并更新页LSN
+class WritePageGuard : public PageGuard {
+private:
+    std::unique_ptr<char[]> before_image; // 修改前的页内容（不记日志时为空）
+
+public:
+    WritePageGuard() = default;
+    WritePageGuard(CacheManager& cm, uint32_t pid);
+    WritePageGuard(WritePageGuard&& other) noexcept = default;
+    WritePageGuard& operator=(WritePageGuard&& other) noexcept;
+    ~WritePageGuard() { release(); }
+
+    Page* get() const { return page; }
+    Page* operator->() const { return page; }
+    Page& operator*() const { return *page; }
+
+    // 提前解除固定（记录日志、标记脏页）
+    void release();
+};
+
+#endif // PAGE_GUARD_H
@@ -3,136 +3,839 @@
 // =============================================
 #include "page_manager.hpp"
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 using namespace std;
-// 캯ʼļͺĲ
-PageManager::PageManager(const string& data_path)
-    : data_file_path(data_path), next_page_id(1) {
-    init_data_file(); // ȷļ
+
+#ifdef _WIN32
+#define INVALID_FILE_HANDLE INVALID_HANDLE_VALUE
+#else
+#define INVALID_FILE_HANDLE (-1)
+#endif
+
+// -------------------------- 私有辅助函数：打开/关闭数据文件 --------------------------
+void PageManager::open_data_file() {
+#ifdef _WIN32
+    file_handle = CreateFileA(data_file_path.c_str(), GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file_handle == INVALID_FILE_HANDLE) {
+        throw runtime_error("page_manager.cpp：页管理初始化失败: 打开文件 " + data_file_path + "失败");
+    }
+    LARGE_INTEGER size;
+    file_size = GetFileSizeEx(file_handle, &size) ? static_cast<uint64_t>(size.QuadPart) : 0;
+#else
+    file_handle = ::open(data_file_path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (file_handle == INVALID_FILE_HANDLE) {
+        throw runtime_error("page_manager.cpp：页管理初始化失败: 打开文件 " + data_file_path + "失败");
+    }
+    struct stat st;
+    file_size = (fstat(file_handle, &st) == 0) ? static_cast<uint64_t>(st.st_size) : 0;
+#endif
+}
+
+void PageManager::close_data_file() {
+    if (file_handle == INVALID_FILE_HANDLE) return;
+#ifdef _WIN32
+    CloseHandle(file_handle);
+#else
+    ::close(file_handle);
+#endif
+    file_handle = INVALID_FILE_HANDLE;
+}
+
+// -------------------------- 私有辅助函数：内存映射（按块扩展 + 重新映射） --------------------------
+bool PageManager::ensure_mapped(uint64_t required) {
+    if (map_base != nullptr && required <= map_size) return true;
+
+    // 新映射长度：向上取整到MMAP_GROW_CHUNK
+    uint64_t new_size = (required + MMAP_GROW_CHUNK - 1) / MMAP_GROW_CHUNK * MMAP_GROW_CHUNK;
+    if (new_size == 0) new_size = MMAP_GROW_CHUNK;
+
+#ifdef _WIN32
+    if (map_base != nullptr) UnmapViewOfFile(map_base);
+    if (map_handle != nullptr) CloseHandle(map_handle);
+    map_base = nullptr;
+    // 映射对象长度大于文件时，系统会自动把文件扩展到该长度
+    map_handle = CreateFileMappingA(file_handle, NULL, PAGE_READWRITE,
+        static_cast<DWORD>(new_size >> 32), static_cast<DWORD>(new_size & 0xFFFFFFFFu), NULL);
+    if (map_handle == nullptr) return false;
+    map_base = static_cast<char*>(MapViewOfFile(map_handle, FILE_MAP_ALL_ACCESS, 0, 0, static_cast<SIZE_T>(new_size)));
+    if (map_base == nullptr) {
+        CloseHandle(map_handle);
+        map_handle = nullptr;
+        return false;
+    }
+#else
+    // 先把文件物理扩展到新长度，避免访问映射尾部时触发SIGBUS
+    if (ftruncate(file_handle, static_cast<off_t>(new_size)) != 0) return false;
+    if (map_base != nullptr) munmap(map_base, map_size);
+    map_base = nullptr;
+    void* addr = mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, file_handle, 0);
+    if (addr == MAP_FAILED) return false;
+    map_base = static_cast<char*>(addr);
+#endif
+    map_size = new_size;
+    return true;
+}
+
+void PageManager::unmap_data_file() {
+    if (map_base == nullptr) return;
+#ifdef _WIN32
+    FlushViewOfFile(map_base, 0);
+    UnmapViewOfFile(map_base);
+    if (map_handle != nullptr) CloseHandle(map_handle);
+    map_handle = nullptr;
+    // 截掉按块扩展出的尾部，文件大小回到实际数据大小
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(file_size.load());
+    if (SetFilePointerEx(file_handle, end, NULL, FILE_BEGIN)) SetEndOfFile(file_handle);
+#else
+    msync(map_base, map_size, MS_SYNC);
+    munmap(map_base, map_size);
+    if (ftruncate(file_handle, static_cast<off_t>(file_size.load())) != 0) {
+        cerr << "page_manager.cpp：截断数据文件失败: " << data_file_path << endl;
+    }
+#endif
+    map_base = nullptr;
+    map_size = 0;
+}
+
+// -------------------------- 私有辅助函数：定位读写（pread/pwrite，不移动文件指针） --------------------------
+bool PageManager::pread_full(uint64_t offset, char* buf, uint32_t len) const {
+    if (file_handle == INVALID_FILE_HANDLE) return false;
+    if (io_mode == IoMode::MMAP) {
+        // 映射模式：直接从映射拷贝
+        if (map_base == nullptr || offset + len > map_size) return false;
+        memcpy(buf, map_base + offset, len);
+        return true;
+    }
+#ifdef _WIN32
+    OVERLAPPED ov{};
+    ov.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFu);
+    ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD got = 0;
+    if (!ReadFile(file_handle, buf, len, &got, &ov)) return false;
+    return got == len;
+#else
+    uint32_t done = 0;
+    while (done < len) {
+        ssize_t n = ::pread(file_handle, buf + done, len - done, static_cast<off_t>(offset + done));
+        if (n <= 0) return false;
+        done += static_cast<uint32_t>(n);
+    }
+    return true;
+#endif
 }
 
-// ҳ䣺ÿҳ򴴽ҳ
+bool PageManager::pwrite_full(uint64_t offset, const char* buf, uint32_t len) {
+    if (file_handle == INVALID_FILE_HANDLE) return false;
+    if (io_mode == IoMode::MMAP) {
+        // 映射模式：写入映射（必要时先扩展），由sync或解除映射时落盘
+        if (!ensure_mapped(offset + len)) return false;
+        memcpy(map_base + offset, buf, len);
+        if (offset + len > file_size) file_size = offset + len;
+        return true;
+    }
+#ifdef _WIN32
+    OVERLAPPED ov{};
+    ov.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFu);
+    ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD put = 0;
+    if (!WriteFile(file_handle, buf, len, &put, &ov) || put != len) return false;
+#else
+    uint32_t done = 0;
+    while (done < len) {
+        ssize_t n = ::pwrite(file_handle, buf + done, len - done, static_cast<off_t>(offset + done));
+        if (n <= 0) return false;
+        done += static_cast<uint32_t>(n);
+    }
+#endif
+    // 写到文件末尾之后时，同步更新内存中的文件大小
+    // （只在增长时写：缓存各分片并发写回已有页时不会互相覆盖file_size）
+    if (offset + len > file_size) file_size = offset + len;
+    return true;
+}
+
+// 构造函数：初始化数据文件和核心参数
+PageManager::PageManager(const string& data_path, IoMode mode)
+    : data_file_path(data_path), file_id(SHARED_FILE_ID), page_size(DEFAULT_PAGE_SIZE), next_page_id(1),
+    file_handle(INVALID_FILE_HANDLE), file_size(0), extent_pages(DEFAULT_EXTENT_PAGES), zeroed_from(0),
+    io_mode(mode), map_base(nullptr), map_size(0), map_handle(nullptr),
+    verify_checksums(true), checksum_required(false), checksum_failures(0), files(MAX_DATA_FILES) {
+    open_data_file(); // 确保数据文件存在，并在生命周期内保持打开
+    zeroed_from = file_size;
+    if (io_mode == IoMode::MMAP && !ensure_mapped(file_size)) {
+        close_data_file();
+        throw runtime_error("page_manager.cpp：页管理初始化失败: 映射文件 " + data_file_path + "失败");
+    }
+}
+
+// 析构函数：解除映射并关闭数据文件句柄
+PageManager::~PageManager() {
+    unmap_data_file();
+    close_data_file();
+}
+
+PageManager::PageManager(PageManager&& other) noexcept
+    : data_file_path(std::move(other.data_file_path)), file_id(other.file_id), page_size(other.page_size),
+    next_page_id(other.next_page_id),
+    free_map(std::move(other.free_map)), bitmap_pages(std::move(other.bitmap_pages)),
+    file_handle(other.file_handle), file_size(other.file_size.load()),
+    extent_pages(other.extent_pages), zeroed_from(other.zeroed_from),
+    io_mode(other.io_mode), map_base(other.map_base), map_size(other.map_size), map_handle(other.map_handle),
+    verify_checksums(other.verify_checksums), checksum_required(other.checksum_required),
+    checksum_failures(other.checksum_failures.load()), files(std::move(other.files)) {
+    other.file_handle = INVALID_FILE_HANDLE;
+    other.map_base = nullptr;
+    other.map_size = 0;
+    other.map_handle = nullptr;
+}
+
+PageManager& PageManager::operator=(PageManager&& other) noexcept {
+    if (this != &other) {
+        unmap_data_file();
+        close_data_file();
+        data_file_path = std::move(other.data_file_path);
+        file_id = other.file_id;
+        page_size = other.page_size;
+        next_page_id = other.next_page_id;
+        free_map = std::move(other.free_map);
+        bitmap_pages = std::move(other.bitmap_pages);
+        file_handle = other.file_handle;
+        file_size = other.file_size.load();
+        extent_pages = other.extent_pages;
+        zeroed_from = other.zeroed_from;
+        io_mode = other.io_mode;
+        map_base = other.map_base;
+        map_size = other.map_size;
+        map_handle = other.map_handle;
+        verify_checksums = other.verify_checksums;
+        checksum_required = other.checksum_required;
+        checksum_failures = other.checksum_failures.load();
+        files = std::move(other.files);
+        other.file_handle = INVALID_FILE_HANDLE;
+        other.map_base = nullptr;
+        other.map_size = 0;
+        other.map_handle = nullptr;
+    }
+    return *this;
+}
+
+bool PageManager::set_page_size(uint32_t size) {
+    if (!Page::is_valid_page_size(size)) return false;
+    page_size = size;
+    return true;
+}
+
+void PageManager::set_extent_pages(uint32_t pages) {
+    extent_pages = pages == 0 ? 1 : pages;
+    for (auto& file : files) {
+        if (file) file->set_extent_pages(pages);
+    }
+}
+
+void PageManager::check_page_no_limit(uint32_t first, uint32_t count) const {
+    if (static_cast<uint64_t>(first) + count - 1 > PAGE_NO_MASK) {
+        throw std::runtime_error("allocate page failed: data file " + data_file_path + " is full");
+    }
+}
+
+// 页分配：复用空闲页或创建新页（返回的页号带本文件的文件号）
 uint32_t PageManager::allocate_page() {
-    uint32_t page_id;
-    if (!free_page_list.empty()) {
-        page_id = free_page_list.front();
-        free_page_list.pop_front();
+    // 复用空闲页：释放时已写为空页，无需再写
+    uint32_t page_no = free_map.find_first();
+    if (page_no != INVALID_PAGE_ID) {
+        free_map.set_used(page_no);
+        return qualify(page_no);
     }
-    else {
-        page_id = next_page_id++;
-        // Ԥչļȷƫдһҳ
-        std::fstream fs(data_file_path, std::ios::in | std::ios::out | std::ios::binary);
-        if (!fs) {
-            // ļܻûΪɶд ofstream ȴٴ
-            std::ofstream create(data_file_path, std::ios::binary | std::ios::app);
-            create.close();
-            fs.open(data_file_path, std::ios::in | std::ios::out | std::ios::binary);
+
+    // 新页：文件按区段预扩展，区段内的新页读出即为空页
+    check_page_no_limit(next_page_id, 1);
+    page_no = next_page_id++;
+    if (!prepare_new_pages(page_no, 1)) {
+        throw std::runtime_error("allocate_page(): extend data file failed");
+    }
+    return qualify(page_no);
+}
+
+// 连续页分配：首次适配位图中的连续空闲段，没有则在文件末尾一次扩展count页
+uint32_t PageManager::allocate_run(uint32_t count) {
+    if (count == 0) return INVALID_PAGE_ID;
+    uint32_t first = free_map.find_run(count);
+    if (first != INVALID_PAGE_ID) {
+        free_map.set_used_range(first, count);
+        return qualify(first);
+    }
+    check_page_no_limit(next_page_id, count);
+    first = next_page_id;
+    next_page_id += count;
+    if (!prepare_new_pages(first, count)) {
+        throw std::runtime_error("allocate_run(): extend data file failed");
+    }
+    return qualify(first);
+}
+
+// 批量分配：先取空闲页，剩下的在文件末尾连续分配
+vector<uint32_t> PageManager::allocate_pages(uint32_t count) {
+    vector<uint32_t> pages;
+    pages.reserve(count);
+    while (pages.size() < count) {
+        uint32_t page_no = free_map.find_first();
+        if (page_no == INVALID_PAGE_ID) break;
+        free_map.set_used(page_no);
+        pages.push_back(qualify(page_no));
+    }
+    uint32_t rest = count - static_cast<uint32_t>(pages.size());
+    if (rest > 0) {
+        check_page_no_limit(next_page_id, rest);
+        uint32_t first = next_page_id;
+        next_page_id += rest;
+        if (!prepare_new_pages(first, rest)) {
+            throw std::runtime_error("allocate_pages(): extend data file failed");
         }
-        fs.seekp(get_page_offset(page_id), std::ios::beg);
-        char zero[PAGE_SIZE] = { 0 };
-        fs.write(zero, PAGE_SIZE);
-        fs.close();
+        for (uint32_t i = 0; i < rest; ++i) pages.push_back(qualify(first + i));
+    }
+    return pages;
+}
+
+// 区段分配：优先接着前一页，其次整段空闲的区段，最后在文件末尾按区段对齐新开
+uint32_t PageManager::allocate_page_after(uint32_t prev_page_id) {
+    bool append = false;
+    if (prev_page_id != INVALID_PAGE_ID && Page::file_of(prev_page_id) == file_id) {
+        uint32_t prev_no = Page::number_of(prev_page_id);
+        uint32_t page_no = prev_no + 1;
+        if (prev_no != INVALID_PAGE_ID && page_no <= PAGE_NO_MASK && extent_of(page_no) == extent_of(prev_no)) {
+            if (page_no < next_page_id && free_map.is_free(page_no)) {
+                free_map.set_used(page_no);
+                return qualify(page_no);
+            }
+            append = page_no == next_page_id; // 前一页是文件末页：区段内接着在末尾分配
+        }
+    }
+
+    if (!append) {
+        uint32_t first = free_map.find_aligned_run(extent_pages);
+        if (first != INVALID_PAGE_ID) {
+            free_map.set_used(first);
+            return qualify(first);
+        }
+        // 文件末尾不在区段起点：上一个区段剩下的页留给它的页链
+        first = extent_of(next_page_id) * extent_pages + 1;
+        if (first < next_page_id) first += extent_pages;
+        if (first > next_page_id && !skip_to(first)) {
+            throw std::runtime_error("allocate_page_after(): extend data file failed");
+        }
+    }
+    check_page_no_limit(next_page_id, 1);
+    uint32_t page_no = next_page_id++;
+    if (!prepare_new_pages(page_no, 1)) {
+        throw std::runtime_error("allocate_page_after(): extend data file failed");
+    }
+    return qualify(page_no);
+}
+
+bool PageManager::skip_to(uint32_t first) {
+    check_page_no_limit(first, 1);
+    uint32_t skip_from = next_page_id;
+    if (!prepare_new_pages(skip_from, first - skip_from)) return false;
+    next_page_id = first;
+    // 跳过的页需要位图页记录时，位图页取跳过范围的末尾（不占新区段，也不挡住前一区段页链的下一页）
+    uint32_t end = first;
+    while (end > skip_from && bitmap_pages.size() <= FreePageBitmap::chunk_of(end - 1)) {
+        if (!add_bitmap_page(--end)) return false;
+    }
+    for (uint32_t page_no = skip_from; page_no < end; ++page_no) free_map.set_free(page_no);
+    return true;
+}
+
+bool PageManager::redo_allocate(uint32_t page_id) {
+    if (Page::file_of(page_id) != file_id) {
+        PageManager* file = route(page_id);
+        return file != nullptr && file->redo_allocate(page_id);
+    }
+    uint32_t page_no = Page::number_of(page_id);
+    if (page_no == INVALID_PAGE_ID) return false;
+    if (find(bitmap_pages.begin(), bitmap_pages.end(), page_no) != bitmap_pages.end()) return false;
+    if (page_no < next_page_id) {
+        if (free_map.is_free(page_no)) free_map.set_used(page_no);
+        return true;
     }
+    next_page_id = page_no + 1;
+    return extend_file(get_page_offset(page_no) + page_size);
+}
+
+bool PageManager::prepare_new_pages(uint32_t first, uint32_t count) {
+    if (!extend_file(get_page_offset(first + count - 1) + page_size)) return false;
+    // 打开前已存在的区域可能有旧内容（如上次未保存元数据），这部分页写成空页
+    uint32_t stale = 0;
+    while (stale < count && get_page_offset(first + stale) < zeroed_from) ++stale;
+    return stale == 0 || init_pages(first, stale);
+}
 
-    Page new_page(page_id);
-    new_page.serialize();
-    if (!write_page(page_id, new_page)) {
-        throw std::runtime_error("allocate_page(): write_page failed");
+bool PageManager::extend_file(uint64_t required) {
+    if (required <= file_size) return true;
+    uint64_t extent = static_cast<uint64_t>(extent_pages) * page_size;
+    uint64_t new_size = (required + extent - 1) / extent * extent;
+
+    if (io_mode == IoMode::MMAP) {
+        // 映射模式：映射本身按MMAP_GROW_CHUNK扩展文件，这里只需扩大有效范围
+        if (!ensure_mapped(new_size)) return false;
+        file_size = new_size;
+        return true;
     }
-    return page_id;
+#ifdef _WIN32
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(new_size);
+    if (!SetFilePointerEx(file_handle, end, NULL, FILE_BEGIN) || !SetEndOfFile(file_handle)) return false;
+#else
+    // 优先真正预留磁盘块（posix_fallocate），文件系统不支持时退回ftruncate（稀疏扩展）
+    int err = posix_fallocate(file_handle, static_cast<off_t>(file_size.load()), static_cast<off_t>(new_size - file_size));
+    if (err != 0 && ftruncate(file_handle, static_cast<off_t>(new_size)) != 0) return false;
+#endif
+    file_size = new_size;
+    return true;
 }
 
+bool PageManager::init_pages(uint32_t first, uint32_t count) {
+    // 分批拼成一块缓冲区写入，避免逐页定位写
+    const uint32_t batch = 64;
+    vector<char> buf(static_cast<size_t>(min(count, batch)) * page_size);
+    for (uint32_t done = 0; done < count; done += batch) {
+        uint32_t n = min(batch, count - done);
+        for (uint32_t i = 0; i < n; ++i) {
+            Page page = new_page(qualify(first + done + i));
+            page.serialize();
+            memcpy(buf.data() + static_cast<size_t>(i) * page_size, page.data, page_size);
+            Page::stamp_checksum(buf.data() + static_cast<size_t>(i) * page_size, page_size);
+        }
+        if (!pwrite_full(get_page_offset(first + done), buf.data(), n * page_size)) return false;
+    }
+    return true;
+}
 
-// ҳͷţҳżб߼ͷţ
+
+// 页释放：在空闲页位图中标记页为空闲（逻辑释放）
 bool PageManager::free_page(uint32_t page_id) {
-    // ϷԼ飺ҳЧڿб
-    if (page_id == INVALID_PAGE_ID) {
+    if (Page::file_of(page_id) != file_id) {
+        PageManager* file = route(page_id);
+        return file != nullptr && file->free_page(page_id);
+    }
+    // 合法性检查：页号无效、超出数据文件、已空闲或是位图页本身
+    uint32_t page_no = Page::number_of(page_id);
+    if (page_no == INVALID_PAGE_ID || get_page_offset(page_no) + page_size > file_size) {
+        return false;
+    }
+    // 未加载元数据直接使用PageManager时，next_page_id可能落后于文件中已有的页
+    if (page_no >= next_page_id) next_page_id = page_no + 1;
+    if (free_map.is_free(page_no)) {
+        return false; // 页已空闲，无需重复释放
+    }
+    if (find(bitmap_pages.begin(), bitmap_pages.end(), page_no) != bitmap_pages.end()) {
         return false;
     }
-    auto it = find(free_page_list.begin(), free_page_list.end(), page_id);
-    if (it != free_page_list.end()) {
-        return false; // ҳѿУظͷ
+    if (!ensure_bitmap_page(FreePageBitmap::chunk_of(page_no))) {
+        return false;
     }
 
-    // ҳݣϢݰȫԣ
-    Page empty_page(page_id);
+    // 清空页数据（避免敏感信息残留，提高数据安全性）
+    Page empty_page = new_page(page_id);
     empty_page.serialize();
     if (!write_page(page_id, empty_page)) {
         return false;
     }
 
-    // ҳżб
-    free_page_list.push_back(page_id);
+    // 在位图中标记为空闲
+    free_map.set_free(page_no);
+    return true;
+}
+
+bool PageManager::is_page_free(uint32_t page_id) const {
+    const PageManager* file = route(page_id);
+    return file != nullptr && file->free_map.is_free(Page::number_of(page_id));
+}
+
+bool PageManager::is_page_in_use(uint32_t page_id) const {
+    const PageManager* file = route(page_id);
+    uint32_t page_no = Page::number_of(page_id);
+    return file != nullptr && page_no != INVALID_PAGE_ID && page_no < file->next_page_id && !file->free_map.is_free(page_no);
+}
+
+// -------------------------- 空闲页位图：位图页分配与读写 --------------------------
+bool PageManager::ensure_bitmap_page(uint32_t chunk) {
+    while (bitmap_pages.size() <= chunk) {
+        // 位图页总在文件末尾分配（不复用空闲页，避免位图页所在段尚无位图页时的循环依赖）
+        uint32_t page_no = next_page_id++;
+        if (!extend_file(get_page_offset(page_no) + page_size) || !add_bitmap_page(page_no)) {
+            --next_page_id;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PageManager::add_bitmap_page(uint32_t page_no) {
+    Page page = new_page(qualify(page_no));
+    page.set_page_flags(PAGE_FLAG_BITMAP);
+    page.serialize();
+    if (!write_page(qualify(page_no), page)) return false;
+    bitmap_pages.push_back(page_no);
+    return true;
+}
+
+bool PageManager::flush_free_map() {
+    for (uint32_t chunk : free_map.get_dirty_chunks()) {
+        if (chunk >= bitmap_pages.size()) return false;
+        Page page = new_page(qualify(bitmap_pages[chunk]));
+        page.set_page_flags(PAGE_FLAG_BITMAP);
+        free_map.store_chunk(chunk, page.data);
+        if (!write_page(qualify(bitmap_pages[chunk]), page)) return false;
+    }
+    free_map.clear_dirty();
+    return true;
+}
+
+bool PageManager::load_free_map(const vector<uint32_t>& pages) {
+    free_map = FreePageBitmap();
+    bitmap_pages.clear();
+    for (uint32_t chunk = 0; chunk < pages.size(); ++chunk) {
+        Page page = new_page();
+        if (!read_page(qualify(pages[chunk]), page) || page.get_page_flags() != PAGE_FLAG_BITMAP) {
+            return false;
+        }
+        free_map.load_chunk(chunk, page.data);
+        bitmap_pages.push_back(pages[chunk]);
+    }
+    // 超出next_page_id的位（未分配过的页）以及位图页自身不应为空闲
+    for (uint32_t pid : bitmap_pages) free_map.set_used(pid);
+    free_map.truncate(next_page_id);
+    free_map.clear_dirty();
+    return true;
+}
+
+bool PageManager::import_free_page_list(const list<uint32_t>& free_list) {
+    for (uint32_t page_id : free_list) {
+        if (page_id == INVALID_PAGE_ID || page_id >= next_page_id) continue;
+        if (!ensure_bitmap_page(FreePageBitmap::chunk_of(page_id))) return false;
+        free_map.set_free(page_id);
+    }
     return true;
 }
 
-// ҳȡӴ̶ȡָҳŵݵPage
+// 页读取：从磁盘读取指定页号的内容到Page对象
 bool PageManager::read_page(uint32_t page_id, Page& page) {
-    if (page_id == INVALID_PAGE_ID) {
+    if (Page::file_of(page_id) != file_id) {
+        PageManager* file = route(page_id);
+        return file != nullptr && file->read_page(page_id, page);
+    }
+    if (Page::number_of(page_id) == INVALID_PAGE_ID) {
         return false;
     }
     uint64_t offset = get_page_offset(page_id);
 
-    std::ifstream data_file(data_file_path, std::ios::in | std::ios::binary);
-    if (!data_file) {
+    // 检查偏移是否越界（使用内存中维护的文件大小，无需seek到末尾）
+    if (offset + page_size > file_size) {
         return false;
     }
 
-    // ƫǷԽ
-    data_file.seekg(0, std::ios::end);
-    std::streamoff file_size = data_file.tellg();
-    if (file_size < 0 || offset + PAGE_SIZE > static_cast<uint64_t>(file_size)) {
-        data_file.close();
+    // 定位读取一页，直接读入页对象的缓冲区（页大小不同时先按本文件的页大小重建）
+    if (page.get_page_size() != page_size) page = new_page(page_id);
+    if (!pread_full(offset, page.data, page_size)) {
         return false;
     }
+    // 校验和不匹配（页写了一半、介质损坏或写错位置）：不解析页内容
+    if (!verify_read(page_id, page.data)) {
+        return false;
+    }
+    page.reload_header();
+    // 文件按区段预扩展出的页从未写过（全零），按新空页返回
+    if (page.get_page_id() == INVALID_PAGE_ID) {
+        page = new_page(page_id);
+        page.serialize();
+    }
+    return true;
+}
+
+// 连续页读取：一次定位读取多页（预读整段区段时使用）
+uint32_t PageManager::read_pages(uint32_t first, uint32_t count, vector<Page>& pages) {
+    pages.clear();
+    if (Page::file_of(first) != file_id) {
+        PageManager* file = route(first);
+        return file != nullptr ? file->read_pages(first, count, pages) : 0;
+    }
+    if (Page::number_of(first) == INVALID_PAGE_ID || count == 0) return 0;
+    uint64_t offset = get_page_offset(first);
+    uint64_t size = file_size;
+    if (offset + page_size > size) return 0;
+    count = static_cast<uint32_t>(min<uint64_t>(count, (size - offset) / page_size));
 
-    // ȡһҳ
-    data_file.seekg(offset, std::ios::beg);
-    char disk_page[PAGE_SIZE];
-    data_file.read(disk_page, PAGE_SIZE);
+    vector<char> buf(static_cast<size_t>(count) * page_size);
+    if (!pread_full(offset, buf.data(), static_cast<uint32_t>(buf.size()))) return 0;
+    pages.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        // 校验失败的页及之后的页不返回（之后按需读取时由read_page报告）
+        if (!verify_read(first + i, buf.data() + static_cast<size_t>(i) * page_size)) break;
+        pages.emplace_back(first + i, page_size);
+        try {
+            pages.back().deserialize(buf.data() + static_cast<size_t>(i) * page_size);
+        }
+        catch (...) {
+            pages.pop_back();
+            break;
+        }
+        // 与read_page相同：从未写过的全零页按新空页返回
+        if (pages.back().get_page_id() == INVALID_PAGE_ID) {
+            pages.back() = new_page(first + i);
+            pages.back().serialize();
+        }
+    }
+    return static_cast<uint32_t>(pages.size());
+}
 
-    // ڹرǰȡֽ
-    if (data_file.gcount() != PAGE_SIZE) {
-        data_file.close();
+// 页写入：将Page对象的数据写入磁盘对应页位置
+bool PageManager::write_page(uint32_t page_id, const Page& page) {
+    if (Page::file_of(page_id) != file_id) {
+        PageManager* file = route(page_id);
+        return file != nullptr && file->write_page(page_id, page);
+    }
+    // 合法性检查：页号不匹配或无效
+    if (Page::number_of(page_id) == INVALID_PAGE_ID || page.get_page_id() != page_id || page.get_page_size() != page_size) {
         return false;
     }
-    data_file.close();
+    uint64_t offset = get_page_offset(page_id);
 
+    // 序列化Page对象并写入校验和，通过常驻句柄定位写入（不再每页重新打开文件）
+    Page temp_page = page;
+    temp_page.serialize();
+    Page::stamp_checksum(temp_page.data, page_size);
+    return pwrite_full(offset, temp_page.data, page_size);
+}
+
+// -------------------------- 页校验和 --------------------------
+bool PageManager::verify_read(uint32_t page_id, const char* raw) const {
+    if (!verify_checksums) return true;
+    PageCheck result = Page::check_page(raw, page_size, page_id);
+    if (result == PageCheck::OK || result == PageCheck::EMPTY) return true;
+    if (result == PageCheck::UNSTAMPED && !checksum_required) return true;
+    checksum_failures.fetch_add(1, memory_order_relaxed);
+    cerr << "page_manager.cpp：页校验失败: " << data_file_path << " 页" << page_id
+        << (result == PageCheck::UNSTAMPED ? "（缺少校验和）" : "（校验和不匹配）") << endl;
+    return false;
+}
+
+bool PageManager::read_raw_pages(uint32_t first, uint32_t count, char* buf) const {
+    if (Page::file_of(first) != file_id) {
+        const PageManager* file = route(first);
+        return file != nullptr && file->read_raw_pages(first, count, buf);
+    }
+    if (Page::number_of(first) == INVALID_PAGE_ID || count == 0) return false;
+    uint64_t offset = get_page_offset(first);
+    if (offset + static_cast<uint64_t>(count) * page_size > file_size) return false;
+    return pread_full(offset, buf, count * page_size);
+}
+
+int64_t PageManager::stamp_all_pages() {
+    // 按批读入，只改写没有校验和的非全零页（全零页读出时按新空页处理，不必写入）
+    const uint32_t batch = 64;
+    uint32_t last = static_cast<uint32_t>(min<uint64_t>(next_page_id - 1, file_size / page_size));
+    vector<char> buf(static_cast<size_t>(batch) * page_size);
+    int64_t stamped = 0;
+    for (uint32_t first = 1; first <= last; first += batch) {
+        uint32_t n = min(batch, last - first + 1);
+        if (!read_raw_pages(qualify(first), n, buf.data())) return -1;
+        for (uint32_t i = 0; i < n; ++i) {
+            char* raw = buf.data() + static_cast<size_t>(i) * page_size;
+            if (Page::check_page(raw, page_size, qualify(first + i)) != PageCheck::UNSTAMPED) continue;
+            Page::stamp_checksum(raw, page_size);
+            if (!pwrite_full(get_page_offset(first + i), raw, page_size)) return -1;
+            ++stamped;
+        }
+    }
+    for (auto& file : files) {
+        if (!file) continue;
+        int64_t n = file->stamp_all_pages();
+        if (n < 0) return -1;
+        stamped += n;
+    }
+    return stamped;
+}
+
+void PageManager::set_verify_checksums(bool on) {
+    verify_checksums = on;
+    for (auto& file : files) {
+        if (file) file->set_verify_checksums(on);
+    }
+}
+
+void PageManager::set_checksum_required(bool on) {
+    checksum_required = on;
+    for (auto& file : files) {
+        if (file) file->set_checksum_required(on);
+    }
+}
+
+uint64_t PageManager::get_checksum_failures() const {
+    uint64_t total = checksum_failures.load();
+    for (const auto& file : files) {
+        if (file) total += file->get_checksum_failures();
+    }
+    return total;
+}
+
+// -------------------------- 多文件：各表的页文件 --------------------------
+PageManager* PageManager::route(uint32_t page_id) {
+    return const_cast<PageManager*>(static_cast<const PageManager*>(this)->route(page_id));
+}
+
+const PageManager* PageManager::route(uint32_t page_id) const {
+    uint32_t id = Page::file_of(page_id);
+    if (id == file_id) return this;
+    return id < files.size() ? files[id].get() : nullptr;
+}
+
+PageManager* PageManager::get_file(uint32_t id) {
+    return route(Page::make_page_id(id, 0));
+}
+
+const PageManager* PageManager::get_file(uint32_t id) const {
+    return route(Page::make_page_id(id, 0));
+}
+
+bool PageManager::attach_file(uint32_t id, const string& path) {
+    if (file_id != SHARED_FILE_ID || id == SHARED_FILE_ID || id >= files.size() || files[id]) return false;
+    unique_ptr<PageManager> file;
     try {
-        page.deserialize(disk_page);
+        file.reset(new PageManager(path, io_mode));
     }
-    catch (...) {
+    catch (const exception& e) {
+        cerr << e.what() << endl;
         return false;
     }
+    // 挂接的文件不再挂接其他文件
+    file->files.clear();
+    file->file_id = id;
+    file->page_size = page_size;
+    file->extent_pages = extent_pages;
+    file->verify_checksums = verify_checksums;
+    file->checksum_required = checksum_required;
+    files[id] = std::move(file);
     return true;
 }
 
+bool PageManager::remove_file(uint32_t id) {
+    if (id == SHARED_FILE_ID || id >= files.size() || !files[id]) return false;
+    string path = files[id]->data_file_path;
+    files[id].reset(); // 析构时解除映射并关闭句柄，之后才能删除文件
+    return std::remove(path.c_str()) == 0;
+}
 
-// ҳд룺Pageд̶Ӧҳλ
-bool PageManager::write_page(uint32_t page_id, const Page& page) {
-    // ϷԼ飺ҳŲƥЧ
-    if (page_id == INVALID_PAGE_ID || page.get_page_id() != page_id) {
-        return false;
+bool PageManager::truncate_file() {
+    if (io_mode == IoMode::MMAP) {
+        // 解除映射时文件被截回file_size
+        file_size = 0;
+        unmap_data_file();
     }
-    uint64_t offset = get_page_offset(page_id);
+    else {
+#ifdef _WIN32
+        LARGE_INTEGER zero;
+        zero.QuadPart = 0;
+        if (!SetFilePointerEx(file_handle, zero, NULL, FILE_BEGIN) || !SetEndOfFile(file_handle)) return false;
+#else
+        if (ftruncate(file_handle, 0) != 0) return false;
+#endif
+    }
+    file_size = 0;
+    zeroed_from = 0;
+    next_page_id = 1;
+    free_map = FreePageBitmap();
+    bitmap_pages.clear();
+    return io_mode != IoMode::MMAP || ensure_mapped(0);
+}
 
-    // ļдģʽλҳƫ
-    fstream data_file(data_file_path, ios::in | ios::out | ios::binary);
-    if (!data_file) {
-        return false;
+bool PageManager::rename_file(const string& new_path) {
+    if (new_path == data_file_path) return true;
+    unmap_data_file();
+    close_data_file();
+    bool renamed = std::rename(data_file_path.c_str(), new_path.c_str()) == 0;
+    if (renamed) data_file_path = new_path;
+    // 无论改名是否成功都重新打开（失败时打开原文件）
+    try {
+        open_data_file();
     }
-    data_file.seekp(offset, ios::beg);
-    if (!data_file) { // λʧܣļ𻵣
-        data_file.close();
+    catch (const exception& e) {
+        cerr << e.what() << endl;
         return false;
     }
+    if (io_mode == IoMode::MMAP && !ensure_mapped(file_size)) return false;
+    return renamed;
+}
 
-    // лPageд
-    Page temp_page = page;
-    temp_page.serialize();
-    data_file.write(temp_page.data, PAGE_SIZE);
-    data_file.close();
+// -------------------------- 内存映射模式：零拷贝读取 --------------------------
+const char* PageManager::page_view(uint32_t page_id) const {
+    if (Page::file_of(page_id) != file_id) {
+        const PageManager* file = route(page_id);
+        return file != nullptr ? file->page_view(page_id) : nullptr;
+    }
+    if (io_mode != IoMode::MMAP || map_base == nullptr || Page::number_of(page_id) == INVALID_PAGE_ID) {
+        return nullptr;
+    }
+    uint64_t offset = get_page_offset(page_id);
+    if (offset + page_size > file_size) {
+        return nullptr;
+    }
+    if (!verify_read(page_id, map_base + offset)) {
+        return nullptr;
+    }
+    return map_base + offset;
+}
 
-    return true;
-}
\ No newline at end of file
+// -------------------------- 内存映射模式：脏页写回 --------------------------
+bool PageManager::sync() {
+    for (auto& file : files) {
+        if (file && !file->sync()) return false;
+    }
+    if (file_handle == INVALID_FILE_HANDLE) return true;
+    if (io_mode != IoMode::MMAP || map_base == nullptr) {
+        // STREAM模式：把已写入的页从系统缓存刷到磁盘（检查点在替换meta.dat之前调用）
+#ifdef _WIN32
+        return FlushFileBuffers(file_handle) != 0;
+#else
+        return fsync(file_handle) == 0;
+#endif
+    }
+#ifdef _WIN32
+    return FlushViewOfFile(map_base, 0) && FlushFileBuffers(file_handle);
+#else
+    return msync(map_base, map_size, MS_SYNC) == 0;
+#endif
+}
+
+bool PageManager::sync_page(uint32_t page_id) {
+    if (Page::file_of(page_id) != file_id) {
+        PageManager* file = route(page_id);
+        return file == nullptr || file->sync_page(page_id);
+    }
+    if (io_mode != IoMode::MMAP || map_base == nullptr || Page::number_of(page_id) == INVALID_PAGE_ID) return true;
+    uint64_t offset = get_page_offset(page_id);
+    if (offset + page_size > map_size) return false;
+#ifdef _WIN32
+    return FlushViewOfFile(map_base + offset, page_size) != 0;
+#else
+    // msync要求起始地址按系统内存页对齐（系统页可能大于页大小）
+    uint64_t sys_page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t start = offset / sys_page * sys_page;
+    return msync(map_base + start, offset + page_size - start, MS_ASYNC) == 0;
+#endif
+}
@@ -5,80 +5,231 @@
 #define PAGE_MANAGER_H
 
 #include "page.hpp"
+#include "free_page_bitmap.hpp"
+#include <atomic>
 #include <list>
+#include <memory>
+#include <vector>
 #include <string>
 #include <fstream>
 #include <stdexcept>
 
 using namespace std;
 
+// 数据文件访问方式
+enum class IoMode {
+    STREAM,     // 常驻句柄 + 定位读写（pread/pwrite），默认
+    MMAP        // 内存映射：读可直接返回映射内指针，写回由msync完成
+};
+
+// 内存映射模式下文件按块扩展（每次扩展后重新映射）
+#define MMAP_GROW_CHUNK (64ull * 1024 * 1024)
+// 区段的默认页数：分配新页时数据文件按区段扩展（fallocate/ftruncate 一次预留，之后的新页不再逐页扩展文件）；
+// 页链按区段分配（allocate_page_after），一个区段只给一条页链使用
+#define DEFAULT_EXTENT_PAGES 64
+
+// 并发约定：read_page/write_page读写已分配的页可由多个线程同时调用（缓存各分片并发换入换出）；
+// 页分配/释放、文件扩展和元数据读写仍要求单线程（STREAM模式下可与后台写线程的write_page并发）
+// 多文件：共享数据文件（文件0）的PageManager可挂接各表的页文件（文件1~255，各自一个PageManager），
+//        按页号中的文件号把读写/释放转给对应文件；每个文件有各自的next_page_id、空闲页位图与位图页
+//        （内部按文件内页号维护，对外的页号都带文件号）。挂接/移除文件与页分配一样要求单线程，
+//        且调用前缓存中不能再有该文件的页
 class PageManager {
 private:
-    string data_file_path;       // ļ·
-    uint32_t next_page_id;       // һҳţʼΪ1ȷҳΨһ
-    list<uint32_t> free_page_list; // ҳбάɸõҳţƬ
-
-    // ؼҳƫƱ (page_id - 1) * PAGE_SIZE
+#ifdef _WIN32
+    using FileHandle = void*;    // Windows：HANDLE
+#else
+    using FileHandle = int;      // POSIX：文件描述符
+#endif
+
+    string data_file_path;       // 磁盘数据文件路径
+    uint32_t file_id;            // 数据文件号（页号高8位；共享数据文件为SHARED_FILE_ID）
+    uint32_t page_size;          // 页大小（字节，数据库建库时确定，由meta.dat记录）
+    uint32_t next_page_id;       // 下一个待分配的新页号（文件内页号，初始为1，确保页号唯一）
+    FreePageBitmap free_map;     // 空闲页位图（按文件内页号维护可复用的页，减少磁盘碎片）
+    vector<uint32_t> bitmap_pages; // 位图页的文件内页号：bitmap_pages[k] 保存第k段位图（在meta.dat中持久化）
+    FileHandle file_handle;      // 常驻打开的数据文件句柄（生命周期与PageManager相同）
+    std::atomic<uint64_t> file_size; // 内存中维护的数据文件大小（读页前无需再seek到末尾；后台写线程会并发读取）
+    uint32_t extent_pages;       // 文件扩展区段大小（页数）
+    uint64_t zeroed_from;        // 此偏移之后的内容都由本进程扩展得到、从未写过，必为零（打开时的文件大小）
+
+    // 内存映射模式
+    IoMode io_mode;              // 数据文件访问方式
+    char* map_base;              // 映射起始地址（未映射为nullptr）
+    uint64_t map_size;           // 当前映射长度（MMAP_GROW_CHUNK的整数倍，>= file_size）
+    void* map_handle;            // Windows：文件映射对象句柄（POSIX不使用）
+
+    // 页校验和
+    bool verify_checksums;       // 读盘时是否校验（写盘时总是计算）
+    bool checksum_required;      // 非全零页必须带校验和（数据文件已全部写入校验和后开启）
+    mutable std::atomic<uint64_t> checksum_failures; // 校验失败次数
+
+    // 挂接的各表页文件（只有共享数据文件使用；下标为文件号，构造时定长，挂接时不会重新分配）
+    vector<unique_ptr<PageManager>> files;
+
+    // 关键：计算页偏移必须是 (文件内页号 - 1) * page_size（页号或文件内页号均可传入）
     uint64_t get_page_offset(uint32_t page_id) const {
-        // ҳŴ 1 ʼ
-        return static_cast<uint64_t>(page_id - 1) * PAGE_SIZE;
-    }
-
-    // ʼļ򴴽ļȷд
-    void init_data_file() {
-        ifstream file(data_file_path, ios::binary);
-        if (!file) { // ļڣƿļ
-            ofstream new_file(data_file_path, ios::binary);
-            if (!new_file) {
-                throw runtime_error("page_manager.hppҳʼʧ: ļ " + data_file_path + "ʧ");
-            }
-            new_file.close();
-        }
-        else {
-            file.close();
-        }
+        // 页号从 1 开始
+        return static_cast<uint64_t>(Page::number_of(page_id) - 1) * page_size;
     }
+    // 文件内页号 -> 带文件号的页号
+    uint32_t qualify(uint32_t page_no) const { return Page::make_page_id(file_id, page_no); }
+    // 页所在文件的PageManager（本文件返回this，未挂接的文件返回nullptr）
+    PageManager* route(uint32_t page_id);
+    const PageManager* route(uint32_t page_id) const;
+
+    // 辅助函数：打开（不存在则创建）数据文件，并记录当前文件大小
+    void open_data_file();
+    // 辅助函数：关闭数据文件句柄
+    void close_data_file();
+    // 辅助函数：按绝对偏移读/写len字节（pread/pwrite，不移动共享文件指针）
+    bool pread_full(uint64_t offset, char* buf, uint32_t len) const;
+    bool pwrite_full(uint64_t offset, const char* buf, uint32_t len);
+    // 辅助函数（内存映射模式）：确保映射覆盖[0, required)，不足时按块扩展文件并重新映射
+    bool ensure_mapped(uint64_t required);
+    // 辅助函数：确保第chunk段位图已有位图页（不足时从文件末尾分配新页作为位图页）
+    bool ensure_bitmap_page(uint32_t chunk);
+    // 辅助函数：把文件内页号page_no（已在文件范围内）写为下一段位图的位图页
+    bool add_bitmap_page(uint32_t page_no);
+    // 文件内页号所在的区段序号（区段为[k*extent_pages+1, (k+1)*extent_pages]）
+    uint32_t extent_of(uint32_t page_no) const { return (page_no - 1) / extent_pages; }
+    // 辅助函数：把文件末尾推进到first（区段起点），跳过的[next_page_id, first)记为空闲页，
+    //          留给其所在区段的页链继续使用
+    bool skip_to(uint32_t first);
+    // 辅助函数：把[first, first+count)初始化为空页并一次写入
+    bool init_pages(uint32_t first, uint32_t count);
+    // 辅助函数：确保文件至少有required字节，不足时按区段扩展（fallocate/ftruncate，新内容为零）
+    bool extend_file(uint64_t required);
+    // 辅助函数：为文件末尾新分配的[first, first+count)准备页：扩展文件，
+    //          只有落在打开前已有区域（可能残留旧内容）的页才需要写入空页
+    bool prepare_new_pages(uint32_t first, uint32_t count);
+    // 辅助函数（内存映射模式）：解除映射，并把文件截回实际数据大小（去掉按块扩展的尾部）
+    void unmap_data_file();
+    // 辅助函数：校验读出的页字节，不通过时计数并输出错误（未开启校验时总是通过）
+    bool verify_read(uint32_t page_id, const char* raw) const;
+    // 辅助函数：文件内页号[first, first+count)超出PAGE_NO_MASK时抛出runtime_error（分配新页前调用）
+    void check_page_no_limit(uint32_t first, uint32_t count) const;
 
 public:
  
-    // 캯ʼļ·ҳбһҳ
-    PageManager(const string& data_path);
-
-    // -------------------------- Ĺܣҳ --------------------------
-    // ܣӿҳбҳ޿ҳҳҳţ
+    // 构造函数：初始化数据文件路径、空闲页列表、下一页号，并打开数据文件
+    // mode-数据文件访问方式（MMAP模式下打开后立即建立映射）
+    PageManager(const string& data_path, IoMode mode = IoMode::STREAM);
+    // 析构函数：关闭数据文件句柄
+    ~PageManager();
+
+    // 持有文件句柄：禁止拷贝，允许移动
+    PageManager(const PageManager&) = delete;
+    PageManager& operator=(const PageManager&) = delete;
+    PageManager(PageManager&& other) noexcept;
+    PageManager& operator=(PageManager&& other) noexcept;
+
+    // -------------------------- 核心功能：页分配 --------------------------
+    // 功能：从空闲页位图复用页号最小的空闲页，无空闲页则分配新页（返回页号）
     uint32_t allocate_page();
-
-    // -------------------------- Ĺܣҳͷ --------------------------
-    // ܣҳżб߼ͷţݲɾ
+    // 功能：分配count个页号连续的页（优先复用位图中最靠前的连续空闲段，否则在文件末尾扩展），返回首页号
+    uint32_t allocate_run(uint32_t count);
+    // 功能：批量分配count个页（先复用空闲页，其余在文件末尾连续分配，文件最多扩展一次），返回页号列表
+    vector<uint32_t> allocate_pages(uint32_t count);
+    // 功能：区段分配，返回页链中接在prev_page_id之后的新页。prev_page_id所在区段的下一页空闲时分配它，
+    //      使页链在文件中连续；否则取一个整段空闲的区段（没有则在文件末尾新开区段）的首页。
+    //      prev_page_id为INVALID_PAGE_ID（页链的第一页）或不在本文件时直接取新区段
+    uint32_t allocate_page_after(uint32_t prev_page_id);
+    // 文件扩展区段大小（页数，至少为1；同时设置挂接的各文件）
+    void set_extent_pages(uint32_t pages);
+    uint32_t get_extent_pages() const { return extent_pages; }
+
+    // 页大小：打开数据库时按meta.dat设置，必须在读写任何页之前调用（非法值返回false）
+    bool set_page_size(uint32_t size);
+    uint32_t get_page_size() const { return page_size; }
+    // 按本数据文件的页大小构造一个空槽页
+    Page new_page(uint32_t page_id = INVALID_PAGE_ID) const { return Page(page_id, page_size); }
+
+    // 功能（崩溃恢复）：重做一次页分配。页号小于next_page_id时在位图中标记为已用，
+    //      否则把next_page_id推进到页号之后并扩展文件（中间未记日志的页号不回收）；位图页返回false
+    bool redo_allocate(uint32_t page_id);
+    // -------------------------- 核心功能：页释放 --------------------------
+    // 功能：在空闲页位图中把页标记为空闲（逻辑释放，暂不物理删除）
     bool free_page(uint32_t page_id);
 
-    // -------------------------- Ľӿڣҳȡread_page --------------------------
-    // ܣҳŴӴ̶ȡҳݣpage
+    // -------------------------- 核心接口：页读取（read_page） --------------------------
+    // 功能：根据页号从磁盘读取页数据，存入输出参数page（预扩展出的全零页按新空页返回）
     bool read_page(uint32_t page_id, Page& page);
+    // 功能（预读）：一次读取页号连续的[first, first+count)页，超出文件末尾的部分不读；返回实际读到的页数
+    uint32_t read_pages(uint32_t first, uint32_t count, vector<Page>& pages);
 
-    // -------------------------- Ľӿڣҳд루write_page --------------------------
-    // ܣPageд̶Ӧҳλ
+    // -------------------------- 核心接口：页写入（write_page） --------------------------
+    // 功能：将Page对象的数据写入磁盘对应页位置（写入的字节带校验和，Page对象本身不变）
     bool write_page(uint32_t page_id, const Page& page);
 
-    // -------------------------- ӿڣ/ݿģã --------------------------
-    // ȡҳбģжҳǷɸã
-    list<uint32_t> get_free_page_list() const { return free_page_list; }
-    // ÿҳб
-    void set_free_page_list(const std::list<uint32_t>& free_list) {
-        free_page_list = free_list;
-    }
-
-
-    // ȡһҳţԪݳ־ûʱʹã
+    // -------------------------- 页校验和 --------------------------
+    // read_page/read_pages/page_view读盘后校验页校验和，不通过时读取失败（设置同时作用于挂接的各文件）
+    void set_verify_checksums(bool on);
+    bool get_verify_checksums() const { return verify_checksums; }
+    // 开启后没有校验和的非全零页也视为损坏（旧格式数据文件升级前不能开启）
+    void set_checksum_required(bool on);
+    bool get_checksum_required() const { return checksum_required; }
+    // 校验失败次数（含挂接的各文件）
+    uint64_t get_checksum_failures() const;
+    // 功能：不解析、不校验地读取[first, first+count)页的原始字节到buf（校验整个数据文件时使用）
+    bool read_raw_pages(uint32_t first, uint32_t count, char* buf) const;
+    // 功能：给数据文件（含挂接的各文件）中所有没有校验和的非全零页写入校验和（升级旧格式数据文件时使用，
+    //      调用前需先把缓存中的脏页写回）；返回写入的页数，失败返回-1
+    int64_t stamp_all_pages();
+
+    // -------------------------- 多文件：各表的页文件 --------------------------
+    // 功能：把path处的页文件（不存在则创建）挂接为file_id号文件，页大小/访问方式/校验设置与本文件相同
+    //      只能在共享数据文件上调用；文件号非法或已挂接、打开失败返回false
+    bool attach_file(uint32_t file_id, const string& path);
+    // 功能：关闭并删除file_id号文件（调用前需先丢弃缓存中该文件的页）
+    bool remove_file(uint32_t file_id);
+    // 功能：取file_id号文件的PageManager（SHARED_FILE_ID返回本文件，未挂接返回nullptr）
+    PageManager* get_file(uint32_t file_id);
+    const PageManager* get_file(uint32_t file_id) const;
+    // 功能：清空本文件：截断为0字节，next_page_id回到1，空闲页位图与位图页清空
+    bool truncate_file();
+    // 功能：把本文件改名为new_path（关闭、改名、重新打开，页分配状态不变）
+    bool rename_file(const string& new_path);
+    uint32_t get_file_id() const { return file_id; }
+
+    // -------------------------- 内存映射模式接口 --------------------------
+    // 功能：返回页在映射中的只读指针（零拷贝，含16字节页头），非MMAP模式或页越界返回nullptr
+    // 注意：指针在下一次使文件扩展（重新映射）的写入之前有效
+    const char* page_view(uint32_t page_id) const;
+    // 功能：把修改同步到磁盘（MMAP：msync/FlushViewOfFile；STREAM：fsync/FlushFileBuffers），含挂接的各文件
+    // sync_page只同步指定页，并且不等待写盘完成
+    bool sync();
+    bool sync_page(uint32_t page_id);
+    // 获取数据文件访问方式
+    IoMode get_io_mode() const { return io_mode; }
+
+    // -------------------------- 辅助接口（供缓存/数据库模块调用） --------------------------
+    // 本文件的空闲页数量 / 页是否空闲 / 页是否在使用中（已分配、未释放；按页号中的文件号查对应文件）
+    uint32_t get_free_page_count() const { return free_map.get_free_count(); }
+    bool is_page_free(uint32_t page_id) const;
+    bool is_page_in_use(uint32_t page_id) const;
+    // 位图页的文件内页号（元数据持久化时使用）
+    const vector<uint32_t>& get_bitmap_pages() const { return bitmap_pages; }
+    // 从位图页加载空闲页位图（需先设置next_page_id）；位图页损坏返回false
+    bool load_free_map(const vector<uint32_t>& pages);
+    // 导入旧版meta.dat中的空闲页列表（转换为位图，随下一次flush_free_map写入位图页）
+    bool import_free_page_list(const list<uint32_t>& free_list);
+    // 把有变化的位图页写回数据文件（保存元数据前调用）
+    bool flush_free_map();
+
+
+    // 获取下一页号（文件内页号，元数据持久化时使用）
     uint32_t get_next_page_id() const { return next_page_id; }
-    // һҳ
+    // 设置下一个页号
     void set_next_page_id(uint32_t next_page) {
         next_page_id = next_page;
     }
 
 
-    // ȡļ·ã
+    // 获取数据文件路径（调试用）
     string get_data_file_path() const { return data_file_path; }
+    // 获取数据文件当前大小（字节，内存维护值）
+    uint64_t get_file_size() const { return file_size.load(); }
 
    
 };
@@ -0,0 +1,371 @@
+// =============================================
+// storage/wal_manager.cpp
+// =============================================
+//实现WalManager类（日志追加、组提交写出、段文件管理、日志扫描）
+#include "wal_manager.hpp"
+#include "crc32c.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+#define INVALID_FILE_HANDLE INVALID_HANDLE_VALUE
+#else
+#define INVALID_FILE_HANDLE (-1)
+#endif
+
+// 页LSN字段不参与差异比较（由调用者在记录日志后写入新LSN，重做时直接设置）
+static inline bool in_lsn_field(uint32_t pos) {
+    return pos >= PAGE_LSN_OFFSET && pos < PAGE_LSN_OFFSET + sizeof(uint64_t);
+}
+
+// -------------------------- 构造/析构 --------------------------
+WalManager::WalManager(const string& dir)
+    : wal_dir(dir), page_size(DEFAULT_PAGE_SIZE), buffer_start_lsn(0), current_lsn(0), flushed_lsn(0), flushing(false), commit_delay_us(0),
+    seg_handle(INVALID_FILE_HANDLE), seg_index(0), flush_count(0), commit_count(0), flusher_stopping(false) {}
+
+WalManager::~WalManager() {
+    stop_flusher();
+    flush_all();
+    close_segment();
+}
+
+// -------------------------- 段文件 --------------------------
+string WalManager::segment_path(uint32_t index) const {
+    char name[32];
+    snprintf(name, sizeof(name), "wal_%08u.log", index);
+    return wal_dir + "\\" + name;
+}
+
+bool WalManager::open_segment(uint32_t index) {
+    if (seg_handle != INVALID_FILE_HANDLE && seg_index == index) return true;
+    close_segment();
+    string path = segment_path(index);
+#ifdef _WIN32
+    seg_handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+#else
+    seg_handle = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+#endif
+    if (seg_handle == INVALID_FILE_HANDLE) return false;
+    seg_index = index;
+    return true;
+}
+
+void WalManager::close_segment() {
+    if (seg_handle == INVALID_FILE_HANDLE) return;
+    sync_segment();
+#ifdef _WIN32
+    CloseHandle(seg_handle);
+#else
+    ::close(seg_handle);
+#endif
+    seg_handle = INVALID_FILE_HANDLE;
+}
+
+bool WalManager::sync_segment() {
+    if (seg_handle == INVALID_FILE_HANDLE) return true;
+#ifdef _WIN32
+    return FlushFileBuffers(seg_handle) != 0;
+#else
+    return fsync(seg_handle) == 0;
+#endif
+}
+
+bool WalManager::write_at(uint64_t start, const string& data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        uint64_t lsn = start + done;
+        uint32_t index = static_cast<uint32_t>(lsn / WAL_SEGMENT_SIZE);
+        uint32_t offset = static_cast<uint32_t>(lsn % WAL_SEGMENT_SIZE);
+        uint32_t len = static_cast<uint32_t>(min<size_t>(data.size() - done, WAL_SEGMENT_SIZE - offset));
+        // 换段前先同步写满的旧段（open_segment关闭旧段时同步）
+        if (!open_segment(index)) return false;
+#ifdef _WIN32
+        OVERLAPPED ov{};
+        ov.Offset = offset;
+        DWORD put = 0;
+        if (!WriteFile(seg_handle, data.data() + done, len, &put, &ov) || put != len) return false;
+#else
+        uint32_t put = 0;
+        while (put < len) {
+            ssize_t n = ::pwrite(seg_handle, data.data() + done + put, len - put, static_cast<off_t>(offset + put));
+            if (n <= 0) return false;
+            put += static_cast<uint32_t>(n);
+        }
+#endif
+        done += len;
+    }
+    return sync_segment();
+}
+
+// -------------------------- 打开：确定日志末尾 --------------------------
+bool WalManager::open(uint64_t start_lsn) {
+    uint64_t end = scan(start_lsn, nullptr);
+    uint32_t index = static_cast<uint32_t>(end / WAL_SEGMENT_SIZE);
+    uint32_t offset = static_cast<uint32_t>(end % WAL_SEGMENT_SIZE);
+    if (!open_segment(index)) return false;
+
+    // 截掉末尾之后的残缺数据，并删除更后面的段：新记录接在有效末尾之后，旧的残留记录不会再被扫描到
+#ifdef _WIN32
+    LARGE_INTEGER pos;
+    pos.QuadPart = offset;
+    if (!SetFilePointerEx(seg_handle, pos, NULL, FILE_BEGIN) || !SetEndOfFile(seg_handle)) return false;
+#else
+    if (ftruncate(seg_handle, static_cast<off_t>(offset)) != 0) return false;
+#endif
+    for (uint32_t i = index + 1; remove(segment_path(i).c_str()) == 0; ++i) {}
+    if (!sync_segment()) return false;
+
+    lock_guard<std::mutex> lock(mutex);
+    buffer.clear();
+    buffer_start_lsn = end;
+    current_lsn = end;
+    flushed_lsn = end;
+    return true;
+}
+
+// -------------------------- 追加 --------------------------
+uint64_t WalManager::append(WalRecordType type, uint32_t page_id, const char* payload, uint32_t len) {
+    char header[WAL_RECORD_HEADER_SIZE] = { 0 };
+    uint32_t total = WAL_RECORD_HEADER_SIZE + len;
+    memcpy(header, &total, sizeof(total));
+    header[8] = static_cast<char>(type);
+    memcpy(header + 12, &page_id, sizeof(page_id));
+    uint32_t crc = crc32c(header + 8, WAL_RECORD_HEADER_SIZE - 8);
+    if (len > 0) crc = crc32c(payload, len, crc);
+    memcpy(header + 4, &crc, sizeof(crc));
+
+    uint64_t lsn;
+    bool spill;
+    {
+        lock_guard<std::mutex> lock(mutex);
+        buffer.append(header, WAL_RECORD_HEADER_SIZE);
+        if (len > 0) buffer.append(payload, len);
+        current_lsn += total;
+        lsn = current_lsn;
+        spill = buffer.size() >= WAL_BUFFER_FLUSH_BYTES;
+    }
+    // 缓冲过大：不等提交直接写出，避免占用过多内存
+    if (spill) flush(lsn);
+    return lsn;
+}
+
+// 追加一段差异 [偏移(u16) | 长度(u16) | 新字节]，超过WAL_DELTA_MAX_SEGMENT的拆成多段
+static void append_delta_segments(string& payload, const char* data, uint32_t start, uint32_t end) {
+    while (start < end) {
+        uint32_t n = min(end - start, WAL_DELTA_MAX_SEGMENT);
+        uint16_t off16 = static_cast<uint16_t>(start);
+        uint16_t len16 = static_cast<uint16_t>(n);
+        payload.append(reinterpret_cast<const char*>(&off16), sizeof(off16));
+        payload.append(reinterpret_cast<const char*>(&len16), sizeof(len16));
+        payload.append(data + start, n);
+        start += n;
+    }
+}
+
+uint64_t WalManager::log_page_changes(uint32_t page_id, const char* before, const char* after) {
+    string payload;
+    uint32_t pos = 0;
+    while (pos < page_size) {
+        // 跳过相同的字节：先按8字节比较，再逐字节
+        while (pos + 8 <= page_size && memcmp(before + pos, after + pos, 8) == 0) pos += 8;
+        while (pos < page_size && (before[pos] == after[pos] || in_lsn_field(pos))) ++pos;
+        if (pos >= page_size) break;
+
+        // 一段修改：相隔不超过WAL_DELTA_MERGE_GAP的修改并入同一段
+        uint32_t start = pos;
+        uint32_t end = pos + 1;
+        for (uint32_t i = end; i < page_size && i - end < WAL_DELTA_MERGE_GAP; ++i) {
+            if (before[i] != after[i] && !in_lsn_field(i)) end = i + 1;
+        }
+        append_delta_segments(payload, after, start, end);
+        pos = end;
+    }
+    if (payload.empty()) return 0;
+    // 修改分散时差异可能比整页还大：改为记录整页
+    uint32_t image_segments = (page_size + WAL_DELTA_MAX_SEGMENT - 1) / WAL_DELTA_MAX_SEGMENT;
+    if (payload.size() > page_size + image_segments * 2 * sizeof(uint16_t)) return log_page_image(page_id, after);
+    return append(WalRecordType::PAGE_DELTA, page_id, payload.data(), static_cast<uint32_t>(payload.size()));
+}
+
+uint64_t WalManager::log_page_image(uint32_t page_id, const char* data) {
+    string payload;
+    append_delta_segments(payload, data, 0, page_size);
+    return append(WalRecordType::PAGE_DELTA, page_id, payload.data(), static_cast<uint32_t>(payload.size()));
+}
+
+bool WalManager::apply_page_delta(char* page_data, uint32_t page_size, const char* payload, uint32_t len) {
+    uint32_t pos = 0;
+    while (pos < len) {
+        if (pos + 2 * sizeof(uint16_t) > len) return false;
+        uint16_t off, seg_len;
+        memcpy(&off, payload + pos, sizeof(off));
+        memcpy(&seg_len, payload + pos + 2, sizeof(seg_len));
+        pos += 2 * sizeof(uint16_t);
+        if (pos + seg_len > len || static_cast<uint32_t>(off) + seg_len > page_size) return false;
+        memcpy(page_data + off, payload + pos, seg_len);
+        pos += seg_len;
+    }
+    return true;
+}
+
+uint64_t WalManager::get_current_lsn() const {
+    lock_guard<std::mutex> lock(mutex);
+    return current_lsn;
+}
+
+// -------------------------- 组提交 --------------------------
+bool WalManager::flush(uint64_t lsn) {
+    unique_lock<std::mutex> lock(mutex);
+    while (flushed_lsn.load() < lsn) {
+        if (flushing) {
+            // 已有领头者在写出：等它完成后再检查（它写出的内容可能已包含本线程的记录）
+            flushed_cv.wait(lock);
+            continue;
+        }
+        flushing = true;
+        if (commit_delay_us > 0) {
+            // 领头者稍等片刻，让并发提交的记录进入同一批
+            lock.unlock();
+            this_thread::sleep_for(chrono::microseconds(commit_delay_us));
+            lock.lock();
+        }
+        string out;
+        out.swap(buffer);
+        uint64_t start = buffer_start_lsn;
+        uint64_t upto = current_lsn;
+        buffer_start_lsn = current_lsn;
+        lock.unlock();
+
+        bool ok = write_at(start, out);
+
+        lock.lock();
+        flushing = false;
+        if (ok) {
+            flushed_lsn = upto;
+            flush_count.fetch_add(1, memory_order_relaxed);
+        }
+        else {
+            // 写出失败：数据放回缓冲头部，下次重试
+            buffer.insert(0, out);
+            buffer_start_lsn = start;
+        }
+        flushed_cv.notify_all();
+        if (!ok) return false;
+    }
+    return true;
+}
+
+bool WalManager::commit(bool synchronous) {
+    uint64_t lsn = append(WalRecordType::COMMIT, 0);
+    commit_count.fetch_add(1, memory_order_relaxed);
+    return synchronous ? flush(lsn) : true;
+}
+
+void WalManager::set_commit_delay(uint32_t us) {
+    lock_guard<std::mutex> lock(mutex);
+    commit_delay_us = us;
+}
+
+// -------------------------- 异步提交：后台刷日志 --------------------------
+void WalManager::flusher_loop(uint32_t interval_ms) {
+    unique_lock<std::mutex> lock(flusher_mutex);
+    while (!flusher_stopping) {
+        flusher_cv.wait_for(lock, chrono::milliseconds(interval_ms), [this]() { return flusher_stopping; });
+        lock.unlock();
+        flush_all();
+        lock.lock();
+    }
+}
+
+void WalManager::start_flusher(uint32_t interval_ms) {
+    if (flusher_thread.joinable()) return;
+    {
+        lock_guard<std::mutex> lock(flusher_mutex);
+        flusher_stopping = false;
+    }
+    flusher_thread = thread(&WalManager::flusher_loop, this, max(1u, interval_ms));
+}
+
+void WalManager::stop_flusher() {
+    if (!flusher_thread.joinable()) return;
+    {
+        lock_guard<std::mutex> lock(flusher_mutex);
+        flusher_stopping = true;
+    }
+    flusher_cv.notify_all();
+    flusher_thread.join();
+}
+
+// -------------------------- 扫描 --------------------------
+uint64_t WalManager::scan(uint64_t from, const function<bool(const WalRecord&)>& fn) const {
+    ifstream seg;
+    uint32_t open_index = UINT32_MAX;
+    // 读日志流[lsn, lsn+len)，可跨段；不足len字节返回false
+    auto read_at = [&](uint64_t lsn, char* buf, uint32_t len) {
+        while (len > 0) {
+            uint32_t index = static_cast<uint32_t>(lsn / WAL_SEGMENT_SIZE);
+            uint32_t offset = static_cast<uint32_t>(lsn % WAL_SEGMENT_SIZE);
+            if (index != open_index) {
+                seg.close();
+                seg.clear();
+                seg.open(segment_path(index), ios::in | ios::binary);
+                if (!seg) return false;
+                open_index = index;
+            }
+            uint32_t n = min(len, WAL_SEGMENT_SIZE - offset);
+            seg.seekg(offset);
+            seg.read(buf, n);
+            if (static_cast<uint32_t>(seg.gcount()) != n) return false;
+            lsn += n;
+            buf += n;
+            len -= n;
+        }
+        return true;
+    };
+
+    vector<char> record(WAL_MAX_RECORD_SIZE);
+    uint64_t pos = from;
+    for (;;) {
+        if (!read_at(pos, record.data(), WAL_RECORD_HEADER_SIZE)) break;
+        uint32_t total, crc;
+        memcpy(&total, record.data(), sizeof(total));
+        memcpy(&crc, record.data() + 4, sizeof(crc));
+        if (total < WAL_RECORD_HEADER_SIZE || total > WAL_MAX_RECORD_SIZE) break;
+        if (!read_at(pos + WAL_RECORD_HEADER_SIZE, record.data() + WAL_RECORD_HEADER_SIZE, total - WAL_RECORD_HEADER_SIZE)) break;
+        if (crc32c(record.data() + 8, total - 8) != crc) break;
+
+        WalRecord rec;
+        rec.start_lsn = pos;
+        rec.lsn = pos + total;
+        rec.type = static_cast<WalRecordType>(record[8]);
+        memcpy(&rec.page_id, record.data() + 12, sizeof(rec.page_id));
+        rec.payload = record.data() + WAL_RECORD_HEADER_SIZE;
+        rec.payload_len = total - WAL_RECORD_HEADER_SIZE;
+        pos = rec.lsn;
+        if (fn && !fn(rec)) break;
+    }
+    return pos;
+}
+
+// -------------------------- 回收段文件 --------------------------
+void WalManager::remove_segments_before(uint64_t lsn) {
+    uint32_t keep = static_cast<uint32_t>(lsn / WAL_SEGMENT_SIZE);
+    // 段号连续：从keep-1向前删除，遇到不存在的段即停止
+    for (uint32_t i = keep; i > 0 && remove(segment_path(i - 1).c_str()) == 0; --i) {}
+}
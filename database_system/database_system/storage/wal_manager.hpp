@@ -0,0 +1,151 @@
+// =============================================
+// storage/wal_manager.hpp
+// =============================================
+//定义WalManager类（写前日志：分段日志文件、LSN、组提交、页修改的字节差异记录）
+#ifndef WAL_MANAGER_H
+#define WAL_MANAGER_H
+
+#include "page.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 日志是一条只追加的字节流，按WAL_SEGMENT_SIZE切分为段文件 <目录>\wal_<段号8位>.log
+// LSN即字节流中的偏移；一条记录的LSN取其结束位置（>0），页LSN等于最后修改该页的记录的LSN
+#define WAL_SEGMENT_SIZE (16u * 1024 * 1024)
+// 缓冲中未写出的日志超过该大小时由追加者直接写出（不等提交）
+#define WAL_BUFFER_FLUSH_BYTES (4u * 1024 * 1024)
+// 页差异中两段修改相隔不超过该字节数时合并为一段（每段额外4字节段头）
+#define WAL_DELTA_MERGE_GAP 8
+// 页差异中一段的最大长度（段长为u16，64KB的页按整页记录时拆成多段）
+#define WAL_DELTA_MAX_SEGMENT 32768u
+// 异步提交时后台刷日志的间隔
+#define WAL_ASYNC_FLUSH_MS 10
+
+// 日志记录布局：
+//   [0,4)   记录总长（含记录头）
+//   [4,8)   CRC32C（覆盖[8, 记录总长)）
+//   [8,9)   记录类型
+//   [9,12)  保留
+//   [12,16) 页号（与页无关的记录为0）
+//   [16, 记录总长) 负载
+#define WAL_RECORD_HEADER_SIZE 16
+#define WAL_MAX_RECORD_SIZE (WAL_RECORD_HEADER_SIZE + 2 * MAX_PAGE_SIZE)
+
+enum class WalRecordType : uint8_t {
+    PAGE_DELTA = 1,   // 页字节差异：若干段 [偏移(u16) | 长度(u16) | 新字节]
+    PAGE_ALLOC = 2,   // 分配页：页被重置为空槽页
+    PAGE_FREE = 3,    // 释放页
+    COMMIT = 4,       // 语句提交（组提交的边界）
+    CHECKPOINT = 5    // 检查点：负载为重做起点LSN(u64)
+};
+
+// 扫描日志时交给回调的一条记录（payload指向内部缓冲，回调返回后失效）
+struct WalRecord {
+    uint64_t lsn;          // 记录的结束位置
+    uint64_t start_lsn;    // 记录的起始位置
+    WalRecordType type;
+    uint32_t page_id;
+    const char* payload;
+    uint32_t payload_len;
+};
+
+class WalManager {
+private:
+#ifdef _WIN32
+    using FileHandle = void*;    // Windows：HANDLE
+#else
+    using FileHandle = int;      // POSIX：文件描述符
+#endif
+
+    std::string wal_dir;                  // 段文件所在目录
+    uint32_t page_size;                   // 页大小（页差异按整页比较）
+
+    // 追加状态（mutex保护）
+    mutable std::mutex mutex;
+    std::condition_variable flushed_cv;   // 写出完成时唤醒等待提交的线程
+    std::string buffer;                   // 已追加、尚未写出的记录
+    uint64_t buffer_start_lsn;            // buffer[0]对应的LSN
+    uint64_t current_lsn;                 // 已追加记录的末尾（下一条记录的起始位置）
+    std::atomic<uint64_t> flushed_lsn;    // 已持久化到的位置
+    bool flushing;                        // 是否有线程（组提交的领头者）正在写出
+    uint32_t commit_delay_us;             // 领头者写出前等待其他提交加入的时间（0表示不等待）
+
+    // 段文件（只有领头者访问）
+    FileHandle seg_handle;
+    uint32_t seg_index;
+
+    // 统计
+    std::atomic<uint64_t> flush_count;    // 写出+同步的次数
+    std::atomic<uint64_t> commit_count;   // 提交次数
+
+    // 异步提交：后台刷日志线程
+    std::thread flusher_thread;
+    std::mutex flusher_mutex;
+    std::condition_variable flusher_cv;
+    bool flusher_stopping;
+
+    std::string segment_path(uint32_t index) const;
+    // 打开第index段（不存在则创建），关闭之前的段（关闭前同步）
+    bool open_segment(uint32_t index);
+    void close_segment();
+    bool sync_segment();
+    // 把data写到日志流的start位置（可跨段）
+    bool write_at(uint64_t start, const std::string& data);
+    void flusher_loop(uint32_t interval_ms);
+
+public:
+    explicit WalManager(const std::string& dir);
+    // 析构：停止后台线程、写出并同步剩余日志
+    ~WalManager();
+    WalManager(const WalManager&) = delete;
+    WalManager& operator=(const WalManager&) = delete;
+
+    // 打开日志：从start_lsn（上一次检查点的重做起点）起扫描出有效日志的末尾，之后的追加接在末尾；
+    // 末尾之后的残缺数据（崩溃时写了一半的记录）被截掉
+    bool open(uint64_t start_lsn);
+
+    // 追加一条记录，返回其LSN（结束位置）；只进缓冲，持久化由flush/commit负责
+    uint64_t append(WalRecordType type, uint32_t page_id, const char* payload = nullptr, uint32_t len = 0);
+    // 页大小：打开数据库时按meta.dat设置（默认DEFAULT_PAGE_SIZE），在记录任何页修改之前调用
+    void set_page_size(uint32_t size) { page_size = size; }
+    // 比较页的修改前/后内容（各page_size字节，页LSN字段不参与比较），追加PAGE_DELTA记录并返回LSN；
+    // 没有修改返回0
+    uint64_t log_page_changes(uint32_t page_id, const char* before, const char* after);
+    // 整页记录为一条PAGE_DELTA（无法取得修改前内容时使用），返回LSN
+    uint64_t log_page_image(uint32_t page_id, const char* data);
+    // 把PAGE_DELTA记录的负载应用到页字节上（page_size用于越界检查）
+    static bool apply_page_delta(char* page_data, uint32_t page_size, const char* payload, uint32_t len);
+
+    // 组提交：确保日志已持久化到lsn。已有领头者在写出时等待其完成；否则成为领头者，
+    // 把缓冲中（包括其他线程追加的）全部记录一次写出并同步
+    bool flush(uint64_t lsn);
+    bool flush_all() { return flush(get_current_lsn()); }
+    // 提交：追加COMMIT记录，synchronous为true时等待其持久化
+    bool commit(bool synchronous = true);
+    // 设置组提交等待时间（微秒）
+    void set_commit_delay(uint32_t us);
+
+    // 异步提交：后台线程每隔interval_ms写出一次缓冲（已启动时不重复启动）
+    void start_flusher(uint32_t interval_ms = WAL_ASYNC_FLUSH_MS);
+    void stop_flusher();
+
+    // 扫描段文件中[from, 日志末尾)的有效记录（只读已写出的记录，遇到残缺或校验失败的记录即停止），
+    // fn返回false时提前结束；
+    // 返回最后一条有效记录的结束位置（没有记录时返回from）
+    uint64_t scan(uint64_t from, const std::function<bool(const WalRecord&)>& fn) const;
+
+    // 删除完全位于lsn之前的段文件（检查点之后调用）
+    void remove_segments_before(uint64_t lsn);
+
+    uint64_t get_current_lsn() const;
+    uint64_t get_flushed_lsn() const { return flushed_lsn.load(); }
+    uint64_t get_flush_count() const { return flush_count.load(); }
+    uint64_t get_commit_count() const { return commit_count.load(); }
+};
+
+#endif // WAL_MANAGER_H
@@ -0,0 +1,1129 @@
+// =============================================
+// tests/bench_storage.cpp
+// =============================================
+// 存储层微基准：与 tests/ 下其他文件一样不参与主项目编译，单独编译运行
+// 用法：bench_storage [页数] [最大缓存帧数] [SelectAll表大小MB]
+// 编译时需同时链接 storage/*.cpp 与 engine/catalog_manager.cpp、engine/storage_engine.cpp、engine/tuple_codec.cpp
+#include "../storage/page.hpp"
+#include "../storage/page_manager.hpp"
+#include "../storage/cache_manager.hpp"
+#include "../storage/crc32c.hpp"
+#include "../storage/file_manager.hpp"
+#include "../storage/page_guard.hpp"
+#include "../storage/wal_manager.hpp"
+#include "../engine/catalog_manager.hpp"
+#include "../engine/storage_engine.hpp"
+#include "../engine/tuple_codec.hpp"
+#include "../engine/csv_loader.hpp"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// 基准数据目录（每个基准运行前清空）
+string bench_dir = "bench_data";
+
+static void reset_bench_dir() {
+    std::error_code ec;
+    fs::remove_all(bench_dir, ec);
+    fs::create_directories(bench_dir, ec);
+}
+
+static double seconds_since(chrono::steady_clock::time_point t0) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+// 对照基线：旧版 read_page 的做法（每页新建 ifstream，并 seek 到末尾检查文件大小）
+static bool legacy_read_page(const string& path, uint32_t page_id, Page& page) {
+    uint64_t offset = static_cast<uint64_t>(page_id - 1) * DEFAULT_PAGE_SIZE;
+    ifstream data_file(path, ios::in | ios::binary);
+    if (!data_file) return false;
+    data_file.seekg(0, ios::end);
+    streamoff file_size = data_file.tellg();
+    if (file_size < 0 || offset + DEFAULT_PAGE_SIZE > static_cast<uint64_t>(file_size)) return false;
+    data_file.seekg(offset, ios::beg);
+    char disk_page[DEFAULT_PAGE_SIZE];
+    data_file.read(disk_page, DEFAULT_PAGE_SIZE);
+    if (data_file.gcount() != DEFAULT_PAGE_SIZE) return false;
+    page.deserialize(disk_page);
+    return true;
+}
+
+// 基准1：顺序表扫描（沿 next_page_id 遍历页链），对比逐页开流与常驻句柄+定位读
+void bench_seq_scan(uint32_t page_count) {
+    cout << "=== 基准1：页链顺序扫描（" << page_count << " 页） ===" << endl;
+    reset_bench_dir();
+    string data_path = bench_dir + "/data.dat";
+
+    uint32_t first_pid = INVALID_PAGE_ID;
+    {
+        // 构造一条 page_count 页的表页链，每页写满一条记录模拟数据
+        PageManager pm(data_path);
+        uint32_t prev_pid = INVALID_PAGE_ID;
+        string payload(DEFAULT_PAGE_SIZE - PAGE_HEADER_SIZE, 'x');
+        for (uint32_t i = 0; i < page_count; ++i) {
+            uint32_t pid = pm.allocate_page();
+            Page page(pid);
+            page.write_data(PAGE_HEADER_SIZE, payload.data(), static_cast<uint32_t>(payload.size()));
+            page.set_free_offset(DEFAULT_PAGE_SIZE);
+            page.set_prev_page_id(prev_pid);
+            pm.write_page(pid, page);
+            if (prev_pid != INVALID_PAGE_ID) {
+                Page prev(prev_pid);
+                pm.read_page(prev_pid, prev);
+                prev.set_next_page_id(pid);
+                pm.write_page(prev_pid, prev);
+            }
+            else {
+                first_pid = pid;
+            }
+            prev_pid = pid;
+        }
+    }
+
+    // 1) 旧路径：每页构造一次 ifstream
+    uint32_t scanned = 0;
+    auto t0 = chrono::steady_clock::now();
+    for (uint32_t pid = first_pid; pid != INVALID_PAGE_ID; ++scanned) {
+        Page page(pid);
+        if (!legacy_read_page(data_path, pid, page)) break;
+        pid = page.get_next_page_id();
+    }
+    double legacy_sec = seconds_since(t0);
+    double legacy_pps = scanned / legacy_sec;
+
+    // 2) 新路径：PageManager 常驻句柄 + 定位读
+    PageManager pm(data_path);
+    scanned = 0;
+    t0 = chrono::steady_clock::now();
+    for (uint32_t pid = first_pid; pid != INVALID_PAGE_ID; ++scanned) {
+        Page page(pid);
+        if (!pm.read_page(pid, page)) break;
+        pid = page.get_next_page_id();
+    }
+    double pread_sec = seconds_since(t0);
+    double pread_pps = scanned / pread_sec;
+
+    cout << "逐页开流（ifstream）: " << static_cast<uint64_t>(legacy_pps) << " 页/秒" << endl;
+    cout << "常驻句柄（pread）   : " << static_cast<uint64_t>(pread_pps) << " 页/秒" << endl;
+    cout << "加速比: " << pread_pps / legacy_pps << "x" << endl << endl;
+}
+
+// 基准2：缓存替换开销随缓存帧数的变化
+// 循环访问 2 倍于容量的页集合，使每次访问都未命中并触发一次替换；
+// O(1) 的替换策略每次访问耗时应基本不随帧数增长
+void bench_eviction(uint32_t max_frames) {
+    cout << "=== 基准2：缓存替换开销（最大 " << max_frames << " 帧） ===" << endl;
+#ifdef _WIN32
+    const string null_log = "NUL";
+#else
+    const string null_log = "/dev/null";
+#endif
+    const ReplacePolicy policies[] = { ReplacePolicy::LRU, ReplacePolicy::FIFO, ReplacePolicy::CLOCK,
+        ReplacePolicy::TWO_Q, ReplacePolicy::LRU_2, ReplacePolicy::ARC };
+    const char* policy_names[] = { "LRU", "FIFO", "CLOCK", "2Q", "LRU-2", "ARC" };
+
+    vector<uint32_t> frame_sizes;
+    for (uint32_t frames = 64; frames < max_frames; frames *= 8) frame_sizes.push_back(frames);
+    frame_sizes.push_back(max_frames);
+
+    for (uint32_t frames : frame_sizes) {
+        reset_bench_dir();
+        string data_path = bench_dir + "/data.dat";
+        uint32_t working_set = frames * 2;
+        {
+            // 只写最后一页，得到一个稀疏数据文件，前面的页读出为全零
+            PageManager pm(data_path);
+            Page last(working_set);
+            pm.write_page(working_set, last);
+        }
+        PageManager pm(data_path);
+
+        for (int p = 0; p < 6; ++p) {
+            CacheManager cm(pm, frames, policies[p], null_log);
+            // 预热：填满缓存
+            for (uint32_t pid = 1; pid <= frames; ++pid) cm.get_page(pid);
+
+            uint64_t accesses = 0;
+            auto t0 = chrono::steady_clock::now();
+            for (int round = 0; round < 2; ++round) {
+                for (uint32_t pid = 1; pid <= working_set; ++pid, ++accesses) cm.get_page(pid);
+            }
+            double sec = seconds_since(t0);
+            cout << policy_names[p] << " 帧数=" << frames << ": "
+                << static_cast<uint64_t>(sec * 1e9 / accesses) << " ns/次访问" << endl;
+        }
+    }
+    cout << endl;
+}
+
+// 基准3：缓存命中路径上的事件日志开销（不同日志级别/采样率）
+void bench_event_log() {
+    cout << "=== 基准3：事件日志开销（缓存命中路径） ===" << endl;
+    reset_bench_dir();
+    string data_path = bench_dir + "/data.dat";
+    const uint32_t frames = 1024;
+    const uint32_t accesses = 1000000;
+    {
+        PageManager pm(data_path);
+        Page last(frames);
+        pm.write_page(frames, last);
+    }
+    PageManager pm(data_path);
+
+    struct Config { const char* name; LogLevel level; uint32_t sample; };
+    const Config configs[] = {
+        { "OFF", LogLevel::OFF, 1 },
+        { "EVICTIONS", LogLevel::EVICTIONS, 1 },
+        { "ALL 采样1/16", LogLevel::ALL, 16 },
+        { "ALL 全量", LogLevel::ALL, 1 },
+    };
+    for (const Config& cfg : configs) {
+        string log_path = bench_dir + "/cache_log.txt";
+        CacheManager cm(pm, frames, ReplacePolicy::LRU, log_path, cfg.level, cfg.sample);
+        for (uint32_t pid = 1; pid <= frames; ++pid) cm.get_page(pid);
+
+        auto t0 = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < accesses; ++i) cm.get_page(1 + i % frames);
+        double sec = seconds_since(t0);
+        cout << cfg.name << ": " << static_cast<uint64_t>(sec * 1e9 / accesses) << " ns/次命中"
+            << "（丢弃事件 " << cm.get_event_log().get_dropped_count() << "）" << endl;
+    }
+    cout << endl;
+}
+
+// 基准表的模式：id INT, name VARCHAR(32), pad VARCHAR(128)
+static Schema bench_schema() {
+    return Schema({ Column("id", ColumnType::INT), Column("name", ColumnType::VARCHAR, 32),
+        Column("pad", ColumnType::VARCHAR, 128) });
+}
+
+// 直接按存储引擎的槽页格式构造一张表的页链（每行 (id, "nameN", pad) 编码为二进制元组），避免逐行Insert的开销
+// page_size为新建库的页大小
+static void build_bench_table(const string& db_dir, uint32_t table_mb, uint32_t& page_count,
+    uint32_t& first_pid, uint32_t& last_pid, uint64_t& row_count, uint32_t page_size = DEFAULT_PAGE_SIZE) {
+    page_count = static_cast<uint32_t>(static_cast<uint64_t>(table_mb) * 1024 * 1024 / page_size);
+    first_pid = last_pid = INVALID_PAGE_ID;
+    row_count = 0;
+    FileManager fm(db_dir, 64, ReplacePolicy::LRU, IoMode::STREAM, REDO_DEFAULT_THREADS, page_size); // 析构时写出 meta.dat
+    TupleCodec codec(bench_schema());
+    string pad(120, 'p');
+    string line;
+    for (uint32_t i = 0; i < page_count; ++i) {
+        uint32_t pid = fm.allocate_page();
+        Page page = fm.new_page(pid);
+        for (;;) {
+            codec.encode({ to_string(row_count), "name" + to_string(row_count), pad }, line);
+            uint16_t slot;
+            if (!page.insert_record(line.data(), static_cast<uint32_t>(line.size()), slot)) break;
+            ++row_count;
+        }
+        page.set_prev_page_id(last_pid);
+        fm.write_page(pid, page);
+        if (last_pid != INVALID_PAGE_ID) {
+            Page prev = *fm.read_page(last_pid);
+            prev.set_next_page_id(pid);
+            fm.write_page(last_pid, prev);
+        }
+        else {
+            first_pid = pid;
+        }
+        last_pid = pid;
+    }
+}
+
+// 基准4：SelectAll 全表扫描，对比 STREAM（pread + 反序列化进缓存）与 MMAP（映射内零拷贝视图）
+void bench_select_all(uint32_t table_mb) {
+    cout << "=== 基准4：SelectAll 全表扫描（约 " << table_mb << " MB） ===" << endl;
+    reset_bench_dir();
+    string db_dir = bench_dir + "/db";
+    fs::create_directories(db_dir);
+
+    uint32_t page_count = 0, first_pid = INVALID_PAGE_ID, last_pid = INVALID_PAGE_ID;
+    uint64_t row_count = 0;
+    build_bench_table(db_dir, table_mb, page_count, first_pid, last_pid, row_count);
+
+    Schema schema = bench_schema();
+    const IoMode modes[] = { IoMode::STREAM, IoMode::MMAP };
+    const char* mode_names[] = { "STREAM", "MMAP  " };
+    double seconds[2] = { 0, 0 };
+    double walk_seconds[2] = { 0, 0 };
+    for (int m = 0; m < 2; ++m) {
+        FileManager fm(db_dir, 64, ReplacePolicy::LRU, modes[m]);
+        CatalogManager cmgr(db_dir + "/catalog.txt");
+        Catalog catalog;
+        catalog.AddTable("t", schema, "t.tbl", first_pid, last_pid);
+        StorageEngine se(cmgr, catalog, fm);
+
+        se.SelectAll("t"); // 预热：两种模式都在操作系统页缓存热的情况下比较
+        auto t0 = chrono::steady_clock::now();
+        size_t rows = se.SelectAll("t").size();
+        seconds[m] = seconds_since(t0);
+        if (rows != row_count) {
+            cerr << "SelectAll 行数不符：" << rows << " != " << row_count << endl;
+        }
+        cout << mode_names[m] << ": " << rows << " 行，" << seconds[m] << " 秒，"
+            << static_cast<uint64_t>(page_count / seconds[m]) << " 页/秒" << endl;
+
+        // 只走页链、不解析行：单独衡量存储层取页的开销（页视图不固定页，先停掉预读线程）
+        fm.set_read_ahead(false);
+        t0 = chrono::steady_clock::now();
+        uint64_t slots = 0;
+        for (uint32_t pid = first_pid; pid != INVALID_PAGE_ID;) {
+            const char* raw = fm.read_page_view(pid);
+            if (!raw) break;
+            slots += Page::view_slot_count(raw);
+            pid = Page::view_next_page_id(raw);
+        }
+        walk_seconds[m] = seconds_since(t0);
+        cout << mode_names[m] << " 仅遍历页链: " << walk_seconds[m] << " 秒（" << slots << " 个槽）" << endl;
+    }
+    cout << "SelectAll 加速比: " << seconds[0] / seconds[1] << "x，"
+        << "页链遍历加速比: " << walk_seconds[0] / walk_seconds[1] << "x" << endl << endl;
+}
+
+// 基准5：大表上只改/删一行（槽页原地修改，只写回命中记录所在的页）
+void bench_update_one_row(uint32_t table_mb) {
+    cout << "=== 基准5：大表单行 UPDATE / DELETE（约 " << table_mb << " MB） ===" << endl;
+    reset_bench_dir();
+    string db_dir = bench_dir + "/db";
+    fs::create_directories(db_dir);
+
+    uint32_t page_count = 0, first_pid = INVALID_PAGE_ID, last_pid = INVALID_PAGE_ID;
+    uint64_t row_count = 0;
+    build_bench_table(db_dir, table_mb, page_count, first_pid, last_pid, row_count);
+
+    FileManager fm(db_dir, 64, ReplacePolicy::LRU);
+    CatalogManager cmgr(db_dir + "/catalog.txt");
+    Catalog catalog;
+    Schema schema = bench_schema();
+    catalog.AddTable("t", schema, "t.tbl", first_pid, last_pid);
+    StorageEngine se(cmgr, catalog, fm);
+    string target = to_string(row_count / 2);
+
+    uint64_t size_before = fm.get_page_manager().get_file_size();
+    auto t0 = chrono::steady_clock::now();
+    se.UpdateWhere("t", [&](const vector<string>& r) { return !r.empty() && r[0] == target; },
+        { { 2, string(200, 'u') } }); // 变长：本页放不下，迁到有空间的页并留转发桩
+    double update_sec = seconds_since(t0);
+
+    t0 = chrono::steady_clock::now();
+    se.DeleteWhere("t", 0, to_string(row_count / 3));
+    double delete_sec = seconds_since(t0);
+    uint64_t size_after = fm.get_page_manager().get_file_size();
+
+    cout << row_count << " 行 / " << page_count << " 页" << endl;
+    cout << "UPDATE 1 行: " << update_sec << " 秒" << endl;
+    cout << "DELETE 1 行: " << delete_sec << " 秒" << endl;
+    cout << "数据文件增长: " << (size_after - size_before) / DEFAULT_PAGE_SIZE << " 页（整表重写时约为 " << page_count << " 页）" << endl << endl;
+}
+
+// 基准6：逐行取出 id 列做数值比较，对比旧 CSV 行（stringstream 拆分 + 去空白/引号 + stod）与二进制元组（零拷贝定长读取）
+void bench_tuple_decode(uint32_t rows) {
+    cout << "=== 基准6：行解码（" << rows << " 行，取 id 列做数值比较） ===" << endl;
+    Schema schema = bench_schema();
+    TupleCodec codec(schema);
+    string pad(120, 'p');
+    vector<string> csv_rows, bin_rows(rows);
+    csv_rows.reserve(rows);
+    for (uint32_t i = 0; i < rows; ++i) {
+        csv_rows.push_back(to_string(i) + ",name" + to_string(i) + "," + pad);
+        codec.encode({ to_string(i), "name" + to_string(i), pad }, bin_rows[i]);
+    }
+    const double target = rows / 2.0;
+
+    // 旧做法：与 StorageEngine 原 split_csv_line 相同的拆分方式，再由谓词 stod
+    auto t0 = chrono::steady_clock::now();
+    uint64_t csv_hits = 0;
+    vector<string> fields;
+    for (const auto& line : csv_rows) {
+        fields.clear();
+        stringstream ss(line);
+        string val;
+        while (getline(ss, val, ',')) {
+            size_t b = val.find_first_not_of(" \t\r\n");
+            size_t e = val.find_last_not_of(" \t\r\n;");
+            val = (b == string::npos) ? string() : val.substr(b, e - b + 1);
+            if (val.size() >= 2 && (val.front() == '\'' || val.front() == '"') && val.back() == val.front()) {
+                val = val.substr(1, val.size() - 2);
+            }
+            fields.push_back(move(val));
+        }
+        if (stod(fields[0]) >= target) ++csv_hits;
+    }
+    double csv_sec = seconds_since(t0);
+
+    t0 = chrono::steady_clock::now();
+    uint64_t bin_hits = 0;
+    for (const auto& rec : bin_rows) {
+        TupleView view(codec, rec.data(), static_cast<uint32_t>(rec.size()));
+        if (view.valid() && !view.is_null(0) && view.get_int(0) >= target) ++bin_hits;
+    }
+    double bin_sec = seconds_since(t0);
+
+    if (csv_hits != bin_hits) cerr << "命中行数不符：" << csv_hits << " != " << bin_hits << endl;
+    cout << "CSV 拆分 + stod: " << static_cast<uint64_t>(csv_sec * 1e9 / rows) << " ns/行" << endl;
+    cout << "二进制元组视图: " << static_cast<uint64_t>(bin_sec * 1e9 / rows) << " ns/行" << endl;
+    cout << "加速比: " << csv_sec / bin_sec << "x" << endl << endl;
+}
+
+// 基准7：插入/删除交替（每轮插入一批新行并删除上一轮的行），观察表页数是否随轮数增长
+void bench_insert_delete_churn(uint32_t rounds, uint32_t rows_per_round) {
+    cout << "=== 基准7：插入/删除交替（" << rounds << " 轮，每轮 " << rows_per_round << " 行） ===" << endl;
+    reset_bench_dir();
+    string db_dir = bench_dir + "/db";
+    fs::create_directories(db_dir);
+
+    FileManager fm(db_dir, 256, ReplacePolicy::LRU);
+    CatalogManager cmgr(db_dir + "/catalog.txt");
+    Catalog catalog;
+    Schema schema({ Column("id", ColumnType::INT), Column("grp", ColumnType::INT),
+        Column("pad", ColumnType::VARCHAR, 128) });
+    cmgr.CreateTable(catalog, "t", schema, "t.tbl");
+    StorageEngine se(cmgr, catalog, fm);
+
+    string pad(120, 'p');
+    uint64_t id = 0;
+    auto t0 = chrono::steady_clock::now();
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (uint32_t i = 0; i < rows_per_round; ++i) {
+            se.Insert("t", { to_string(id++), to_string(r), pad });
+        }
+        if (r > 0) se.DeleteWhere("t", 1, to_string(r - 1));
+
+        if (r == 0 || (r + 1) % 5 == 0 || r + 1 == rounds) {
+            const TableInfo* t = catalog.GetTable("t");
+            uint32_t pages = 0;
+            for (uint32_t pid = t->first_pid; pid != INVALID_PAGE_ID; ++pages) {
+                const char* raw = fm.read_page_view(pid);
+                if (!raw) break;
+                pid = Page::view_next_page_id(raw);
+            }
+            size_t live = se.SelectAll("t").size();
+            cout << "第 " << r + 1 << " 轮: " << live << " 行 / " << pages << " 页，"
+                << "每千行 " << pages * 1000.0 / live << " 页" << endl;
+        }
+    }
+    cout << "耗时: " << seconds_since(t0) << " 秒" << endl << endl;
+}
+
+// 基准8：分配新页，对比逐页扩展文件（区段=1页）、按区段预扩展（区段=64页）与批量分配 allocate_pages
+void bench_page_allocation(uint32_t page_count) {
+    cout << "=== 基准8：新页分配（" << page_count << " 页） ===" << endl;
+    auto run = [&](const char* name, uint32_t extent, bool batch) {
+        reset_bench_dir();
+        PageManager pm(bench_dir + "/alloc.dat");
+        pm.set_extent_pages(extent);
+        auto t0 = chrono::steady_clock::now();
+        if (batch) {
+            pm.allocate_pages(page_count);
+        }
+        else {
+            for (uint32_t i = 0; i < page_count; ++i) pm.allocate_page();
+        }
+        double sec = seconds_since(t0);
+        cout << name << ": " << sec * 1e6 / page_count << " us/页" << endl;
+    };
+    run("逐页分配，区段=1页 ", 1, false);
+    run("逐页分配，区段=64页", 64, false);
+    run("allocate_pages 批量", 64, true);
+    cout << endl;
+}
+
+// 基准9：多线程只读扫描（全部命中缓存），对比单分片（一把全局锁）与按硬件线程数分片的吞吐随线程数的变化
+void bench_concurrent_scan(uint32_t page_count) {
+    cout << "=== 基准9：多线程缓存命中扫描（" << page_count << " 页） ===" << endl;
+    reset_bench_dir();
+    PageManager pm(bench_dir + "/scan_mt.dat");
+    vector<uint32_t> pages = pm.allocate_pages(page_count);
+    {
+        CacheManager cm(pm, page_count, ReplacePolicy::LRU, bench_dir + "/scan_mt_log.txt", LogLevel::OFF);
+        string rec(100, 'x');
+        for (uint32_t pid : pages) {
+            WritePageGuard w(cm, pid);
+            uint16_t slot;
+            while (w->insert_record(rec.data(), static_cast<uint32_t>(rec.size()), slot)) {}
+        }
+        cm.flush_all();
+    }
+
+    uint32_t max_threads = max(4u, thread::hardware_concurrency());
+    const int passes = 4; // 每个线程扫描全部页的遍数
+    auto run = [&](uint32_t shard_count, uint32_t threads) {
+        CacheManager cm(pm, page_count, ReplacePolicy::LRU, bench_dir + "/scan_mt_log.txt", LogLevel::OFF, 1, shard_count);
+        for (uint32_t pid : pages) cm.get_page(pid); // 预热：之后全部命中
+        vector<thread> workers;
+        vector<uint64_t> bytes(threads, 0);
+        auto t0 = chrono::steady_clock::now();
+        for (uint32_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                for (int pass = 0; pass < passes; ++pass) {
+                    for (uint32_t pid : pages) {
+                        ReadPageGuard r(cm, pid);
+                        const char* data = nullptr;
+                        uint32_t len = 0;
+                        for (uint16_t slot = 0; slot < r->get_slot_count(); ++slot) {
+                            if (r->get_record(slot, data, len)) bytes[t] += len;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        double sec = seconds_since(t0);
+        return static_cast<double>(page_count) * passes * threads / sec;
+    };
+    for (uint32_t shard_count : { 1u, 0u }) {
+        double base = 0;
+        for (uint32_t threads = 1; threads <= max_threads; threads *= 2) {
+            double rate = run(shard_count, threads);
+            if (threads == 1) base = rate;
+            cout << (shard_count == 1 ? "单分片" : "分片  ") << " " << threads << " 线程: "
+                << rate / 1e6 << " M页/s，加速比 " << rate / base << endl;
+        }
+    }
+    cout << endl;
+}
+
+// 基准10：提交开销。逐条插入并在每条后强制写回数据页+同步（旧做法）、每条同步提交日志、异步提交；
+//        以及多线程并发同步提交时组提交合并的写出次数
+void bench_commit(uint32_t rows) {
+    cout << "=== 基准10：提交开销（" << rows << " 行） ===" << endl;
+    Schema schema({ Column("id", ColumnType::INT), Column("pad", ColumnType::VARCHAR, 64) });
+    string pad(60, 'p');
+    auto run = [&](const char* name, int mode) {
+        reset_bench_dir();
+        string db_dir = bench_dir + "/db";
+        fs::create_directories(db_dir);
+        FileManager fm(db_dir, 1024, ReplacePolicy::LRU);
+        CatalogManager cmgr(db_dir + "/catalog.txt");
+        Catalog catalog;
+        cmgr.CreateTable(catalog, "t", schema, "t.tbl");
+        StorageEngine se(cmgr, catalog, fm);
+        fm.set_synchronous_commit(mode != 2);
+        auto t0 = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < rows; ++i) {
+            se.Insert("t", { to_string(i), pad });
+            if (mode == 0) fm.flush_all_pages();
+        }
+        double sec = seconds_since(t0);
+        cout << name << ": " << rows / sec << " 行/s，日志写出 " << fm.get_wal().get_flush_count() << " 次" << endl;
+    };
+    run("强制写回数据页    ", 0);
+    run("同步提交（写日志）", 1);
+    run("异步提交          ", 2);
+
+    // 组提交：每个线程各提交 rows 次，统计每次写出+同步平均覆盖的提交数
+    uint32_t max_threads = max(4u, thread::hardware_concurrency());
+    for (uint32_t threads = 1; threads <= max_threads; threads *= 2) {
+        reset_bench_dir();
+        WalManager wal(bench_dir);
+        wal.open(0);
+        wal.set_commit_delay(threads > 1 ? 100 : 0);
+        vector<thread> workers;
+        auto t0 = chrono::steady_clock::now();
+        for (uint32_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&]() {
+                char payload[64] = { 0 };
+                for (uint32_t i = 0; i < rows; ++i) {
+                    wal.append(WalRecordType::PAGE_DELTA, 1, payload, sizeof(payload));
+                    wal.commit();
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        double sec = seconds_since(t0);
+        cout << "并发同步提交 " << threads << " 线程: " << wal.get_commit_count() / sec << " 提交/s，每次写出合并 "
+            << static_cast<double>(wal.get_commit_count()) / wal.get_flush_count() << " 个提交" << endl;
+    }
+    cout << endl;
+}
+
+// 基准11：崩溃恢复耗时（同一份崩溃现场分别用串行与按页号分区的并行重做）
+void bench_recovery(uint32_t page_count) {
+    cout << "=== 基准11：崩溃恢复（" << page_count << " 页） ===" << endl;
+    reset_bench_dir();
+    string src_dir = bench_dir + "/db";
+    fs::create_directories(src_dir);
+    uint32_t max_threads = max(4u, thread::hardware_concurrency());
+    {
+        // 缓存放得下全部页：崩溃时数据页都还没写回，修改只在日志中
+        FileManager fm(src_dir, page_count + 64, ReplacePolicy::LRU);
+        string rec(100, 'r');
+        for (uint32_t pid : fm.allocate_pages(page_count)) {
+            WritePageGuard w = fm.write_page_guard(pid);
+            uint16_t slot;
+            while (w->insert_record(rec.data(), static_cast<uint32_t>(rec.size()), slot)) {}
+        }
+        fm.commit();
+        // FileManager仍在运行时复制数据文件、meta.dat与日志段，作为崩溃现场
+        for (uint32_t threads = 1; threads <= max_threads; threads *= 2) {
+            string crash_dir = src_dir + "_crash" + to_string(threads);
+            fs::create_directories(crash_dir);
+            for (const char* name : { "data.dat", "meta.dat", "wal_00000000.log" }) {
+                fs::copy_file(src_dir + "\\" + name, crash_dir + "\\" + name, fs::copy_options::overwrite_existing);
+            }
+        }
+    }
+    for (uint32_t threads = 1; threads <= max_threads; threads *= 2) {
+        string crash_dir = src_dir + "_crash" + to_string(threads);
+        FileManager fm(crash_dir, page_count + 64, ReplacePolicy::LRU, IoMode::STREAM, threads);
+        const RecoveryStats& stats = fm.get_recovery_stats();
+        cout << "重做 " << threads << " 线程: " << stats.page_records << " 条页记录（应用 " << stats.applied << " 条），"
+            << stats.seconds * 1000 << " ms" << endl;
+    }
+    cout << endl;
+}
+
+// 基准12：页链扫描的顺序预读（SelectAll，缓存远小于表；开启/关闭预读对比，并给出预读命中）
+void bench_read_ahead(uint32_t table_mb) {
+    cout << "=== 基准12：顺序预读（约 " << table_mb << " MB） ===" << endl;
+    reset_bench_dir();
+    string db_dir = bench_dir + "/db";
+    fs::create_directories(db_dir);
+
+    uint32_t page_count = 0, first_pid = INVALID_PAGE_ID, last_pid = INVALID_PAGE_ID;
+    uint64_t row_count = 0;
+    build_bench_table(db_dir, table_mb, page_count, first_pid, last_pid, row_count);
+
+    for (int on = 0; on < 2; ++on) {
+        FileManager fm(db_dir, 1024, ReplacePolicy::LRU);
+        fm.set_read_ahead(on != 0);
+        CatalogManager cmgr(db_dir + "/catalog.txt");
+        Catalog catalog;
+        catalog.AddTable("t", bench_schema(), "t.tbl", first_pid, last_pid);
+        StorageEngine se(cmgr, catalog, fm);
+
+        auto t0 = chrono::steady_clock::now();
+        size_t rows = se.SelectAll("t").size();
+        double sec = seconds_since(t0);
+        uint32_t hit, miss, prefetched, prefetch_hits;
+        double hit_rate;
+        fm.get_cache_stats(hit, miss, hit_rate);
+        fm.get_prefetch_stats(prefetched, prefetch_hits);
+        cout << (on ? "开启预读: " : "关闭预读: ") << rows << " 行，" << sec << " 秒，未命中 " << miss
+            << " 次，预读 " << prefetched << " 页（命中 " << prefetch_hits << "）" << endl;
+    }
+    cout << endl;
+}
+
+// 基准13：点查询与全表扫描混合负载下各替换策略的命中率
+// 点查询80%落在热点页（缓存的一半）、20%落在更大的温数据范围上，每轮若干次点查询后做一次全表扫描（表远大于缓存）；
+// 分别统计点查询命中率与总命中率，并对比LRU在扫描带顺序提示时的结果
+void bench_mixed_workload(uint32_t page_count) {
+    cout << "=== 基准13：点查询+全表扫描混合负载的命中率 ===" << endl;
+    reset_bench_dir();
+    string data_path = bench_dir + "/data.dat";
+    const uint32_t frames = max(64u, page_count / 8);
+    const uint32_t hot_count = frames / 2;
+    const uint32_t warm_count = min(page_count, frames * 2);
+    const uint32_t rounds = 20;
+    const uint32_t lookups_per_round = frames * 8;
+    {
+        PageManager pm(data_path);
+        Page last(page_count);
+        pm.write_page(page_count, last);
+    }
+    PageManager pm(data_path);
+
+    struct Config { const char* name; ReplacePolicy policy; AccessHint scan_hint; };
+    const Config configs[] = {
+        { "LRU", ReplacePolicy::LRU, AccessHint::NORMAL },
+        { "FIFO", ReplacePolicy::FIFO, AccessHint::NORMAL },
+        { "CLOCK", ReplacePolicy::CLOCK, AccessHint::NORMAL },
+        { "2Q", ReplacePolicy::TWO_Q, AccessHint::NORMAL },
+        { "LRU-2", ReplacePolicy::LRU_2, AccessHint::NORMAL },
+        { "ARC", ReplacePolicy::ARC, AccessHint::NORMAL },
+        { "LRU+扫描提示", ReplacePolicy::LRU, AccessHint::SEQUENTIAL },
+    };
+    cout << "表 " << page_count << " 页，缓存 " << frames << " 帧，热点 " << hot_count << " 页，温数据 "
+        << warm_count << " 页" << endl;
+    for (const Config& cfg : configs) {
+        CacheManager cm(pm, frames, cfg.policy, bench_dir + "/mixed_log.txt", LogLevel::OFF);
+        mt19937 rng(42); // 各策略使用相同的访问序列
+        uniform_int_distribution<uint32_t> hot_page(1, hot_count);
+        uniform_int_distribution<uint32_t> warm_page(1, warm_count);
+        uniform_int_distribution<uint32_t> percent(0, 99);
+        uint64_t lookups = 0, lookup_hits = 0;
+        for (uint32_t round = 0; round < rounds; ++round) {
+            for (uint32_t i = 0; i < lookups_per_round; ++i) {
+                uint32_t pid = percent(rng) < 80 ? hot_page(rng) : warm_page(rng);
+                if (cm.contains(pid)) ++lookup_hits;
+                cm.get_page(pid);
+                ++lookups;
+            }
+            for (uint32_t pid = 1; pid <= page_count; ++pid) cm.get_page(pid, cfg.scan_hint);
+        }
+        uint32_t hit, miss;
+        double hit_rate;
+        cm.get_cache_stats(hit, miss, hit_rate);
+        cout << cfg.name << ": 点查询命中率 " << fixed << setprecision(1) << 100.0 * lookup_hits / lookups
+            << "%，总命中率 " << hit_rate * 100 << "%" << defaultfloat << endl;
+    }
+    cout << endl;
+}
+
+// 基准14：页校验和开销。CRC32C（SSE4.2指令/软件查表）每页耗时，
+// 以及读页（数据文件在系统缓存中）开启/关闭校验的吞吐对比、整个数据文件并行校验的速度
+void bench_page_checksum(uint32_t page_count) {
+    cout << "=== 基准14：页校验和开销 ===" << endl;
+    reset_bench_dir();
+
+    vector<char> buf(static_cast<size_t>(DEFAULT_PAGE_SIZE) * 256);
+    for (size_t i = 0; i < buf.size(); ++i) buf[i] = static_cast<char>(i * 2654435761u >> 13);
+    const uint32_t rounds = 4000;
+    volatile uint32_t sink = 0; // 防止计算被优化掉
+    for (int hw = 1; hw >= 0; --hw) {
+        if (hw && !crc32c_hardware_enabled()) continue;
+        auto t0 = chrono::steady_clock::now();
+        for (uint32_t r = 0; r < rounds; ++r) {
+            const char* page = buf.data() + static_cast<size_t>(r % 256) * DEFAULT_PAGE_SIZE;
+            sink += hw ? crc32c(page, DEFAULT_PAGE_SIZE) : crc32c_software(page, DEFAULT_PAGE_SIZE);
+        }
+        double sec = seconds_since(t0);
+        cout << (hw ? "CRC32C（SSE4.2）: " : "CRC32C（软件）  : ") << static_cast<uint64_t>(sec * 1e9 / rounds)
+            << " ns/页，" << static_cast<uint64_t>(rounds * static_cast<double>(DEFAULT_PAGE_SIZE) / sec / (1 << 20)) << " MB/s" << endl;
+    }
+
+    string db_dir = bench_dir + "/checksum_db";
+    {
+        FileManager fm(db_dir, 64, ReplacePolicy::LRU);
+        vector<uint32_t> pages = fm.allocate_pages(page_count);
+        for (uint32_t pid : pages) {
+            WritePageGuard w = fm.write_page_guard(pid);
+            uint16_t slot;
+            w->insert_record(buf.data(), 3000, slot);
+        }
+    }
+    {
+        PageManager pm(db_dir + "\\" + DATA_FILE_NAME);
+        pm.set_next_page_id(page_count + 1);
+        Page page;
+        for (bool verify : { false, true }) {
+            pm.set_verify_checksums(verify);
+            auto t0 = chrono::steady_clock::now();
+            uint64_t reads = 0;
+            for (int round = 0; round < 3; ++round) {
+                for (uint32_t pid = 1; pid <= page_count; ++pid, ++reads) pm.read_page(pid, page);
+            }
+            double sec = seconds_since(t0);
+            cout << (verify ? "读页（校验）  : " : "读页（不校验）: ") << static_cast<uint64_t>(reads / sec) << " 页/秒，"
+                << static_cast<uint64_t>(sec * 1e9 / reads) << " ns/页" << endl;
+        }
+    }
+    FileManager fm(db_dir, 64, ReplacePolicy::LRU);
+    VerifyStats st = fm.verify_data_file();
+    cout << "整个数据文件校验: " << st.pages << " 页，" << st.threads << " 线程，"
+        << static_cast<uint64_t>(st.pages / max(st.seconds, 1e-9)) << " 页/秒，损坏 " << st.corrupt.size() << endl << endl;
+}
+
+// 基准15：不同页大小下的全表扫描吞吐（同样的数据量与同样字节数的缓存；冷扫描经过缓存换入，热扫描全部命中）
+void bench_page_size_scan(uint32_t table_mb) {
+    cout << "=== 基准15：页大小与扫描吞吐（约 " << table_mb << " MB） ===" << endl;
+    const uint32_t cache_bytes = 4u << 20;
+    for (uint32_t size : { 4096u, 16384u, 65536u }) {
+        reset_bench_dir();
+        string db_dir = bench_dir + "/db";
+        fs::create_directories(db_dir);
+        uint32_t page_count = 0, first_pid = INVALID_PAGE_ID, last_pid = INVALID_PAGE_ID;
+        uint64_t row_count = 0;
+        build_bench_table(db_dir, table_mb, page_count, first_pid, last_pid, row_count, size);
+
+        // 热扫描时整张表在缓存中（帧数按页大小换算）；冷扫描用固定字节数的小缓存
+        for (uint32_t frames : { cache_bytes / size, page_count + 16 }) {
+            FileManager fm(db_dir, frames, ReplacePolicy::LRU);
+            CatalogManager cmgr(db_dir + "/catalog.txt");
+            Catalog catalog;
+            catalog.AddTable("t", bench_schema(), "t.tbl", first_pid, last_pid);
+            StorageEngine se(cmgr, catalog, fm);
+
+            bool hot = frames > page_count;
+            uint64_t rows = 0;
+            if (hot) se.ScanTable("t", [&](const TupleView&) { ++rows; }); // 预热：全部页读入缓存
+            rows = 0;
+            auto t0 = chrono::steady_clock::now();
+            se.ScanTable("t", [&](const TupleView& v) { rows += v.get_int(0) >= 0; });
+            double sec = seconds_since(t0);
+            if (rows != row_count) cerr << "扫描行数不符：" << rows << " != " << row_count << endl;
+            cout << setw(5) << size / 1024 << "KB 页 " << (hot ? "热扫描" : "冷扫描") << ": " << page_count << " 页，"
+                << row_count / page_count << " 行/页，" << sec << " 秒，" << static_cast<uint64_t>(rows / sec) << " 行/秒，"
+                << static_cast<uint64_t>(static_cast<double>(page_count) * size / sec / (1 << 20)) << " MB/秒" << endl;
+        }
+    }
+    cout << endl;
+}
+
+// 冷缓存（64帧）下开启预读，沿页链扫描从first开始的一条页链，输出吞吐、未命中与预读统计
+static void scan_page_chain(const string& db_dir, uint32_t first, const char* label) {
+    FileManager fm(db_dir, 64, ReplacePolicy::LRU);
+    fm.set_read_ahead(true);
+    ReadAheadState ra;
+    uint64_t pages = 0;
+    auto t0 = chrono::steady_clock::now();
+    for (uint32_t pid = first; pid != INVALID_PAGE_ID; ++pages) {
+        ReadPageGuard p = fm.read_page_guard(pid, AccessHint::SEQUENTIAL);
+        if (!p) break;
+        uint32_t next = p->get_next_page_id();
+        fm.read_ahead(ra, pid, next);
+        pid = next;
+    }
+    double sec = seconds_since(t0);
+    uint32_t hit, miss, prefetched, prefetch_hits;
+    double hit_rate;
+    fm.get_cache_stats(hit, miss, hit_rate);
+    fm.get_prefetch_stats(prefetched, prefetch_hits);
+    cout << label << pages << " 页，" << sec << " 秒，" << static_cast<uint64_t>(pages / max(sec, 1e-9))
+        << " 页/秒，未命中 " << miss << " 次，预读 " << prefetched << " 页（命中 " << prefetch_hits << "）" << endl;
+}
+
+// 基准16：两张表交替插入后扫描其中一张（缓存远小于表，开启预读）。
+// 共享数据文件中两张表的页交错排列，页链上相邻两页在文件中不相邻，预读无法启动；
+// 每张表一个页文件时页链在文件内连续
+void bench_table_files(uint32_t page_count) {
+    cout << "=== 基准16：共享数据文件与每表一个页文件的扫描对比 ===" << endl;
+    vector<char> row(200, 'x');
+    for (bool per_table : { false, true }) {
+        reset_bench_dir();
+        string db_dir = bench_dir + "/db";
+        uint32_t first = INVALID_PAGE_ID;
+        {
+            FileManager fm(db_dir, 64, ReplacePolicy::LRU);
+            uint32_t files[2] = { SHARED_FILE_ID, SHARED_FILE_ID };
+            if (per_table) {
+                files[0] = fm.open_table_file("a.tbl");
+                files[1] = fm.open_table_file("b.tbl");
+            }
+            uint32_t prev[2] = { INVALID_PAGE_ID, INVALID_PAGE_ID };
+            for (uint32_t i = 0; i < page_count * 2; ++i) {
+                uint32_t t = i % 2;
+                uint32_t pid = fm.allocate_page(files[t]);
+                WritePageGuard w = fm.write_page_guard(pid);
+                uint16_t slot;
+                while (w->insert_record(row.data(), row.size(), slot)) {}
+                w->set_prev_page_id(prev[t]);
+                if (prev[t] != INVALID_PAGE_ID) {
+                    w.release();
+                    fm.write_page_guard(prev[t])->set_next_page_id(pid);
+                }
+                else if (t == 0) {
+                    first = pid;
+                }
+                prev[t] = pid;
+            }
+        }
+        scan_page_chain(db_dir, first, per_table ? "每表一个页文件: " : "共享数据文件  : ");
+    }
+    cout << endl;
+}
+
+// 基准17：同一数据文件中两条页链交替增长（两张表交替插入），逐页分配与区段分配对比：
+// 页链在文件中的跳转次数，以及冷缓存下开启预读扫描其中一条的吞吐
+void bench_extent_allocation(uint32_t page_count) {
+    cout << "=== 基准17：逐页分配与区段分配（两条页链交替增长） ===" << endl;
+    for (bool extent : { false, true }) {
+        reset_bench_dir();
+        string db_dir = bench_dir + "/db";
+        uint32_t first = INVALID_PAGE_ID, jumps = 0;
+        {
+            FileManager fm(db_dir, 64, ReplacePolicy::LRU);
+            uint32_t prev[2] = { INVALID_PAGE_ID, INVALID_PAGE_ID };
+            for (uint32_t i = 0; i < page_count * 2; ++i) {
+                uint32_t t = i % 2;
+                uint32_t pid = extent ? fm.allocate_page_after(prev[t]) : fm.allocate_page();
+                WritePageGuard w = fm.write_page_guard(pid);
+                w->set_prev_page_id(prev[t]);
+                w.release();
+                if (prev[t] != INVALID_PAGE_ID) {
+                    fm.write_page_guard(prev[t])->set_next_page_id(pid);
+                    if (t == 0 && pid != prev[t] + 1) ++jumps;
+                }
+                else if (t == 0) {
+                    first = pid;
+                }
+                prev[t] = pid;
+            }
+        }
+        string label = string(extent ? "区段分配: " : "逐页分配: ") + "页链跳转 " + to_string(jumps) + " 次，";
+        scan_page_chain(db_dir, first, label.c_str());
+    }
+    cout << endl;
+}
+
+// 基准18：VACUUM。表中每4行删去3行后，逐步压缩（搬尾页记录、释放尾页）与 VACUUM FULL（整表重写）的耗时，
+// 以及压缩前后全表扫描的页数与耗时
+void bench_vacuum(uint32_t table_mb) {
+    cout << "=== 基准18：VACUUM（约 " << table_mb << " MB，删去3/4的行） ===" << endl;
+    reset_bench_dir();
+    string db_dir = bench_dir + "/db";
+    fs::create_directories(db_dir);
+
+    uint32_t page_count = 0, first_pid = INVALID_PAGE_ID, last_pid = INVALID_PAGE_ID;
+    uint64_t row_count = 0;
+    build_bench_table(db_dir, table_mb, page_count, first_pid, last_pid, row_count);
+    uint64_t kept = 0;
+    {
+        FileManager fm(db_dir, 64, ReplacePolicy::LRU);
+        for (uint32_t pid = first_pid; pid != INVALID_PAGE_ID;) {
+            WritePageGuard w = fm.write_page_guard(pid);
+            for (uint16_t slot = 0; slot < w->get_slot_count(); ++slot) {
+                if (slot % 4 != 0) w->delete_record(slot);
+                else ++kept;
+            }
+            pid = w->get_next_page_id();
+        }
+    }
+
+    FileManager fm(db_dir, 1024, ReplacePolicy::LRU);
+    CatalogManager cmgr(db_dir + "/catalog.txt");
+    Catalog catalog;
+    catalog.AddTable("t", bench_schema(), "t.tbl", first_pid, last_pid);
+    StorageEngine se(cmgr, catalog, fm);
+    auto scan = [&](const char* label) {
+        uint64_t rows = 0;
+        auto t0 = chrono::steady_clock::now();
+        se.ScanTable("t", [&](const TupleView&) { ++rows; });
+        double sec = seconds_since(t0);
+        if (rows != kept) cerr << "扫描行数不符：" << rows << " != " << kept << endl;
+        cout << label << rows << " 行，" << sec << " 秒" << endl;
+    };
+    scan("压缩前扫描: ");
+    for (bool full : { false, true }) {
+        StorageEngine::VacuumState st;
+        auto t0 = chrono::steady_clock::now();
+        bool ok = se.Vacuum("t", full, st);
+        double sec = seconds_since(t0);
+        cout << (full ? "VACUUM FULL: " : "VACUUM     : ") << (ok ? "" : "失败，") << st.pages_before << " -> " << st.pages_after
+            << " 页，释放 " << st.pages_freed << " 页，搬移 " << st.records_moved << " 行，" << st.steps << " 步，" << sec << " 秒" << endl;
+        scan(full ? "FULL 后扫描: " : "压缩后扫描: ");
+    }
+    cout << endl;
+}
+
+// 按范围删除一半的行：谓词删除（逐页原地打墓碑）对比整表重写（读出全部行、过滤后 OverwriteAll）
+void bench_delete_range(uint32_t table_mb) {
+    cout << "=== 基准19：范围删除（约 " << table_mb << " MB，删去 id < 行数/2） ===" << endl;
+    for (bool rewrite : { true, false }) {
+        reset_bench_dir();
+        string db_dir = bench_dir + "/db";
+        fs::create_directories(db_dir);
+
+        uint32_t page_count = 0, first_pid = INVALID_PAGE_ID, last_pid = INVALID_PAGE_ID;
+        uint64_t row_count = 0;
+        build_bench_table(db_dir, table_mb, page_count, first_pid, last_pid, row_count);
+        const int64_t bound = static_cast<int64_t>(row_count / 2);
+
+        FileManager fm(db_dir, 1024, ReplacePolicy::LRU);
+        CatalogManager cmgr(db_dir + "/catalog.txt");
+        Catalog catalog;
+        catalog.AddTable("t", bench_schema(), "t.tbl", first_pid, last_pid);
+        StorageEngine se(cmgr, catalog, fm);
+
+        size_t deleted = 0;
+        bool ok;
+        auto t0 = chrono::steady_clock::now();
+        if (rewrite) {
+            vector<vector<string>> rows = se.SelectAll("t"), kept;
+            for (auto& r : rows) {
+                if (stoll(r[0]) < bound) ++deleted;
+                else kept.push_back(std::move(r));
+            }
+            ok = se.OverwriteAll("t", kept);
+        }
+        else {
+            ok = se.DeleteIf("t", [bound](const TupleView& v) { return v.get_int(0) < bound; }, &deleted);
+        }
+        double sec = seconds_since(t0);
+
+        uint64_t rows = 0;
+        se.ScanTable("t", [&](const TupleView&) { ++rows; });
+        if (rows + deleted != row_count) cerr << "删除后行数不符：" << rows << " + " << deleted << " != " << row_count << endl;
+        cout << (rewrite ? "整表重写: " : "谓词删除: ") << (ok ? "" : "失败，") << "删除 " << deleted << " 行，剩余 "
+            << rows << " 行，" << sec << " 秒" << endl;
+    }
+    cout << endl;
+}
+
+// 每16行中一行变长到本页放不下：原地更新 + 转发桩，对比整表重写（读出全部行、修改后 OverwriteAll）
+void bench_update_forwarding(uint32_t table_mb) {
+    cout << "=== 基准20：变长 UPDATE（约 " << table_mb << " MB，每16行改1行、变长到本页放不下） ===" << endl;
+    for (bool rewrite : { true, false }) {
+        reset_bench_dir();
+        string db_dir = bench_dir + "/db";
+        fs::create_directories(db_dir);
+
+        uint32_t page_count = 0, first_pid = INVALID_PAGE_ID, last_pid = INVALID_PAGE_ID;
+        uint64_t row_count = 0;
+        build_bench_table(db_dir, table_mb, page_count, first_pid, last_pid, row_count);
+
+        FileManager fm(db_dir, 1024, ReplacePolicy::LRU);
+        CatalogManager cmgr(db_dir + "/catalog.txt");
+        Catalog catalog;
+        catalog.AddTable("t", bench_schema(), "t.tbl", first_pid, last_pid);
+        StorageEngine se(cmgr, catalog, fm);
+        const string grown(128, 'u');
+        auto hit = [](const vector<string>& r) { return !r.empty() && stoll(r[0]) % 16 == 0; };
+
+        uint64_t lsn_before = fm.get_wal().get_current_lsn();
+        bool ok;
+        auto t0 = chrono::steady_clock::now();
+        if (rewrite) {
+            vector<vector<string>> rows = se.SelectAll("t");
+            for (auto& r : rows) {
+                if (hit(r)) r[1] = grown;
+            }
+            ok = se.OverwriteAll("t", rows);
+        }
+        else {
+            ok = se.UpdateWhere("t", hit, { { 1, grown } });
+        }
+        double sec = seconds_since(t0);
+        uint64_t log_bytes = fm.get_wal().get_current_lsn() - lsn_before;
+
+        // 统计转发桩并核对行数（转发的行在迁入处读到，恰好一次）
+        uint64_t rows = 0, stubs = 0;
+        se.ScanTable("t", [&](const TupleView&) { ++rows; });
+        for (uint32_t pid = catalog.GetTable("t")->first_pid; pid != INVALID_PAGE_ID && pid != 0;) {
+            ReadPageGuard g = fm.read_page_guard(pid);
+            if (!g) break;
+            for (uint16_t slot = 0; slot < g->get_slot_count(); ++slot) {
+                uint32_t target_pid;
+                uint16_t target_slot;
+                if (g->get_forward(slot, target_pid, target_slot)) ++stubs;
+            }
+            pid = g->get_next_page_id();
+        }
+        if (rows != row_count) cerr << "更新后行数不符：" << rows << " != " << row_count << endl;
+        cout << (rewrite ? "整表重写: " : "原地更新: ") << (ok ? "" : "失败，") << sec << " 秒，日志 "
+            << log_bytes / 1024 << " KB，转发桩 " << stubs << " 个" << endl;
+    }
+    cout << endl;
+}
+
+// 逐行 Insert（每行找页、记一条页差异、提交一次）对比 BulkInsert（内存中装满整页、按批分配写入、只提交一次）
+void bench_bulk_insert(uint32_t rows) {
+    cout << "=== 基准21：批量插入（" << rows << " 行） ===" << endl;
+    string pad(120, 'p');
+    for (bool bulk : { false, true }) {
+        reset_bench_dir();
+        string db_dir = bench_dir + "/db";
+        fs::create_directories(db_dir);
+
+        FileManager fm(db_dir, 1024, ReplacePolicy::LRU);
+        CatalogManager cmgr(db_dir + "/catalog.txt");
+        Catalog catalog;
+        cmgr.CreateTable(catalog, "t", bench_schema(), "t.tbl");
+        StorageEngine se(cmgr, catalog, fm);
+        se.InitTablePages("t");
+
+        uint64_t flushes_before = fm.get_wal().get_flush_count();
+        size_t inserted = 0;
+        auto t0 = chrono::steady_clock::now();
+        if (bulk) {
+            uint32_t i = 0;
+            se.BulkInsert("t", [&](vector<string>& row) {
+                if (i == rows) return false;
+                row = { to_string(i), "name" + to_string(i), pad };
+                ++i;
+                return true;
+            }, &inserted);
+        }
+        else {
+            for (uint32_t i = 0; i < rows; ++i) {
+                if (se.Insert("t", { to_string(i), "name" + to_string(i), pad })) ++inserted;
+            }
+        }
+        double sec = seconds_since(t0);
+
+        uint64_t scanned = 0;
+        se.ScanTable("t", [&](const TupleView&) { ++scanned; });
+        if (scanned != rows) cerr << "插入后行数不符：" << scanned << " != " << rows << endl;
+        cout << (bulk ? "BulkInsert: " : "逐行 Insert: ") << inserted << " 行，" << sec << " 秒，"
+            << static_cast<uint64_t>(inserted / (sec > 0 ? sec : 1e-9)) << " 行/秒，日志同步 "
+            << fm.get_wal().get_flush_count() - flushes_before << " 次" << endl;
+    }
+    cout << endl;
+}
+
+// CSV导入（读文件、并行解析编码、批量写页）：单个解析线程对比按硬件线程数并行解析
+void bench_csv_load(uint32_t rows) {
+    cout << "=== 基准22：CSV导入（" << rows << " 行） ===" << endl;
+    string csv_path = bench_dir + "_load.csv";
+    {
+        ofstream out(csv_path, ios::binary);
+        out << "id,name,pad\n";
+        string pad(120, 'p');
+        for (uint32_t i = 0; i < rows; ++i) out << i << ",\"name, " << i << "\"," << pad << "\n";
+    }
+    uint32_t hw = max(1u, thread::hardware_concurrency());
+    for (uint32_t threads : { 1u, hw }) {
+        reset_bench_dir();
+        string db_dir = bench_dir + "/db";
+        fs::create_directories(db_dir);
+
+        FileManager fm(db_dir, 1024, ReplacePolicy::LRU);
+        CatalogManager cmgr(db_dir + "/catalog.txt");
+        Catalog catalog;
+        cmgr.CreateTable(catalog, "t", bench_schema(), "t.tbl");
+        StorageEngine se(cmgr, catalog, fm);
+        se.InitTablePages("t");
+
+        CsvLoadOptions opts;
+        opts.skip_lines = 1;
+        opts.threads = threads;
+        CsvLoadStats st;
+        CsvLoader loader(catalog, se);
+        if (!loader.Load("t", csv_path, opts, st)) cerr << "导入失败：第" << st.error_line << "行 " << st.error << endl;
+
+        uint64_t scanned = 0;
+        se.ScanTable("t", [&](const TupleView&) { ++scanned; });
+        if (scanned != rows) cerr << "导入后行数不符：" << scanned << " != " << rows << endl;
+        cout << threads << " 个解析线程: " << st.rows << " 行，" << st.file_bytes / (1024 * 1024) << " MB，" << st.seconds
+            << " 秒，" << static_cast<uint64_t>(st.rows / (st.seconds > 0 ? st.seconds : 1e-9)) << " 行/秒" << endl;
+        if (threads == hw) break;
+    }
+    std::error_code ec;
+    fs::remove(csv_path, ec);
+    cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t page_count = (argc > 1) ? static_cast<uint32_t>(stoul(argv[1])) : 16384;
+    uint32_t max_frames = (argc > 2) ? static_cast<uint32_t>(stoul(argv[2])) : 100000;
+    uint32_t table_mb = (argc > 3) ? static_cast<uint32_t>(stoul(argv[3])) : 256;
+
+    bench_seq_scan(page_count);
+    bench_eviction(max_frames);
+    bench_event_log();
+    bench_select_all(table_mb);
+    bench_update_one_row(table_mb);
+    bench_tuple_decode(1000000);
+    bench_insert_delete_churn(20, 1000);
+    bench_page_allocation(page_count);
+    bench_concurrent_scan(page_count);
+    bench_commit(2000);
+    bench_recovery(page_count);
+    bench_read_ahead(table_mb);
+    bench_mixed_workload(page_count);
+    bench_page_checksum(page_count);
+    bench_page_size_scan(table_mb);
+    bench_table_files(page_count);
+    bench_extent_allocation(page_count);
+    bench_vacuum(table_mb);
+    bench_delete_range(table_mb);
+    bench_update_forwarding(table_mb);
+    bench_bulk_insert(50000);
+    bench_csv_load(500000);
+
+    std::error_code ec;
+    fs::remove_all(bench_dir, ec);
+    return 0;
+}
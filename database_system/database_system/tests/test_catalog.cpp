@@ -1,54 +1,101 @@
-﻿#include "../engine/catalog_manager.hpp"
-#include <iostream>
-
-int main() {
-    // Create CatalogManager with catalog.db file
-    CatalogManager manager("catalog.db");
-    Catalog catalog;
-
-    // Try to load catalog from file (if exists)
-    if (manager.LoadCatalog(catalog)) {
-        std::cout << "Catalog loaded successfully!\n";
-    }
-    else {
-        std::cout << "Catalog file does not exist, starting with an empty catalog.\n";
-    }
-
-    // Create schema for the "student" table
-    std::vector<Column> studentCols = {
-        Column("id", ColumnType::INT),
-        Column("name", ColumnType::VARCHAR, 50),
-        Column("gpa", ColumnType::FLOAT)
-    };
-    Schema studentSchema(studentCols);
-
-    // Create a new "student" table
-    if (manager.CreateTable(catalog, "student", studentSchema, "student.tbl")) {
-        std::cout << "'student' table created successfully!\n";
-    }
-    else {
-        std::cout << "'student' table already exists.\n";
-    }
-
-    // List all tables in the catalog
-    std::cout << "\nCurrent tables in the catalog:\n";
-    for (const auto& name : catalog.ListTables()) {
-        std::cout << " - " << name << "\n";
-    }
-
-    // Drop the "student" table
-    if (manager.DropTable(catalog, "student")) {
-        std::cout << "\n'student' table dropped successfully.\n";
-    }
-    else {
-        std::cout << "\n'student' table not found to drop.\n";
-    }
-
-    // List tables after deletion
-    std::cout << "\nTables after deletion:\n";
-    for (const auto& name : catalog.ListTables()) {
-        std::cout << " - " << name << "\n";
-    }
-
-    return 0;
-}
+#include "../engine/catalog_manager.hpp"
+#include "../engine/tuple_codec.hpp"
+#include <iostream>
+
+int main() {
+    // Create CatalogManager with catalog.db file
+    CatalogManager manager("catalog.db");
+    Catalog catalog;
+
+    // Try to load catalog from file (if exists)
+    if (manager.LoadCatalog(catalog)) {
+        std::cout << "Catalog loaded successfully!\n";
+    }
+    else {
+        std::cout << "Catalog file does not exist, starting with an empty catalog.\n";
+    }
+
+    // Create schema for the "student" table
+    std::vector<Column> studentCols = {
+        Column("id", ColumnType::INT),
+        Column("name", ColumnType::VARCHAR, 50),
+        Column("gpa", ColumnType::FLOAT)
+    };
+    Schema studentSchema(studentCols);
+
+    // Create a new "student" table
+    if (manager.CreateTable(catalog, "student", studentSchema, "student.tbl")) {
+        std::cout << "'student' table created successfully!\n";
+    }
+    else {
+        std::cout << "'student' table already exists.\n";
+    }
+
+    // List all tables in the catalog
+    std::cout << "\nCurrent tables in the catalog:\n";
+    for (const auto& name : catalog.ListTables()) {
+        std::cout << " - " << name << "\n";
+    }
+
+    // Drop the "student" table
+    if (manager.DropTable(catalog, "student")) {
+        std::cout << "\n'student' table dropped successfully.\n";
+    }
+    else {
+        std::cout << "\n'student' table not found to drop.\n";
+    }
+
+    // List tables after deletion
+    std::cout << "\nTables after deletion:\n";
+    for (const auto& name : catalog.ListTables()) {
+        std::cout << " - " << name << "\n";
+    }
+
+    // Column types must survive a save/load round trip (rows are encoded by type)
+    std::vector<Column> orderCols = {
+        Column("id", ColumnType::INT),
+        Column("qty", ColumnType::TINYINT),
+        Column("price", ColumnType::DECIMAL, 10),
+        Column("created", ColumnType::TIMESTAMP),
+        Column("note", ColumnType::VARCHAR, 20)
+    };
+    orderCols[1].unsigned_flag = true;
+    orderCols[2].scale = 2;
+    Schema orderSchema(orderCols);
+    manager.CreateTable(catalog, "orders", orderSchema, "orders.tbl");
+    Catalog reloaded;
+    manager.LoadCatalog(reloaded);
+    const TableInfo* orders = reloaded.GetTable("orders");
+    bool typesOk = orders && orders->getSchema().GetColumnCount() == 5;
+    for (int i = 0; typesOk && i < 5; ++i) {
+        const Column& c = orders->getSchema().GetColumns()[i];
+        typesOk = c.type == orderCols[i].type && c.length == orderCols[i].length &&
+            c.scale == orderCols[i].scale && c.unsigned_flag == orderCols[i].unsigned_flag;
+    }
+    std::cout << "\nColumn types after reload: " << (typesOk ? "OK" : "MISMATCH") << "\n";
+
+    // Binary tuple round trip
+    TupleCodec codec(orderSchema);
+    std::string rec, err;
+    std::vector<std::string> row = { "7", "200", "12.345", "2024-02-29 10:20:30", "a, b" };
+    std::vector<std::string> decoded;
+    bool encoded = codec.encode(row, rec, &err);
+    TupleView view(codec, rec.data(), (uint16_t)rec.size());
+    if (encoded && view.valid()) view.decode(decoded);
+    bool roundTripOk = decoded.size() == 5 && decoded[0] == "7" && decoded[1] == "200" &&
+        decoded[2] == "12.35" && decoded[3] == "2024-02-29 10:20:30" && decoded[4] == "a, b" &&
+        view.get_int(2) == 1235;
+    std::cout << "Tuple round trip: " << (roundTripOk ? "OK" : "FAILED " + err) << "\n";
+
+    // NULL columns and type checking
+    bool nullOk = codec.encode({ "8", "", "", "", "" }, rec) &&
+        TupleView(codec, rec.data(), (uint16_t)rec.size()).is_null(2) &&
+        !TupleView(codec, rec.data(), (uint16_t)rec.size()).is_null(4);
+    bool rejectOk = !codec.encode({ "x" }, rec) && !codec.encode({ "1", "300" }, rec) &&
+        !codec.encode({ "1", "1", "1", "2023-02-29" }, rec);
+    std::cout << "NULL handling: " << (nullOk ? "OK" : "FAILED") << "\n";
+    std::cout << "Invalid values rejected: " << (rejectOk ? "OK" : "FAILED") << "\n";
+
+    manager.DropTable(catalog, "orders");
+    return (typesOk && roundTripOk && nullOk && rejectOk) ? 0 : 1;
+}
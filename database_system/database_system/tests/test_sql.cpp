@@ -13,13 +13,13 @@
 #include "../sql_compiler/planner.h"
 #include "../sql_compiler/pretty.h"
 
-// Ŀ¼ӿڣ engine/
+// 独立目录接口（避免依赖 engine/）
 #include "../sql_compiler/catalog_iface.h"
 
 using namespace minidb;
 
-// зֶ䣨ַеķֺţ
-// 滻ԭ split_sql(...) Ϊкŵİ汾
+// 简单切分多语句（考虑字符串中的分号）
+// 替换原来的 split_sql(...) 为带行号的版本
 static std::vector<std::pair<std::string, int>>
 split_sql_with_lines(const std::string& all) {
     std::vector<std::pair<std::string, int>> out;
@@ -38,7 +38,7 @@ split_sql_with_lines(const std::string& all) {
         };
 
     while (i < all.size()) {
-        // ǰհײкţõһʼλк
+        // 跳过前导空白并更新行号，得到这一条语句的起始位置与行号
         skip_spaces_and_newlines(i, line);
         if (i >= all.size()) break;
 
@@ -48,13 +48,13 @@ split_sql_with_lines(const std::string& all) {
         bool in_str = false;
         bool escaped = false;
 
-        //  start ɨֺţַڵǸ
+        // 从 start 扫到分号（不在字符串字面量内的那个）
         for (; i < all.size(); ++i) {
             char c = all[i];
 
             if (c == '\n') {
                 if (!in_str) line++;
-                // ַҲ԰ԭ SQL ͨеַ̣
+                // 在字符串内遇到换行也可以按原样计数（常见 SQL 通常不允许跨行单引号字符串，但我们容忍）
             }
 
             if (in_str) {
@@ -67,15 +67,15 @@ split_sql_with_lines(const std::string& all) {
             if (c == '\'') { in_str = true; continue; }
 
             if (c == ';') {
-                // ȡ [start, i]ֺţ
+                // 取 [start, i]（包含分号）
                 out.emplace_back(all.substr(start, i - start + 1), start_line);
-                i++; // Ƶֺ֮λãһ
+                i++; // 移到分号之后的位置，继续下一条
                 break;
             }
         }
 
         if (i >= all.size()) {
-            // ĩβûзֺŵвҲһ﷨׶αȱֺš
+            // 末尾没有分号但还有残留：也输出一条（让语法阶段报“缺分号”）
             std::string tail = all.substr(start);
             if (!trim(tail).empty()) out.emplace_back(tail, start_line);
             break;
@@ -86,19 +86,19 @@ split_sql_with_lines(const std::string& all) {
 }
 
 static void run_one(const std::string& sql_src, int start_line, ICatalog& cat) {
-    //  trim ǰУк=1кŴ start_line 
+    // 不再 trim 前导换行；保持列号=1，且行号从 start_line 起
     const std::string& sql = sql_src;
 
     std::cout << "============================\n";
     std::cout << "SQL: " << sql << "\n";
 
-    // 1) ʷָкſʼ
+    // 1) 词法：从指定行号开始
     {
         std::cout << "TOKENS:\n";
         Lexer lx(sql, start_line, /*start_col*/0, /*keep_comments*/true);
         while (true) {
             Token t = lx.next();
-            // >>> Ҫĸʽ
+            // >>> 按你要的格式输出：
             std::cout << "  (type=\"" << TokName(t.type)
                 << "\", value=\"" << t.lexeme
                 << "\", line=" << t.line
@@ -111,16 +111,16 @@ static void run_one(const std::string& sql_src, int start_line, ICatalog& cat) {
             }
         }
 
-        //ѡ㻹γ̡ԪʽУ
+        //（可选）如果你还想输出课程“四元式”，保留下面两行：
         std::cout << "TOKENS (quads):\n";
         PrintTokenQuads(sql, start_line, std::cout);
     }
 
-    // 2) ﷨AST
+    // 2) 语法（AST）
     Status pst = Status::OK();
     Lexer lx(sql, start_line);
     Parser ps(lx);
-    ps.enable_trace(true);                 // 
+    ps.enable_trace(true);                 // 开启步骤跟踪
     auto stmt = ps.parse_statement(pst);
 
     if (!pst.ok) {
@@ -129,11 +129,11 @@ static void run_one(const std::string& sql_src, int start_line, ICatalog& cat) {
     }
     PrintAST(stmt.get(), std::cout);
 
-    // 3) 
+    // 3) 语义
     SemanticAnalyzer sa(cat);
     auto sem = sa.analyze(stmt.get());
 
-    // >>> ȴӡԪʽ۳ɹʧܶȰɵĲ³㶨λ
+    // >>> 先打印四元式（无论成功失败都先把已生成的步骤吐出来，方便定位）
     if (!sem.quads.empty()) {
         std::cout << "SEMANTIC (quads):\n";
         for (size_t i = 0; i < sem.quads.size(); ++i) {
@@ -151,7 +151,7 @@ static void run_one(const std::string& sql_src, int start_line, ICatalog& cat) {
         std::cout << "SEMANTIC: OK\n";
     }
 
-    // 4) ƻ
+    // 4) 计划
     Planner pl;
     auto plan = pl.plan_from_stmt(stmt.get());
     PrintPlan(plan, std::cout);
@@ -165,34 +165,34 @@ int main() {
     cat.create_table(td);
 
     std::string all =
-        //"/* ȷ */\n"
+        //"/* 正确用例 */\n"
         //"CREATE TABLE course(cid INT, title VARCHAR);\n"
         //"INSERT INTO student(id,name,age) VALUES (1,'Alice',20);\n"
-        //"INSERT INTO student VALUES (2,'Bob',19);\n"                 // δ嵥˳=3
-        //"SELECT name, age FROM student WHERE age >= 20;\n"          // Сд
-        //"SELECT student.name FROM student WHERE id = 1;\n"          // ޶ a.b
-        "DELETE FROM student WHERE id = 999;\n"                      // OKȻûƥУ
+        //"INSERT INTO student VALUES (2,'Bob',19);\n"                 // 未给列清单，按表列顺序；数量=3
+        //"SELECT name, age FROM student WHERE age >= 20;\n"          // 大小写不敏感
+        //"SELECT student.name FROM student WHERE id = 1;\n"          // 限定列名 a.b
+        "DELETE FROM student WHERE id = 999;\n"                      // 语义OK（虽然没匹配行）
         //"\n"
-        //"/*  */\n"
-        //"CREATE TABLE student(id INT); \n"                           // Ѵ
-        //"INSERT INTO student(id,name,age) VALUES (3,'Carol');\n"     // һ
-        //"INSERT INTO student(id,name,age) VALUES (4,20,19);\n"       // Ͳƥ䣺name  INT
-        //"SELECT not_exist FROM student;\n"                           // в
-        //"UPDATE student SET notExist = 1 WHERE id = 1; \n"           //  UPDATE ٷſ
+        //"/* 语义错误用例 */\n"
+        //"CREATE TABLE student(id INT); \n"                           // 表已存在
+        //"INSERT INTO student(id,name,age) VALUES (3,'Carol');\n"     // 个数不一致
+        //"INSERT INTO student(id,name,age) VALUES (4,20,19);\n"       // 类型不匹配：name 用了 INT
+        //"SELECT not_exist FROM student;\n"                           // 列不存在
+        //"UPDATE student SET notExist = 1 WHERE id = 1; \n"           // 开启 UPDATE 语义后再放开
         ;
 
     auto parts = split_sql_with_lines(all);
     for (auto& [sql, line] : parts) {
         if (!trim(sql).empty()) {
-            run_one(sql, line, cat);   // ӡ TOKENS / TRACE / AST / 
+            run_one(sql, line, cat);   // 这里会打印 TOKENS / TRACE / AST / 语义错误
         }
     }
 
     std::cout << "==== SQL compiler end ====\n";
     return 0;
     
-    //ͨ
-    // ȷԭĶַ
+    //跑通测试
+    //② 正确用例（保持你原来的多行字符串）
     //std::string ok_sql =
     //    "SELECT name FROM student;";
     //    "CREATE TABLE course(cid INT, title VARCHAR);\n"
@@ -206,24 +206,24 @@ int main() {
     //        run_one(sql, line, cat);
     //}
 
- //   //  ֿ֧ͬжλ
+ //   // ③ 错误用例（同样支持跨行定位）
  //   std::vector<std::string> bad = {
- //       "SELECT id FROM student",                          // ȱֺ
- //       "SELECT idx,name FROM student;",                   // ƴд
- //       "INSERT INTO student(id,name,age) VALUES (2,20,19);", // Ͳƥ
- //       "INSERT INTO student(id,name,age) VALUES (3,'Bob');", // ֵһ
- //       "INSERT INTO student(id,name,age) VALUES (3,'Bob,19);", // δպַ
- //       "CREATE TABLE t(a INT, a VARCHAR);"                // ظ
+ //       "SELECT id FROM student",                          // 缺分号
+ //       "SELECT idx,name FROM student;",                   // 列名拼写错误
+ //       "INSERT INTO student(id,name,age) VALUES (2,20,19);", // 类型不匹配
+ //       "INSERT INTO student(id,name,age) VALUES (3,'Bob');", // 值个数不一致
+ //       "INSERT INTO student(id,name,age) VALUES (3,'Bob,19);", // 未闭合字符串
+ //       "CREATE TABLE t(a INT, a VARCHAR);"                // 重复列
  //   };
 
  //   int line = 1;
  //   for (auto& s : bad) {
  //       run_one(s, line, cat);
- //       line += 1; // ÿҲܿͬʼк
+ //       line += 1; // 让每条错误用例也能看到不同的起始行号
  //   }
 
-    //ʷ
-    //  ʵ
+    //词法分析测试
+    // ① 程序实例用例
     //std::string demo =
     //    "/* test_sql_program */\n"
     //    "SELECT name, age\n"
@@ -231,13 +231,13 @@ int main() {
     //    "WHERE age > 20; -- only adults\n";
     //run_one(demo, /*start_line*/1, cat);
 
-    //﷨
+    //语法分析测试
     //std::string demo =
     //    "/* test_sql_program */\n"
     //    "SELECT name FROM student;\n";
     //run_one(demo, 1, cat);
 
-    // 䴮кзִ
+    // 多语句串：按行号切分执行
     //std::string sql_all =
     //    "/* demo */\n"
     //    "CREATE TABLE course(cid INT, title VARCHAR);\n"
@@ -252,7 +252,7 @@ int main() {
     //}
 
     //std::string all =
-        //"/* ȷ */\n"
+        //"/* 正确用例 */\n"
         //"CREATE TABLE course(cid INT, title VARCHAR);\n"
         //"INSERT INTO student(id,name,age) VALUES (1,'Alice',20);\n"
         //"UPDATE student SET age = 21, name = 'Alice-2' WHERE id = 1;\n"
@@ -261,11 +261,11 @@ int main() {
         //"SELECT id, name FROM student GROUP BY id, name HAVING id = 1 ORDER BY name;\n"
         //"DELETE FROM student WHERE id = 1;\n"
         //"\n"
-        //"/*  */\n"
-        //"SELECT id FROM student\n"                 // ȱֺ
-        //"INSERT INTO student(id,name,age) VALUES (2, 20, 19);\n" // Ͳƥ䣨name  INT
-        //"INSERT INTO student(id,name,age) VALUES (3,'Bob');\n"   // һ
-        //"INSERT INTO student(id,name,age) VALUES (4,'Bob,19);\n" // δպַ
-        //"UPDATE student SET notExist = 1 WHERE id = 1; \n"       // ƴд׶α
+        //"/* 常见错误用例 */\n"
+        //"SELECT id FROM student\n"                 // 缺分号
+        //"INSERT INTO student(id,name,age) VALUES (2, 20, 19);\n" // 类型不匹配（name 用了 INT）
+        //"INSERT INTO student(id,name,age) VALUES (3,'Bob');\n"   // 个数不一致
+        //"INSERT INTO student(id,name,age) VALUES (4,'Bob,19);\n" // 未闭合字符串
+        //"UPDATE student SET notExist = 1 WHERE id = 1; \n"       // 列名拼写（语义阶段报）
         //;
 }
\ No newline at end of file
@@ -1,8 +1,28 @@
 #include "../storage/cache_manager.hpp"
+#include "../storage/crc32c.hpp"
 #include "../storage/file_manager.hpp"
+#include "../storage/free_page_bitmap.hpp"
+#include "../storage/free_space_map.hpp"
 #include "../storage/page.hpp"
+#include "../storage/page_guard.hpp"
 #include "../storage/page_manager.hpp"
+#include "../storage/wal_manager.hpp"
+#include "../engine/catalog_manager.hpp"
+#include "../engine/storage_engine.hpp"
+#include "../engine/tuple_codec.hpp"
+#include "../engine/csv_loader.hpp"
+#include "../engine/executor.hpp"
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
 #include <direct.h>
 #include <cassert>
 #include <system_error>
@@ -10,303 +30,297 @@
 
 using namespace std;
 
-// Ŀ¼Windows汾
+// 辅助函数：创建测试目录（Windows版本）
 void create_test_dir(const string& dir_path) {
-    // ʹWindows APIĿ¼
+    // 使用Windows API创建目录
     if (CreateDirectoryA(dir_path.c_str(), NULL) == 0) {
         DWORD error = GetLastError();
         if (error == ERROR_ALREADY_EXISTS) {
-            cout << dir_path << "Ѵ"<<endl;
+            cout << dir_path << "已存在"<<endl;
             return;
             
         }else{
-                throw runtime_error("Ŀ¼ʧܣ" + dir_path +
+                throw runtime_error("创建目录失败：" + dir_path +
                 ", error code: " + to_string(error));
         }
     }
     else {
-        cout << "Ŀ¼ɹ: " << dir_path << endl;
+        cout << "测试目录创建成功: " << dir_path << endl;
     }
 }
 
-// Ŀ¼ļ·
-string test_dir = "C:\\Users\\que07\\Desktop\\ʵѵ\\202509\\test";
+// 测试目录和文件路径
+string test_dir = "C:\\Users\\que07\\Desktop\\实训\\202509\\test";
 string data_path = test_dir + "\\data.dat";
 
-// 1ҳд
+// 测试1：页分配与写入
 void test_allocate_and_write() {
-    cout << "=== 1ҳд ===" << endl;
+    cout << "=== 测试1：页分配与写入 ===" << endl;
 
     try {
         create_test_dir(test_dir);
        
     }
     catch (const exception& e) {
-        cerr << ": " << e.what() << endl;
+        cerr << "错误: " << e.what() << endl;
         return;
     }
 
     try {
         PageManager pm(data_path);
-        cout << "ɹʼPageManagerļ: " << data_path << endl;
+        cout << "成功初始化PageManager，数据文件: " << data_path << endl;
 
-        // һҳԤҳ1
+        // 分配第一页（预期页号1）
         uint32_t page_id = pm.allocate_page();
-        assert(page_id == 1 && "1ʧܣ״ηҳӦΪ1");
-        cout << "ɹҳţ" << page_id << "Ԥڣ" << endl;
+        assert(page_id == 1 && "测试1失败：首次分配页号应为1");
+        cout << "成功分配页号：" << page_id << "（符合预期）" << endl;
 
-        // ҳдݣģstudentԪݣ
+        // 向页写入测试数据（模拟student表的元数据）
         Page page;
         bool read_ok = pm.read_page(page_id, page);
-        assert(read_ok && "1ʧܣȡշҳʧ");
+        assert(read_ok && "测试1失败：读取刚分配的页失败");
 
-        string table_meta = "student:id(INT,4),name(VARCHAR,20),age(INT,4)"; // ṹԪ
+        string table_meta = "student:id(INT,4),name(VARCHAR,20),age(INT,4)"; // 表结构元数据
         bool write_ok = page.write_data(
-            PAGE_HEADER_SIZE,        // ʼλд
+            PAGE_HEADER_SIZE,        // 从数据区起始位置写入
             table_meta.c_str(),
             static_cast<uint32_t>(table_meta.size())
         );
-        assert(write_ok && "1ʧܣҳдʧ");
+        assert(write_ok && "测试1失败：向页写入数据失败");
 
-        // ҳĿƫƣдƫ=ҳͷС+ݳȣ
+        // 更新页的空闲偏移（写入后空闲偏移=页头大小+数据长度）
         bool offset_ok = page.set_free_offset(PAGE_HEADER_SIZE + static_cast<uint32_t>(table_meta.size()));
-        assert(offset_ok && "1ʧܣ¿ƫʧ");
+        assert(offset_ok && "测试1失败：更新空闲偏移失败");
 
-        // д̲֤
+        // 写入磁盘并验证
         bool disk_ok = pm.write_page(page_id, page);
-        assert(disk_ok && "1ʧܣҳдʧ");
-        cout << "ɹдҳݣ" << table_meta << endl;
-        cout << "1ͨ" << endl << endl;
+        assert(disk_ok && "测试1失败：将页写入磁盘失败");
+        cout << "成功写入页数据：" << table_meta << endl;
+        cout << "测试1通过！" << endl << endl;
     }
     catch (const exception& e) {
-        cerr << "1ʧܣ" << e.what() << endl << endl;
+        cerr << "测试1失败：" << e.what() << endl << endl;
         exit(1);
     }
 }
 
-// 2ҳȡͷ
+// 测试2：页读取与释放
 void test_read_and_free() {
-    cout << "=== 2ҳȡͷ ===" << endl;
+    cout << "=== 测试2：页读取与释放 ===" << endl;
 
     try {
         PageManager pm(data_path);
-        uint32_t page_id = 1; // 1зҳ
+        uint32_t page_id = 1; // 测试1中分配的页号
         Page page;
 
-        // ȡҳݲ֤
+        // 读取页数据并验证
         bool read_ok = pm.read_page(page_id, page);
-        assert(read_ok && "2ʧܣȡҳʧ");
+        assert(read_ok && "测试2失败：读取页失败");
 
         char read_buf[256] = { 0 };
-        bool data_ok = page.read_data(PAGE_HEADER_SIZE, read_buf, 50); // ȡ50ֽڣǲݣ
-        assert(data_ok && "2ʧܣҳȡʧ");
+        bool data_ok = page.read_data(PAGE_HEADER_SIZE, read_buf, 50); // 读取50字节（覆盖测试数据）
+        assert(data_ok && "测试2失败：从页读取数据失败");
 
         string expected_meta = "student:id(INT,4),name(VARCHAR,20),age(INT,4)";
-        assert(string(read_buf) == expected_meta && "2ʧܣȡԤڲ");
-        cout << "ҳ" << page_id << "ȡݣ" << read_buf << "Ԥڣ" << endl;
+        assert(string(read_buf) == expected_meta && "测试2失败：读取的数据与预期不符");
+        cout << "从页" << page_id << "读取到数据：" << read_buf << "（符合预期）" << endl;
 
-        // ͷҳ֤
+        // 释放页并验证
         bool free_ok = pm.free_page(page_id);
-        assert(free_ok && "2ʧܣͷҳʧ");
-        cout << "ɹͷҳ" << page_id << endl;
+        assert(free_ok && "测试2失败：释放页失败");
+        cout << "成功释放页" << page_id << endl;
 
-        // ֤ҳã·Ӧҳ1
+        // 验证空闲页复用（重新分配应返回页号1）
         uint32_t new_page_id = pm.allocate_page();
-        assert(new_page_id == 1 && "2ʧܣҳδ");
-        cout << "·ҳţ" << new_page_id << "Ԥڣҳóɹ" << endl;
-        cout << "2ͨ" << endl << endl;
+        assert(new_page_id == 1 && "测试2失败：空闲页未复用");
+        cout << "重新分配页号：" << new_page_id << "（符合预期，空闲页复用成功）" << endl;
+        cout << "测试2通过！" << endl << endl;
     }
     catch (const exception& e) {
-        cerr << "2ʧܣ" << e.what() << endl << endl;
+        cerr << "测试2失败：" << e.what() << endl << endl;
         exit(1);
     }
 }
 
-// 3ݱӳģ
+// 测试3：数据表映射模拟
 void test_table_page_mapping() {
-    cout << "=== 3ݱӳģ ===" << endl;
+    cout << "=== 测试3：数据表映射模拟 ===" << endl;
 
     try {
         PageManager pm(data_path);
-        // ģstudentҳҳ1ҳ ҳ2һҳ
-        uint32_t page1_id = pm.allocate_page(); // ҳ1
-        uint32_t page2_id = pm.allocate_page(); // ҳ2
+        // 模拟student表的页链表：页1（首页）→ 页2（下一页）
+        uint32_t page1_id = pm.allocate_page(); // 复用页1
+        uint32_t page2_id = pm.allocate_page(); // 新页2
 
-        // ʼҳ1ҳnext_page_idΪ2
+        // 初始化页1（首页）：next_page_id设为2
         Page page1;
         pm.read_page(page1_id, page1);
         page1.set_next_page_id(page2_id);
         pm.write_page(page1_id, page1);
 
-        // ʼҳ2һҳprev_page_idΪ1next_page_idΪЧ
+        // 初始化页2（下一页）：prev_page_id设为1，next_page_id设为无效
         Page page2;
         pm.read_page(page2_id, page2);
         page2.set_prev_page_id(page1_id);
         page2.set_next_page_id(INVALID_PAGE_ID);
         pm.write_page(page2_id, page2);
 
-        // ֤ҳϵ
+        // 验证页链表关系
         Page verify_page1, verify_page2;
         pm.read_page(page1_id, verify_page1);
         pm.read_page(page2_id, verify_page2);
 
-        assert(verify_page1.get_next_page_id() == page2_id && "3ʧܣҳ1һҳŴ");
-        assert(verify_page2.get_prev_page_id() == page1_id && "3ʧܣҳ2һҳŴ");
-        cout << "studentҳӳϵҳ" << page1_id << "  ҳ" << page2_id << "Ԥڣ" << endl;
-        cout << "3ͨ" << endl << endl;
+        assert(verify_page1.get_next_page_id() == page2_id && "测试3失败：页1的下一页号错误");
+        assert(verify_page2.get_prev_page_id() == page1_id && "测试3失败：页2的上一页号错误");
+        cout << "student表页映射关系：页" << page1_id << " → 页" << page2_id << "（符合预期）" << endl;
+        cout << "测试3通过！" << endl << endl;
     }
     catch (const exception& e) {
-        cerr << "3ʧܣ" << e.what() << endl << endl;
+        cerr << "测试3失败：" << e.what() << endl << endl;
         exit(1);
     }
 }
 
 
 
-// 4δ
+// 测试4：缓存命中与未命中
 void test_cache_hit_miss() {
-    cout << "=== 4δ ===" << endl;
+    cout << "=== 测试4：缓存命中与未命中 ===" << endl;
     string log_path = test_dir + "/cache_log.txt";
     create_test_dir(test_dir);
 
     try {
-        // ʼҳȷ2ҳڲԣ
+        // 初始化页管理器（先分配2个页，用于测试）
         PageManager pm(data_path);
-        uint32_t page1_id = pm.allocate_page(); // ҳ1
-        uint32_t page2_id = pm.allocate_page(); // ҳ2
+        uint32_t page1_id = pm.allocate_page(); // 页1
+        uint32_t page2_id = pm.allocate_page(); // 页2
 
-        // ʼ1LRUԣ
+        // 初始化缓存管理器（容量1，LRU策略）
         CacheManager cm(pm, 1, ReplacePolicy::LRU, log_path);
 
-        // һηҳ1δУգ
+        // 第一次访问页1：未命中（缓存空）
         Page* page1 = cm.get_page(page1_id);
-        assert(page1 != nullptr && "4ʧܣһηҳ1δеȡʧ");
-        assert(cm.get_current_size() == 1 && "4ʧܣӦ1ҳ");
+        assert(page1 != nullptr && "测试4失败：第一次访问页1未命中但获取失败");
+        assert(cm.get_current_size() == 1 && "测试4失败：缓存应包含1个页");
 
-        // ڶηҳ1
+        // 第二次访问页1：命中
         Page* page1_hit = cm.get_page(page1_id);
-        assert(page1_hit != nullptr && "4ʧܣڶηҳ1еȡʧ");
+        assert(page1_hit != nullptr && "测试4失败：第二次访问页1命中但获取失败");
 
-        // ҳ2δУ滻ҳ1
+        // 访问页2：未命中（缓存满，替换页1）
         Page* page2 = cm.get_page(page2_id);
-        assert(page2 != nullptr && "4ʧܣҳ2δеȡʧ");
-        assert(cm.get_current_size() == 1 && "4ʧܣ滻ӦΪ1ҳ");
+        assert(page2 != nullptr && "测试4失败：访问页2未命中但获取失败");
+        assert(cm.get_current_size() == 1 && "测试4失败：缓存替换后应仍为1个页");
 
-        // ͳϢܷ3Σ1Σδ2Σ
+        // 检查统计信息（总访问3次：命中1次，未命中2次）
         uint32_t hit, miss;
         double hit_rate;
         cm.get_cache_stats(hit, miss, hit_rate);
-        assert(hit == 1 && miss == 2 && "4ʧܣͳϢ");
-        assert(hit_rate == 1.0 / 3 && "4ʧܣʼ");
+        assert(hit == 1 && miss == 2 && "测试4失败：统计信息错误");
+        assert(hit_rate == 1.0 / 3 && "测试4失败：命中率计算错误");
 
         cm.print_stats();
-        cout << "4ͨ" << endl << endl;
+        cout << "测试4通过！" << endl << endl;
     }
     catch (const exception& e) {
-        cerr << "4ʧܣ" << e.what() << endl << endl;
+        cerr << "测试4失败：" << e.what() << endl << endl;
         exit(1);
     }
 }
 
-// 5LRU滻
+// 测试5：LRU替换策略
 void test_lru_policy() {
-    cout << "=== 5LRU滻 ===" << endl;
+    cout << "=== 测试5：LRU替换策略 ===" << endl;
     string log_path = test_dir + "/cache_log_lru.txt";
 
     try {
         PageManager pm(data_path);
         CacheManager cm(pm, 2, ReplacePolicy::LRU, log_path);
 
-        // 3ҳ
+        // 分配3个页
         uint32_t page1_id = pm.allocate_page();
         uint32_t page2_id = pm.allocate_page();
         uint32_t page3_id = pm.allocate_page();
 
-        // ˳ҳ1  ҳ2  ҳ3滻ʹáҳ1
+        // 访问顺序：页1 → 页2 → 页3（缓存满，需替换“最近最少使用”的页1）
         cm.get_page(page1_id);
         cm.get_page(page2_id);
         cm.get_page(page3_id);
 
-        // ֤ݣӦҳ2ҳ3滻ҳ1
-        assert(cm.get_current_size() == 2 && "5ʧܣС");
-        // ҳ1δУѱ滻
+        // 验证缓存内容：应包含页2、页3（替换页1）
+        assert(cm.get_current_size() == 2 && "测试5失败：缓存大小错误");
+        // 访问页1：未命中（已被替换）
         Page* page1_miss = cm.get_page(page1_id);
-        assert(page1_miss != nullptr && "5ʧܣʱ滻ҳ1ʧ");
-        // ʺ󻺴ݣҳ3ҳ1滻ʹáҳ2
+        assert(page1_miss != nullptr && "测试5失败：访问被替换的页1失败");
+        // 访问后缓存内容：页3、页1（替换“最近最少使用”的页2）
         Page* page2_miss = cm.get_page(page2_id);
-        assert(page2_miss != nullptr && "5ʧܣҳ2Ӧδ");
+        assert(page2_miss != nullptr && "测试5失败：访问页2应未命中");
 
-        cout << "LRU滻֤ɹ" << endl;
+        cout << "LRU替换策略验证成功" << endl;
         cm.print_stats();
-        cout << "5ͨ" << endl << endl;
+        cout << "测试5通过！" << endl << endl;
     }
     catch (const exception& e) {
-        cerr << "5ʧܣ" << e.what() << endl << endl;
+        cerr << "测试5失败：" << e.what() << endl << endl;
         exit(1);
     }
 }
 
-// 6ҳˢ
+// 测试6：脏页刷新
 void test_dirty_page_flush() {
-    cout << "=== 6ҳˢ ===" << endl;
+    cout << "=== 测试6：脏页刷新 ===" << endl;
     string log_path = test_dir + "/cache_log_dirty.txt";
 
     try {
         PageManager pm(data_path);
         CacheManager cm(pm, 1, ReplacePolicy::FIFO, log_path);
 
-        // 1. ҳдݣΪҳ
+        // 1. 分配页并写入测试数据（标记为脏页）
         uint32_t page_id = pm.allocate_page();
         Page* page = cm.get_page(page_id);
         string test_data = "Cache dirty page test data";
         page->write_data(PAGE_HEADER_SIZE, test_data.c_str(), test_data.size());
-        // ֶΪҳʵĿݿã
-        auto it = cm.get_cache_map().find(page_id);
-        if (it != cm.get_cache_map().end()) {
-            it->second.is_dirty = true;
-        }
+        // 手动标记为脏页（实际项目中由数据库引擎调用）
+        cm.mark_dirty(page_id);
 
-        // 2. ˢҳ
+        // 2. 刷新页到磁盘
         bool flush_ok = cm.flush_page(page_id);
-        assert(flush_ok && "6ʧܣҳˢʧ");
+        assert(flush_ok && "测试6失败：脏页刷新失败");
 
-        // 3. Ӵ̶ȡ֤ƹ棩
+        // 3. 从磁盘读取验证（绕过缓存）
         Page disk_page(page_id);
         pm.read_page(page_id, disk_page);
         char read_buf[1024] = { 0 };
         disk_page.read_data(PAGE_HEADER_SIZE, read_buf, test_data.size());
-        assert(string(read_buf) == test_data && "6ʧܣҳݲһ");
+        assert(string(read_buf) == test_data && "测试6失败：磁盘数据与脏页数据不一致");
 
-        // 4. flush_allҳˢУ
+        // 4. 测试flush_all（新增脏页后刷新所有）
         Page* page2 = cm.get_page(pm.allocate_page());
         string test_data2 = "Flush all test data";
         page2->write_data(PAGE_HEADER_SIZE, test_data2.c_str(), test_data2.size());
-        it = cm.get_cache_map().find(page2->get_page_id());
-        if (it != cm.get_cache_map().end()) {
-            it->second.is_dirty = true;
-        }
+        cm.mark_dirty(page2->get_page_id());
         cm.flush_all();
 
-        cout << "ҳˢ֤ɹ뻺һ" << endl;
-        cout << "6ͨ" << endl << endl;
+        cout << "脏页刷新验证成功，磁盘数据与缓存数据一致" << endl;
+        cout << "测试6通过！" << endl << endl;
     }
     catch (const exception& e) {
-        cerr << "6ʧܣ" << e.what() << endl << endl;
+        cerr << "测试6失败：" << e.what() << endl << endl;
         exit(1);
     }
 }
 
-// ļǷ
+// 检查文件是否存在
 bool file_exists(const std::string& file_path) {
     std::ifstream file(file_path);
-    return file.good();  // ļԳɹ򿪣򷵻 true
+    return file.good();  // 如果文件可以成功打开，则返回 true
 }
-// ɾĿ¼Խ
+// 辅助函数：删除测试目录（测试结束后清理）
 void delete_test_dir(const string& dir_path) {
 
-    // Ŀ¼Ƿ
+    // 检查目录是否存在
     if (!file_exists(dir_path)) {
-        cout << "Ŀ¼: " << dir_path << endl;
+        cout << "目录不存在: " << dir_path << endl;
         return;
     }
 
@@ -318,55 +332,55 @@ void delete_test_dir(const string& dir_path) {
     system(cmd.c_str());
 }
 
-// 7ļʼԪݼ
+// 测试7：文件初始化与元数据加载
 void test_file_init_and_metadata() {
-    cout << "=== 7ļʼԪݼ ===" << endl;
+    cout << "=== 测试7：文件初始化与元数据加载 ===" << endl;
     string test_dir7 = test_dir + "/test_db_files";
-    delete_test_dir(test_dir7); // Ŀ¼
+    delete_test_dir(test_dir7); // 先清理旧目录
 
 
     try {
-        // 1. һγʼFileManagerĿ¼ļԪļ
+        // 1. 第一次初始化FileManager：创建目录、数据文件、元数据文件
         FileManager fm1(test_dir7, 2, ReplacePolicy::LRU);
-        cout << "һγʼ" << endl;
-        cout << "ļ·" << fm1.get_data_file_path() << endl;
-        cout << "Ԫļ·" << fm1.get_meta_file_path() << endl;
+        cout << "第一次初始化：" << endl;
+        cout << "数据文件路径：" << fm1.get_data_file_path() << endl;
+        cout << "元数据文件路径：" << fm1.get_meta_file_path() << endl;
 
 
-        // ֤ļǷ񴴽ɹ
-        assert(file_exists(fm1.get_data_file_path()) && "7ʧܣļδ");
-        assert(file_exists(fm1.get_meta_file_path()) && "7ʧܣԪļδ");
+        // 验证文件是否创建成功
+        assert(file_exists(fm1.get_data_file_path()) && "测试7失败：数据文件未创建");
+        assert(file_exists(fm1.get_meta_file_path()) && "测试7失败：元数据文件未创建");
 
-        // 2. 2ҳ޸Ԫݣnext_page_id=3free_page_listΪգ
+        // 2. 分配2个页（修改元数据：next_page_id=3，free_page_list为空）
         uint32_t page1_id = fm1.allocate_page();
         uint32_t page2_id = fm1.allocate_page();
-        assert(page1_id == 1 && page2_id == 2 && "7ʧܣҳŴ");
+        assert(page1_id == 1 && page2_id == 2 && "测试7失败：页分配号错误");
 
-        // 3. ͷҳ1޸Ԫݣfree_page_list1
+        // 3. 释放页1（修改元数据：free_page_list包含1）
         bool free_ok = fm1.free_page(page1_id);
-        assert(free_ok && "7ʧܣҳͷʧ");
+        assert(free_ok && "测试7失败：页释放失败");
 
-        // 4. fm1Ԫݱ棨save_metadata
+        // 4. 销毁fm1，触发元数据保存（析构函数调用save_metadata）
         fm1.~FileManager();
 
-        // 5. ڶγʼFileManager֮ǰԪ
+        // 5. 第二次初始化FileManager：加载之前保存的元数据
         FileManager fm2(test_dir7, 2, ReplacePolicy::LRU);
-        cout << "ڶγʼ" << endl;
+        cout << "第二次初始化：" << endl;
 
-        // ֤ԪǷָҳӦҳ1free_page_listеҳ
+        // 验证元数据是否恢复：分配页应复用页1（free_page_list中的页）
         uint32_t page3_id = fm2.allocate_page();
-        assert(page3_id == 1 && "7ʧܣԪδָҳδ");
+        assert(page3_id == 1 && "测试7失败：元数据未恢复，空闲页未复用");
 
-        // ֤next_page_idǷָӦΪ3
-        // עPageManagerget_next_page_idӿڣã
-        PageManager& pm = const_cast<PageManager&>(fm2.get_page_manager()); // ãʵĿconst_cast
-        assert(pm.get_next_page_id() == 3 && "7ʧܣnext_page_idδָ");
+        // 验证next_page_id是否恢复（应为3）
+        // 注：需在PageManager中新增get_next_page_id接口（供测试用）
+        PageManager& pm = const_cast<PageManager&>(fm2.get_page_manager()); // 测试用，实际项目需避免const_cast
+        assert(pm.get_next_page_id() == 3 && "测试7失败：next_page_id未恢复");
 
-        cout << "ļʼԪݼ֤ɹ" << endl;
-        cout << "7ͨ" << endl << endl;
+        cout << "文件初始化与元数据加载验证成功" << endl;
+        cout << "测试7通过！" << endl << endl;
     }
     catch (const exception& e) {
-        cerr << "7ʧܣ" << e.what() << endl << endl;
+        cerr << "测试7失败：" << e.what() << endl << endl;
         delete_test_dir(test_dir7);
         exit(1);
     }
@@ -374,48 +388,48 @@ void test_file_init_and_metadata() {
     delete_test_dir(test_dir7);
 }
 
-// 8ݳ־û
+// 测试8：数据持久化
 void test_data_persistence() {
-    cout << "=== 8ݳ־û ===" << endl;
+    cout << "=== 测试8：数据持久化 ===" << endl;
     string test_dir = test_dir + "/test_db_files";
     delete_test_dir(test_dir);
 
     try {
-        // 1. һд
+        // 1. 第一次启动：写入测试数据
         FileManager fm1(test_dir, 2, ReplacePolicy::LRU);
         uint32_t page_id = fm1.allocate_page();
         Page page(page_id);
 
-        // дݣģstudentһм¼
+        // 写入测试数据（模拟student表的一行记录）
         string student_data = "1,Alice,20";
         page.write_data(PAGE_HEADER_SIZE, student_data.c_str(), student_data.size());
-        page.set_free_offset(PAGE_HEADER_SIZE + student_data.size()); // ¿ƫ
+        page.set_free_offset(PAGE_HEADER_SIZE + student_data.size()); // 更新空闲偏移
 
-        // дļΪҳ
+        // 写入文件（缓存标记为脏页）
         bool write_ok = fm1.write_page(page_id, page);
-        assert(write_ok && "8ʧܣҳдʧ");
+        assert(write_ok && "测试8失败：页写入失败");
 
-        // ˢҳ̣ȷдļ
+        // 刷新脏页到磁盘（确保数据写入文件）
         fm1.flush_page(page_id);
-        fm1.~FileManager(); // fm1
+        fm1.~FileManager(); // 销毁fm1
 
-        // 2. ڶȡ֤
+        // 2. 第二次启动：读取并验证数据
         FileManager fm2(test_dir, 2, ReplacePolicy::LRU);
         Page* read_page = fm2.read_page(page_id);
-        assert(read_page != nullptr && "8ʧܣҳȡʧ");
+        assert(read_page != nullptr && "测试8失败：页读取失败");
 
-        // ȡݲ֤
+        // 读取数据并验证
         char read_buf[1024] = { 0 };
         read_page->read_data(PAGE_HEADER_SIZE, read_buf, student_data.size());
-        assert(string(read_buf) == student_data && "8ʧܣ־ûԭݲһ");
+        assert(string(read_buf) == student_data && "测试8失败：持久化数据与原数据不一致");
 
-        cout << "ԭݣ" << student_data << endl;
-        cout << "ȡݣ" << read_buf << endl;
-        cout << "ݳ־û֤ɹ" << endl;
-        cout << "8ͨ" << endl << endl;
+        cout << "原数据：" << student_data << endl;
+        cout << "重启后读取的数据：" << read_buf << endl;
+        cout << "数据持久化验证成功" << endl;
+        cout << "测试8通过！" << endl << endl;
     }
     catch (const exception& e) {
-        cerr << "8ʧܣ" << e.what() << endl << endl;
+        cerr << "测试8失败：" << e.what() << endl << endl;
         delete_test_dir(test_dir);
         exit(1);
     }
@@ -423,56 +437,56 @@ void test_data_persistence() {
     delete_test_dir(test_dir);
 }
 
-// 9ģЭͬļ-ҳ-棩
+// 测试9：模块协同（文件-页-缓存）
 void test_module_coordination() {
-    cout << "=== 9ģЭͬļ-ҳ-棩 ===" << endl;
+    cout << "=== 测试9：模块协同（文件-页-缓存） ===" << endl;
     string test_dir = test_dir + "/test_db_files";
     delete_test_dir(test_dir);
 
     try {
-        FileManager fm(test_dir, 1, ReplacePolicy::LRU); // 1LRU
+        FileManager fm(test_dir, 1, ReplacePolicy::LRU); // 缓存容量1，LRU策略
         uint32_t page1_id = fm.allocate_page();
         uint32_t page2_id = fm.allocate_page();
 
-        // 1. дҳ1ݲҳ
+        // 1. 写页1数据并标记脏页
         Page page1(page1_id);
         string data1 = "Cache test data 1";
         page1.write_data(PAGE_HEADER_SIZE, data1.c_str(), data1.size());
         fm.write_page(page1_id, page1);
 
-        // 2. ҳ1УһζѼ뻺棩
+        // 2. 读页1：缓存命中（第一次读已加入缓存）
         Page* cache_page1 = fm.read_page(page1_id);
-        assert(cache_page1 != nullptr && "9ʧܣҳ1ȡʧ");
+        assert(cache_page1 != nullptr && "测试9失败：页1缓存读取失败");
 
-        // 3. ҳ2LRU滻ҳ1ҳ1ҳˢ̣
+        // 3. 读页2：缓存满，LRU替换页1（页1脏页刷盘）
         Page page2(page2_id);
         string data2 = "Cache test data 2";
         page2.write_data(PAGE_HEADER_SIZE, data2.c_str(), data2.size());
         fm.write_page(page2_id, page2);
         Page* cache_page2 = fm.read_page(page2_id);
-        assert(cache_page2 != nullptr && "9ʧܣҳ2ȡʧ");
+        assert(cache_page2 != nullptr && "测试9失败：页2缓存读取失败");
 
-        // 4. ֤ҳ1ˢ̣ļֱӶƹ棩
+        // 4. 验证页1已刷盘（从文件直接读，绕过缓存）
         PageManager& pm = const_cast<PageManager&>(fm.get_page_manager());
         Page disk_page1(page1_id);
         pm.read_page(page1_id, disk_page1);
         char disk_buf[1024] = { 0 };
         disk_page1.read_data(PAGE_HEADER_SIZE, disk_buf, data1.size());
-        assert(string(disk_buf) == data1 && "9ʧܣҳ1ҳδˢ");
+        assert(string(disk_buf) == data1 && "测试9失败：页1脏页未刷盘");
 
-        // 5. ֤ͳƣܷ3Σҳ12Σ1Σҳ21ΣδУ
+        // 5. 验证缓存统计（总访问3次：页1读2次（命中1次），页2读1次（未命中））
         uint32_t hit, miss;
         double hit_rate;
         fm.get_cache_stats(hit, miss, hit_rate);
-        assert(hit == 1 && miss == 2 && "9ʧܣͳƴ");
-        assert(hit_rate == 1.0 / 3 && "9ʧܣʴ");
+        assert(hit == 1 && miss == 2 && "测试9失败：缓存统计错误");
+        assert(hit_rate == 1.0 / 3 && "测试9失败：缓存命中率错误");
 
         fm.print_cache_stats();
-        cout << "ģЭͬļ-ҳ-棩֤ɹ" << endl;
-        cout << "9ͨ" << endl << endl;
+        cout << "模块协同（文件-页-缓存）验证成功" << endl;
+        cout << "测试9通过！" << endl << endl;
     }
     catch (const exception& e) {
-        cerr << "9ʧܣ" << e.what() << endl << endl;
+        cerr << "测试9失败：" << e.what() << endl << endl;
         delete_test_dir(test_dir);
         exit(1);
     }
@@ -480,21 +494,1986 @@ void test_module_coordination() {
     delete_test_dir(test_dir);
 }
 
+// 测试10：LRU命中后移到队头、CLOCK第二次机会
+void test_lru_clock_order() {
+    cout << "=== 测试10：LRU命中顺序与CLOCK策略 ===" << endl;
+    string log_path = test_dir + "/cache_log_clock.txt";
+
+    try {
+        PageManager pm(data_path);
+        uint32_t p1 = pm.allocate_page();
+        uint32_t p2 = pm.allocate_page();
+        uint32_t p3 = pm.allocate_page();
+
+        // 1. LRU：访问 1 → 2 → 1(命中) → 3，应替换页2而不是页1
+        {
+            CacheManager cm(pm, 2, ReplacePolicy::LRU, log_path);
+            cm.get_page(p1);
+            cm.get_page(p2);
+            cm.get_page(p1);
+            cm.get_page(p3);
+            assert(cm.contains(p1) && "测试10失败：LRU不应替换刚命中的页1");
+            assert(!cm.contains(p2) && "测试10失败：LRU应替换最久未使用的页2");
+            assert(cm.contains(p3) && "测试10失败：页3应在缓存中");
+        }
+
+        // 2. CLOCK：访问 1 → 2 → 1(命中，置引用位) → 3，页1获得第二次机会，替换页2
+        {
+            CacheManager cm(pm, 2, ReplacePolicy::CLOCK, log_path);
+            cm.get_page(p1);
+            cm.get_page(p2);
+            cm.get_page(p1);
+            cm.get_page(p3);
+            assert(cm.contains(p1) && "测试10失败：CLOCK应给引用位为1的页1第二次机会");
+            assert(!cm.contains(p2) && "测试10失败：CLOCK应替换引用位为0的页2");
+            assert(cm.contains(p3) && "测试10失败：页3应在缓存中");
+
+            // 再访问页2：页1的引用位已被指针清零，页1被替换
+            cm.get_page(p2);
+            assert(!cm.contains(p1) && "测试10失败：CLOCK第二轮应替换页1");
+            assert(cm.get_current_size() == 2 && "测试10失败：缓存大小错误");
+
+            uint32_t hit, miss;
+            double hit_rate;
+            cm.get_cache_stats(hit, miss, hit_rate);
+            assert(hit == 1 && miss == 4 && "测试10失败：CLOCK缓存统计错误");
+        }
+
+        cout << "LRU命中顺序与CLOCK策略验证成功" << endl;
+        cout << "测试10通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试10失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试11：缓存事件日志（级别过滤、采样、轮转）
+void test_event_log() {
+    cout << "=== 测试11：缓存事件日志 ===" << endl;
+    string log_path = test_dir + "/event_log.txt";
+    remove(log_path.c_str());
+    remove((log_path + ".1").c_str());
+
+    // 统计日志文件中包含指定内容的行数
+    auto count_lines = [](const string& path, const string& pattern) {
+        ifstream in(path);
+        string line;
+        uint32_t n = 0;
+        while (getline(in, line)) {
+            if (line.find(pattern) != string::npos) n++;
+        }
+        return n;
+    };
+
+    try {
+        PageManager pm(data_path);
+        uint32_t p1 = pm.allocate_page();
+        uint32_t p2 = pm.allocate_page();
+
+        // 1. 默认级别EVICTIONS：不记录命中，记录替换
+        {
+            CacheManager cm(pm, 1, ReplacePolicy::LRU, log_path);
+            cm.get_page(p1);
+            cm.get_page(p1);
+            cm.get_page(p2);
+            cm.get_event_log().flush();
+            assert(count_lines(log_path, "Cache hit") == 0 && "测试11失败：EVICTIONS级别不应记录命中");
+            assert(count_lines(log_path, "LRU evict: page") == 1 && "测试11失败：应记录一次替换");
+        }
+
+        // 2. ALL级别+采样率4：8次命中只记录2条
+        remove(log_path.c_str());
+        {
+            CacheManager cm(pm, 2, ReplacePolicy::LRU, log_path, LogLevel::ALL, 4);
+            cm.get_page(p1);
+            cm.get_page(p2);
+            cm.get_event_log().set_sample_rate(1);
+            cm.get_page(p1);
+            cm.get_event_log().set_sample_rate(4);
+            for (int i = 0; i < 8; ++i) cm.get_page(p1);
+        }
+        assert(count_lines(log_path, "Cache hit") == 1 + 2 && "测试11失败：采样率未生效");
+
+        // 3. OFF级别：不写任何事件
+        remove(log_path.c_str());
+        {
+            CacheManager cm(pm, 1, ReplacePolicy::FIFO, log_path, LogLevel::OFF);
+            cm.get_page(p1);
+            cm.get_page(p2);
+        }
+        assert(count_lines(log_path, "evict") == 0 && "测试11失败：OFF级别不应写日志");
+
+        // 4. 轮转：超过阈值后旧日志改名为.1
+        remove(log_path.c_str());
+        {
+            CacheManager cm(pm, 1, ReplacePolicy::LRU, log_path, LogLevel::ALL);
+            cm.get_event_log().set_max_file_size(512);
+            for (int i = 0; i < 50; ++i) cm.get_page(i % 2 ? p1 : p2);
+        }
+        assert(file_exists(log_path + ".1") && "测试11失败：日志未轮转");
+
+        cout << "缓存事件日志验证成功" << endl;
+        cout << "测试11通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试11失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试12：内存映射模式（零拷贝视图、扩展后重新映射、关闭后截回实际大小）
+void test_mmap_mode() {
+    cout << "=== 测试12：内存映射模式 ===" << endl;
+    string mmap_path = test_dir + "/data_mmap.dat";
+    remove(mmap_path.c_str());
+
+    try {
+        uint32_t page1_id, far_page_id;
+        string data1 = "mmap page data";
+        {
+            PageManager pm(mmap_path, IoMode::MMAP);
+            page1_id = pm.allocate_page();
+            Page page1(page1_id);
+            page1.write_data(PAGE_HEADER_SIZE, data1.c_str(), data1.size());
+            page1.set_free_offset(PAGE_HEADER_SIZE + data1.size());
+            assert(pm.write_page(page1_id, page1) && "测试12失败：映射模式写页失败");
+
+            // 视图直接指向映射，包含页头
+            const char* view = pm.page_view(page1_id);
+            assert(view != nullptr && "测试12失败：映射模式应返回页视图");
+            assert(string(view + PAGE_HEADER_SIZE, data1.size()) == data1 && "测试12失败：页视图数据错误");
+            assert(Page::view_free_offset(view) == PAGE_HEADER_SIZE + data1.size() && "测试12失败：页视图页头错误");
+
+            // 写到第一个映射块之外：触发扩展与重新映射
+            far_page_id = static_cast<uint32_t>(MMAP_GROW_CHUNK / DEFAULT_PAGE_SIZE) + 10;
+            Page far_page(far_page_id);
+            assert(pm.write_page(far_page_id, far_page) && "测试12失败：扩展映射失败");
+            assert(pm.page_view(page1_id) != nullptr && "测试12失败：重新映射后视图失效");
+            assert(pm.page_view(far_page_id + 1) == nullptr && "测试12失败：越界页不应返回视图");
+            assert(pm.sync() && "测试12失败：msync失败");
+        }
+
+        // 关闭后文件大小应为实际数据大小，而非映射块大小；STREAM模式可读出相同数据
+        PageManager pm(mmap_path);
+        assert(pm.get_file_size() == static_cast<uint64_t>(far_page_id) * DEFAULT_PAGE_SIZE && "测试12失败：文件未截回实际大小");
+        assert(pm.page_view(page1_id) == nullptr && "测试12失败：STREAM模式不应返回页视图");
+        Page read_back(page1_id);
+        assert(pm.read_page(page1_id, read_back) && "测试12失败：STREAM模式读页失败");
+        char buf[64] = { 0 };
+        read_back.read_data(PAGE_HEADER_SIZE, buf, data1.size());
+        assert(string(buf) == data1 && "测试12失败：映射模式写入的数据丢失");
+
+        cout << "内存映射模式验证成功" << endl;
+        cout << "测试12通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试12失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+    remove(mmap_path.c_str());
+}
+
+// 测试13：槽页记录（插入、删除、原地更新、压缩后槽号不变）
+void test_slotted_page() {
+    cout << "=== 测试13：槽页记录操作 ===" << endl;
+
+    try {
+        Page page(1);
+        const char* rec = nullptr;
+        uint32_t len = 0;
+
+        // 1. 插入三条记录，槽号依次为0、1、2
+        string r0 = "1,Alice,20", r1 = "2,Bob,21", r2 = "3,Carol,22";
+        uint16_t s0, s1, s2;
+        assert(page.insert_record(r0.data(), r0.size(), s0) && s0 == 0 && "测试13失败：插入记录0失败");
+        assert(page.insert_record(r1.data(), r1.size(), s1) && s1 == 1 && "测试13失败：插入记录1失败");
+        assert(page.insert_record(r2.data(), r2.size(), s2) && s2 == 2 && "测试13失败：插入记录2失败");
+        assert(page.get_slot_count() == 3 && "测试13失败：槽数量错误");
+        assert(page.get_free_offset() == PAGE_HEADER_SIZE + 3 * SLOT_SIZE && "测试13失败：槽数组末尾错误");
+
+        // 2. 删除记录1：只打墓碑，其他记录不受影响
+        assert(page.delete_record(s1) && "测试13失败：删除记录失败");
+        assert(!page.get_record(s1, rec, len) && "测试13失败：已删除记录不应可读");
+        assert(page.get_record(s2, rec, len) && string(rec, len) == r2 && "测试13失败：删除影响了其他记录");
+
+        // 3. 原地更新：变短直接覆盖，变长在页内重新放置，槽号不变
+        string r0_short = "1,Al,20";
+        assert(page.update_record(s0, r0_short.data(), r0_short.size()) && "测试13失败：变短更新失败");
+        string r2_long = "3,Caroline-with-a-much-longer-name,22";
+        assert(page.update_record(s2, r2_long.data(), r2_long.size()) && "测试13失败：变长更新失败");
+        assert(page.get_record(s0, rec, len) && string(rec, len) == r0_short && "测试13失败：更新后记录0错误");
+        assert(page.get_record(s2, rec, len) && string(rec, len) == r2_long && "测试13失败：更新后记录2错误");
+
+        // 4. 新插入复用墓碑槽
+        string r3 = "4,Dave,23";
+        uint16_t s3;
+        assert(page.insert_record(r3.data(), r3.size(), s3) && s3 == s1 && "测试13失败：未复用墓碑槽");
+
+        // 5. 填满页：连续空间不足时自动压缩，最终空间耗尽返回false
+        string filler(100, 'f');
+        uint16_t fs;
+        uint32_t inserted = 0;
+        while (page.insert_record(filler.data(), filler.size(), fs)) inserted++;
+        assert(inserted > 0 && page.reclaimable_space() < filler.size() + SLOT_SIZE && "测试13失败：页未被填满");
+
+        // 删除一部分后压缩，回收的空间可以再次插入，存活记录与槽号保持不变
+        for (uint16_t i = 4; i < page.get_slot_count(); i += 2) page.delete_record(i);
+        page.compact();
+        assert(page.contiguous_free_space() == page.reclaimable_space() && "测试13失败：压缩后空间仍不连续");
+        assert(page.insert_record(filler.data(), filler.size(), fs) && fs == 4 && "测试13失败：压缩后插入失败");
+        assert(page.get_record(s0, rec, len) && string(rec, len) == r0_short && "测试13失败：压缩后记录0错误");
+        assert(page.get_record(s2, rec, len) && string(rec, len) == r2_long && "测试13失败：压缩后记录2错误");
+
+        cout << "槽页记录操作验证成功" << endl;
+        cout << "测试13通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试13失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试14：空闲空间映射（按档位找页、删除后空间可复用、重新加载后档位不变、释放FSM页）
+void test_free_space_map() {
+    cout << "=== 测试14：空闲空间映射 ===" << endl;
+    string fsm_dir = test_dir + "/fsm_db";
+    delete_test_dir(fsm_dir);
+
+    try {
+        uint32_t fsm_first = INVALID_PAGE_ID;
+        uint32_t full_pid, half_pid;
+        {
+            FileManager fm(fsm_dir, 16, ReplacePolicy::LRU);
+            FreeSpaceMap fsm(fm);
+            assert(fsm.find_page(10) == INVALID_PAGE_ID && "测试14失败：空映射不应返回页");
+
+            // 一页几乎写满，一页写一半
+            full_pid = fm.allocate_page();
+            half_pid = fm.allocate_page();
+            Page* full = fm.read_page(full_pid);
+            string rec(200, 'r');
+            uint16_t slot;
+            while (full->insert_record(rec.data(), rec.size(), slot)) {}
+            fm.write_page(full_pid, *full);
+            assert(fsm.update(full_pid, fm.read_page(full_pid)->reclaimable_space()) && "测试14失败：登记满页失败");
+            Page* half = fm.read_page(half_pid);
+            for (int i = 0; i < 10; ++i) half->insert_record(rec.data(), rec.size(), slot);
+            fm.write_page(half_pid, *half);
+            assert(fsm.update(half_pid, fm.read_page(half_pid)->reclaimable_space()) && "测试14失败：登记半满页失败");
+
+            // 放得下的记录落到半满页，满页放不下
+            assert(fsm.find_page(200) == half_pid && "测试14失败：应选择有空间的页");
+            assert(fsm.find_page(DEFAULT_PAGE_SIZE) == INVALID_PAGE_ID && "测试14失败：超大记录不应有可用页");
+
+            // 档位只会低估空间：选中的页一定放得下
+            uint32_t need = 1000;
+            uint32_t pid = fsm.find_page(need);
+            assert(pid != INVALID_PAGE_ID && fm.read_page(pid)->reclaimable_space() >= need + SLOT_SIZE && "测试14失败：档位高估了空间");
+
+            // 满页删除记录后空间可复用
+            full = fm.read_page(full_pid);
+            for (uint16_t i = 0; i < 15; ++i) full->delete_record(i);
+            fm.write_page(full_pid, *full);
+            fsm.update(full_pid, fm.read_page(full_pid)->reclaimable_space());
+            assert(fsm.find_page(2500) == full_pid && "测试14失败：删除腾出的空间未被登记");
+
+            // 大量数据页：跨越多个FSM页
+            for (uint32_t i = 0; i < FSM_ENTRIES_PER_PAGE + 10; ++i) {
+                fsm.update(100000 + i, 0);
+            }
+            assert(fsm.size() == FSM_ENTRIES_PER_PAGE + 12 && "测试14失败：登记页数错误");
+            fsm_first = fsm.get_first_page_id();
+        }
+
+        // 重新打开后从FSM页链加载，档位与之前一致
+        FileManager fm(fsm_dir, 16, ReplacePolicy::LRU);
+        FreeSpaceMap fsm(fm, fsm_first);
+        assert(fsm.load() && "测试14失败：加载FSM失败");
+        assert(fsm.size() == FSM_ENTRIES_PER_PAGE + 12 && "测试14失败：重新加载后页数错误");
+        uint8_t category = 0;
+        assert(fsm.get_category(half_pid, category) && category == FreeSpaceMap::category_of(fm.read_page(half_pid)->reclaimable_space(), fm.get_page_size()) && "测试14失败：重新加载后档位错误");
+        assert(fsm.find_page(2500) == full_pid && "测试14失败：重新加载后查找错误");
+
+        // 释放后为空映射，FSM页回到空闲列表
+        size_t free_before = fm.get_page_manager().get_free_page_count();
+        fsm.release();
+        assert(fsm.size() == 0 && fsm.get_first_page_id() == INVALID_PAGE_ID && "测试14失败：释放后映射应为空");
+        assert(fm.get_page_manager().get_free_page_count() == free_before + 2 && "测试14失败：FSM页未释放");
+
+        cout << "空闲空间映射验证成功" << endl;
+        cout << "测试14通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试14失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+
+// 测试15：空闲页位图（首次适配、连续段分配、重复释放检测、位图页持久化）
+void test_free_page_bitmap() {
+    cout << "=== 测试15：空闲页位图 ===" << endl;
+    string bitmap_dir = test_dir + "/bitmap_db";
+    delete_test_dir(bitmap_dir);
+
+    try {
+        // 纯内存位图：跨越多个位图页的首次适配与连续段查找
+        FreePageBitmap bitmap;
+        assert(bitmap.find_first() == INVALID_PAGE_ID && "测试15失败：空位图不应有空闲页");
+        bitmap.set_free(BITMAP_BITS_PER_PAGE + 70);
+        bitmap.set_free(5);
+        assert(bitmap.find_first() == 5 && "测试15失败：首次适配应返回最小页号");
+        for (uint32_t pid = 2 * BITMAP_BITS_PER_PAGE - 100; pid < 2 * BITMAP_BITS_PER_PAGE + 100; ++pid) {
+            bitmap.set_free(pid);
+        }
+        assert(bitmap.chunk_count() == 3 && "测试15失败：位图应覆盖3个位图页");
+        assert(bitmap.find_run(150) == 2 * BITMAP_BITS_PER_PAGE - 100 && "测试15失败：跨位图页的连续段查找错误");
+        assert(bitmap.find_run(201) == INVALID_PAGE_ID && "测试15失败：不应找到超长连续段");
+        bitmap.set_used(5);
+        assert(bitmap.find_first() == BITMAP_BITS_PER_PAGE + 70 && "测试15失败：占用后摘要未更新");
+        assert(bitmap.get_free_count() == 201 && "测试15失败：空闲页计数错误");
+
+        uint32_t run_first;
+        {
+            FileManager fm(bitmap_dir, 16, ReplacePolicy::LRU);
+            vector<uint32_t> pages;
+            for (int i = 0; i < 100; ++i) pages.push_back(fm.allocate_page());
+
+            // 释放一个单页和一段连续页，重复释放应被拒绝
+            assert(fm.free_page(pages[70]) && "测试15失败：释放页失败");
+            assert(!fm.free_page(pages[70]) && "测试15失败：重复释放未被拒绝");
+            for (int i = 20; i < 30; ++i) fm.free_page(pages[i]);
+            assert(fm.get_page_manager().get_free_page_count() == 11 && "测试15失败：空闲页数错误");
+            assert(fm.get_page_manager().get_bitmap_pages().size() == 1 && "测试15失败：应分配一个位图页");
+            run_first = pages[20];
+        }
+
+        // 重新打开：空闲页从位图页恢复
+        FileManager fm(bitmap_dir, 16, ReplacePolicy::LRU);
+        assert(fm.get_page_manager().get_free_page_count() == 11 && "测试15失败：重新加载后空闲页数错误");
+        assert(fm.get_page_manager().is_page_free(run_first) && "测试15失败：重新加载后空闲位丢失");
+
+        // 连续段分配复用释放的10页；单页分配复用剩下的空闲页
+        PageManager& pm = const_cast<PageManager&>(fm.get_page_manager());
+        assert(pm.allocate_run(10) == run_first && "测试15失败：连续段未复用");
+        uint32_t reused = fm.allocate_page();
+        assert(fm.get_page_manager().get_free_page_count() == 0 && reused != INVALID_PAGE_ID && "测试15失败：单页未复用空闲页");
+        Page* page = fm.read_page(run_first + 9);
+        assert(page && page->get_page_id() == run_first + 9 && page->get_slot_count() == 0 && "测试15失败：连续段页未初始化");
+
+        // 没有足够长的空闲段时在文件末尾扩展
+        uint32_t next = fm.get_page_manager().get_next_page_id();
+        assert(pm.allocate_run(5) == next && fm.get_page_manager().get_next_page_id() == next + 5 && "测试15失败：文件末尾扩展错误");
+
+        cout << "空闲页位图验证成功" << endl;
+        cout << "测试15通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试15失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试16：批量分配与按区段扩展数据文件
+void test_batch_allocate() {
+    cout << "=== 测试16：批量分配与区段扩展 ===" << endl;
+    string extent_dir = test_dir + "/extent_db";
+    delete_test_dir(extent_dir);
+
+    try {
+        FileManager fm(extent_dir, 16, ReplacePolicy::LRU);
+        fm.set_extent_pages(32);
+        const PageManager& pm = fm.get_page_manager();
+
+        // 第一页即按区段扩展，之后区段内的新页不再扩展文件
+        uint32_t first = fm.allocate_page();
+        assert(pm.get_file_size() == 32ull * DEFAULT_PAGE_SIZE && "测试16失败：文件应按区段扩展");
+        vector<uint32_t> pages = fm.allocate_pages(20);
+        assert(pages.size() == 20 && pages.front() == first + 1 && pages.back() == first + 20 && "测试16失败：新页应连续分配");
+        assert(pm.get_file_size() == 32ull * DEFAULT_PAGE_SIZE && "测试16失败：区段内分配不应扩展文件");
+
+        // 预扩展出的页读出为空页
+        Page* page = fm.read_page(pages.back());
+        assert(page && page->get_page_id() == pages.back() && page->get_slot_count() == 0 && "测试16失败：新页应为空页");
+
+        // 先复用空闲页，不足部分在文件末尾分配，跨区段时一次扩展到位
+        fm.free_page(pages[3]);
+        fm.free_page(pages[7]);
+        uint32_t next = pm.get_next_page_id();
+        vector<uint32_t> more = fm.allocate_pages(100);
+        assert(more[0] == pages[3] && more[1] == pages[7] && more[2] == next && "测试16失败：应先复用空闲页");
+        assert(pm.get_file_size() == ((more.back() + 31) / 32) * 32ull * DEFAULT_PAGE_SIZE && "测试16失败：跨区段扩展大小错误");
+
+        cout << "批量分配与区段扩展验证成功" << endl;
+        cout << "测试16通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试16失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试17：页守卫（固定的页不被替换，写守卫自动标脏）
+void test_page_guard() {
+    cout << "=== 测试17：页守卫 ===" << endl;
+    string guard_path = test_dir + "/guard.dat";
+    remove(guard_path.c_str());
+
+    try {
+        for (ReplacePolicy policy : { ReplacePolicy::LRU, ReplacePolicy::FIFO, ReplacePolicy::CLOCK }) {
+            PageManager pm(guard_path);
+            CacheManager cm(pm, 2, policy, test_dir + "/cache_log_guard.txt");
+            vector<uint32_t> pages = pm.allocate_pages(5);
+
+            {
+                // 固定页1后连续访问其他页：页1一直留在缓存中，指针保持有效
+                ReadPageGuard guard(cm, pages[0]);
+                assert(guard && cm.get_pin_count(pages[0]) == 1 && "测试17失败：固定计数错误");
+                for (int i = 1; i < 5; ++i) cm.get_page(pages[i]);
+                assert(cm.peek_page(pages[0]) == guard.get() && "测试17失败：固定的页被替换");
+
+                // 所有页都被固定时缓存暂时超出容量
+                WritePageGuard w1(cm, pages[1]);
+                WritePageGuard w2(cm, pages[2]);
+                assert(w1 && w2 && cm.get_current_size() == 3 && "测试17失败：固定页应允许缓存暂时超出容量");
+
+                // 写守卫释放后自动标脏
+                string rec = "guarded";
+                uint16_t slot;
+                assert(w1->insert_record(rec.data(), static_cast<uint32_t>(rec.size()), slot) && "测试17失败：写入记录失败");
+                WritePageGuard moved = std::move(w1);
+                assert(!w1 && moved && cm.get_pin_count(pages[1]) == 1 && "测试17失败：移动守卫后固定计数错误");
+                moved.release();
+                assert(cm.get_pin_count(pages[1]) == 0 && cm.is_dirty(pages[1]) && "测试17失败：写守卫未标脏");
+            }
+            assert(cm.get_pin_count(pages[0]) == 0 && cm.get_pin_count(pages[2]) == 0 && "测试17失败：守卫析构未解除固定");
+
+            // 解除固定后恢复正常替换，缓存回到容量以内
+            cm.get_page(pages[3]);
+            cm.get_page(pages[4]);
+            assert(cm.get_current_size() <= 2 && "测试17失败：解除固定后缓存未回到容量以内");
+
+            // 脏页在替换时刷盘：重新读出记录
+            cm.flush_all();
+            Page disk_page;
+            const char* rec_data = nullptr;
+            uint32_t len = 0;
+            assert(pm.read_page(pages[1], disk_page) && disk_page.get_record(0, rec_data, len) &&
+                string(rec_data, len) == "guarded" && "测试17失败：写守卫的修改未落盘");
+        }
+
+        cout << "页守卫验证成功" << endl;
+        cout << "测试17通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试17失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试18：分片缓存与并发读写（多线程经页守卫访问，缓存容量小于页数以触发并发替换）
+void test_sharded_cache() {
+    cout << "=== 测试18：分片缓存并发访问 ===" << endl;
+    string shard_path = test_dir + "/shard.dat";
+    remove(shard_path.c_str());
+
+    try {
+        PageManager pm(shard_path);
+        // 每个分片至少CACHE_MIN_FRAMES_PER_SHARD帧：容量128时最多2个分片
+        {
+            CacheManager small(pm, 128, ReplacePolicy::LRU, test_dir + "/cache_log_shard.txt", LogLevel::OFF, 1, 8);
+            assert(small.get_shard_count() == 2 && "测试18失败：分片数未按容量限制");
+        }
+
+        for (ReplacePolicy policy : { ReplacePolicy::LRU, ReplacePolicy::FIFO, ReplacePolicy::CLOCK }) {
+            CacheManager cm(pm, 256, policy, test_dir + "/cache_log_shard.txt", LogLevel::OFF, 1, 4);
+            assert(cm.get_shard_count() == 4 && "测试18失败：分片数错误");
+            vector<uint32_t> pages = pm.allocate_pages(1024);
+
+            // 1. 4个线程各写入1/4的页，每页一条记录（内容为页号）
+            const int thread_count = 4;
+            atomic<int> failures(0);
+            vector<thread> workers;
+            for (int t = 0; t < thread_count; ++t) {
+                workers.emplace_back([&, t]() {
+                    for (size_t i = t; i < pages.size(); i += thread_count) {
+                        WritePageGuard w(cm, pages[i]);
+                        uint16_t slot;
+                        string rec = to_string(pages[i]);
+                        if (!w || !w->insert_record(rec.data(), static_cast<uint32_t>(rec.size()), slot)) ++failures;
+                    }
+                });
+            }
+            for (auto& worker : workers) worker.join();
+            workers.clear();
+            assert(failures == 0 && "测试18失败：并发写入失败");
+
+            // 2. 4个线程同时读取全部页：每页内容都应与页号一致（被替换的脏页已刷盘）
+            for (int t = 0; t < thread_count; ++t) {
+                workers.emplace_back([&]() {
+                    for (uint32_t pid : pages) {
+                        ReadPageGuard r(cm, pid);
+                        const char* data = nullptr;
+                        uint32_t len = 0;
+                        if (!r || !r->get_record(0, data, len) || string(data, len) != to_string(pid)) ++failures;
+                    }
+                });
+            }
+            for (auto& worker : workers) worker.join();
+            assert(failures == 0 && "测试18失败：并发读取内容错误");
+            assert(cm.get_current_size() <= 256 && "测试18失败：缓存超出容量");
+            for (uint32_t pid : pages) {
+                assert(cm.get_pin_count(pid) == 0 && "测试18失败：固定计数未归零");
+            }
+            cm.flush_all();
+            for (uint32_t pid : pages) pm.free_page(pid);
+        }
+
+        cout << "分片缓存并发访问验证成功" << endl;
+        cout << "测试18通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试18失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试19：后台写回与检查点（按脏页年龄/比例写回，检查点后重新打开数据完整）
+void test_background_writer() {
+    cout << "=== 测试19：后台写回与检查点 ===" << endl;
+    string writer_path = test_dir + "/bgwriter.dat";
+    remove(writer_path.c_str());
+
+    try {
+        PageManager pm(writer_path);
+        CacheManager cm(pm, 64, ReplacePolicy::LRU, test_dir + "/cache_log_bgwriter.txt");
+        vector<uint32_t> pages = pm.allocate_pages(40);
+        for (uint32_t pid : pages) {
+            WritePageGuard w(cm, pid);
+            uint16_t slot;
+            string rec = "bg" + to_string(pid);
+            w->insert_record(rec.data(), static_cast<uint32_t>(rec.size()), slot);
+        }
+        assert(cm.get_dirty_count() == 40 && "测试19失败：脏页数错误");
+
+        // 1. 脏页比例超过阈值：按替换顺序写回到比例以内（脏页都还很“年轻”）
+        uint32_t written = cm.write_dirty_pages(0.25, 60000, 1000);
+        assert(written == 24 && cm.get_dirty_count() == 16 && "测试19失败：按脏页比例写回数量错误");
+        // LRU队尾（最早写入的页）先被写回
+        assert(!cm.is_dirty(pages[0]) && cm.is_dirty(pages.back()) && "测试19失败：应先写回即将被替换的页");
+
+        // 2. 每轮写回数量受上限约束；年龄达到阈值的页全部写回
+        assert(cm.write_dirty_pages(0.25, 0, 5) == 5 && "测试19失败：每轮写回上限无效");
+        // 3. 后台线程：年龄阈值为0时很快写回全部脏页
+        cm.start_background_writer(5, 0.25, 0, 64);
+        assert(cm.is_background_writer_running() && "测试19失败：后台写线程未启动");
+        for (int i = 0; i < 400 && cm.get_dirty_count() > 0; ++i) {
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+        cm.stop_background_writer();
+        assert(cm.get_dirty_count() == 0 && !cm.is_background_writer_running() && "测试19失败：后台写线程未写回脏页");
+        for (uint32_t pid : pages) {
+            Page disk_page;
+            const char* data = nullptr;
+            uint32_t len = 0;
+            assert(pm.read_page(pid, disk_page) && disk_page.get_record(0, data, len) &&
+                string(data, len) == "bg" + to_string(pid) && "测试19失败：写回内容错误");
+        }
+
+        // 4. 检查点：写页只标脏，检查点后元数据替换完成，重新打开后数据与空闲页都在
+        string ckpt_dir = test_dir + "/checkpoint_db";
+        delete_test_dir(ckpt_dir);
+        uint32_t pid, freed;
+        string meta_path;
+        {
+            FileManager fm(ckpt_dir, 16, ReplacePolicy::LRU);
+            pid = fm.allocate_page();
+            freed = fm.allocate_page();
+            fm.free_page(freed);
+            {
+                WritePageGuard w = fm.write_page_guard(pid);
+                uint16_t slot;
+                w->insert_record("checkpoint", 10, slot);
+            }
+            assert(fm.checkpoint() && "测试19失败：检查点失败");
+            meta_path = fm.get_meta_file_path();
+            ifstream tmp(meta_path + ".tmp");
+            assert(!tmp && "测试19失败：检查点后不应留下临时元数据文件");
+        }
+        {
+            FileManager fm(ckpt_dir, 16, ReplacePolicy::LRU);
+            Page* page = fm.read_page(pid);
+            const char* data = nullptr;
+            uint32_t len = 0;
+            assert(page && page->get_record(0, data, len) && string(data, len) == "checkpoint" && "测试19失败：检查点后数据丢失");
+            assert(fm.get_page_manager().is_page_free(freed) && "测试19失败：检查点后空闲页丢失");
+        }
+
+        cout << "后台写回与检查点验证成功" << endl;
+        cout << "测试19通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试19失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试20：写前日志与组提交
+void test_wal() {
+    cout << "=== 测试20：写前日志与组提交 ===" << endl;
+    string wal_dir = test_dir + "/wal_db";
+    delete_test_dir(wal_dir);
+
+    try {
+        create_test_dir(wal_dir);
+        uint64_t end_lsn;
+        {
+            // 1. 追加与扫描：记录按顺序读回，LSN为记录结束位置
+            WalManager wal(wal_dir);
+            assert(wal.open(0) && wal.get_current_lsn() == 0 && "测试20失败：打开空日志失败");
+            uint64_t lsn1 = wal.append(WalRecordType::PAGE_ALLOC, 7);
+            uint64_t lsn2 = wal.append(WalRecordType::PAGE_FREE, 8, "xyz", 3);
+            assert(lsn1 == WAL_RECORD_HEADER_SIZE && lsn2 == lsn1 + WAL_RECORD_HEADER_SIZE + 3 && "测试20失败：LSN错误");
+            assert(wal.commit() && wal.get_flushed_lsn() == wal.get_current_lsn() && "测试20失败：同步提交未持久化日志");
+
+            // 2. 页差异：相近的修改合并为一段，页LSN字段不参与比较；应用差异后得到修改后的页
+            char before[DEFAULT_PAGE_SIZE] = { 0 };
+            char after[DEFAULT_PAGE_SIZE] = { 0 };
+            after[100] = 1;
+            after[105] = 2;
+            after[PAGE_LSN_OFFSET] = 9;
+            assert(wal.log_page_changes(3, before, before) == 0 && "测试20失败：页未修改时不应记录日志");
+            uint64_t lsn3 = wal.log_page_changes(3, before, after);
+            assert(lsn3 == wal.get_current_lsn() && wal.flush(lsn3) && "测试20失败：页差异记录LSN错误");
+            after[PAGE_LSN_OFFSET] = 0;
+            vector<WalRecord> records;
+            vector<string> payloads;
+            uint64_t end = wal.scan(0, [&](const WalRecord& rec) {
+                records.push_back(rec);
+                payloads.emplace_back(rec.payload, rec.payload_len);
+                return true;
+            });
+            assert(end == lsn3 && records.size() == 4 && "测试20失败：扫描记录数错误");
+            assert(records[0].type == WalRecordType::PAGE_ALLOC && records[0].page_id == 7 && records[0].lsn == lsn1 &&
+                records[1].type == WalRecordType::PAGE_FREE && payloads[1] == "xyz" &&
+                records[2].type == WalRecordType::COMMIT && "测试20失败：扫描记录内容错误");
+            assert(records[3].type == WalRecordType::PAGE_DELTA && payloads[3].size() == 4 + 6 && "测试20失败：相近修改未合并");
+            char redo[DEFAULT_PAGE_SIZE] = { 0 };
+            assert(WalManager::apply_page_delta(redo, DEFAULT_PAGE_SIZE, payloads[3].data(), (uint32_t)payloads[3].size()) &&
+                memcmp(redo, after, DEFAULT_PAGE_SIZE) == 0 && "测试20失败：应用页差异结果错误");
+
+            // 3. 组提交：多个线程并发同步提交，一次写出+同步覆盖多个提交
+            wal.set_commit_delay(1000);
+            uint64_t flushes_before = wal.get_flush_count();
+            vector<thread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([&wal]() {
+                    for (int i = 0; i < 25; ++i) wal.commit();
+                });
+            }
+            for (auto& th : threads) th.join();
+            uint64_t flushes = wal.get_flush_count() - flushes_before;
+            assert(wal.get_commit_count() == 101 && flushes > 0 && flushes < 100 && "测试20失败：并发提交未合并写出");
+            assert(wal.get_flushed_lsn() == wal.get_current_lsn() && "测试20失败：组提交后日志未全部持久化");
+            end_lsn = wal.get_current_lsn();
+        }
+        {
+            // 4. 日志末尾写了一半的记录（崩溃）：重新打开时截掉，新记录接在有效末尾之后
+            ofstream seg(wal_dir + "\\wal_00000000.log", ios::out | ios::binary | ios::app);
+            seg.write("\x40\x00\x00\x00torn", 8);
+        }
+        {
+            WalManager wal(wal_dir);
+            assert(wal.open(0) && wal.get_current_lsn() == end_lsn && "测试20失败：未截掉残缺的日志末尾");
+            uint64_t lsn = wal.append(WalRecordType::COMMIT, 0);
+            assert(wal.flush(lsn) && wal.scan(0, nullptr) == lsn && "测试20失败：截断后追加的记录无法读回");
+        }
+
+        // 5. FileManager：写守卫修改页时记日志并更新页LSN；检查点LSN写入meta.dat
+        string fm_dir = test_dir + "/wal_fm_db";
+        delete_test_dir(fm_dir);
+        uint32_t pid;
+        uint64_t ckpt_lsn;
+        {
+            FileManager fm(fm_dir, 16, ReplacePolicy::LRU);
+            pid = fm.allocate_page();
+            uint64_t alloc_lsn = fm.read_page(pid)->get_lsn();
+            assert(alloc_lsn > 0 && "测试20失败：分配页未记日志");
+            {
+                WritePageGuard w = fm.write_page_guard(pid);
+                uint16_t slot;
+                w->insert_record("wal", 3, slot);
+            }
+            uint64_t page_lsn = fm.read_page(pid)->get_lsn();
+            assert(page_lsn > alloc_lsn && page_lsn == fm.get_wal().get_current_lsn() && "测试20失败：页LSN未更新");
+            assert(fm.commit() && fm.get_wal().get_flushed_lsn() >= page_lsn && "测试20失败：提交未持久化日志");
+            assert(fm.checkpoint() && fm.get_checkpoint_lsn() >= page_lsn && "测试20失败：检查点LSN错误");
+            ckpt_lsn = fm.get_checkpoint_lsn();
+        }
+        {
+            FileManager fm(fm_dir, 16, ReplacePolicy::LRU);
+            // 析构时又做了一次检查点：重做起点只会前移，其后是该检查点的记录
+            assert(fm.get_checkpoint_lsn() >= ckpt_lsn && "测试20失败：检查点LSN未持久化");
+            assert(fm.get_wal().get_current_lsn() > fm.get_checkpoint_lsn() && "测试20失败：重新打开后日志末尾错误");
+            const char* data = nullptr;
+            uint32_t len = 0;
+            Page* page = fm.read_page(pid);
+            assert(page && page->get_record(0, data, len) && string(data, len) == "wal" && "测试20失败：数据丢失");
+        }
+
+        cout << "写前日志与组提交验证成功" << endl;
+        cout << "测试20通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试20失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试21：崩溃恢复（从检查点重做日志，串行与按页号分区的并行重做）
+void test_crash_recovery() {
+    cout << "=== 测试21：崩溃恢复 ===" << endl;
+    string src_dir = test_dir + "/recovery_db";
+    delete_test_dir(src_dir);
+
+    try {
+        auto record_of = [](uint32_t pid) { return "rec" + to_string(pid); };
+        vector<uint32_t> pages;
+        vector<uint32_t> freed;
+        uint32_t reused;
+        {
+            // 缓存小于页数：一部分页被换出写回（磁盘上已是新内容），其余只在日志中
+            FileManager fm(src_dir, 16, ReplacePolicy::LRU);
+            pages = fm.allocate_pages(40);
+            for (uint32_t pid : pages) {
+                WritePageGuard w = fm.write_page_guard(pid);
+                uint16_t slot;
+                string rec = record_of(pid);
+                w->insert_record(rec.data(), static_cast<uint32_t>(rec.size()), slot);
+            }
+            freed = { pages[3], pages[4] };
+            assert(fm.free_pages(freed) && "测试21失败：释放页失败");
+            reused = fm.allocate_page();
+            {
+                WritePageGuard w = fm.write_page_guard(reused);
+                uint16_t slot;
+                w->insert_record("reused", 6, slot);
+            }
+            assert(fm.commit() && "测试21失败：提交失败");
+
+            // 模拟崩溃：FileManager仍在运行（脏页未写回、meta.dat仍是打开时的状态）时复制数据文件、meta.dat与日志段
+            for (uint32_t threads : { 1u, 4u }) {
+                string crash_dir = src_dir + "_crash" + to_string(threads);
+                filesystem::create_directories(crash_dir);
+                for (const char* name : { "data.dat", "meta.dat", "wal_00000000.log" }) {
+                    filesystem::copy_file(src_dir + "\\" + name, crash_dir + "\\" + name,
+                        filesystem::copy_options::overwrite_existing);
+                }
+            }
+        }
+
+        for (uint32_t threads : { 1u, 4u }) {
+            string crash_dir = src_dir + "_crash" + to_string(threads);
+            {
+                FileManager fm(crash_dir, 16, ReplacePolicy::LRU, IoMode::STREAM, threads);
+                const RecoveryStats& stats = fm.get_recovery_stats();
+                assert(stats.page_records >= 40 && stats.threads == threads && "测试21失败：未重做日志");
+                assert(stats.end_lsn > stats.start_lsn && stats.applied <= stats.page_records && "测试21失败：恢复统计错误");
+                const char* data = nullptr;
+                uint32_t len = 0;
+                for (uint32_t pid : pages) {
+                    if (pid == reused) continue;
+                    if (pid == freed[0] || pid == freed[1]) {
+                        assert(!fm.is_page_in_use(pid) && "测试21失败：释放页未重做");
+                        continue;
+                    }
+                    Page* page = fm.read_page(pid);
+                    assert(page && page->get_record(0, data, len) && string(data, len) == record_of(pid) && "测试21失败：页内容未恢复");
+                }
+                Page* page = fm.read_page(reused);
+                assert(fm.is_page_in_use(reused) && page && page->get_slot_count() == 1 && "测试21失败：复用页未恢复为新页");
+                assert(page->get_record(0, data, len) && string(data, len) == "reused" && "测试21失败：复用页内容错误");
+                cout << threads << "个线程重做" << stats.page_records << "条页记录（应用" << stats.applied << "条）" << endl;
+            }
+            {
+                // 恢复后做过检查点：再次打开无需重做
+                FileManager fm(crash_dir, 16, ReplacePolicy::LRU, IoMode::STREAM, threads);
+                assert(fm.get_recovery_stats().page_records == 0 && "测试21失败：恢复后未做检查点");
+                const char* data = nullptr;
+                uint32_t len = 0;
+                Page* page = fm.read_page(pages.back());
+                assert(page && page->get_record(0, data, len) && string(data, len) == record_of(pages.back()) && "测试21失败：恢复的数据未持久化");
+            }
+        }
+
+        cout << "崩溃恢复验证成功" << endl;
+        cout << "测试21通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试21失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试22：顺序预读（页链扫描时预读线程提前读入后续页，窗口随顺序访问增长）
+void test_read_ahead() {
+    cout << "=== 测试22：顺序预读 ===" << endl;
+    string ra_path = test_dir + "/read_ahead.dat";
+    remove(ra_path.c_str());
+
+    try {
+        PageManager pm(ra_path);
+        // 两条页链：正向链在连续区段上（一次读盘覆盖多页），反向链每页单独读
+        vector<uint32_t> pages = pm.allocate_pages(96);
+        vector<uint32_t> forward(pages.begin(), pages.begin() + 48);
+        vector<uint32_t> backward(pages.rbegin(), pages.rbegin() + 48);
+        {
+            CacheManager cm(pm, 256, ReplacePolicy::LRU, test_dir + "/cache_log_read_ahead.txt");
+            for (const vector<uint32_t>* chain : { &forward, &backward }) {
+                for (size_t i = 0; i < chain->size(); ++i) {
+                    WritePageGuard w(cm, (*chain)[i]);
+                    w->set_next_page_id(i + 1 < chain->size() ? (*chain)[i + 1] : INVALID_PAGE_ID);
+                }
+            }
+            cm.flush_all();
+        }
+
+        for (const vector<uint32_t>* chain : { &forward, &backward }) {
+            CacheManager cm(pm, 256, ReplacePolicy::LRU, test_dir + "/cache_log_read_ahead.txt");
+            cm.start_read_ahead();
+            ReadAheadState state;
+            uint32_t pid = chain->front();
+            uint32_t visited = 0;
+            while (pid != INVALID_PAGE_ID) {
+                ReadPageGuard p(cm, pid);
+                assert(p && "测试22失败：读页失败");
+                uint32_t next = p->get_next_page_id();
+                cm.read_ahead(state, pid, next);
+                this_thread::sleep_for(chrono::milliseconds(2)); // 模拟处理页内记录，让预读跑在扫描前面
+                pid = next;
+                ++visited;
+            }
+            assert(visited == chain->size() && "测试22失败：扫描页数错误");
+            cm.stop_read_ahead();
+
+            uint32_t hit, miss, prefetched, prefetch_hits;
+            double hit_rate;
+            cm.get_cache_stats(hit, miss, hit_rate);
+            cm.get_prefetch_stats(prefetched, prefetch_hits);
+            cout << (chain == &forward ? "连续" : "非连续") << "页链：未命中" << miss << "次，预读" << prefetched
+                << "页，其中" << prefetch_hits << "页被访问，预读窗口" << state.window << endl;
+            assert(prefetched > 0 && prefetch_hits > 0 && prefetch_hits <= prefetched && "测试22失败：预读未生效");
+            assert(miss < visited / 2 && "测试22失败：预读后仍大量未命中");
+            assert(state.window > READAHEAD_MIN_WINDOW && "测试22失败：预读窗口未增长");
+        }
+
+        // 非顺序访问不触发预读
+        {
+            CacheManager cm(pm, 256, ReplacePolicy::LRU, test_dir + "/cache_log_read_ahead.txt");
+            cm.start_read_ahead();
+            ReadAheadState state;
+            for (size_t i = 0; i < forward.size(); i += 3) {
+                ReadPageGuard p(cm, forward[i]);
+                cm.read_ahead(state, forward[i], p->get_next_page_id());
+            }
+            cm.stop_read_ahead();
+            uint32_t prefetched, prefetch_hits;
+            cm.get_prefetch_stats(prefetched, prefetch_hits);
+            assert(prefetched == 0 && state.window == 0 && "测试22失败：非顺序访问触发了预读");
+        }
+
+        cout << "顺序预读验证成功" << endl;
+        cout << "测试22通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试22失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试23：抗扫描替换策略（2Q/LRU-2/ARC）与顺序扫描提示
+void test_scan_resistant_policies() {
+    cout << "=== 测试23：抗扫描替换策略与顺序扫描提示 ===" << endl;
+    string sr_path = test_dir + "/scan_resistant.dat";
+    string log_path = test_dir + "/cache_log_scan.txt";
+    remove(sr_path.c_str());
+
+    try {
+        PageManager pm(sr_path);
+        // 4个热点页 + 每轮6个只访问一次的扫描页，缓存容量8：热点页与一轮扫描合起来放不下
+        const uint32_t rounds = 10, hot_count = 4, scan_per_round = 6;
+        vector<uint32_t> pages = pm.allocate_pages(hot_count + rounds * scan_per_round);
+        vector<uint32_t> hot(pages.begin(), pages.begin() + hot_count);
+
+        // 每轮先把全部热点页访问两遍（点查询）再扫描一段新页，返回第3轮起热点页的命中次数
+        auto run = [&](ReplacePolicy policy, AccessHint scan_hint) {
+            CacheManager cm(pm, 8, policy, log_path, LogLevel::OFF);
+            uint32_t hot_hits = 0;
+            size_t next_scan = hot_count;
+            for (uint32_t round = 0; round < rounds; ++round) {
+                for (int pass = 0; pass < 2; ++pass) {
+                    for (uint32_t pid : hot) {
+                        if (round >= 2 && cm.contains(pid)) ++hot_hits;
+                        assert(cm.get_page(pid) && "测试23失败：读热点页失败");
+                    }
+                }
+                for (uint32_t i = 0; i < scan_per_round; ++i) {
+                    assert(cm.get_page(pages[next_scan++], scan_hint) && "测试23失败：读扫描页失败");
+                }
+                assert(cm.get_current_size() <= 8 && "测试23失败：缓存超出容量");
+            }
+            return hot_hits;
+        };
+
+        const uint32_t measured = (rounds - 2) * hot_count * 2;
+        uint32_t lru_hits = run(ReplacePolicy::LRU, AccessHint::NORMAL);
+        uint32_t two_q_hits = run(ReplacePolicy::TWO_Q, AccessHint::NORMAL);
+        uint32_t lru2_hits = run(ReplacePolicy::LRU_2, AccessHint::NORMAL);
+        uint32_t arc_hits = run(ReplacePolicy::ARC, AccessHint::NORMAL);
+        uint32_t hinted_hits = run(ReplacePolicy::LRU, AccessHint::SEQUENTIAL);
+        cout << "热点页命中（共" << measured << "次访问）：LRU " << lru_hits << "，2Q " << two_q_hits
+            << "，LRU-2 " << lru2_hits << "，ARC " << arc_hits << "，LRU+扫描提示 " << hinted_hits << endl;
+        assert(lru_hits == measured / 2 && "测试23失败：LRU下扫描应冲掉热点页（只有每轮第二遍命中）");
+        assert(two_q_hits == measured && "测试23失败：2Q应保留热点页");
+        assert(lru2_hits == measured && "测试23失败：LRU-2应保留热点页");
+        assert(arc_hits == measured && "测试23失败：ARC应保留热点页");
+        assert(hinted_hits == measured && "测试23失败：带扫描提示时热点页不应被换出");
+
+        // 冷队列中的页：顺序访问命中不提升，普通访问命中后进入替换策略
+        {
+            CacheManager cm(pm, 2, ReplacePolicy::LRU, log_path, LogLevel::OFF);
+            cm.get_page(hot[0]);
+            cm.get_page(hot[1], AccessHint::SEQUENTIAL);
+            cm.get_page(hot[1], AccessHint::SEQUENTIAL);
+            cm.get_page(hot[2]);
+            assert(cm.contains(hot[0]) && !cm.contains(hot[1]) && "测试23失败：扫描页应先于普通页换出");
+            cm.get_page(hot[3], AccessHint::SEQUENTIAL);
+            cm.get_page(hot[3]);                       // 普通访问：页3离开冷队列，成为LRU队头
+            cm.get_page(hot[1]);
+            assert(cm.contains(hot[3]) && cm.contains(hot[1]) && "测试23失败：普通访问后扫描页应进入LRU");
+        }
+
+        cout << "抗扫描替换策略验证成功" << endl;
+        cout << "测试23通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试23失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试24：页校验和（写盘时计算、读盘时校验、整个数据文件并行校验）
+void test_page_checksum() {
+    cout << "=== 测试24：页校验和 ===" << endl;
+    string ck_path = test_dir + "/checksum.dat";
+    remove(ck_path.c_str());
+
+    // 直接改写数据文件中的字节（绕过PageManager，模拟介质损坏/写了一半的页）
+    auto patch_file = [](const string& path, uint64_t offset, const char* bytes, size_t len) {
+        fstream f(path, ios::in | ios::out | ios::binary);
+        f.seekp(static_cast<streamoff>(offset));
+        f.write(bytes, len);
+    };
+    auto page_offset = [](uint32_t pid) { return static_cast<uint64_t>(pid - 1) * DEFAULT_PAGE_SIZE; };
+
+    try {
+        // 1. CRC32C：标准校验值，硬件实现与软件实现结果相同（含非对齐起点与分段计算）
+        assert(crc32c("123456789", 9) == 0xE3069283u && "测试24失败：CRC32C校验值错误");
+        vector<char> buf(5000);
+        for (size_t i = 0; i < buf.size(); ++i) buf[i] = static_cast<char>(i * 131 + 7);
+        for (size_t off = 0; off < 8; ++off) {
+            for (size_t len : { 0, 1, 7, 8, 15, 64, 4093 }) {
+                assert(crc32c(buf.data() + off, len, 5) == crc32c_software(buf.data() + off, len, 5) &&
+                    "测试24失败：硬件与软件CRC32C结果不同");
+            }
+        }
+        assert(crc32c(buf.data() + 100, 200, crc32c(buf.data(), 100)) == crc32c(buf.data(), 300) &&
+            "测试24失败：分段计算结果不同");
+
+        PageManager pm(ck_path);
+        uint32_t p1 = pm.allocate_page();
+        uint32_t p2 = pm.allocate_page();
+        Page page(p1);
+        uint16_t slot;
+        page.insert_record("checksum", 8, slot);
+        assert(pm.write_page(p1, page) && "测试24失败：写页失败");
+        assert(page.raw_data()[PAGE_CHECKSUM_FLAG_OFFSET] == 0 && "测试24失败：写盘不应修改Page对象");
+
+        // 2. 写入的页带校验和，读出正确
+        char raw[DEFAULT_PAGE_SIZE];
+        assert(pm.read_raw_pages(p1, 1, raw) && Page::check_page(raw, DEFAULT_PAGE_SIZE, p1) == PageCheck::OK && "测试24失败：页校验和错误");
+        Page read_back;
+        assert(pm.read_page(p1, read_back) && "测试24失败：读带校验和的页失败");
+
+        // 3. 记录区翻转一个字节：读页失败并计数；关闭校验后可读
+        char flipped = static_cast<char>(raw[DEFAULT_PAGE_SIZE - 1] ^ 0x01);
+        patch_file(ck_path, page_offset(p1) + DEFAULT_PAGE_SIZE - 1, &flipped, 1);
+        assert(!pm.read_page(p1, read_back) && "测试24失败：损坏的页应读取失败");
+        assert(pm.get_checksum_failures() == 1 && "测试24失败：校验失败计数错误");
+        pm.set_verify_checksums(false);
+        assert(pm.read_page(p1, read_back) && "测试24失败：关闭校验后应能读取");
+        pm.set_verify_checksums(true);
+        patch_file(ck_path, page_offset(p1) + DEFAULT_PAGE_SIZE - 1, raw + DEFAULT_PAGE_SIZE - 1, 1);
+        assert(pm.read_page(p1, read_back) && "测试24失败：恢复字节后应能读取");
+
+        // 4. 写错位置：页1的内容出现在页2的位置，校验和本身正确但页号不符
+        patch_file(ck_path, page_offset(p2), raw, DEFAULT_PAGE_SIZE);
+        assert(!pm.read_page(p2, read_back) && "测试24失败：写错位置的页应读取失败");
+
+        // 5. 旧格式的页（没有校验和）：未要求校验和时可读；要求后读取失败，补写校验和后可读
+        char legacy[DEFAULT_PAGE_SIZE];
+        memcpy(legacy, raw, DEFAULT_PAGE_SIZE);
+        memset(legacy + PAGE_CHECKSUM_OFFSET, 0, 6);
+        patch_file(ck_path, page_offset(p1), legacy, DEFAULT_PAGE_SIZE);
+        Page blank(p2);
+        assert(pm.write_page(p2, blank) && "测试24失败：写页失败");
+        assert(pm.read_page(p1, read_back) && "测试24失败：未要求校验和时旧页应可读");
+        pm.set_checksum_required(true);
+        assert(!pm.read_page(p1, read_back) && "测试24失败：要求校验和时旧页应读取失败");
+        assert(pm.stamp_all_pages() == 1 && "测试24失败：应只给一个旧页补写校验和");
+        assert(pm.read_page(p1, read_back) && "测试24失败：补写校验和后应可读");
+        const char* rec = nullptr;
+        uint32_t len = 0;
+        assert(read_back.get_record(slot, rec, len) && len == 8 && memcmp(rec, "checksum", 8) == 0 &&
+            "测试24失败：补写校验和后记录内容错误");
+
+        // 6. 整个数据文件并行校验：损坏的页被找出，其余页正常
+        string verify_dir = test_dir + "/verify_db";
+        delete_test_dir(verify_dir);
+        vector<uint32_t> pages;
+        {
+            FileManager fm(verify_dir, 16, ReplacePolicy::LRU);
+            pages = fm.allocate_pages(300);
+            for (uint32_t pid : pages) {
+                WritePageGuard w = fm.write_page_guard(pid);
+                w->insert_record("verify", 6, slot);
+            }
+            VerifyStats st = fm.verify_data_file(4);
+            assert(st.corrupt.empty() && st.ok + st.empty == st.pages && st.ok >= pages.size() &&
+                "测试24失败：完好的数据文件校验出错");
+        }
+        uint32_t bad1 = pages[10], bad2 = pages[250];
+        char junk[16] = "garbage bytes!!";
+        patch_file(verify_dir + "\\" + DATA_FILE_NAME, page_offset(bad1) + 2000, junk, sizeof(junk));
+        patch_file(verify_dir + "\\" + DATA_FILE_NAME, page_offset(bad2) + 100, junk, sizeof(junk));
+        {
+            FileManager fm(verify_dir, 16, ReplacePolicy::LRU);
+            VerifyStats st = fm.verify_data_file(4);
+            cout << "校验" << st.pages << "页（" << st.threads << "线程）：正确" << st.ok << "，全零" << st.empty
+                << "，损坏" << st.corrupt.size() << endl;
+            assert(st.corrupt == vector<uint32_t>({ bad1, bad2 }) && "测试24失败：未找出损坏的页");
+            assert(!fm.read_page(bad1) && fm.read_page(pages[11]) && "测试24失败：损坏的页应读取失败");
+        }
+        delete_test_dir(verify_dir);
+
+        cout << "页校验和验证成功" << endl;
+        cout << "测试24通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试24失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试25：可选页大小（建库时选择并记录在meta.dat中；大于16KB的页使用宽槽）
+void test_page_size() {
+    cout << "=== 测试25：可选页大小 ===" << endl;
+
+    try {
+        // 1. 页大小取4KB~64KB之间的2的幂；不超过16KB的页用窄槽（与4KB页格式相同），更大的页用宽槽
+        assert(Page::is_valid_page_size(4096) && Page::is_valid_page_size(16384) && Page::is_valid_page_size(65536) &&
+            !Page::is_valid_page_size(2048) && !Page::is_valid_page_size(12288) && !Page::is_valid_page_size(131072) &&
+            "测试25失败：页大小合法性判断错误");
+        assert(Page::slot_size_of(16384) == SLOT_SIZE && Page::slot_size_of(32768) == WIDE_SLOT_SIZE &&
+            "测试25失败：槽宽度错误");
+
+        // 2. 64KB槽页：记录偏移与长度超出u16，删除/复用墓碑槽/变长更新（触发压缩）后槽号与内容不变
+        Page big(1, 65536);
+        string small(100, 'a'), large(40000, 'b'), reuse(20000, 'c'), longer(45000, 'd');
+        uint16_t s0, s1, s2;
+        assert(big.insert_record(small.data(), small.size(), s0) && big.insert_record(large.data(), large.size(), s1) &&
+            "测试25失败：64KB页插入失败");
+        assert(big.delete_record(s0) && big.insert_record(reuse.data(), reuse.size(), s2) && s2 == s0 &&
+            "测试25失败：64KB页未复用墓碑槽");
+        assert(big.update_record(s1, longer.data(), longer.size()) && "测试25失败：64KB页变长更新失败");
+        const char* rec = nullptr;
+        uint32_t len = 0;
+        assert(big.get_record(s1, rec, len) && string(rec, len) == longer && "测试25失败：更新后的记录错误");
+        assert(Page::view_record(big.raw_data(), 65536, s2, rec, len) && string(rec, len) == reuse &&
+            "测试25失败：只读视图读取记录错误");
+        Page empty(2, 65536);
+        string max_rec(empty.max_record_size(), 'm');
+        assert(!empty.insert_record(max_rec.data(), max_rec.size() + 1, s0) &&
+            empty.insert_record(max_rec.data(), max_rec.size(), s0) && empty.contiguous_free_space() == 0 &&
+            "测试25失败：最长记录边界错误");
+
+        // 3. 窄槽：16KB页的墓碑标志在磁盘字节中仍是len(u16)的最高位
+        Page mid(1, 16384);
+        assert(mid.insert_record(small.data(), small.size(), s0) && mid.delete_record(s0) && "测试25失败：16KB页删除失败");
+        uint16_t raw_len;
+        memcpy(&raw_len, mid.raw_data() + PAGE_HEADER_SIZE + 2, sizeof(raw_len));
+        assert(raw_len == (small.size() | 0x8000) && "测试25失败：窄槽格式改变");
+
+        // 4. 64KB页的整页日志拆成多段（段长为u16），应用后与原页相同
+        string wal_dir = test_dir + "/page_size_wal";
+        delete_test_dir(wal_dir);
+        create_test_dir(wal_dir);
+        {
+            WalManager wal(wal_dir);
+            wal.set_page_size(65536);
+            assert(wal.open(0) && "测试25失败：打开日志失败");
+            uint64_t lsn = wal.log_page_image(1, big.raw_data());
+            assert(wal.flush(lsn) && "测试25失败：写出日志失败");
+            string payload;
+            wal.scan(0, [&](const WalRecord& r) { payload.assign(r.payload, r.payload_len); return true; });
+            assert(payload.size() == 65536 + 2 * 4 && "测试25失败：整页日志分段错误");
+            vector<char> redo(65536, 0);
+            assert(WalManager::apply_page_delta(redo.data(), 65536, payload.data(), (uint32_t)payload.size()) &&
+                memcmp(redo.data(), big.raw_data(), 65536) == 0 && "测试25失败：应用整页日志结果错误");
+        }
+        delete_test_dir(wal_dir);
+
+        // 5. 按每种页大小建库：页大小写入meta.dat，重新打开（页大小参数被忽略）与崩溃恢复后内容不变
+        auto record_of = [](uint32_t pid, int i) { return to_string(pid) + ":" + to_string(i) + string(1000, 'x'); };
+        for (uint32_t size : { 4096u, 16384u, 65536u }) {
+            string dir = test_dir + "/page_size_" + to_string(size);
+            string crash_dir = dir + "_crash";
+            delete_test_dir(dir);
+            delete_test_dir(crash_dir);
+            vector<uint32_t> pages;
+            vector<int> counts;
+            {
+                FileManager fm(dir, 8, ReplacePolicy::LRU, IoMode::STREAM, REDO_DEFAULT_THREADS, size);
+                assert(fm.get_page_size() == size && fm.new_page().get_page_size() == size && "测试25失败：页大小未生效");
+                pages = fm.allocate_pages(20);
+                for (uint32_t pid : pages) {
+                    WritePageGuard w = fm.write_page_guard(pid);
+                    int n = 0;
+                    uint16_t slot;
+                    string r = record_of(pid, n);
+                    while (w->insert_record(r.data(), r.size(), slot)) r = record_of(pid, ++n);
+                    counts.push_back(n);
+                }
+                assert(counts.front() == static_cast<int>((size - PAGE_HEADER_SIZE) / (record_of(pages[0], 0).size() + Page::slot_size_of(size))) &&
+                    "测试25失败：每页记录数与页大小不符");
+                // 页大小不同的页对象不能写入
+                Page wrong(pages[0], size == DEFAULT_PAGE_SIZE ? 8192 : DEFAULT_PAGE_SIZE);
+                assert(!fm.write_page(pages[0], wrong) && "测试25失败：页大小不同的页不应写入");
+                assert(fm.commit() && "测试25失败：提交失败");
+
+                // 模拟崩溃：运行中复制数据文件、meta.dat与日志段
+                filesystem::create_directories(crash_dir);
+                for (const char* name : { "data.dat", "meta.dat", "wal_00000000.log" }) {
+                    filesystem::copy_file(dir + "\\" + name, crash_dir + "\\" + name, filesystem::copy_options::overwrite_existing);
+                }
+            }
+            for (const string& d : { dir, crash_dir }) {
+                FileManager fm(d, 8, ReplacePolicy::LRU, IoMode::STREAM, REDO_DEFAULT_THREADS, 8192);
+                assert(fm.get_page_size() == size && "测试25失败：重新打开后页大小错误");
+                for (size_t k = 0; k < pages.size(); ++k) {
+                    ReadPageGuard r = fm.read_page_guard(pages[k]);
+                    assert(r && r->get_page_size() == size && r->get_slot_count() == counts[k] && "测试25失败：重新打开后槽数错误");
+                    for (int i = 0; i < counts[k]; ++i) {
+                        assert(r->get_record(static_cast<uint16_t>(i), rec, len) && string(rec, len) == record_of(pages[k], i) &&
+                            "测试25失败：重新打开后记录错误");
+                    }
+                }
+                VerifyStats st = fm.verify_data_file(2);
+                assert(st.corrupt.empty() && st.ok >= pages.size() && "测试25失败：校验数据文件出错");
+            }
+            cout << size << "字节页：每页" << counts.front() << "条记录，重新打开与崩溃恢复后内容一致" << endl;
+            delete_test_dir(dir);
+            delete_test_dir(crash_dir);
+        }
+
+        // 6. 不合法的页大小不能建库
+        string bad_dir = test_dir + "/page_size_bad";
+        delete_test_dir(bad_dir);
+        bool rejected = false;
+        try {
+            FileManager fm(bad_dir, 8, ReplacePolicy::LRU, IoMode::STREAM, REDO_DEFAULT_THREADS, 5000);
+        }
+        catch (const runtime_error&) {
+            rejected = true;
+        }
+        assert(rejected && "测试25失败：不合法的页大小应拒绝建库");
+        delete_test_dir(bad_dir);
+
+        cout << "可选页大小验证成功" << endl;
+        cout << "测试25通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试25失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+void test_table_files() {
+    cout << "=== 测试26：每张表一个页文件 ===" << endl;
+
+    try {
+        string dir = test_dir + "/table_files";
+        string crash_dir = dir + "_crash";
+        delete_test_dir(dir);
+        delete_test_dir(crash_dir);
+        auto record_of = [](uint32_t pid) { return "row@" + to_string(pid); };
+        auto fill = [&](FileManager& fm, uint32_t pid) {
+            WritePageGuard w = fm.write_page_guard(pid);
+            uint16_t slot;
+            string r = record_of(pid);
+            return w && w->insert_record(r.data(), r.size(), slot);
+        };
+        auto check = [&](FileManager& fm, uint32_t pid) {
+            ReadPageGuard r = fm.read_page_guard(pid);
+            const char* rec = nullptr;
+            uint32_t len = 0;
+            return r && r->get_record(0, rec, len) && string(rec, len) == record_of(pid);
+        };
+
+        vector<uint32_t> a_pages, b_pages;
+        uint32_t a = 0, b = 0;
+        {
+            FileManager fm(dir, 16, ReplacePolicy::LRU);
+            // 1. 按文件名取文件号：不存在时创建，再次打开返回同一文件号；data.dat与meta.dat不能作为表文件
+            a = fm.open_table_file("a.tbl");
+            b = fm.open_table_file("b.tbl");
+            assert(a != SHARED_FILE_ID && b != SHARED_FILE_ID && a != b && fm.open_table_file("a.tbl") == a &&
+                fm.find_table_file("b.tbl") == b && fm.open_table_file(DATA_FILE_NAME) == SHARED_FILE_ID &&
+                "测试26失败：表文件号错误");
+
+            // 2. 两张表交替分配：各自文件内页号连续，共享数据文件不增长
+            for (int i = 0; i < 40; ++i) {
+                uint32_t pid = fm.allocate_page(i % 2 == 0 ? a : b);
+                (i % 2 == 0 ? a_pages : b_pages).push_back(pid);
+                assert(fill(fm, pid) && "测试26失败：写表页失败");
+            }
+            for (uint32_t k = 0; k < a_pages.size(); ++k) {
+                assert(Page::file_of(a_pages[k]) == a && Page::number_of(a_pages[k]) == k + 1 &&
+                    Page::file_of(b_pages[k]) == b && Page::number_of(b_pages[k]) == k + 1 && "测试26失败：表页未在各自文件中连续分配");
+            }
+            assert(fm.get_file_size(SHARED_FILE_ID) == 0 && fm.get_file_size(a) > 0 && "测试26失败：表页写入了共享数据文件");
+            assert(fm.commit() && "测试26失败：提交失败");
+
+            // 模拟崩溃：运行中复制全部文件（表页只在缓存与日志中）
+            filesystem::create_directories(crash_dir);
+            for (const char* name : { "data.dat", "meta.dat", "wal_00000000.log", "a.tbl", "b.tbl" }) {
+                filesystem::copy_file(dir + "\\" + name, crash_dir + "\\" + name, filesystem::copy_options::overwrite_existing);
+            }
+        }
+
+        // 3. 重新打开与崩溃恢复：文件号与页内容不变
+        for (const string& d : { dir, crash_dir }) {
+            FileManager fm(d, 16, ReplacePolicy::LRU);
+            assert(fm.find_table_file("a.tbl") == a && fm.find_table_file("b.tbl") == b && "测试26失败：重新打开后文件号错误");
+            for (size_t k = 0; k < a_pages.size(); ++k) {
+                assert(check(fm, a_pages[k]) && check(fm, b_pages[k]) && "测试26失败：重新打开后表页内容错误");
+            }
+            VerifyStats st = fm.verify_data_file(2);
+            assert(st.corrupt.empty() && st.ok == a_pages.size() + b_pages.size() && "测试26失败：校验表文件出错");
+        }
+        delete_test_dir(crash_dir);
+
+        {
+            FileManager fm(dir, 16, ReplacePolicy::LRU);
+            // 4. 清空：文件截断为0，缓存中的旧页被丢弃，之后从文件内页号1重新分配
+            assert(fm.truncate_table_file(a) && fm.get_file_size(a) == 0 && !fm.is_page_in_use(a_pages[0]) &&
+                "测试26失败：清空表文件失败");
+            uint32_t pid = fm.allocate_page(a);
+            assert(pid == a_pages[0] && fill(fm, pid) && "测试26失败：清空后分配的页错误");
+
+            // 5. 删除：文件从磁盘上删除，文件号可被新表复用
+            assert(fm.drop_table_file(b) && !filesystem::exists(dir + "\\b.tbl") && fm.find_table_file("b.tbl") == SHARED_FILE_ID &&
+                "测试26失败：删除表文件失败");
+            assert(fm.open_table_file("c.tbl") == b && fm.allocate_page(b) == b_pages[0] && "测试26失败：文件号未复用");
+
+            // 6. 改名：文件号与页不变
+            assert(fm.rename_table_file(a, "a2.tbl") && filesystem::exists(dir + "\\a2.tbl") && !filesystem::exists(dir + "\\a.tbl") &&
+                fm.find_table_file("a2.tbl") == a && check(fm, a_pages[0]) && "测试26失败：表文件改名失败");
+        }
+        {
+            FileManager fm(dir, 16, ReplacePolicy::LRU);
+            assert(fm.find_table_file("a2.tbl") == a && fm.find_table_file("c.tbl") == b && check(fm, a_pages[0]) &&
+                fm.is_page_in_use(b_pages[0]) && !fm.is_page_in_use(b_pages[1]) && "测试26失败：重新打开后表文件状态错误");
+        }
+        delete_test_dir(dir);
+
+        cout << "表页文件验证成功" << endl;
+        cout << "测试26通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试26失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+void test_extent_allocation() {
+    cout << "=== 测试27：区段分配 ===" << endl;
+
+    try {
+        string dir = test_dir + "/extent_db";
+        delete_test_dir(dir);
+        const uint32_t extent = 8;
+        auto extent_of = [&](uint32_t pid) { return (Page::number_of(pid) - 1) / extent; };
+        // 页链检查：同一区段内的相邻两页在文件中相邻，不同页链不共用区段
+        auto check_chains = [&](const vector<vector<uint32_t>>& chains) {
+            map<pair<uint32_t, uint32_t>, size_t> owner;
+            for (size_t c = 0; c < chains.size(); ++c) {
+                for (size_t i = 0; i < chains[c].size(); ++i) {
+                    uint32_t pid = chains[c][i];
+                    auto key = make_pair(Page::file_of(pid), extent_of(pid));
+                    if (owner.count(key) && owner[key] != c) return false;
+                    owner[key] = c;
+                    if (i > 0 && extent_of(chains[c][i - 1]) == extent_of(pid) && chains[c][i - 1] + 1 != pid) return false;
+                }
+            }
+            return true;
+        };
+
+        vector<uint32_t> a, b, c;
+        uint32_t file = 0;
+        {
+            FileManager fm(dir, 64, ReplacePolicy::LRU);
+            fm.set_extent_pages(extent);
+            file = fm.open_table_file("t.tbl");
+
+            // 1. 同一文件中两条页链交替增长：各自占用区段，区段内页号连续
+            a.push_back(fm.allocate_page_after(INVALID_PAGE_ID, file));
+            b.push_back(fm.allocate_page_after(INVALID_PAGE_ID, file));
+            assert(Page::number_of(a[0]) == 1 && Page::number_of(b[0]) == extent + 1 && "测试27失败：新页链未从区段起点开始");
+            for (int i = 0; i < 30; ++i) {
+                a.push_back(fm.allocate_page_after(a.back()));
+                b.push_back(fm.allocate_page_after(b.back()));
+            }
+            assert(check_chains({ a, b }) && "测试27失败：交替增长的页链不连续或共用区段");
+            assert(Page::number_of(a[1]) == 2 && Page::number_of(b[1]) == extent + 2 && "测试27失败：跳过的页未留给前一区段的页链");
+
+            // 2. 共享数据文件中同样按区段分配
+            vector<uint32_t> x, y;
+            x.push_back(fm.allocate_page_after(INVALID_PAGE_ID));
+            y.push_back(fm.allocate_page_after(INVALID_PAGE_ID));
+            for (int i = 0; i < 20; ++i) {
+                x.push_back(fm.allocate_page_after(x.back()));
+                y.push_back(fm.allocate_page_after(y.back()));
+            }
+            assert(Page::file_of(x[0]) == SHARED_FILE_ID && check_chains({ x, y }) && "测试27失败：共享数据文件中的页链不连续");
+
+            // 3. 释放一条页链后，新页链取整段空闲的区段
+            assert(fm.free_pages(a) && "测试27失败：释放页链失败");
+            c.push_back(fm.allocate_page_after(INVALID_PAGE_ID, file));
+            assert(find(a.begin(), a.end(), c[0]) != a.end() && Page::number_of(c[0]) % extent == 1 &&
+                "测试27失败：新页链未复用整段空闲的区段");
+            for (int i = 0; i < 5; ++i) c.push_back(fm.allocate_page_after(c.back()));
+            assert(check_chains({ b, c }) && "测试27失败：复用区段后页链不连续");
+        }
+        {
+            // 4. 重新打开后页链接着增长：区段中剩下的空闲页仍按顺序分配
+            FileManager fm(dir, 64, ReplacePolicy::LRU);
+            fm.set_extent_pages(extent);
+            for (int i = 0; i < 10; ++i) {
+                b.push_back(fm.allocate_page_after(b.back()));
+                c.push_back(fm.allocate_page_after(c.back()));
+            }
+            assert(check_chains({ b, c }) && "测试27失败：重新打开后页链不连续");
+            set<uint32_t> all(b.begin(), b.end());
+            all.insert(c.begin(), c.end());
+            assert(all.size() == b.size() + c.size() && "测试27失败：同一页被分配了两次");
+            VerifyStats st = fm.verify_data_file();
+            assert(st.corrupt.empty() && "测试27失败：数据文件校验出错");
+        }
+        delete_test_dir(dir);
+
+        cout << "区段分配验证成功" << endl;
+        cout << "测试27通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试27失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+void test_free_space_map_remove() {
+    cout << "=== 测试28：空闲空间映射注销数据页 ===" << endl;
+    string dir = test_dir + "/fsm_remove_db";
+    delete_test_dir(dir);
+
+    try {
+        const uint32_t base = 100000, count = FSM_ENTRIES_PER_PAGE + 10;
+        auto category_for = [](uint32_t i) { return static_cast<uint32_t>((i % 200) * FreeSpaceMap::category_bytes_of(DEFAULT_PAGE_SIZE) + 100); };
+        set<uint32_t> removed;
+        uint32_t fsm_first = INVALID_PAGE_ID;
+        {
+            FileManager fm(dir, 16, ReplacePolicy::LRU);
+            FreeSpaceMap fsm(fm);
+            for (uint32_t i = 0; i < count; ++i) assert(fsm.update(base + i, category_for(i)) && "测试28失败：登记数据页失败");
+
+            // 1. 注销首个FSM页中的条目、末尾条目与不存在的页：条目数相应减少
+            for (uint32_t i : { 0u, 7u, count - 1, static_cast<uint32_t>(FSM_ENTRIES_PER_PAGE - 1) }) {
+                assert(fsm.remove(base + i) && "测试28失败：注销数据页失败");
+                removed.insert(base + i);
+            }
+            assert(fsm.remove(base + count + 5) && fsm.size() == count - removed.size() && "测试28失败：注销后条目数错误");
+            uint8_t category;
+            assert(!fsm.get_category(base + 7, category) && fsm.get_category(base + count - 2, category) &&
+                "测试28失败：注销的页仍在映射中");
+
+            // 2. 注销到最后一个FSM页为空，之后再登记新页
+            for (uint32_t i = FSM_ENTRIES_PER_PAGE; i < count - 1; ++i) {
+                assert(fsm.remove(base + i) && "测试28失败：注销数据页失败");
+                removed.insert(base + i);
+            }
+            assert(fsm.update(base + count + 1, 0) && "测试28失败：注销后登记新页失败");
+            fsm_first = fsm.get_first_page_id();
+        }
+
+        // 3. 重新加载：注销的页不在映射中，其余页档位不变（被移动的条目写回了新位置）
+        FileManager fm(dir, 16, ReplacePolicy::LRU);
+        FreeSpaceMap fsm(fm, fsm_first);
+        assert(fsm.load() && fsm.size() == count - removed.size() + 1 && "测试28失败：重新加载后条目数错误");
+        for (uint32_t i = 0; i < count; ++i) {
+            uint8_t category;
+            bool found = fsm.get_category(base + i, category);
+            assert(found == (removed.count(base + i) == 0) && "测试28失败：重新加载后条目错误");
+            assert((!found || category == FreeSpaceMap::category_of(category_for(i), DEFAULT_PAGE_SIZE)) && "测试28失败：重新加载后档位错误");
+        }
+        fsm.release();
+        delete_test_dir(dir);
+
+        cout << "空闲空间映射注销验证成功" << endl;
+        cout << "测试28通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试28失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试29：记录转发（转发桩与迁入记录，窄槽与宽槽两种页）
+void test_record_forwarding() {
+    cout << "=== 测试29：记录转发 ===" << endl;
+    try {
+        for (uint32_t page_size : { DEFAULT_PAGE_SIZE, MAX_PAGE_SIZE }) {
+            auto read = [](const Page& p, uint16_t slot) {
+                const char* rec = nullptr;
+                uint32_t len = 0;
+                return p.get_record(slot, rec, len) ? string(rec, len) : string("<none>");
+            };
+            Page home(1, page_size), target(2, page_size);
+            uint16_t s0, s1, s2;
+            assert(home.insert_record("alpha", 5, s0) && home.insert_record("bravo", 5, s1) && "测试29失败：插入记录失败");
+
+            // 1. 迁入记录：扫描读到的是去掉原位置前缀的记录；原槽改为转发桩后扫描跳过
+            string grown(100, 'g');
+            assert(target.insert_moved_record(1, s1, grown.data(), (uint32_t)grown.size(), s2) && "测试29失败：插入迁入记录失败");
+            assert(home.set_forward(s1, 2, s2) && "测试29失败：设置转发桩失败");
+            uint32_t pid;
+            uint16_t slot;
+            assert(read(home, s1) == "<none>" && home.get_forward(s1, pid, slot) && pid == 2 && slot == s2 &&
+                "测试29失败：转发桩内容错误");
+            assert(read(target, s2) == grown && target.get_home(s2, pid, slot) && pid == 1 && slot == s1 &&
+                "测试29失败：迁入记录内容错误");
+            assert(!home.get_home(s1, pid, slot) && !target.get_forward(s2, pid, slot) && !home.get_forward(s0, pid, slot) &&
+                "测试29失败：普通记录被当作转发槽");
+            const char* raw_rec = nullptr;
+            uint32_t raw_len = 0;
+            assert(!Page::view_record(home.raw_data(), page_size, s1, raw_rec, raw_len) &&
+                Page::view_record(target.raw_data(), page_size, s2, raw_rec, raw_len) && string(raw_rec, raw_len) == grown &&
+                "测试29失败：只读视图未按转发处理");
+
+            // 2. 迁入记录原地更新保留原位置；转发桩不能按记录更新
+            string regrown(150, 'h');
+            assert(target.update_record(s2, regrown.data(), (uint32_t)regrown.size()) && read(target, s2) == regrown &&
+                target.get_home(s2, pid, slot) && pid == 1 && slot == s1 && "测试29失败：迁入记录更新后原位置丢失");
+            assert(!home.update_record(s1, "x", 1) && "测试29失败：转发桩被当作记录更新");
+
+            // 3. 压缩不回收转发桩与迁入记录；墓碑槽复用不占用它们
+            home.delete_record(s0);
+            target.compact();
+            home.compact();
+            assert(home.get_forward(s1, pid, slot) && slot == s2 && read(target, s2) == regrown &&
+                "测试29失败：压缩后转发槽丢失");
+            uint16_t s3;
+            assert(home.insert_record("charlie", 7, s3) && s3 == s0 && "测试29失败：墓碑槽未被复用");
+
+            // 4. 转发桩换回记录；删除迁入记录后槽可复用
+            assert(home.restore_record(s1, regrown.data(), (uint32_t)regrown.size()) && read(home, s1) == regrown &&
+                !home.get_forward(s1, pid, slot) && "测试29失败：迁回原页失败");
+            assert(!home.restore_record(s1, "y", 1) && "测试29失败：普通记录被当作转发桩换回");
+            assert(target.delete_record(s2) && !target.get_home(s2, pid, slot) && target.insert_record("z", 1, s3) && s3 == s2 &&
+                "测试29失败：删除迁入记录后槽未释放");
+
+            // 5. 经序列化往返后标志位保持（窄槽的标志位在长度的高两位）
+            assert(home.set_forward(s1, 7, 3) && "测试29失败：设置转发桩失败");
+            home.serialize();
+            Page copy(0, page_size);
+            copy.deserialize(home.raw_data());
+            assert(copy.get_forward(s1, pid, slot) && pid == 7 && slot == 3 && read(copy, s3) == "charlie" &&
+                "测试29失败：序列化后转发桩丢失");
+        }
+
+        cout << "记录转发验证成功" << endl;
+        cout << "测试29通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试29失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 辅助函数：沿表的页链取全部页号（检查前后链接一致）
+vector<uint32_t> table_chain(FileManager& fm, uint32_t first_pid) {
+    vector<uint32_t> pids;
+    uint32_t prev = INVALID_PAGE_ID;
+    for (uint32_t pid = first_pid; pid != INVALID_PAGE_ID && pid != 0;) {
+        ReadPageGuard p = fm.read_page_guard(pid);
+        if (!p || (!pids.empty() && p->get_prev_page_id() != prev)) throw runtime_error("页链断开：" + to_string(pid));
+        pids.push_back(pid);
+        prev = pid;
+        pid = p->get_next_page_id();
+    }
+    return pids;
+}
+
+// 测试30：谓词删除（StorageEngine::DeleteIf）
+void test_delete_if() {
+    cout << "=== 测试30：谓词删除 ===" << endl;
+    try {
+        string dir = test_dir + "/delete_if";
+        delete_test_dir(dir);
+        FileManager fm(dir, 256, ReplacePolicy::LRU);
+        CacheManager& cache = fm.get_cache_manager();
+        cache.stop_background_writer(); // 脏页标记只由本测试的写入与刷新改变
+        CatalogManager cmgr(dir + "/catalog.txt");
+        Catalog cat;
+        assert(cmgr.CreateTable(cat, "t", Schema({ Column("id", ColumnType::INT), Column("s", ColumnType::VARCHAR, 500) }), "t.tbl") &&
+            "测试30失败：建表失败");
+        StorageEngine se(cmgr, cat, fm);
+        assert(se.InitTablePages("t") && "测试30失败：初始化页链失败");
+        vector<vector<string>> rows;
+        for (int i = 0; i < 400; ++i) rows.push_back({ to_string(i), string(100, 'a' + i % 26) });
+        assert(se.BulkInsert("t", rows) && "测试30失败：批量插入失败");
+
+        TupleCodec codec(cat.GetTable("t")->getSchema());
+        auto ids_of = [&]() {
+            vector<int64_t> ids;
+            se.ScanTable("t", [&](const TupleView& v) { ids.push_back(v.get_int(0)); });
+            return ids;
+        };
+        // 每页中记录的id
+        map<uint32_t, vector<int64_t>> page_ids;
+        vector<uint32_t> chain = table_chain(fm, cat.GetTable("t")->first_pid);
+        for (uint32_t pid : chain) {
+            ReadPageGuard p = fm.read_page_guard(pid);
+            for (uint16_t slot = 0; slot < p->get_slot_count(); ++slot) {
+                const char* data = nullptr;
+                uint32_t len = 0;
+                if (p->get_record(slot, data, len)) page_ids[pid].push_back(TupleView(codec, data, len).get_int(0));
+            }
+        }
+        assert(chain.size() > 5 && "测试30失败：测试数据应占多页");
+
+        // 1. 范围谓词：删除行数正确，剩余行按原顺序保留；只有含命中记录的页被标脏
+        fm.flush_all_pages();
+        assert(cache.get_dirty_count() == 0 && "测试30失败：刷新后仍有脏页");
+        auto in_range = [](int64_t id) { return id >= 100 && id < 150; };
+        size_t deleted = 0;
+        assert(se.DeleteIf("t", [&](const TupleView& v) { return in_range(v.get_int(0)); }, &deleted) && deleted == 50 &&
+            "测试30失败：删除行数错误");
+        vector<int64_t> ids = ids_of();
+        vector<int64_t> expect;
+        for (int64_t i = 0; i < 400; ++i) if (!in_range(i)) expect.push_back(i);
+        assert(ids == expect && "测试30失败：剩余行错误");
+        for (uint32_t pid : chain) {
+            const vector<int64_t>& v = page_ids[pid];
+            bool hit = any_of(v.begin(), v.end(), in_range);
+            assert(cache.is_dirty(pid) == hit && "测试30失败：没有命中记录的页被标脏（或命中页未标脏）");
+        }
+
+        // 2. 迁入记录被删除时，原页中的转发桩一并删除
+        uint32_t home_pid = chain.front();
+        uint16_t home_slot = 5; // 首页按插入顺序存放，第6条为 id=5
+        {
+            ReadPageGuard p = fm.read_page_guard(home_pid);
+            const char* data = nullptr;
+            uint32_t len = 0;
+            assert(p->get_record(home_slot, data, len) && TupleView(codec, data, len).get_int(0) == 5 &&
+                "测试30失败：记录位置与预期不符");
+        }
+        assert(se.UpdateWhere("t", [](const vector<string>& r) { return r[0] == "5"; }, { { 1, string(400, 'z') } }) &&
+            "测试30失败：更新失败");
+        uint32_t moved_pid = 0;
+        uint16_t moved_slot = 0;
+        {
+            ReadPageGuard p = fm.read_page_guard(home_pid);
+            assert(p->get_forward(home_slot, moved_pid, moved_slot) && moved_pid != home_pid &&
+                "测试30失败：变长后的记录未迁出（首页应已装满）");
+        }
+        assert(se.DeleteIf("t", [](const TupleView& v) { return v.get_int(0) == 5; }, &deleted) && deleted == 1 &&
+            "测试30失败：删除迁出的记录失败");
+        {
+            ReadPageGuard home = fm.read_page_guard(home_pid);
+            const char* data = nullptr;
+            uint32_t len = 0, pid;
+            uint16_t slot;
+            assert(!home->get_forward(home_slot, pid, slot) && !home->get_record(home_slot, data, len) &&
+                "测试30失败：转发桩未删除");
+            ReadPageGuard moved = fm.read_page_guard(moved_pid);
+            assert(!moved->get_record(moved_slot, data, len) && "测试30失败：迁入记录未删除");
+        }
+        assert(ids_of().size() == 349 && "测试30失败：删除迁出记录后行数错误");
+
+        // 3. 空谓词：清空表，页链只剩一个空页
+        assert(se.DeleteIf("t", nullptr) && ids_of().empty() && "测试30失败：空谓词未清空表");
+        TableInfo* t = cat.GetTable("t");
+        assert(t->first_pid == t->last_pid && table_chain(fm, t->first_pid).size() == 1 && "测试30失败：清空后页链未重建");
+        assert(se.Insert("t", { "1", "x" }) && ids_of() == vector<int64_t>{ 1 } && "测试30失败：清空后不能插入");
+
+        cout << "谓词删除验证成功" << endl;
+        cout << "测试30通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试30失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试31：批量插入（StorageEngine::BulkInsert）
+void test_bulk_insert() {
+    cout << "=== 测试31：批量插入 ===" << endl;
+    try {
+        string dir = test_dir + "/bulk_insert";
+        delete_test_dir(dir);
+        const int bulk_rows = 3000; // 每页约35行：约86页，超过一批（BULK_INSERT_BATCH_PAGES页）
+        vector<int64_t> expect;
+        uint32_t last_pid = 0;
+        {
+            FileManager fm(dir, 256, ReplacePolicy::LRU);
+            CatalogManager cmgr(dir + "/catalog.txt");
+            Catalog cat;
+            assert(cmgr.CreateTable(cat, "t", Schema({ Column("id", ColumnType::INT), Column("s", ColumnType::VARCHAR, 500) }), "t.tbl") &&
+                "测试31失败：建表失败");
+            StorageEngine se(cmgr, cat, fm);
+            assert(se.InitTablePages("t") && "测试31失败：初始化页链失败");
+            auto ids_of = [&]() {
+                vector<int64_t> ids;
+                se.ScanTable("t", [&](const TupleView& v) { ids.push_back(v.get_int(0)); });
+                return ids;
+            };
+            for (int i = 0; i < 3; ++i) {
+                assert(se.Insert("t", { to_string(i), string(100, 'x') }) && "测试31失败：插入失败");
+                expect.push_back(i);
+            }
+            TableInfo* t = cat.GetTable("t");
+            const uint32_t tail = t->last_pid;
+
+            // 1. 先填满原表尾页，其余行整页写入（跨多批），行序与插入顺序一致
+            int next_id = 3;
+            size_t inserted = 0;
+            assert(se.BulkInsert("t", [&](vector<string>& row) {
+                if (next_id == 3 + bulk_rows) return false;
+                row = { to_string(next_id++), string(100, 'y') };
+                return true;
+            }, &inserted) && inserted == (size_t)bulk_rows && "测试31失败：批量插入失败");
+            for (int i = 3; i < 3 + bulk_rows; ++i) expect.push_back(i);
+            assert(ids_of() == expect && "测试31失败：批量插入后的行错误");
+
+            vector<uint32_t> chain = table_chain(fm, t->first_pid);
+            assert(chain.size() > BULK_INSERT_BATCH_PAGES + 1 && chain.front() == tail && chain.back() == t->last_pid &&
+                "测试31失败：页链错误");
+            string rec;
+            assert(TupleCodec(t->getSchema()).encode({ "0", string(100, 'y') }, rec) && "测试31失败：编码失败");
+            {
+                ReadPageGuard p = fm.read_page_guard(tail);
+                assert(p->get_slot_count() > 3 && p->reclaimable_space() < rec.size() + Page::slot_size_of(fm.get_page_size()) &&
+                    "测试31失败：原表尾页未填满");
+            }
+
+            // 2. FSM 中登记了每个数据页的可用空间
+            FreeSpaceMap fsm(fm, t->fsm_pid);
+            assert(t->fsm_pid != 0 && fsm.load() && "测试31失败：FSM 未建立");
+            for (uint32_t pid : chain) {
+                ReadPageGuard p = fm.read_page_guard(pid);
+                uint8_t category = 0;
+                assert(fsm.get_category(pid, category) &&
+                    category == FreeSpaceMap::category_of(p->reclaimable_space(), fm.get_page_size()) &&
+                    "测试31失败：FSM 登记的可用空间错误");
+            }
+
+            // 3. 目录中的 last_pid 已保存（不等关闭时的检查点）
+            last_pid = t->last_pid;
+            {
+                CatalogManager cmgr2(dir + "/catalog.txt");
+                Catalog cat2;
+                assert(cmgr2.LoadCatalog(cat2) && cat2.GetTable("t") && cat2.GetTable("t")->last_pid == last_pid &&
+                    "测试31失败：目录中的表尾页号未保存");
+            }
+
+            // 4. 中途遇到与列类型不符的行：停止并返回 false，之前的行保留，inserted 为已写入的行数
+            vector<vector<string>> rows;
+            for (int i = 0; i < 100; ++i) rows.push_back({ to_string(3 + bulk_rows + i), string(100, 'z') });
+            rows.push_back({ "abc", "bad" });
+            rows.push_back({ "999999", "after" });
+            assert(!se.BulkInsert("t", rows, &inserted) && inserted == 100 && "测试31失败：编码错误时返回值或行数错误");
+            for (int i = 0; i < 100; ++i) expect.push_back(3 + bulk_rows + i);
+            assert(ids_of() == expect && "测试31失败：编码错误之前的行未保留");
+            assert(t->last_pid == table_chain(fm, t->first_pid).back() && "测试31失败：中途出错后表尾页号错误");
+            last_pid = t->last_pid;
+        }
+
+        // 5. 重新打开：表尾页号与数据保持，且可以继续追加
+        {
+            FileManager fm(dir, 256, ReplacePolicy::LRU);
+            CatalogManager cmgr(dir + "/catalog.txt");
+            Catalog cat;
+            assert(cmgr.LoadCatalog(cat) && "测试31失败：读取目录失败");
+            StorageEngine se(cmgr, cat, fm);
+            assert(se.Startup() && cat.GetTable("t")->last_pid == last_pid && "测试31失败：重新打开后表尾页号错误");
+            assert(se.BulkInsert("t", vector<vector<string>>{ { "-1", "tail" } }) && "测试31失败：重新打开后追加失败");
+            expect.push_back(-1);
+            vector<int64_t> ids;
+            se.ScanTable("t", [&](const TupleView& v) { ids.push_back(v.get_int(0)); });
+            assert(ids == expect && "测试31失败：重新打开后的行错误");
+        }
+
+        cout << "批量插入验证成功" << endl;
+        cout << "测试31通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试31失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试32：CSV 导入（CsvLoader）
+void test_csv_loader() {
+    cout << "=== 测试32：CSV导入 ===" << endl;
+    try {
+        // 1. 拆分字段：引号内的分隔符与 "" 转义，空字段，右引号之后的字符
+        vector<string> f;
+        string line = "a,\"b,c\",\"d\"\"e\",,\"x\"y";
+        CsvLoader::SplitLine(line.data(), line.data() + line.size(), ',', f);
+        assert((f == vector<string>{ "a", "b,c", "d\"e", "", "xy" }) && "测试32失败：拆分字段错误");
+        line = "1\t\"2\t3\"";
+        CsvLoader::SplitLine(line.data(), line.data() + line.size(), '\t', f);
+        assert((f == vector<string>{ "1", "2\t3" }) && "测试32失败：制表符分隔错误");
+
+        // 2. 导入语句
+        string table, path, err;
+        CsvLoadOptions opts;
+        assert(CsvLoader::ParseCommand("load data infile 'a b.csv' into table t fields terminated by '\\t' ignore 2 lines;",
+            table, path, opts, err) && table == "t" && path == "a b.csv" && opts.delimiter == '\t' && opts.skip_lines == 2 &&
+            "测试32失败：解析 LOAD DATA 错误");
+        opts = CsvLoadOptions();
+        assert(CsvLoader::ParseCommand("COPY t2 FROM \"x.csv\" DELIMITER ';' HEADER", table, path, opts, err) &&
+            table == "t2" && path == "x.csv" && opts.delimiter == ';' && opts.skip_lines == 1 && "测试32失败：解析 COPY 错误");
+        assert(!CsvLoader::ParseCommand("LOAD DATA INFILE 'x' t", table, path, opts, err) && !err.empty() &&
+            !CsvLoader::ParseCommand("COPY t FROM 'x' DELIMITER ';;'", table, path, opts, err) &&
+            !CsvLoader::ParseCommand("COPY t FROM 'x' HEADER extra", table, path, opts, err) &&
+            !CsvLoader::ParseCommand("COPY t FROM 'x", table, path, opts, err) && "测试32失败：语法错误未报告");
+
+        string dir = test_dir + "/csv_loader";
+        delete_test_dir(dir);
+        FileManager fm(dir, 256, ReplacePolicy::LRU);
+        CatalogManager cmgr(dir + "/catalog.txt");
+        Catalog cat;
+        Schema schema({ Column("id", ColumnType::INT), Column("s", ColumnType::VARCHAR, 300) });
+        assert(cmgr.CreateTable(cat, "bom", schema, "bom.tbl") && cmgr.CreateTable(cat, "big", schema, "big.tbl") &&
+            cmgr.CreateTable(cat, "bad", schema, "bad.tbl") && "测试32失败：建表失败");
+        StorageEngine se(cmgr, cat, fm);
+        assert(se.InitTablePages("bom") && se.InitTablePages("big") && se.InitTablePages("bad") && "测试32失败：初始化页链失败");
+        CsvLoader loader(cat, se);
+        auto rows_of = [&](const string& name) { return se.SelectAll(name); };
+        auto value_of = [](int i) { return string(200, (char)('a' + i % 26)); };
+
+        // 3. UTF-8 BOM 与表头行跳过；空行跳过，\r\n 行尾，缺少的列为 NULL
+        {
+            ofstream out(dir + "/bom.csv", ios::binary);
+            out << "\xEF\xBB\xBFid,s\r\n1,\"x,y\"\r\n\r\n2\r\n";
+        }
+        opts = CsvLoadOptions();
+        opts.skip_lines = 1;
+        CsvLoadStats st;
+        assert(loader.Load("bom", dir + "/bom.csv", opts, st) && st.rows == 2 && "测试32失败：BOM/表头文件导入失败");
+        vector<vector<string>> rows = rows_of("bom");
+        assert(rows.size() == 2 && rows[0][0] == "1" && rows[0][1] == "x,y" && rows[1][0] == "2" && "测试32失败：BOM/表头文件的行错误");
+
+        // 4. 多于一块（CSV_LOAD_CHUNK_BYTES）的文件、多个解析线程：跨块的行完整，表中行序与文件一致
+        const int big_rows = 30000;
+        uint64_t offset = 0;
+        int spanning = -1; // 跨过第一块末尾的行
+        {
+            ofstream out(dir + "/big.csv", ios::binary);
+            for (int i = 0; i < big_rows; ++i) {
+                string l = to_string(i) + "," + value_of(i) + "\n";
+                if (offset < CSV_LOAD_CHUNK_BYTES && offset + l.size() > CSV_LOAD_CHUNK_BYTES) spanning = i;
+                offset += l.size();
+                out << l;
+            }
+        }
+        assert(offset > CSV_LOAD_CHUNK_BYTES && spanning > 0 &&
+            "测试32失败：测试文件应跨多块且有行跨块");
+        opts = CsvLoadOptions();
+        opts.threads = 4;
+        assert(loader.Load("big", dir + "/big.csv", opts, st) && st.rows == (uint64_t)big_rows && st.threads == 4 &&
+            st.bytes == offset && "测试32失败：大文件导入失败");
+        rows = rows_of("big");
+        assert(rows.size() == (size_t)big_rows && "测试32失败：大文件导入行数错误");
+        for (int i = 0; i < big_rows; ++i) {
+            assert(rows[i][0] == to_string(i) && rows[i][1] == value_of(i) && "测试32失败：行序或内容错误");
+        }
+        assert(rows[spanning][1] == value_of(spanning) && "测试32失败：跨块的行不完整");
+
+        // 5. 出错行：行号为文件中的绝对行号（含跳过的表头），之前的行已写入
+        const int bad_line = 25002; // 表头 + 25000 行之后
+        {
+            ofstream out(dir + "/bad.csv", ios::binary);
+            out << "id,s\n";
+            for (int i = 0; i < bad_line - 2; ++i) out << i << "," << value_of(i) << "\n";
+            out << "oops," << value_of(0) << "\n";
+            for (int i = 0; i < 100; ++i) out << i << ",after\n";
+        }
+        opts.skip_lines = 1;
+        assert(!loader.Load("bad", dir + "/bad.csv", opts, st) && st.error_line == (uint64_t)bad_line && !st.error.empty() &&
+            st.rows == (uint64_t)(bad_line - 2) && "测试32失败：出错行号或已写入行数错误");
+        rows = rows_of("bad");
+        assert(rows.size() == (size_t)(bad_line - 2) && rows.back()[0] == to_string(bad_line - 3) &&
+            "测试32失败：出错行之前的行未保留");
+
+        cout << "CSV导入验证成功" << endl;
+        cout << "测试32通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试32失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
+
+// 测试33：文本 UPDATE 原地更新（Executor::ExecuteUpdate -> StorageEngine::UpdateIf）
+void test_update_in_place() {
+    cout << "=== 测试33：UPDATE原地更新 ===" << endl;
+    try {
+        string dir = test_dir + "/update_in_place";
+        delete_test_dir(dir);
+        FileManager fm(dir, 256, ReplacePolicy::LRU);
+        CacheManager& cache = fm.get_cache_manager();
+        cache.stop_background_writer(); // 脏页标记只由本测试的写入与刷新改变
+        CatalogManager cmgr(dir + "/catalog.txt");
+        Catalog cat;
+        assert(cmgr.CreateTable(cat, "t", Schema({ Column("id", ColumnType::INT), Column("name", ColumnType::VARCHAR, 500) }), "t.tbl") &&
+            "测试33失败：建表失败");
+        StorageEngine se(cmgr, cat, fm);
+        assert(se.InitTablePages("t") && "测试33失败：初始化页链失败");
+        vector<vector<string>> rows;
+        for (int i = 0; i < 400; ++i) rows.push_back({ to_string(i), string(100, 'a' + i % 26) });
+        assert(se.BulkInsert("t", rows) && "测试33失败：批量插入失败");
+        Executor exec(cmgr, cat, se);
+
+        TupleCodec codec(cat.GetTable("t")->getSchema());
+        vector<uint32_t> chain = table_chain(fm, cat.GetTable("t")->first_pid);
+        assert(chain.size() > 5 && "测试33失败：测试数据应占多页");
+        // 记录所在页 与 各页的页LSN
+        auto page_of = [&](int64_t id) {
+            for (uint32_t pid : chain) {
+                ReadPageGuard p = fm.read_page_guard(pid);
+                for (uint16_t slot = 0; slot < p->get_slot_count(); ++slot) {
+                    const char* data = nullptr;
+                    uint32_t len = 0;
+                    if (p->get_record(slot, data, len) && TupleView(codec, data, len).get_int(0) == id) return pid;
+                }
+            }
+            return (uint32_t)INVALID_PAGE_ID;
+        };
+        auto lsns = [&]() {
+            map<uint32_t, uint64_t> m;
+            for (uint32_t pid : chain) m[pid] = fm.read_page_guard(pid)->get_lsn();
+            return m;
+        };
+        auto name_of = [&](int64_t id) {
+            string name;
+            se.ScanTable("t", [&](const TupleView& v) { if (v.get_int(0) == id) name = v.to_text(1); });
+            return name;
+        };
+        // 执行一条 UPDATE 后：只有 touched 中的页被标脏、页LSN前移，其余页不变
+        auto check_touched = [&](const string& sql, const set<uint32_t>& touched) {
+            fm.flush_all_pages();
+            map<uint32_t, uint64_t> before = lsns();
+            assert(exec.Execute(sql) && "测试33失败：UPDATE执行失败");
+            map<uint32_t, uint64_t> after = lsns();
+            for (uint32_t pid : chain) {
+                bool hit = touched.count(pid) > 0;
+                assert(cache.is_dirty(pid) == hit && (after[pid] != before[pid]) == hit &&
+                    "测试33失败：没有命中行的页被改写（或命中页未改写）");
+            }
+        };
+
+        // 1. 单行等值更新：只改写该行所在页
+        check_touched("UPDATE t SET name = 'zz' WHERE id = 200;", { page_of(200) });
+        assert(name_of(200) == "zz" && name_of(201) == string(100, 'a' + 201 % 26) && "测试33失败：等值更新结果错误");
+
+        // 2. IN：两行在不同页
+        assert(page_of(5) != page_of(390) && "测试33失败：测试行应在不同页");
+        check_touched("UPDATE t SET name = 'in' WHERE id IN (5, 390);", { page_of(5), page_of(390) });
+        assert(name_of(5) == "in" && name_of(390) == "in" && "测试33失败：IN更新结果错误");
+
+        // 3. BETWEEN 与 AND 合取
+        check_touched("UPDATE t SET name = 'bt' WHERE id BETWEEN 100 AND 101;", { page_of(100), page_of(101) });
+        assert(name_of(100) == "bt" && name_of(101) == "bt" && name_of(102) != "bt" && "测试33失败：BETWEEN更新结果错误");
+        check_touched("UPDATE t SET name = 'and' WHERE id=300 AND name=bt;", {});
+        check_touched("UPDATE t SET name = 'and' WHERE id=101 AND name=bt;", { page_of(101) });
+        assert(name_of(101) == "and" && "测试33失败：AND更新结果错误");
+
+        // 4. 不合法的 SET 值或条件值：报错，表不变
+        fm.flush_all_pages();
+        assert(!exec.Execute("UPDATE t SET id = 'abc' WHERE id = 1;") && !exec.Execute("UPDATE t SET name = 'x' WHERE id = abc;") &&
+            cache.get_dirty_count() == 0 && "测试33失败：不合法的UPDATE修改了表");
+
+        cout << "UPDATE原地更新验证成功" << endl;
+        cout << "测试33通过！" << endl << endl;
+    }
+    catch (const exception& e) {
+        cerr << "测试33失败：" << e.what() << endl << endl;
+        exit(1);
+    }
+}
 
 int main() {
-    // ִв
+    // 执行测试用例
     test_allocate_and_write();
     test_read_and_free();
     test_table_page_mapping();
 
     test_cache_hit_miss();
     test_lru_policy();
+    test_lru_clock_order();
+    test_event_log();
+    test_mmap_mode();
+    test_slotted_page();
+    test_free_space_map();
+    test_free_page_bitmap();
+    test_batch_allocate();
+    test_page_guard();
+    test_sharded_cache();
+    test_background_writer();
+    test_wal();
+    test_crash_recovery();
+    test_read_ahead();
+    test_scan_resistant_policies();
+    test_page_checksum();
+    test_page_size();
+    test_table_files();
+    test_extent_allocation();
+    test_free_space_map_remove();
+    test_record_forwarding();
+    test_delete_if();
+    test_bulk_insert();
+    test_csv_loader();
+    test_update_in_place();
     //test_dirty_page_flush();
 
      //test_file_init_and_metadata();
      //test_data_persistence();
     //test_module_coordination();
 
-    cout << "вͨ" << endl;
+    cout << "所有测试用例均通过！" << endl;
     return 0;
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
-// =============================================
-// utils/constants.h
-// =============================================
-#pragma once
-namespace minidb { static constexpr const char* CATALOG_FILE = "catalog.dat"; }#pragma once
+// =============================================
+// utils/constants.h
+// =============================================
+#pragma once
+namespace minidb { static constexpr const char* CATALOG_FILE = "catalog.dat"; }#pragma once